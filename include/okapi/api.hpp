@@ -42,6 +42,7 @@
 #include "okapi/api/chassis/controller/odomChassisController.hpp"
 #include "okapi/api/chassis/model/hDriveModel.hpp"
 #include "okapi/api/chassis/model/readOnlyChassisModel.hpp"
+#include "okapi/api/chassis/model/sensorValues.hpp"
 #include "okapi/api/chassis/model/skidSteerModel.hpp"
 #include "okapi/api/chassis/model/threeEncoderSkidSteerModel.hpp"
 #include "okapi/api/chassis/model/threeEncoderXDriveModel.hpp"
@@ -60,10 +61,22 @@
 #include "okapi/api/control/iterative/iterativeMotorVelocityController.hpp"
 #include "okapi/api/control/iterative/iterativePosPidController.hpp"
 #include "okapi/api/control/iterative/iterativeVelPidController.hpp"
+#include "okapi/api/control/util/binaryPath.hpp"
+#include "okapi/api/control/util/executionPlan.hpp"
 #include "okapi/api/control/util/controllerRunner.hpp"
+#include "okapi/api/control/util/controllerTelemetry.hpp"
+#include "okapi/api/control/util/controlScheduler.hpp"
 #include "okapi/api/control/util/flywheelSimulator.hpp"
+#include "okapi/api/control/util/loopStats.hpp"
+#include "okapi/api/control/util/pathGenerationPool.hpp"
+#include "okapi/api/control/util/pathGenerationQueue.hpp"
+#include "okapi/api/control/util/pathMemoryBudget.hpp"
+#include "okapi/api/control/util/sensorCache.hpp"
+#include "okapi/api/control/util/pathStore.hpp"
 #include "okapi/api/control/util/pidTuner.hpp"
 #include "okapi/api/control/util/settledUtil.hpp"
+#include "okapi/api/control/util/trajectoryCache.hpp"
+#include "okapi/api/control/util/trajectorySampler.hpp"
 #include "okapi/impl/control/async/asyncMotionProfileControllerBuilder.hpp"
 #include "okapi/impl/control/async/asyncPosControllerBuilder.hpp"
 #include "okapi/impl/control/async/asyncVelControllerBuilder.hpp"
@@ -71,10 +84,12 @@
 #include "okapi/impl/control/util/controllerRunnerFactory.hpp"
 #include "okapi/impl/control/util/pidTunerFactory.hpp"
 
+#include "okapi/api/odometry/imuOdometry.hpp"
 #include "okapi/api/odometry/odomMath.hpp"
 #include "okapi/api/odometry/odometry.hpp"
 #include "okapi/api/odometry/threeEncoderOdometry.hpp"
 
+#include "okapi/api/device/motor/motorCommandBuffer.hpp"
 #include "okapi/api/device/rotarysensor/continuousRotarySensor.hpp"
 #include "okapi/api/device/rotarysensor/rotarySensor.hpp"
 #include "okapi/impl/device/adiUltrasonic.hpp"
@@ -102,6 +117,7 @@
 #include "okapi/api/filter/filteredControllerInput.hpp"
 #include "okapi/api/filter/medianFilter.hpp"
 #include "okapi/api/filter/passthroughFilter.hpp"
+#include "okapi/api/filter/poseEKF.hpp"
 #include "okapi/api/filter/velMath.hpp"
 #include "okapi/impl/filter/velMathFactory.hpp"
 
@@ -126,6 +142,7 @@
 #include "okapi/api/util/abstractRate.hpp"
 #include "okapi/api/util/abstractTimer.hpp"
 #include "okapi/api/util/mathUtil.hpp"
+#include "okapi/api/util/matrix.hpp"
 #include "okapi/api/util/supplier.hpp"
 #include "okapi/api/util/timeUtil.hpp"
 #include "okapi/impl/util/configurableTimeUtilFactory.hpp"
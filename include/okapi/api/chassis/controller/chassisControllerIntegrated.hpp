@@ -172,6 +172,7 @@ class ChassisControllerIntegrated : public ChassisController {
 
   protected:
   std::shared_ptr<Logger> logger;
+  static constexpr Logger::Component okapiLogComponent = Logger::Component::chassis;
   bool normalTurns{true};
   std::shared_ptr<ChassisModel> chassisModel;
   TimeUtil timeUtil;
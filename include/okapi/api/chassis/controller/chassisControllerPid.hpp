@@ -6,7 +6,10 @@
 #pragma once
 
 #include "okapi/api/chassis/controller/chassisController.hpp"
+#include "okapi/api/chassis/model/sensorValues.hpp"
 #include "okapi/api/control/iterative/iterativePosPidController.hpp"
+#include "okapi/api/control/util/controlScheduler.hpp"
+#include "okapi/api/control/util/loopStats.hpp"
 #include "okapi/api/util/abstractRate.hpp"
 #include "okapi/api/util/logging.hpp"
 #include "okapi/api/util/timeUtil.hpp"
@@ -142,10 +145,20 @@ class ChassisControllerPID : public ChassisController {
   bool isSettled() override;
 
   /**
-   * Delays until the currently executing movement completes.
+   * Delays until the currently executing movement completes. The task sleeps until the
+   * controller's task signals that the movement settled.
    */
   void waitUntilSettled() override;
 
+  /**
+   * Delays until the currently executing movement completes or the timeout passes. The movement
+   * keeps running if the timeout passes.
+   *
+   * @param itimeout The longest time to wait.
+   * @return Whether the movement completed.
+   */
+  bool waitUntilSettled(QTime itimeout);
+
   /**
    * Gets the ChassisScales.
    */
@@ -193,13 +206,32 @@ class ChassisControllerPID : public ChassisController {
    */
   void startThread();
 
+  /**
+   * Runs the PID controllers on a scheduler's task instead of starting a task for them. Use this
+   * instead of startThread(). The controllers then read the chassis sensors through the
+   * scheduler's sensor cache.
+   *
+   * @param ischeduler The scheduler to run on.
+   * @param iorder Where the controllers run in each of the scheduler's ticks.
+   */
+  void startThread(const std::shared_ptr<ControlScheduler> &ischeduler,
+                   int iorder = ControlScheduler::chassisOrder);
+
   /**
    * Returns the underlying thread handle.
    *
-   * @return The underlying thread handle.
+   * @return The underlying thread handle, or `nullptr` if the controllers run on a scheduler.
    */
   CrossplatformThread *getThread() const;
 
+  /**
+   * Returns how long each step of the task which runs the PID controllers takes and how regularly
+   * it runs.
+   *
+   * @return The measurements of the task's loop.
+   */
+  const LoopStats &getLoopStats() const;
+
   /**
    * Interrupts the current movement to stop the robot.
    */
@@ -230,9 +262,12 @@ class ChassisControllerPID : public ChassisController {
 
   protected:
   std::shared_ptr<Logger> logger;
+  static constexpr Logger::Component okapiLogComponent = Logger::Component::chassis;
   bool normalTurns{true};
   std::shared_ptr<ChassisModel> chassisModel;
+  std::shared_ptr<ReadOnlyChassisModel> sensors; // Reads the sensors, through the scheduler's cache
   TimeUtil timeUtil;
+  LoopStats loopStats;
   std::unique_ptr<IterativePosPIDController> distancePid;
   std::unique_ptr<IterativePosPIDController> turnPid;
   std::unique_ptr<IterativePosPIDController> anglePid;
@@ -243,24 +278,40 @@ class ChassisControllerPID : public ChassisController {
   std::atomic_bool doneLoopingSeen{true};
   std::atomic_bool newMovement{false};
   std::atomic_bool dtorCalled{false};
+  bool wasSettled{false}; // Only used by tick(), to notify waiters when the movement settles
   QTime threadSleepTime{10_ms};
 
   static void trampoline(void *context);
   void loop();
 
+  /**
+   * Steps the PID controllers once. This is the body of the task's loop and what a scheduler runs.
+   */
+  void tick();
+
+  /**
+   * Delays until the current movement completes, the timeout passes, or the movement changes.
+   *
+   * @param itimeout The longest time to wait in milliseconds, or CrossplatformSignal::forever.
+   * @return Whether the movement completed.
+   */
+  bool waitUntilSettledFor(std::uint32_t itimeout);
+
   /**
    * Wait for the distance setup (distancePid and anglePid) to settle.
    *
-   * @return true if done settling; false if settling should be tried again
+   * @param itimeout The longest time to wait in milliseconds.
+   * @return true if done settling; false if settling should be tried again or the time is up
    */
-  bool waitForDistanceSettled();
+  bool waitForDistanceSettled(std::uint32_t itimeout);
 
   /**
    * Wait for the angle setup (anglePid) to settle.
    *
-   * @return true if done settling; false if settling should be tried again
+   * @param itimeout The longest time to wait in milliseconds.
+   * @return true if done settling; false if settling should be tried again or the time is up
    */
-  bool waitForAngleSettled();
+  bool waitForAngleSettled(std::uint32_t itimeout);
 
   /**
    * Stops all the controllers and the ChassisModel.
@@ -269,7 +320,12 @@ class ChassisControllerPID : public ChassisController {
 
   typedef enum { distance, angle, none } modeType;
   modeType mode{none};
+  modeType pastMode{none};
+  SensorValues encStartVals;
 
   CrossplatformThread *task{nullptr};
+  CrossplatformSignal settledSignal;
+  std::shared_ptr<ControlScheduler> scheduler;
+  ControlScheduler::SlotId schedulerSlot{0};
 };
 } // namespace okapi
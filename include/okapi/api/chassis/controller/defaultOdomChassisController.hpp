@@ -176,6 +176,7 @@ class DefaultOdomChassisController : public OdomChassisController {
 
   protected:
   std::shared_ptr<Logger> logger;
+  static constexpr Logger::Component okapiLogComponent = Logger::Component::chassis;
   std::shared_ptr<ChassisController> controller;
 
   void waitForOdomTask();
@@ -7,6 +7,8 @@
 
 #include "okapi/api/chassis/controller/chassisController.hpp"
 #include "okapi/api/chassis/model/skidSteerModel.hpp"
+#include "okapi/api/control/util/controlScheduler.hpp"
+#include "okapi/api/control/util/loopStats.hpp"
 #include "okapi/api/coreProsAPI.hpp"
 #include "okapi/api/odometry/odometry.hpp"
 #include "okapi/api/odometry/point.hpp"
@@ -128,10 +130,27 @@ class OdomChassisController : public ChassisController {
   void startOdomThread();
 
   /**
-   * @return The underlying thread handle.
+   * Runs the odometry on a scheduler's task instead of starting a task for it. Use this instead of
+   * startOdomThread().
+   *
+   * @param ischeduler The scheduler to run on.
+   * @param iorder Where the odometry runs in each of the scheduler's ticks.
+   */
+  void startOdomThread(const std::shared_ptr<ControlScheduler> &ischeduler,
+                       int iorder = ControlScheduler::odometryOrder);
+
+  /**
+   * @return The underlying thread handle, or `nullptr` if the odometry runs on a scheduler.
    */
   CrossplatformThread *getOdomThread() const;
 
+  /**
+   * Returns how long each odometry step takes and how regularly the odometry task runs.
+   *
+   * @return The measurements of the task's loop.
+   */
+  const LoopStats &getLoopStats() const;
+
   /**
    * @return The internal odometry.
    */
@@ -139,16 +158,25 @@ class OdomChassisController : public ChassisController {
 
   protected:
   std::shared_ptr<Logger> logger;
+  static constexpr Logger::Component okapiLogComponent = Logger::Component::chassis;
   TimeUtil timeUtil;
+  LoopStats loopStats;
   QLength moveThreshold;
   QAngle turnThreshold;
   std::shared_ptr<Odometry> odom;
   CrossplatformThread *odomTask{nullptr};
+  std::shared_ptr<ControlScheduler> scheduler;
+  ControlScheduler::SlotId schedulerSlot{0};
   std::atomic_bool dtorCalled{false};
   StateMode defaultStateMode{StateMode::FRAME_TRANSFORMATION};
   std::atomic_bool odomTaskRunning{false};
 
   static void trampoline(void *context);
   void loop();
+
+  /**
+   * Steps the odometry once. This is the body of the task's loop and what a scheduler runs.
+   */
+  void tick();
 };
 } // namespace okapi
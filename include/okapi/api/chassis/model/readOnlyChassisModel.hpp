@@ -5,6 +5,7 @@
  */
 #pragma once
 
+#include "okapi/api/chassis/model/sensorValues.hpp"
 #include "okapi/api/coreProsAPI.hpp"
 #include <valarray>
 
@@ -19,7 +20,23 @@ class ReadOnlyChassisModel {
   virtual ~ReadOnlyChassisModel() = default;
 
   /**
-   * Read the sensors.
+   * Read the sensors. The odometry and the chassis controllers call this every loop, so
+   * implementations override it to read their sensors without allocating. Implementations whose
+   * sensors report when they were sampled also set SensorValues::getTimestamp().
+   *
+   * By default, this copies the readings of getSensorVals(), which allocates. At most
+   * SensorValues::capacity readings fit; more throw a std::out_of_range.
+   *
+   * @return sensor readings (format is implementation dependent)
+   */
+  virtual SensorValues getSensorValues() const {
+    return SensorValues(getSensorVals());
+  }
+
+  /**
+   * Read the sensors into a `std::valarray`, which allocates on every call. Prefer
+   * getSensorValues(). Implementations which override getSensorValues() can implement this as
+   * `return getSensorValues().toValarray();`.
    *
    * @return sensor readings (format is implementation dependent)
    */
@@ -0,0 +1,178 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <valarray>
+
+namespace okapi {
+class SensorValues {
+  public:
+  /**
+   * The most values a SensorValues can hold. The built-in chassis models have at most a left, a
+   * right, and a middle sensor; the rest is room for custom models with more sensors.
+   */
+  static constexpr std::size_t capacity = 8;
+
+  /**
+   * The readings of a chassis model's sensors. Unlike a `std::valarray`, the values are stored
+   * inline, so making, copying, and subtracting readings never allocates. This is what the chassis
+   * models, the odometry, and the chassis controllers pass around every loop.
+   */
+  constexpr SensorValues() = default;
+
+  /**
+   * @param ivalues The values. Throws a std::out_of_range if there are more than `capacity`.
+   */
+  SensorValues(std::initializer_list<std::int32_t> ivalues) {
+    assign(ivalues.begin(), ivalues.size());
+  }
+
+  /**
+   * Copies the values of a `std::valarray`, for sensors which still return one. Throws a
+   * std::out_of_range if there are more than `capacity`.
+   *
+   * @param ivalues The values.
+   */
+  explicit SensorValues(const std::valarray<std::int32_t> &ivalues) {
+    assign(std::begin(ivalues), ivalues.size());
+  }
+
+  /**
+   * @return The values as a `std::valarray`, which allocates.
+   */
+  std::valarray<std::int32_t> toValarray() const {
+    return std::valarray<std::int32_t>(values.data(), count);
+  }
+
+  /**
+   * @return The number of values.
+   */
+  constexpr std::size_t size() const {
+    return count;
+  }
+
+  constexpr std::int32_t operator[](const std::size_t i) const {
+    return values[i];
+  }
+
+  constexpr std::int32_t &operator[](const std::size_t i) {
+    return values[i];
+  }
+
+  /**
+   * @return The device time, in ms, the values were sampled at, or `0` if the sensors do not
+   * report when they were sampled.
+   */
+  constexpr std::uint32_t getTimestamp() const {
+    return timestamp;
+  }
+
+  /**
+   * @param itimestamp The device time, in ms, the values were sampled at, or `0` if unknown.
+   */
+  constexpr void setTimestamp(const std::uint32_t itimestamp) {
+    timestamp = itimestamp;
+  }
+
+  /**
+   * Combines the timestamps of sensors which were read together. The values are only as new as
+   * the oldest of them, and are untimed if any of them is untimed.
+   *
+   * @param itimestamps The timestamps of each sensor.
+   * @return The oldest timestamp, or `0` if any of them is `0`.
+   */
+  static constexpr std::uint32_t
+  oldestTimestamp(const std::initializer_list<std::uint32_t> itimestamps) {
+    std::uint32_t oldest = 0;
+    for (const auto time : itimestamps) {
+      if (time == 0) {
+        return 0;
+      }
+
+      // Compare the difference so the device clock wrapping around does not matter
+      if (oldest == 0 || static_cast<std::int32_t>(time - oldest) < 0) {
+        oldest = time;
+      }
+    }
+    return oldest;
+  }
+
+  constexpr const std::int32_t *begin() const {
+    return values.data();
+  }
+
+  constexpr const std::int32_t *end() const {
+    return values.data() + count;
+  }
+
+  /**
+   * Subtracts the values element-wise. The result has as many values, and the timestamp, of this.
+   * Missing values of `rhs` count as zero.
+   */
+  constexpr SensorValues operator-(const SensorValues &rhs) const {
+    SensorValues out(*this);
+    for (std::size_t i = 0; i < std::min(count, rhs.count); ++i) {
+      out.values[i] -= rhs.values[i];
+    }
+    return out;
+  }
+
+  /**
+   * Adds the values element-wise. The result has as many values, and the timestamp, of this.
+   * Missing values of `rhs` count as zero.
+   */
+  constexpr SensorValues operator+(const SensorValues &rhs) const {
+    SensorValues out(*this);
+    for (std::size_t i = 0; i < std::min(count, rhs.count); ++i) {
+      out.values[i] += rhs.values[i];
+    }
+    return out;
+  }
+
+  /**
+   * Compares the values. The timestamps are not compared.
+   */
+  constexpr bool operator==(const SensorValues &rhs) const {
+    if (count != rhs.count) {
+      return false;
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+      if (values[i] != rhs.values[i]) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  constexpr bool operator!=(const SensorValues &rhs) const {
+    return !(*this == rhs);
+  }
+
+  protected:
+  std::array<std::int32_t, capacity> values{};
+  std::size_t count{0};
+  std::uint32_t timestamp{0};
+
+  void assign(const std::int32_t *ivalues, const std::size_t isize) {
+    if (isize > capacity) {
+      throw std::out_of_range("SensorValues: Got " + std::to_string(isize) +
+                              " values, but can only hold " + std::to_string(capacity) + ".");
+    }
+
+    std::copy(ivalues, ivalues + isize, values.begin());
+    count = isize;
+  }
+};
+} // namespace okapi
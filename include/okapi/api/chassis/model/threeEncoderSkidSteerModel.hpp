@@ -29,7 +29,17 @@ class ThreeEncoderSkidSteerModel : public SkidSteerModel {
                              double imaxVoltage);
 
   /**
-   * Read the sensors.
+   * Read the sensors. In a subclass, this returns the readings of getSensorVals() instead, so
+   * subclasses which override only that method are still read correctly. Those readings allocate
+   * and have no timestamp, so subclasses which do not change the readings can override this to
+   * return readSensors().
+   *
+   * @return sensor readings in the format {left, right, middle}
+   */
+  SensorValues getSensorValues() const override;
+
+  /**
+   * Read the sensors into a `std::valarray`, which allocates. Prefer getSensorValues().
    *
    * @return sensor readings in the format {left, right, middle}
    */
@@ -42,5 +52,12 @@ class ThreeEncoderSkidSteerModel : public SkidSteerModel {
 
   protected:
   std::shared_ptr<ContinuousRotarySensor> middleSensor;
+
+  /**
+   * Read the sensors without going through getSensorVals().
+   *
+   * @return sensor readings in the format {left, right, middle}
+   */
+  SensorValues readSensors() const;
 };
 } // namespace okapi
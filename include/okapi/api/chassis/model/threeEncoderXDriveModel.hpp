@@ -33,7 +33,17 @@ class ThreeEncoderXDriveModel : public XDriveModel {
                           double imaxVoltage);
 
   /**
-   * Read the sensors.
+   * Read the sensors. In a subclass, this returns the readings of getSensorVals() instead, so
+   * subclasses which override only that method are still read correctly. Those readings allocate
+   * and have no timestamp, so subclasses which do not change the readings can override this to
+   * return readSensors().
+   *
+   * @return sensor readings in the format {left, right, middle}
+   */
+  SensorValues getSensorValues() const override;
+
+  /**
+   * Read the sensors into a `std::valarray`, which allocates. Prefer getSensorValues().
    *
    * @return sensor readings in the format {left, right, middle}
    */
@@ -46,5 +56,12 @@ class ThreeEncoderXDriveModel : public XDriveModel {
 
   protected:
   std::shared_ptr<ContinuousRotarySensor> middleSensor;
+
+  /**
+   * Read the sensors without going through getSensorVals().
+   *
+   * @return sensor readings in the format {left, right, middle}
+   */
+  SensorValues readSensors() const;
 };
 } // namespace okapi
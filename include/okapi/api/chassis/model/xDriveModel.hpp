@@ -173,7 +173,17 @@ class XDriveModel : public ChassisModel {
   void right(double ispeed) override;
 
   /**
-   * Read the sensors.
+   * Read the sensors. In a subclass, this returns the readings of getSensorVals() instead, so
+   * subclasses which override only that method are still read correctly. Those readings allocate
+   * and have no timestamp, so subclasses which do not change the readings can override this to
+   * return readSensors().
+   *
+   * @return sensor readings in the format {left, right}
+   */
+  SensorValues getSensorValues() const override;
+
+  /**
+   * Read the sensors into a `std::valarray`, which allocates. Prefer getSensorValues().
    *
    * @return sensor readings in the format {left, right}
    */
@@ -269,5 +279,12 @@ class XDriveModel : public ChassisModel {
   std::shared_ptr<AbstractMotor> bottomLeftMotor;
   std::shared_ptr<ContinuousRotarySensor> leftSensor;
   std::shared_ptr<ContinuousRotarySensor> rightSensor;
+
+  /**
+   * Read the sensors without going through getSensorVals().
+   *
+   * @return sensor readings in the format {left, right}
+   */
+  SensorValues readSensors() const;
 };
 } // namespace okapi
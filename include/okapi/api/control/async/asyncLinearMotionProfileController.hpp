@@ -6,7 +6,15 @@
 #pragma once
 
 #include "okapi/api/control/async/asyncPositionController.hpp"
+#include "okapi/api/control/util/controlScheduler.hpp"
+#include "okapi/api/control/util/executionPlan.hpp"
+#include "okapi/api/control/util/loopStats.hpp"
+#include "okapi/api/control/util/pathGenerationPool.hpp"
+#include "okapi/api/control/util/pathGenerationQueue.hpp"
+#include "okapi/api/control/util/pathMemoryBudget.hpp"
+#include "okapi/api/control/util/pathStore.hpp"
 #include "okapi/api/control/util/pathfinderUtil.hpp"
+#include "okapi/api/control/util/trajectorySampler.hpp"
 #include "okapi/api/device/motor/abstractMotor.hpp"
 #include "okapi/api/units/QAngularSpeed.hpp"
 #include "okapi/api/units/QSpeed.hpp"
@@ -14,6 +22,7 @@
 #include "okapi/api/util/timeUtil.hpp"
 #include <atomic>
 #include <map>
+#include <optional>
 
 #include "squiggles.hpp"
 
@@ -74,6 +83,60 @@ class AsyncLinearMotionProfileController : public AsyncPositionController<std::s
                     const std::string &ipathId,
                     const PathfinderLimits &ilimits);
 
+  /**
+   * Queues a path which intersects the given waypoints to be generated in the background and saves
+   * it internally with a key of pathId once it is ready. Paths are generated one at a time, in the
+   * order they were queued, on a low-priority task, so this method returns immediately. Call
+   * `setTarget()` with the same pathId to run it; `setTarget()` will wait for the path to finish
+   * generating if it is not ready yet.
+   *
+   * If the waypoints form a path which is impossible to achieve, the returned handle is marked as
+   * failed (and an error is logged) instead of throwing an exception.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ipathId A unique identifier to save the path with.
+   * @return A handle which can be used to wait for the path.
+   */
+  std::shared_ptr<PathGenerationHandle> generatePathAsync(std::initializer_list<QLength> iwaypoints,
+                                                          const std::string &ipathId);
+
+  /**
+   * Queues a path which intersects the given waypoints to be generated in the background and saves
+   * it internally with a key of pathId once it is ready. Paths are generated one at a time, in the
+   * order they were queued, on a low-priority task, so this method returns immediately. Call
+   * `setTarget()` with the same pathId to run it; `setTarget()` will wait for the path to finish
+   * generating if it is not ready yet.
+   *
+   * If the waypoints form a path which is impossible to achieve, the returned handle is marked as
+   * failed (and an error is logged) instead of throwing an exception.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ipathId A unique identifier to save the path with.
+   * @param ilimits The limits to use for this path only.
+   * @return A handle which can be used to wait for the path.
+   */
+  std::shared_ptr<PathGenerationHandle> generatePathAsync(std::initializer_list<QLength> iwaypoints,
+                                                          const std::string &ipathId,
+                                                          const PathfinderLimits &ilimits);
+
+  /**
+   * Generates several paths at once and saves each one internally with a key of its pathId. The
+   * paths are independent, so they are spread over a pool of worker tasks (see
+   * `PathGenerationPool`) and this method blocks until all of them are done. Use this in
+   * `initialize()` instead of calling `generatePath()` many times in a row.
+   *
+   * A path which is impossible to achieve, or which doesn't fit in the path memory budget, is not
+   * saved and its result says why. The other paths are still generated. Every job must have a
+   * different pathId.
+   *
+   * @param ijobs The paths to generate.
+   * @param iworkers The number of worker tasks to generate them on.
+   * @return The result of each job, including how long it took, in the same order as the jobs.
+   */
+  std::vector<PathGenerationResult>
+  generatePaths(const std::vector<LinearPathGenerationJob> &ijobs,
+                std::size_t iworkers = PathGenerationPool::defaultWorkerCount());
+
   /**
    * Removes a path and frees the memory it used. This function returns `true` if the path was
    * either deleted or didn't exist in the first place. It returns `false` if the path could not be
@@ -93,7 +156,8 @@ class AsyncLinearMotionProfileController : public AsyncPositionController<std::s
 
   /**
    * Executes a path with the given ID. If there is no path matching the ID, the method will
-   * return. Any targets set while a path is being followed will be ignored.
+   * return. Any targets set while a path is being followed will be ignored. If the path is still
+   * being generated by `generatePathAsync()`, this method blocks until it is ready.
    *
    * @param ipathId A unique identifier for the path, previously passed to `generatePath()`.
    */
@@ -101,7 +165,8 @@ class AsyncLinearMotionProfileController : public AsyncPositionController<std::s
 
   /**
    * Executes a path with the given ID. If there is no path matching the ID, the method will
-   * return. Any targets set while a path is being followed will be ignored.
+   * return. Any targets set while a path is being followed will be ignored. If the path is still
+   * being generated by `generatePathAsync()`, this method blocks until it is ready.
    *
    * @param ipathId A unique identifier for the path, previously passed to `generatePath()`.
    * @param ibackwards Whether to follow the profile backwards.
@@ -143,6 +208,15 @@ class AsyncLinearMotionProfileController : public AsyncPositionController<std::s
    */
   void waitUntilSettled() override;
 
+  /**
+   * Blocks the current task until the controller has settled or the timeout passes. The path keeps
+   * being followed if the timeout passes.
+   *
+   * @param itimeout The longest time to wait.
+   * @return Whether the controller settled.
+   */
+  bool waitUntilSettled(QTime itimeout);
+
   /**
    * Generates a new path from the position (typically the current position) to the target and
    * blocks until the controller has settled. Does not save the path which was generated.
@@ -233,12 +307,60 @@ class AsyncLinearMotionProfileController : public AsyncPositionController<std::s
   void startThread();
 
   /**
-   * Returns the underlying thread handle.
+   * Follows paths on a scheduler's task instead of starting a task for them. Use this instead of
+   * startThread().
    *
-   * @return The underlying thread handle.
+   * @param ischeduler The scheduler to run on.
+   * @param iorder Where the controller runs in each of the scheduler's ticks.
+   */
+  void startThread(const std::shared_ptr<ControlScheduler> &ischeduler,
+                   int iorder = ControlScheduler::mechanismOrder);
+
+  /**
+   * @return The underlying thread handle, or `nullptr` if the controller runs on a scheduler.
    */
   CrossplatformThread *getThread() const;
 
+  /**
+   * Returns how long each step of following a path takes and how regularly the steps run.
+   *
+   * @return The measurements of the task's loop.
+   */
+  const LoopStats &getLoopStats() const;
+
+  /**
+   * Returns the maximum lag observed while following the most recent path. The lag of a loop
+   * iteration is how much longer than one loop period it ran after the previous iteration. The path
+   * is sampled by the time since it started, so a late iteration skips ahead instead of delaying
+   * the rest of the path.
+   *
+   * @return The maximum lag.
+   */
+  QTime getMaxLag() const;
+
+  /**
+   * Sets the memory budget paths are stored under. The budget can be shared between controllers so
+   * all of their paths count against the same limit. A path which doesn't fit in the budget is
+   * compacted, and if it still doesn't fit it is not stored and a warning is logged. This should be
+   * set before any paths are generated. Pass `nullptr` to remove the limit, which is the default.
+   *
+   * @param ibudget The path memory budget.
+   */
+  void setPathMemoryBudget(const std::shared_ptr<PathMemoryBudget> &ibudget);
+
+  /**
+   * @return The path memory budget, or `nullptr` if there is no limit.
+   */
+  std::shared_ptr<PathMemoryBudget> getPathMemoryBudget() const;
+
+  /**
+   * Returns how much memory a path uses.
+   *
+   * @param ipathId The path ID.
+   * @return The approximate number of bytes the path uses, or `0` if there is no path with that ID.
+   */
+  std::size_t getPathMemoryUsage(const std::string &ipathId) const;
+
   /**
    * Attempts to remove a path without stopping execution, then if that fails, disables the
    * controller and removes the path.
@@ -249,32 +371,116 @@ class AsyncLinearMotionProfileController : public AsyncPositionController<std::s
 
   protected:
   std::shared_ptr<Logger> logger;
-  std::map<std::string, std::vector<squiggles::ProfilePoint>> paths{};
+  static constexpr Logger::Component okapiLogComponent = Logger::Component::motionProfile;
+  PathStore<ExecutionPlan> paths{};
   PathfinderLimits limits;
   std::shared_ptr<ControllerOutput<double>> output;
   QLength diameter;
   AbstractMotor::GearsetRatioPair pair;
   double currentProfilePosition{0};
   TimeUtil timeUtil;
-
-  // This must be locked when accessing the current path
-  CrossplatformMutex currentPathMutex;
+  LoopStats loopStats;
 
   std::string currentPath{""};
   std::atomic_bool isRunning{false};
   std::atomic_int direction{1};
   std::atomic_bool disabled{false};
   std::atomic_bool dtorCalled{false};
+  std::atomic<double> maxLag{0}; // In seconds
   CrossplatformThread *task{nullptr};
+  CrossplatformSignal settledSignal;
+  std::shared_ptr<ControlScheduler> scheduler;
+  ControlScheduler::SlotId schedulerSlot{0};
+  std::unique_ptr<PathGenerationQueue> generator;
+  std::shared_ptr<PathMemoryBudget> pathMemoryBudget{nullptr};
+
+  /**
+   * How far a path has been followed.
+   */
+  struct PathProgress {
+    const ExecutionPlan *path{nullptr};
+    std::unique_ptr<AbstractTimer> timer{nullptr};
+    TrajectorySampler sampler{};
+    QTime start{0_ms};
+    QTime lastIteration{0_ms};
+    double reversed{1};
+  };
+
+  // The path being followed when the controller runs on a scheduler
+  std::shared_ptr<const ExecutionPlan> scheduledPath{nullptr};
+  std::optional<PathProgress> scheduledProgress;
 
   static void trampoline(void *context);
   void loop();
 
   /**
-   * Follow the supplied path. Must follow the disabled lifecycle.
+   * Follows paths one tick at a time. This is what a scheduler runs.
+   */
+  void tick();
+
+  /**
+   * Looks up the target path before following it.
+   *
+   * @return The path, or `nullptr` (and logs a warning) if there is no path with the target's name.
+   */
+  std::shared_ptr<const ExecutionPlan> findTargetPath();
+
+  /**
+   * Starts following a path.
+   *
+   * @param path The path, which must outlive the returned progress.
+   * @return The progress at the start of the path.
+   */
+  PathProgress beginPath(const ExecutionPlan &path);
+
+  /**
+   * Sends the commands for the current point in a path.
+   *
+   * @param iprogress The progress through the path.
+   * @return Whether the path continues. If not, no commands were sent.
+   */
+  bool followPath(PathProgress &iprogress);
+
+  /**
+   * Warns if points of a path were skipped because it was followed late.
+   *
+   * @param iprogress The progress through the path once it is done.
+   */
+  void endPath(const PathProgress &iprogress);
+
+  /**
+   * Generates a path and saves it. This is shared by `generatePath()`, `generatePathAsync()`, and
+   * `generatePaths()`.
+   *
+   * @return Whether the path was saved.
+   */
+  bool internalGeneratePath(const std::vector<QLength> &iwaypoints,
+                            const std::string &ipathId,
+                            const PathfinderLimits &ilimits);
+
+  /**
+   * Follow the supplied path. Must follow the disabled lifecycle. The path is kept alive by the
+   * caller, so it is safe to use without locking even if it is removed while being followed.
+   */
+  virtual void executeSinglePath(const ExecutionPlan &path, std::unique_ptr<AbstractRate> rate);
+
+  /**
+   * Compiles a path into the motor commands `executeSinglePath()` sends.
+   *
+   * @param ipath The path to compile.
+   * @return The execution plan.
+   */
+  ExecutionPlan compilePath(const std::vector<squiggles::ProfilePoint> &ipath) const;
+
+  /**
+   * Saves a path, replacing any path with the same ID. If there is a path memory budget the path
+   * is counted against it.
+   *
+   * @param ipathId The path ID.
+   * @param iplan The path.
+   * @return Whether the path was saved. It is not saved if it does not fit in the budget.
    */
-  virtual void executeSinglePath(const std::vector<squiggles::ProfilePoint> &path,
-                                 std::unique_ptr<AbstractRate> rate);
+  bool insertPath(const std::string &ipathId, ExecutionPlan iplan);
 
   /**
    * Converts linear "chassis" speed to rotational motor speed.
@@ -8,7 +8,17 @@
 #include "okapi/api/chassis/controller/chassisScales.hpp"
 #include "okapi/api/chassis/model/skidSteerModel.hpp"
 #include "okapi/api/control/async/asyncPositionController.hpp"
+#include "okapi/api/control/util/binaryPath.hpp"
+#include "okapi/api/control/util/controlScheduler.hpp"
+#include "okapi/api/control/util/executionPlan.hpp"
+#include "okapi/api/control/util/pathMemoryBudget.hpp"
+#include "okapi/api/control/util/loopStats.hpp"
+#include "okapi/api/control/util/pathGenerationPool.hpp"
+#include "okapi/api/control/util/pathGenerationQueue.hpp"
+#include "okapi/api/control/util/pathStore.hpp"
 #include "okapi/api/control/util/pathfinderUtil.hpp"
+#include "okapi/api/control/util/trajectoryCache.hpp"
+#include "okapi/api/control/util/trajectorySampler.hpp"
 #include "okapi/api/units/QAngularSpeed.hpp"
 #include "okapi/api/units/QSpeed.hpp"
 #include "okapi/api/util/logging.hpp"
@@ -16,6 +26,7 @@
 #include <atomic>
 #include <iostream>
 #include <map>
+#include <optional>
 
 #include "squiggles.hpp"
 
@@ -79,6 +90,110 @@ class AsyncMotionProfileController : public AsyncPositionController<std::string,
                     const std::string &ipathId,
                     const PathfinderLimits &ilimits);
 
+  /**
+   * Queues a path which intersects the given waypoints to be generated in the background and saves
+   * it internally with a key of pathId once it is ready. Paths are generated one at a time, in the
+   * order they were queued, on a low-priority task, so this method returns immediately. Call
+   * `setTarget()` with the same pathId to run it; `setTarget()` will wait for the path to finish
+   * generating if it is not ready yet.
+   *
+   * If the waypoints form a path which is impossible to achieve, the returned handle is marked as
+   * failed (and an error is logged) instead of throwing an exception.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ipathId A unique identifier to save the path with.
+   * @return A handle which can be used to wait for the path.
+   */
+  std::shared_ptr<PathGenerationHandle>
+  generatePathAsync(std::initializer_list<PathfinderPoint> iwaypoints, const std::string &ipathId);
+
+  /**
+   * Queues a path which intersects the given waypoints to be generated in the background and saves
+   * it internally with a key of pathId once it is ready. Paths are generated one at a time, in the
+   * order they were queued, on a low-priority task, so this method returns immediately. Call
+   * `setTarget()` with the same pathId to run it; `setTarget()` will wait for the path to finish
+   * generating if it is not ready yet.
+   *
+   * If the waypoints form a path which is impossible to achieve, the returned handle is marked as
+   * failed (and an error is logged) instead of throwing an exception.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ipathId A unique identifier to save the path with.
+   * @param ilimits The limits to use for this path only.
+   * @return A handle which can be used to wait for the path.
+   */
+  std::shared_ptr<PathGenerationHandle>
+  generatePathAsync(std::initializer_list<PathfinderPoint> iwaypoints,
+                    const std::string &ipathId,
+                    const PathfinderLimits &ilimits);
+
+  /**
+   * Generates several paths at once and saves each one internally with a key of its pathId. The
+   * paths are independent, so they are spread over a pool of worker tasks (see
+   * `PathGenerationPool`) and this method blocks until all of them are done. Use this in
+   * `initialize()` instead of calling `generatePath()` many times in a row.
+   *
+   * A path which is impossible to achieve, or which doesn't fit in the path memory budget, is not
+   * saved and its result says why. The other paths are still generated. Every job must have a
+   * different pathId.
+   *
+   * @param ijobs The paths to generate.
+   * @param iworkers The number of worker tasks to generate them on.
+   * @return The result of each job, including how long it took, in the same order as the jobs.
+   */
+  std::vector<PathGenerationResult>
+  generatePaths(const std::vector<PathGenerationJob> &ijobs,
+                std::size_t iworkers = PathGenerationPool::defaultWorkerCount());
+
+  /**
+   * Generates a chain of path segments which are followed one after the other without stopping in
+   * between, and saves it internally as one path with a key of pathId. Call `setTarget()` with the
+   * same pathId to run it. Each segment starts where the previous segment ended, and its waypoints
+   * are relative to that point.
+   *
+   * Consecutive segments which are followed in the same direction are joined at the maximum
+   * velocity, so the robot rolls straight from one into the next. Where the direction changes,
+   * the segments are joined at zero velocity, so the robot reverses without waiting for the
+   * chassis to be stopped. The first segment starts at rest and the last segment ends at rest.
+   *
+   * If a segment is impossible to achieve, an instance of `std::runtime_error` is thrown (and an
+   * error is logged). If no segment has waypoints, no path is generated.
+   *
+   * @param isegments The segments to chain together.
+   * @param ipathId A unique identifier to save the path with.
+   * @return Whether the path was saved. It is not saved if no segment has waypoints or if it does
+   * not fit in the path memory budget; the reason is logged.
+   */
+  bool generatePathChain(const std::vector<PathChainSegment> &isegments,
+                         const std::string &ipathId);
+
+  /**
+   * Generates a chain of path segments which are followed one after the other without stopping in
+   * between, and saves it internally as one path with a key of pathId. Call `setTarget()` with the
+   * same pathId to run it. Each segment starts where the previous segment ended, and its waypoints
+   * are relative to that point.
+   *
+   * Consecutive segments which are followed in the same direction are joined at
+   * `ijunctionVelocity`, so the robot rolls straight from one into the next. Where the direction
+   * changes, the segments are joined at zero velocity, so the robot reverses without waiting for
+   * the chassis to be stopped. The first segment starts at rest and the last segment ends at rest.
+   *
+   * If a segment is impossible to achieve, an instance of `std::runtime_error` is thrown (and an
+   * error is logged). If no segment has waypoints, no path is generated.
+   *
+   * @param isegments The segments to chain together.
+   * @param ipathId A unique identifier to save the path with.
+   * @param ilimits The limits to use for this path only.
+   * @param ijunctionVelocity The velocity in m/s to join segments followed in the same direction
+   * at. This must not be more than `ilimits.maxVel`.
+   * @return Whether the path was saved. It is not saved if no segment has waypoints or if it does
+   * not fit in the path memory budget; the reason is logged.
+   */
+  bool generatePathChain(const std::vector<PathChainSegment> &isegments,
+                         const std::string &ipathId,
+                         const PathfinderLimits &ilimits,
+                         double ijunctionVelocity);
+
   /**
    * Removes a path and frees the memory it used. This function returns true if the path was either
    * deleted or didn't exist in the first place. It returns false if the path could not be removed
@@ -98,7 +213,8 @@ class AsyncMotionProfileController : public AsyncPositionController<std::string,
 
   /**
    * Executes a path with the given ID. If there is no path matching the ID, the method will
-   * return. Any targets set while a path is being followed will be ignored.
+   * return. Any targets set while a path is being followed will be ignored. If the path is still
+   * being generated by `generatePathAsync()`, this method blocks until it is ready.
    *
    * @param ipathId A unique identifier for the path, previously passed to `generatePath()`.
    */
@@ -106,7 +222,8 @@ class AsyncMotionProfileController : public AsyncPositionController<std::string,
 
   /**
    * Executes a path with the given ID. If there is no path matching the ID, the method will
-   * return. Any targets set while a path is being followed will be ignored.
+   * return. Any targets set while a path is being followed will be ignored. If the path is still
+   * being generated by `generatePathAsync()`, this method blocks until it is ready.
    *
    * @param ipathId A unique identifier for the path, previously passed to `generatePath()`.
    * @param ibackwards Whether to follow the profile backwards.
@@ -140,6 +257,15 @@ class AsyncMotionProfileController : public AsyncPositionController<std::string,
    */
   void waitUntilSettled() override;
 
+  /**
+   * Blocks the current task until the controller has settled or the timeout passes. The path keeps
+   * being followed if the timeout passes.
+   *
+   * @param itimeout The longest time to wait.
+   * @return Whether the controller settled.
+   */
+  bool waitUntilSettled(QTime itimeout);
+
   /**
    * Generates a new path from the position (typically the current position) to the target and
    * blocks until the controller has settled. Does not save the path which was generated.
@@ -233,10 +359,27 @@ class AsyncMotionProfileController : public AsyncPositionController<std::string,
   void startThread();
 
   /**
-   * @return The underlying thread handle.
+   * Follows paths on a scheduler's task instead of starting a task for them. Use this instead of
+   * startThread().
+   *
+   * @param ischeduler The scheduler to run on.
+   * @param iorder Where the controller runs in each of the scheduler's ticks.
+   */
+  void startThread(const std::shared_ptr<ControlScheduler> &ischeduler,
+                   int iorder = ControlScheduler::chassisOrder);
+
+  /**
+   * @return The underlying thread handle, or `nullptr` if the controller runs on a scheduler.
    */
   CrossplatformThread *getThread() const;
 
+  /**
+   * Returns how long each step of following a path takes and how regularly the steps run.
+   *
+   * @return The measurements of the task's loop.
+   */
+  const LoopStats &getLoopStats() const;
+
   /**
    * Saves a generated path to a file. Paths are stored as `<ipathId>.csv`. An SD card
    * must be inserted into the brain and the directory must exist. `idirectory` can be prefixed with
@@ -248,14 +391,80 @@ class AsyncMotionProfileController : public AsyncPositionController<std::string,
   void storePath(const std::string &idirectory, const std::string &ipathId);
 
   /**
-   * Loads a path from a directory on the SD card containing a path CSV file. `/usd/` is
-   * automatically prepended to `idirectory` if it is not specified.
+   * Saves a generated path to a file in the compact binary format. Paths are stored as
+   * `<ipathId>.bin`. Binary paths load much faster than CSV paths because they don't need to be
+   * parsed. An SD card must be inserted into the brain and the directory must exist. `idirectory`
+   * can be prefixed with `/usd/`, but it this is not required.
+   *
+   * A CSV path can be converted to a binary path by loading it with `loadPath()` and then storing
+   * it with this method, or offline using `BinaryPath::convertSquigglesCSV()` and
+   * `BinaryPath::convertPathfinderCSV()`.
+   *
+   * @param idirectory The directory to store the path file in
+   * @param ipathId The path ID of the generated path
+   */
+  void storeBinaryPath(const std::string &idirectory, const std::string &ipathId);
+
+  /**
+   * Loads a path from a directory on the SD card containing a path file. `/usd/` is
+   * automatically prepended to `idirectory` if it is not specified. A binary path
+   * (`<ipathId>.bin`) is preferred, followed by a Squiggles CSV path (`<ipathId>.csv`), followed by
+   * a pair of Pathfinder CSV paths (`<ipathId>.left.csv` and `<ipathId>.right.csv`).
    *
    * @param idirectory The directory that the path files are stored in
    * @param ipathId The path ID that the paths are stored under (and will be loaded into)
    */
   void loadPath(const std::string &idirectory, const std::string &ipathId);
 
+  /**
+   * Returns the maximum lag observed while following the most recent path. The lag of a loop
+   * iteration is how much longer than one loop period it ran after the previous iteration. The path
+   * is sampled by the time since it started, so a late iteration skips ahead instead of delaying
+   * the rest of the path.
+   *
+   * @return The maximum lag.
+   */
+  QTime getMaxLag() const;
+
+  /**
+   * Sets the cache `generatePath()`, `generatePathAsync()`, and `moveTo()` use to skip generating
+   * paths which have been generated before with the same waypoints and limits. The cache can be
+   * shared between controllers. This should be set before any paths are generated. Pass `nullptr`
+   * to disable caching, which is the default.
+   *
+   * @param icache The trajectory cache.
+   */
+  void setTrajectoryCache(const std::shared_ptr<TrajectoryCache> &icache);
+
+  /**
+   * @return The trajectory cache, or `nullptr` if caching is disabled.
+   */
+  std::shared_ptr<TrajectoryCache> getTrajectoryCache() const;
+
+  /**
+   * Sets the memory budget paths are stored under. The budget can be shared between controllers so
+   * all of their paths count against the same limit. A path which doesn't fit in the budget is
+   * compacted. If it still doesn't fit, it is not stored, any old path with the same ID is kept,
+   * and a warning is logged. This should be set before any paths are generated or loaded. Pass
+   * `nullptr` to remove the limit, which is the default.
+   *
+   * @param ibudget The path memory budget.
+   */
+  void setPathMemoryBudget(const std::shared_ptr<PathMemoryBudget> &ibudget);
+
+  /**
+   * @return The path memory budget, or `nullptr` if there is no limit.
+   */
+  std::shared_ptr<PathMemoryBudget> getPathMemoryBudget() const;
+
+  /**
+   * Returns how much memory a path uses.
+   *
+   * @param ipathId The path ID.
+   * @return The approximate number of bytes the path uses, or `0` if there is no path with that ID.
+   */
+  std::size_t getPathMemoryUsage(const std::string &ipathId) const;
+
   /**
    * Attempts to remove a path without stopping execution. If that fails, disables the controller
    * and removes the path.
@@ -266,15 +475,14 @@ class AsyncMotionProfileController : public AsyncPositionController<std::string,
 
   protected:
   std::shared_ptr<Logger> logger;
-  std::map<std::string, std::vector<squiggles::ProfilePoint>> paths{};
+  static constexpr Logger::Component okapiLogComponent = Logger::Component::motionProfile;
+  PathStore<ExecutionPlan> paths{};
   PathfinderLimits limits;
   std::shared_ptr<ChassisModel> model;
   ChassisScales scales;
   AbstractMotor::GearsetRatioPair pair;
   TimeUtil timeUtil;
-
-  // This must be locked when accessing the current path
-  CrossplatformMutex currentPathMutex;
+  LoopStats loopStats;
 
   std::string currentPath{""};
   std::atomic_bool isRunning{false};
@@ -282,16 +490,119 @@ class AsyncMotionProfileController : public AsyncPositionController<std::string,
   std::atomic_bool mirrored{false};
   std::atomic_bool disabled{false};
   std::atomic_bool dtorCalled{false};
+  std::atomic<double> maxLag{0}; // In seconds
   CrossplatformThread *task{nullptr};
+  CrossplatformSignal settledSignal;
+  std::shared_ptr<ControlScheduler> scheduler;
+  ControlScheduler::SlotId schedulerSlot{0};
+  std::unique_ptr<PathGenerationQueue> generator;
+  std::shared_ptr<TrajectoryCache> trajectoryCache{nullptr};
+  std::shared_ptr<PathMemoryBudget> pathMemoryBudget{nullptr};
+
+  /**
+   * How far a path has been followed.
+   */
+  struct PathProgress {
+    const ExecutionPlan *path{nullptr};
+    std::unique_ptr<AbstractTimer> timer{nullptr};
+    TrajectorySampler sampler{};
+    QTime start{0_ms};
+    QTime lastIteration{0_ms};
+    double reversed{1};
+    bool mirrored{false};
+  };
+
+  // The path being followed when the controller runs on a scheduler
+  std::shared_ptr<const ExecutionPlan> scheduledPath{nullptr};
+  std::optional<PathProgress> scheduledProgress;
 
   static void trampoline(void *context);
   void loop();
 
   /**
-   * Follow the supplied path. Must follow the disabled lifecycle.
+   * Follows paths one tick at a time. This is what a scheduler runs.
+   */
+  void tick();
+
+  /**
+   * Looks up the target path before following it.
+   *
+   * @return The path, or `nullptr` (and logs a warning) if there is no path with the target's name.
+   */
+  std::shared_ptr<const ExecutionPlan> findTargetPath();
+
+  /**
+   * Starts following a path.
+   *
+   * @param path The path, which must outlive the returned progress.
+   * @return The progress at the start of the path.
+   */
+  PathProgress beginPath(const ExecutionPlan &path);
+
+  /**
+   * Sends the commands for the current point in a path.
+   *
+   * @param iprogress The progress through the path.
+   * @return Whether the path continues. If not, no commands were sent.
+   */
+  bool followPath(PathProgress &iprogress);
+
+  /**
+   * Warns if points of a path were skipped because it was followed late.
+   *
+   * @param iprogress The progress through the path once it is done.
+   */
+  void endPath(const PathProgress &iprogress);
+
+  /**
+   * Generates a path and saves it. This is shared by `generatePath()`, `generatePathAsync()`, and
+   * `generatePaths()`.
+   *
+   * @return Whether the path was saved.
+   */
+  bool internalGeneratePath(const std::vector<PathfinderPoint> &iwaypoints,
+                            const std::string &ipathId,
+                            const PathfinderLimits &ilimits);
+
+  /**
+   * Generates a trajectory, or gets it from the trajectory cache if there is one.
+   *
+   * @param iwaypoints The waypoints to hit on the path. Must not be empty.
+   * @param ilimits The limits to use.
+   * @param istartVel The velocity to start the trajectory at in m/s.
+   * @param iendVel The velocity to end the trajectory at in m/s.
+   * @return The trajectory.
+   */
+  std::vector<squiggles::ProfilePoint>
+  generateTrajectory(const std::vector<PathfinderPoint> &iwaypoints,
+                     const PathfinderLimits &ilimits,
+                     double istartVel,
+                     double iendVel);
+
+  /**
+   * Follow the supplied path. Must follow the disabled lifecycle. The path is kept alive by the
+   * caller, so it is safe to use without locking even if it is removed while being followed.
+   */
+  virtual void executeSinglePath(const ExecutionPlan &path, std::unique_ptr<AbstractRate> rate);
+
+  /**
+   * Compiles a path into the motor commands `executeSinglePath()` sends.
+   *
+   * @param ipath The path to compile.
+   * @return The execution plan.
+   */
+  ExecutionPlan compilePath(const std::vector<squiggles::ProfilePoint> &ipath) const;
+
+  /**
+   * Saves a path, replacing any path with the same ID. If there is a path memory budget the path
+   * is counted against it.
+   *
+   * @param ipathId The path ID.
+   * @param iplan The path.
+   * @return Whether the path was saved. It is not saved if it does not fit in the budget, in which
+   * case any old path with the same ID is kept.
    */
-  virtual void executeSinglePath(const std::vector<squiggles::ProfilePoint> &path,
-                                 std::unique_ptr<AbstractRate> rate);
+  bool insertPath(const std::string &ipathId, ExecutionPlan iplan);
 
   /**
    * Converts linear chassis speed to rotational motor speed.
@@ -316,8 +627,10 @@ class AsyncMotionProfileController : public AsyncPositionController<std::string,
   static std::string makeFilePath(const std::string &directory, const std::string &filename);
 
   void internalStorePath(std::ostream &file, const std::string &ipathId);
-  void internalLoadPath(std::istream &file, const std::string &ipathId);
-  void internalLoadPathfinderPath(std::istream &leftFile,
+  void internalStoreBinaryPath(std::ostream &file, const std::string &ipathId);
+  bool internalLoadBinaryPath(std::istream &file, const std::string &ipathId);
+  bool internalLoadPath(std::istream &file, const std::string &ipathId);
+  bool internalLoadPathfinderPath(std::istream &leftFile,
                                   std::istream &rightFile,
                                   const std::string &ipathId);
 
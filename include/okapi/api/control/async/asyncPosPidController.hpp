@@ -93,6 +93,20 @@ class AsyncPosPIDController : public AsyncWrapper<double, double>,
    */
   IterativePosPIDController::Gains getGains() const;
 
+  /**
+   * Attaches a recorder which records every step of the PID controller this controller runs. The
+   * steps are recorded by this controller's task, so only detach or replace a recorder while this
+   * controller runs if the old recorder is still owned elsewhere.
+   *
+   * @param itelemetry The recorder, or `nullptr` to stop recording.
+   */
+  void setTelemetry(std::shared_ptr<ControllerTelemetry> itelemetry);
+
+  /**
+   * @return The attached recorder, or `nullptr` if there is none.
+   */
+  std::shared_ptr<ControllerTelemetry> getTelemetry() const;
+
   protected:
   std::shared_ptr<OffsetableControllerInput> offsettableInput;
   std::shared_ptr<IterativePosPIDController> internalController;
@@ -8,14 +8,19 @@
 #include "okapi/api/control/async/asyncController.hpp"
 #include "okapi/api/control/controllerInput.hpp"
 #include "okapi/api/control/iterative/iterativeController.hpp"
+#include "okapi/api/control/util/controlScheduler.hpp"
+#include "okapi/api/control/util/loopStats.hpp"
 #include "okapi/api/control/util/settledUtil.hpp"
 #include "okapi/api/coreProsAPI.hpp"
 #include "okapi/api/util/abstractRate.hpp"
 #include "okapi/api/util/logging.hpp"
 #include "okapi/api/util/mathUtil.hpp"
 #include "okapi/api/util/supplier.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <algorithm>
 #include <atomic>
 #include <memory>
+#include <type_traits>
 
 namespace okapi {
 template <typename Input, typename Output>
@@ -28,17 +33,21 @@ class AsyncWrapper : virtual public AsyncController<Input, Output> {
    * @param iinput controller input, passed to the `IterativeController`
    * @param ioutput controller output, written to from the `IterativeController`
    * @param icontroller the controller to use
-   * @param irateSupplier used for rates used in the main loop and in `waitUntilSettled`
+   * @param irateSupplier used for rates used in the main loop
    * @param iratio Any external gear ratio.
    * @param ilogger The logger this instance will log to.
+   * @param iloopTimer The timer used to measure the task's loop. See getLoopStats(). If it is
+   * `nullptr`, the loop is not measured; use the constructor which takes a TimeUtil to measure it.
    */
   AsyncWrapper(const std::shared_ptr<ControllerInput<Input>> &iinput,
                const std::shared_ptr<ControllerOutput<Output>> &ioutput,
                const std::shared_ptr<IterativeController<Input, Output>> &icontroller,
                const Supplier<std::unique_ptr<AbstractRate>> &irateSupplier,
                const double iratio = 1,
-               std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger())
+               std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger(),
+               std::unique_ptr<AbstractTimer> iloopTimer = nullptr)
     : logger(std::move(ilogger)),
+      loopStats(std::move(iloopTimer), LoopStats::defaultSummaryPeriod, logger),
       rateSupplier(irateSupplier),
       input(iinput),
       output(ioutput),
@@ -46,12 +55,42 @@ class AsyncWrapper : virtual public AsyncController<Input, Output> {
       ratio(iratio) {
   }
 
+  /**
+   * A wrapper class that transforms an `IterativeController` into an `AsyncController` by running
+   * it in another task. The input controller will act like an `AsyncController`. The task's loop
+   * is measured with a timer from the TimeUtil.
+   *
+   * @param iinput controller input, passed to the `IterativeController`
+   * @param ioutput controller output, written to from the `IterativeController`
+   * @param icontroller the controller to use
+   * @param itimeUtil The TimeUtil whose rates the main loop uses and whose timer measures it.
+   * @param iratio Any external gear ratio.
+   * @param ilogger The logger this instance will log to.
+   */
+  AsyncWrapper(const std::shared_ptr<ControllerInput<Input>> &iinput,
+               const std::shared_ptr<ControllerOutput<Output>> &ioutput,
+               const std::shared_ptr<IterativeController<Input, Output>> &icontroller,
+               const TimeUtil &itimeUtil,
+               const double iratio = 1,
+               std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger())
+    : AsyncWrapper(iinput,
+                   ioutput,
+                   icontroller,
+                   itimeUtil.getRateSupplier(),
+                   iratio,
+                   std::move(ilogger),
+                   itimeUtil.getTimer()) {
+  }
+
   AsyncWrapper(AsyncWrapper<Input, Output> &&other) = delete;
 
   AsyncWrapper<Input, Output> &operator=(AsyncWrapper<Input, Output> &&other) = delete;
 
   ~AsyncWrapper() override {
     dtorCalled.store(true, std::memory_order_release);
+    if (scheduler) {
+      scheduler->remove(schedulerSlot);
+    }
     delete task;
   }
 
@@ -59,10 +98,11 @@ class AsyncWrapper : virtual public AsyncController<Input, Output> {
    * Sets the target for the controller.
    */
   void setTarget(const Input itarget) override {
-    LOG_INFO("AsyncWrapper: Set target to " + std::to_string(itarget));
+    LOG_INFO_EVENT(LogEvent::asyncWrapperSetTarget, itarget);
     hasFirstTarget = true;
     controller->setTarget(itarget * ratio);
     lastTarget = itarget;
+    wasSettled.store(false, std::memory_order_release);
   }
 
   /**
@@ -173,6 +213,8 @@ class AsyncWrapper : virtual public AsyncController<Input, Output> {
     LOG_INFO_S("AsyncWrapper: Reset");
     controller->reset();
     hasFirstTarget = false;
+    wasSettled.store(false, std::memory_order_release);
+    settledSignal.notifyAll();
   }
 
   /**
@@ -183,6 +225,8 @@ class AsyncWrapper : virtual public AsyncController<Input, Output> {
     LOG_INFO("AsyncWrapper: flipDisable " + std::to_string(!controller->isDisabled()));
     controller->flipDisable();
     resumeMovement();
+    wasSettled.store(false, std::memory_order_release);
+    settledSignal.notifyAll();
   }
 
   /**
@@ -195,6 +239,8 @@ class AsyncWrapper : virtual public AsyncController<Input, Output> {
     LOG_INFO("AsyncWrapper: flipDisable " + std::to_string(iisDisabled));
     controller->flipDisable(iisDisabled);
     resumeMovement();
+    wasSettled.store(false, std::memory_order_release);
+    settledSignal.notifyAll();
   }
 
   /**
@@ -208,19 +254,30 @@ class AsyncWrapper : virtual public AsyncController<Input, Output> {
 
   /**
    * Blocks the current task until the controller has settled. Determining what settling means is
-   * implementation-dependent.
+   * implementation-dependent. The task sleeps until the controller's task signals that it settled.
    */
   void waitUntilSettled() override {
     LOG_INFO_S("AsyncWrapper: Waiting to settle");
-
-    auto rate = rateSupplier.get();
-    while (!isSettled()) {
-      rate->delayUntil(motorUpdateRate);
-    }
-
+    settledSignal.waitUntil([this]() { return isSettled(); });
     LOG_INFO_S("AsyncWrapper: Done waiting to settle");
   }
 
+  /**
+   * Blocks the current task until the controller has settled or the timeout passes. The controller
+   * keeps running if the timeout passes.
+   *
+   * @param itimeout The longest time to wait.
+   * @return Whether the controller settled.
+   */
+  bool waitUntilSettled(const QTime itimeout) {
+    LOG_INFO_S("AsyncWrapper: Waiting to settle");
+    const bool settled = settledSignal.waitUntil(
+      [this]() { return isSettled(); },
+      static_cast<std::uint32_t>(std::max(itimeout.convert(millisecond), 0.0)));
+    LOG_INFO("AsyncWrapper: Done waiting to settle, settled: " + std::to_string(settled));
+    return settled;
+  }
+
   /**
    * Starts the internal thread. This should not be called by normal users. This method is called
    * by the AsyncControllerFactory when making a new instance of this class.
@@ -231,17 +288,48 @@ class AsyncWrapper : virtual public AsyncController<Input, Output> {
     }
   }
 
+  /**
+   * Runs the controller on a scheduler's task instead of starting its own. Use this instead of
+   * startThread(). The controller runs about once per sample time, as it is when this is called.
+   * A `double` input is read through the scheduler's sensor cache.
+   *
+   * @param ischeduler The scheduler to run on.
+   * @param iorder Where the controller runs in each of the scheduler's ticks.
+   */
+  void startThread(const std::shared_ptr<ControlScheduler> &ischeduler,
+                   const int iorder = ControlScheduler::mechanismOrder) {
+    if (!task && !scheduler) {
+      scheduler = ischeduler;
+      if constexpr (std::is_same_v<Input, double>) {
+        input = scheduler->getSensorCache()->cache(input);
+      }
+      schedulerSlot = scheduler->add(
+        [this]() { tick(); }, iorder, scheduler->getDivider(controller->getSampleTime()));
+    }
+  }
+
   /**
    * Returns the underlying thread handle.
    *
-   * @return The underlying thread handle.
+   * @return The underlying thread handle, or `nullptr` if the controller runs on a scheduler.
    */
   CrossplatformThread *getThread() const {
     return task;
   }
 
+  /**
+   * Returns how long each step of the controller's task takes and how regularly it runs. Nothing
+   * is measured unless this wrapper was given a loop timer.
+   *
+   * @return The measurements of the task's loop.
+   */
+  const LoopStats &getLoopStats() const {
+    return loopStats;
+  }
+
   protected:
   std::shared_ptr<Logger> logger;
+  LoopStats loopStats;
   Supplier<std::unique_ptr<AbstractRate>> rateSupplier;
   std::shared_ptr<ControllerInput<Input>> input;
   std::shared_ptr<ControllerOutput<Output>> output;
@@ -251,6 +339,10 @@ class AsyncWrapper : virtual public AsyncController<Input, Output> {
   double ratio;
   std::atomic_bool dtorCalled{false};
   CrossplatformThread *task{nullptr};
+  CrossplatformSignal settledSignal;
+  std::atomic_bool wasSettled{false}; // Whether tick() saw the controller settled since it moved
+  std::shared_ptr<ControlScheduler> scheduler;
+  ControlScheduler::SlotId schedulerSlot{0};
 
   static void trampoline(void *context) {
     if (context) {
@@ -261,14 +353,29 @@ class AsyncWrapper : virtual public AsyncController<Input, Output> {
   void loop() {
     auto rate = rateSupplier.get();
     while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
-      if (!isDisabled()) {
-        output->controllerSet(controller->step(input->controllerGet()));
-      }
-
+      tick();
       rate->delayUntil(controller->getSampleTime());
     }
   }
 
+  /**
+   * Steps the controller once. This is the body of the task's loop and what a scheduler runs.
+   */
+  void tick() {
+    loopStats.tickStarted(controller->getSampleTime());
+    if (!isDisabled()) {
+      output->controllerSet(controller->step(input->controllerGet()));
+    }
+
+    // Wake the waiters when the controller settles, not on every tick after
+    if (!isSettled()) {
+      wasSettled.store(false, std::memory_order_release);
+    } else if (!wasSettled.exchange(true, std::memory_order_acq_rel)) {
+      settledSignal.notifyAll();
+    }
+    loopStats.tickFinished();
+  }
+
   /**
    * Resumes moving after the controller is reset. Should not cause movement if the controller is
    * turned off, reset, and turned back on.
@@ -8,11 +8,13 @@
 #pragma once
 
 #include "okapi/api/control/iterative/iterativePositionController.hpp"
+#include "okapi/api/control/util/controllerTelemetry.hpp"
 #include "okapi/api/control/util/settledUtil.hpp"
 #include "okapi/api/filter/filter.hpp"
 #include "okapi/api/filter/passthroughFilter.hpp"
 #include "okapi/api/util/logging.hpp"
 #include "okapi/api/util/timeUtil.hpp"
+#include <atomic>
 #include <limits>
 #include <memory>
 
@@ -237,8 +239,25 @@ class IterativePosPIDController : public IterativePositionController<double, dou
    */
   Gains getGains() const;
 
+  /**
+   * Attaches a recorder which records every step of this controller. This may be called while
+   * another task steps the controller; that step records to either the old or the new recorder.
+   * Because a step may still be recording to the old recorder when this returns, only detach or
+   * replace a recorder on a running controller if the old recorder is still owned elsewhere.
+   * This must not be called from more than one task at a time.
+   *
+   * @param itelemetry The recorder, or `nullptr` to stop recording.
+   */
+  void setTelemetry(std::shared_ptr<ControllerTelemetry> itelemetry);
+
+  /**
+   * @return The attached recorder, or `nullptr` if there is none.
+   */
+  std::shared_ptr<ControllerTelemetry> getTelemetry() const;
+
   protected:
   std::shared_ptr<Logger> logger;
+  static constexpr Logger::Component okapiLogComponent = Logger::Component::pid;
   double kP, kI, kD, kBias;
   QTime sampleTime{10_ms};
   double target{0};
@@ -272,5 +291,9 @@ class IterativePosPIDController : public IterativePositionController<double, dou
 
   std::unique_ptr<AbstractTimer> loopDtTimer;
   std::unique_ptr<SettledUtil> settledUtil;
+  // Owns the attached recorder. Only setTelemetry() and getTelemetry() use it.
+  std::shared_ptr<ControllerTelemetry> telemetry;
+  // The recorder step() records to, which may run on another task. It never locks or allocates.
+  std::atomic<ControllerTelemetry *> activeTelemetry{nullptr};
 };
 } // namespace okapi
@@ -6,11 +6,13 @@
 #pragma once
 
 #include "okapi/api/control/iterative/iterativeVelocityController.hpp"
+#include "okapi/api/control/util/controllerTelemetry.hpp"
 #include "okapi/api/control/util/settledUtil.hpp"
 #include "okapi/api/filter/passthroughFilter.hpp"
 #include "okapi/api/filter/velMath.hpp"
 #include "okapi/api/util/logging.hpp"
 #include "okapi/api/util/timeUtil.hpp"
+#include <atomic>
 
 namespace okapi {
 class IterativeVelPIDController : public IterativeVelocityController<double, double> {
@@ -232,8 +234,25 @@ class IterativeVelPIDController : public IterativeVelocityController<double, dou
    */
   virtual QAngularSpeed getVel() const;
 
+  /**
+   * Attaches a recorder which records every step of this controller. This may be called while
+   * another task steps the controller; that step records to either the old or the new recorder.
+   * Because a step may still be recording to the old recorder when this returns, only detach or
+   * replace a recorder on a running controller if the old recorder is still owned elsewhere.
+   * This must not be called from more than one task at a time.
+   *
+   * @param itelemetry The recorder, or `nullptr` to stop recording.
+   */
+  void setTelemetry(std::shared_ptr<ControllerTelemetry> itelemetry);
+
+  /**
+   * @return The attached recorder, or `nullptr` if there is none.
+   */
+  std::shared_ptr<ControllerTelemetry> getTelemetry() const;
+
   protected:
   std::shared_ptr<Logger> logger;
+  static constexpr Logger::Component okapiLogComponent = Logger::Component::pid;
   double kP, kD, kF, kSF;
   QTime sampleTime{10_ms};
   double error{0};
@@ -251,5 +270,9 @@ class IterativeVelPIDController : public IterativeVelocityController<double, dou
   std::unique_ptr<Filter> derivativeFilter;
   std::unique_ptr<AbstractTimer> loopDtTimer;
   std::unique_ptr<SettledUtil> settledUtil;
+  // Owns the attached recorder. Only setTelemetry() and getTelemetry() use it.
+  std::shared_ptr<ControllerTelemetry> telemetry;
+  // The recorder step() records to, which may run on another task. It never locks or allocates.
+  std::atomic<ControllerTelemetry *> activeTelemetry{nullptr};
 };
 } // namespace okapi
@@ -0,0 +1,159 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/chassis/controller/chassisScales.hpp"
+#include "okapi/api/control/util/pathfinderUtil.hpp"
+#include "okapi/api/util/logging.hpp"
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <vector>
+
+#include "squiggles.hpp"
+
+namespace okapi {
+/**
+ * The header at the start of every binary path file. All fields of the header and of the records
+ * are stored little-endian, whatever the byte order of the device which wrote them.
+ */
+struct BinaryPathHeader {
+  std::uint32_t magic;      // Always BinaryPath::magic
+  std::uint16_t version;    // The format version the file was written with
+  std::uint16_t recordSize; // The size of one BinaryPathRecord in bytes
+  std::uint32_t count;      // The number of records following the header
+  std::uint32_t checksum;   // FNV-1a hash of the records
+  float dt;                 // The time between records in seconds
+  float maxVel;             // Maximum robot velocity in m/s the path was generated with
+  float maxAccel;           // Maximum robot acceleration in m/s/s the path was generated with
+  float maxJerk;            // Maximum robot jerk in m/s/s/s the path was generated with
+  float wheelDiameter;      // The wheel diameter in meters the path was generated for
+  float wheelTrack;         // The wheel track in meters the path was generated for
+};
+
+/**
+ * A single profile point in a binary path file.
+ */
+struct BinaryPathRecord {
+  float x;             // X position in meters (Squiggles frame)
+  float y;             // Y position in meters (Squiggles frame)
+  float yaw;           // Heading in radians (Squiggles frame)
+  float vel;           // Linear velocity in m/s
+  float accel;         // Linear acceleration in m/s/s
+  float jerk;          // Linear jerk in m/s/s/s
+  float curvature;     // Path curvature in 1/m
+  float time;          // Time since the start of the path in seconds
+  float leftVelocity;  // Left wheel velocity in m/s
+  float rightVelocity; // Right wheel velocity in m/s
+};
+
+static_assert(sizeof(BinaryPathHeader) == 40, "BinaryPathHeader must not contain padding");
+static_assert(sizeof(BinaryPathRecord) == 40, "BinaryPathRecord must not contain padding");
+
+class BinaryPath {
+  public:
+  /**
+   * Makes a header describing a path.
+   *
+   * @param icount The number of points in the path.
+   * @param idt The time between points in seconds.
+   * @param ilimits The limits the path was generated with.
+   * @param iscales The chassis dimensions the path was generated for.
+   * @return The header. The checksum is filled in by `write()`.
+   */
+  static BinaryPathHeader makeHeader(std::size_t icount,
+                                     double idt,
+                                     const PathfinderLimits &ilimits,
+                                     const ChassisScales &iscales);
+
+  /**
+   * Writes a path to a stream in the binary format. The stream should be opened in binary mode.
+   *
+   * @param ostream The stream to write to.
+   * @param iheader The header to write. The count and checksum are overwritten.
+   * @param ipath The path to write.
+   * @return Whether the path was written successfully.
+   */
+  static bool write(std::ostream &ostream,
+                    BinaryPathHeader iheader,
+                    const std::vector<squiggles::ProfilePoint> &ipath);
+
+  /**
+   * Reads a path from a stream in the binary format. The records are read with a single bulk read
+   * into a buffer which is allocated once the header has been validated. Returns `std::nullopt`
+   * (and logs a warning) if the header is not valid or the checksum does not match.
+   *
+   * @param istream The stream to read from.
+   * @param oheader The header that was read.
+   * @param logger The logger to log to.
+   * @return The records in the path.
+   */
+  static std::optional<std::vector<BinaryPathRecord>>
+  read(std::istream &istream,
+       BinaryPathHeader &oheader,
+       const std::shared_ptr<Logger> &logger = Logger::getDefaultLogger());
+
+  /**
+   * Converts records into the profile points the motion profile controllers follow.
+   *
+   * @param irecords The records.
+   * @return The profile points.
+   */
+  static std::vector<squiggles::ProfilePoint>
+  toProfilePoints(const std::vector<BinaryPathRecord> &irecords);
+
+  /**
+   * Converts a path stored in the Squiggles CSV format to the binary format.
+   *
+   * @param icsv The CSV file.
+   * @param ostream The stream to write the binary path to.
+   * @param iheader The header to write. The count and checksum are overwritten.
+   * @param logger The logger to log to.
+   * @return Whether the path was converted successfully.
+   */
+  static bool
+  convertSquigglesCSV(std::istream &icsv,
+                      std::ostream &ostream,
+                      const BinaryPathHeader &iheader,
+                      const std::shared_ptr<Logger> &logger = Logger::getDefaultLogger());
+
+  /**
+   * Converts a path stored in the Pathfinder CSV format to the binary format.
+   *
+   * @param ileftCSV The left wheel CSV file.
+   * @param irightCSV The right wheel CSV file.
+   * @param ostream The stream to write the binary path to.
+   * @param iheader The header to write. The count and checksum are overwritten.
+   * @param logger The logger to log to.
+   * @return Whether the path was converted successfully.
+   */
+  static bool
+  convertPathfinderCSV(std::istream &ileftCSV,
+                       std::istream &irightCSV,
+                       std::ostream &ostream,
+                       const BinaryPathHeader &iheader,
+                       const std::shared_ptr<Logger> &logger = Logger::getDefaultLogger());
+
+  /**
+   * Computes the 32-bit FNV-1a hash of some bytes. The checksum of a file is the hash of its
+   * records as they are stored, i.e. little-endian.
+   *
+   * @param idata The bytes.
+   * @param isize The number of bytes.
+   * @return The hash.
+   */
+  static std::uint32_t checksum(const void *idata, std::size_t isize);
+
+  static constexpr std::uint32_t magic = 0x48544150; // "PATH"
+  static constexpr std::uint16_t version = 1;
+
+  /**
+   * The largest number of records a file may contain. This is an hour of points at 10 ms, which is
+   * far longer than any real path, and guards against allocating a huge buffer for a corrupt file.
+   */
+  static constexpr std::uint32_t maxCount = 360000;
+};
+} // namespace okapi
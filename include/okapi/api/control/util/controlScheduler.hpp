@@ -0,0 +1,227 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/util/loopStats.hpp"
+#include "okapi/api/control/util/sensorCache.hpp"
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/device/motor/motorCommandBuffer.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace okapi {
+class ControlScheduler {
+  public:
+  using SlotId = std::uint32_t;
+
+  /**
+   * The stages of a tick, in the order they run. A tick reads the sensors, updates the estimators
+   * (e.g. odometry) from those readings, runs the controllers on the estimates, and then sends the
+   * motor commands, so a reading reaches the motors in the same tick it was taken.
+   */
+  enum class Stage { sense, estimate, control, actuate };
+
+  /**
+   * The order steps which read sensors run in. Orders below odometryOrder are in the sense stage.
+   */
+  static constexpr int senseOrder = -100;
+
+  /**
+   * The order odometry runs in, so the chassis and mechanisms see the newest pose. Orders from
+   * here up to chassisOrder are in the estimate stage.
+   */
+  static constexpr int odometryOrder = 0;
+
+  /**
+   * The order chassis controllers and motion profile controllers run in. Orders from here up to
+   * actuateOrder are in the control stage.
+   */
+  static constexpr int chassisOrder = 100;
+
+  /**
+   * The order the other controllers run in.
+   */
+  static constexpr int mechanismOrder = 200;
+
+  /**
+   * The order steps which send motor commands run in. Orders from here on are in the actuate
+   * stage.
+   */
+  static constexpr int actuateOrder = 300;
+
+  /**
+   * The delay from the start of a tick, when its sensors are read, to the end of its last control
+   * or actuate step, when its motor commands have been sent.
+   */
+  struct LatencySummary {
+    std::uint32_t ticks{0}; // The number of ticks which ran a control or actuate step
+    QTime mean{0_ms};       // The mean delay
+    QTime max{0_ms};        // The longest delay
+  };
+
+  /**
+   * Runs the steps of many controllers on one task at a fixed rate, instead of each controller
+   * running its own task. Every period, the task runs the registered steps one after the other,
+   * lowest order first, so e.g. the odometry is always updated before the chassis controller reads
+   * it. A step can run only once every few periods. Use more than one scheduler to run controllers
+   * on more than one task.
+   *
+   * Controllers are registered with their `startThread(scheduler)` overloads, which are used in
+   * place of `startThread()`, or with the builders' `withScheduler()`.
+   *
+   * @param itimeUtil The TimeUtil. Its rate paces the task and its timer measures the task.
+   * @param iperiod The time between ticks.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit ControlScheduler(const TimeUtil &itimeUtil,
+                            QTime iperiod = 10_ms,
+                            std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  ControlScheduler(ControlScheduler &&other) = delete;
+
+  ControlScheduler &operator=(ControlScheduler &&other) = delete;
+
+  ~ControlScheduler();
+
+  /**
+   * Registers a step. It runs from the next tick on until it is removed.
+   *
+   * @param istep The step. It must not add or remove steps.
+   * @param iorder Where the step runs in each tick. Steps with a lower order run first. Steps with
+   * the same order run in the order they were added.
+   * @param idivider Run the step once every this many ticks.
+   * @return An ID which removes the step.
+   */
+  SlotId add(std::function<void()> istep, int iorder, std::uint32_t idivider = 1);
+
+  /**
+   * Registers a step in a stage. It runs after the steps which were already added to the stage.
+   *
+   * @param istep The step. It must not add or remove steps.
+   * @param istage The stage the step runs in.
+   * @param idivider Run the step once every this many ticks.
+   * @return An ID which removes the step.
+   */
+  SlotId add(std::function<void()> istep, Stage istage, std::uint32_t idivider = 1);
+
+  /**
+   * Removes a step. If the step is running, this waits for it to finish, so the step will not run
+   * once this returns.
+   *
+   * @param islot The ID add() returned.
+   */
+  void remove(SlotId islot);
+
+  /**
+   * Runs one tick: refreshes the sensor cache, runs every step whose divider divides the tick
+   * count, in order, and then commits the motor command buffer. This is what the scheduler's task
+   * does every period.
+   */
+  void tick();
+
+  /**
+   * Starts the task which runs the ticks.
+   */
+  void startThread();
+
+  /**
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  /**
+   * @return The time between ticks.
+   */
+  QTime getPeriod() const;
+
+  /**
+   * @param iperiod How often a controller wants to run.
+   * @return The divider which runs a step closest to that often, at least once per tick.
+   */
+  std::uint32_t getDivider(QTime iperiod) const;
+
+  /**
+   * @return The number of registered steps.
+   */
+  std::size_t getStepCount() const;
+
+  /**
+   * Returns how long each tick takes and how regularly the scheduler's task runs.
+   *
+   * @return The measurements of the task's loop.
+   */
+  const LoopStats &getLoopStats() const;
+
+  /**
+   * Returns the sensor-to-command latency of the ticks so far. Because every stage runs in one
+   * tick, this is bounded by how long a tick takes, instead of by up to a period per step as when
+   * each controller runs its own task. It is measured with the micros() of the TimeUtil's timer.
+   *
+   * @return The latency.
+   */
+  LatencySummary getLatency() const;
+
+  /**
+   * Returns the cache which shares sensor readings between the steps of a tick. It starts a new
+   * frame at the start of every tick, so each sensor read through it is read at most once per
+   * tick. Controllers started on this scheduler read their sensors through it.
+   *
+   * @return The sensor cache.
+   */
+  const std::shared_ptr<SensorCache> &getSensorCache() const;
+
+  /**
+   * Returns the buffer which collects the motor commands of a tick. It is committed at the end of
+   * every tick, so each buffered motor gets at most one command per tick, and only when its command
+   * changed. The chassis controllers built with a scheduler send their commands through it.
+   *
+   * @return The motor command buffer.
+   */
+  const std::shared_ptr<MotorCommandBuffer> &getCommandBuffer() const;
+
+  /**
+   * @param iorder The order of a step.
+   * @return The stage a step with that order runs in.
+   */
+  static Stage getStage(int iorder);
+
+  protected:
+  struct Slot {
+    SlotId id;
+    int order;
+    std::uint32_t divider;
+    std::function<void()> step;
+  };
+
+  std::shared_ptr<Logger> logger;
+  TimeUtil timeUtil;
+  QTime period;
+  LoopStats loopStats;
+  std::unique_ptr<AbstractTimer> latencyTimer;
+  std::shared_ptr<SensorCache> sensorCache;
+  std::shared_ptr<MotorCommandBuffer> commandBuffer;
+  mutable CrossplatformMutex slotsMutex;
+  std::vector<Slot> slots;
+  SlotId nextId{0};
+  std::uint32_t ticks{0};
+  CrossplatformThread *task{nullptr};
+  std::atomic_bool dtorCalled{false};
+
+  // Read by any task. Times are in microseconds.
+  std::atomic<std::uint32_t> latencyTicks{0};
+  std::atomic<std::uint64_t> totalLatency{0};
+  std::atomic<std::uint32_t> maxLatency{0};
+
+  static void trampoline(void *context);
+  void loop();
+};
+} // namespace okapi
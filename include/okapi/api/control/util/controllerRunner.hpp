@@ -28,7 +28,8 @@ template <typename Input, typename Output> class ControllerRunner {
   }
 
   /**
-   * Runs the controller until it has settled.
+   * Runs the controller until it has settled. This blocks in the controller's waitUntilSettled(),
+   * so controllers which signal when they settle wake this task right away.
    *
    * @param itarget the new target
    * @param icontroller the controller to run
@@ -38,10 +39,7 @@ template <typename Input, typename Output> class ControllerRunner {
     LOG_INFO("ControllerRunner: runUntilSettled(AsyncController): Set target to " +
              std::to_string(itarget));
     icontroller.setTarget(itarget);
-
-    while (!icontroller.isSettled()) {
-      rate->delayUntil(10_ms);
-    }
+    icontroller.waitUntilSettled();
 
     LOG_INFO("ControllerRunner: runUntilSettled(AsyncController): Done waiting to settle");
     return icontroller.getError();
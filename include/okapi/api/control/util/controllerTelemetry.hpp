@@ -0,0 +1,164 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/util/abstractTimer.hpp"
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace okapi {
+/**
+ * One step of a controller. All fields are stored little-endian in binary telemetry files.
+ */
+struct TelemetrySample {
+  std::uint32_t step; // The number of steps the recorder had seen before this one
+  float time;         // Seconds since the recorder was made or cleared
+  float target;       // The controller's target
+  float processValue; // The reading the controller was stepped with
+  float error;        // The controller's error
+  float integral;     // The controller's integral term (the output sum for velocity controllers)
+  float derivative;   // The filtered derivative of the process value
+  float output;       // The controller's output
+};
+
+/**
+ * The header at the start of every binary telemetry file. All fields are stored little-endian.
+ */
+struct TelemetryFileHeader {
+  std::uint32_t magic;      // Always ControllerTelemetry::magic
+  std::uint16_t version;    // The format version the file was written with
+  std::uint16_t recordSize; // The size of one TelemetrySample in bytes
+  std::uint32_t count;      // The number of samples following the header
+  std::uint32_t decimation; // How many steps there are per sample
+};
+
+static_assert(sizeof(TelemetrySample) == 32, "TelemetrySample must not contain padding");
+static_assert(sizeof(TelemetryFileHeader) == 16, "TelemetryFileHeader must not contain padding");
+
+class ControllerTelemetry {
+  public:
+  /**
+   * Records what a controller does on each step into a ring buffer which is allocated once, here.
+   * Recording a step does not allocate or lock, so a recorder can stay attached to a controller
+   * during a real autonomous routine. Once the buffer is full, each new sample replaces the oldest
+   * one.
+   *
+   * @param itimer The timer used to timestamp the samples. If it is `nullptr`, every sample has a
+   * time of zero.
+   * @param icapacity The number of samples to keep.
+   * @param idecimation Record one out of every this many steps.
+   */
+  ControllerTelemetry(std::unique_ptr<AbstractTimer> itimer,
+                      std::size_t icapacity,
+                      std::size_t idecimation = 1);
+
+  /**
+   * Records one step of a controller. This is called by the controller the recorder is attached
+   * to. It must only be called from one task at a time.
+   *
+   * @param itarget The controller's target.
+   * @param iprocessValue The reading the controller was stepped with.
+   * @param ierror The controller's error.
+   * @param iintegral The controller's integral term.
+   * @param iderivative The filtered derivative of the process value.
+   * @param ioutput The controller's output.
+   */
+  void record(double itarget,
+              double iprocessValue,
+              double ierror,
+              double iintegral,
+              double iderivative,
+              double ioutput) noexcept;
+
+  /**
+   * Copies the samples out of the ring buffer, oldest first. This may be called while the
+   * controller is running; samples which are overwritten during the copy are left out.
+   *
+   * @return The samples.
+   */
+  std::vector<TelemetrySample> getSamples() const;
+
+  /**
+   * Forgets every sample and restarts the time and step count from zero. This must not be called
+   * while the controller is being stepped.
+   */
+  void clear();
+
+  /**
+   * @return The number of samples which have been recorded, including the ones which have since
+   * been overwritten.
+   */
+  std::size_t getRecordedCount() const;
+
+  /**
+   * @return The number of samples which were overwritten because the buffer was full.
+   */
+  std::size_t getOverwrittenCount() const;
+
+  /**
+   * @return The number of samples the buffer holds.
+   */
+  std::size_t getCapacity() const;
+
+  /**
+   * @return How many steps there are per sample.
+   */
+  std::size_t getDecimation() const;
+
+  /**
+   * Writes the samples to a stream as CSV with a header row.
+   *
+   * @param ostream The stream to write to.
+   * @return Whether the samples were written successfully.
+   */
+  bool writeCSV(std::ostream &ostream) const;
+
+  /**
+   * Writes the samples to a stream in the binary format. The stream should be opened in binary
+   * mode.
+   *
+   * @param ostream The stream to write to.
+   * @return Whether the samples were written successfully.
+   */
+  bool writeBinary(std::ostream &ostream) const;
+
+  /**
+   * Reads samples written by writeBinary().
+   *
+   * @param istream The stream to read from.
+   * @return The samples, or `std::nullopt` if the header is not valid or the file is truncated.
+   */
+  static std::optional<std::vector<TelemetrySample>> readBinary(std::istream &istream);
+
+  static constexpr std::uint32_t magic = 0x594d4c54; // "TLMY"
+  static constexpr std::uint16_t version = 1;
+
+  protected:
+  std::unique_ptr<AbstractTimer> timer;
+  std::size_t capacity;
+  std::size_t decimation;
+  std::unique_ptr<TelemetrySample[]> samples;
+
+  /**
+   * Converts a file header between this device's byte order and little-endian.
+   *
+   * @param iheader The header to convert in place.
+   */
+  static void convertHeaderByteOrder(TelemetryFileHeader &iheader);
+
+  // Only used by the recording task
+  std::uint32_t steps{0};
+
+  // The number of samples which have been started and which have been finished. They only differ
+  // while a sample is being written.
+  std::atomic<std::uint32_t> started{0};
+  std::atomic<std::uint32_t> written{0};
+};
+} // namespace okapi
@@ -0,0 +1,168 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/util/pathfinderUtil.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "squiggles.hpp"
+
+namespace okapi {
+class ExecutionPlan {
+  public:
+  /**
+   * A path compiled for execution by the AsyncMotionProfileController. The motor commands for each
+   * wheel are computed once, when the path is generated or loaded, and stored in their own array
+   * so following the path only needs to index into them. The rest of the profile is kept (as
+   * floats, one array per field) so the path can still be stored to a file.
+   *
+   * Following a path backwards negates the commands and following a path mirrored swaps the
+   * left and right arrays, so neither variant needs to be stored separately.
+   *
+   * Every point has a time since the start of the path, which is used to sample the path by time.
+   * Paths loaded from Pathfinder files store the duration of each point instead, so if the times
+   * in a path are not increasing they are treated as durations and added up.
+   *
+   * A plan can be compacted to roughly halve its size again. Compacting quantizes every field but
+   * the times to 16 bits over the range of its values, so the error is at most that range / 65534.
+   * Zero is kept exact, so a stopped wheel stays stopped, and the times are kept exact, so a long
+   * path still ends on time.
+   */
+  ExecutionPlan() = default;
+
+  /**
+   * Compiles a path into an execution plan.
+   *
+   * @param ipath The path to compile.
+   * @param icommandPerMps The motor command (in the range `[-1, 1]`) which makes a wheel move at
+   * 1 m/s.
+   * @return The execution plan.
+   */
+  static ExecutionPlan compile(const std::vector<squiggles::ProfilePoint> &ipath,
+                               double icommandPerMps);
+
+  /**
+   * Converts the plan back into the profile points it was compiled from. The result has the
+   * precision of a float.
+   *
+   * @return The profile points.
+   */
+  std::vector<squiggles::ProfilePoint> toProfilePoints() const;
+
+  /**
+   * @return The number of points in the plan.
+   */
+  std::size_t size() const;
+
+  /**
+   * @return Whether the plan has no points.
+   */
+  bool empty() const;
+
+  /**
+   * Quantizes every field of the plan but the times to 16 bits. The plan uses about half as much
+   * memory afterwards and loses some precision (see the class documentation).
+   */
+  void compact();
+
+  /**
+   * @return Whether the plan has been compacted.
+   */
+  bool isCompact() const;
+
+  /**
+   * @param i The point index.
+   * @return The motor command for the left wheels at a point.
+   */
+  float getLeftCommand(std::size_t i) const;
+
+  /**
+   * @param i The point index.
+   * @return The motor command for the right wheels at a point.
+   */
+  float getRightCommand(std::size_t i) const;
+
+  /**
+   * @param i The point index.
+   * @return The time of a point since the start of the path in seconds.
+   */
+  float getTime(std::size_t i) const;
+
+  /**
+   * @param i The point index.
+   * @return The pose at a point.
+   */
+  squiggles::Pose getPose(std::size_t i) const;
+
+  /**
+   * @return The motor command which makes a wheel move at 1 m/s.
+   */
+  double getCommandPerMps() const;
+
+  /**
+   * Records the limits the path was generated with, so they can be stored with it.
+   *
+   * @param ilimits The limits.
+   */
+  void setLimits(const PathfinderLimits &ilimits);
+
+  /**
+   * @return The limits the path was generated with, or empty if they are not known (e.g. because
+   * the path was loaded from a CSV file).
+   */
+  const std::optional<PathfinderLimits> &getLimits() const;
+
+  /**
+   * @return The approximate number of bytes the plan uses in memory.
+   */
+  std::size_t getMemoryUsage() const;
+
+  protected:
+  /**
+   * One field of the plan, with one value per point. The values are stored as floats until the
+   * channel is quantized, after which each value is a number of steps from an offset. The offset
+   * is the smallest value, or, if the values span zero, a whole number of steps below zero, so
+   * zero is stored exactly.
+   */
+  class Channel {
+    public:
+    float operator[](std::size_t i) const;
+    std::size_t size() const;
+    bool empty() const;
+    void reserve(std::size_t isize);
+    void push_back(float ivalue);
+    void clear();
+    void quantize();
+    std::size_t getMemoryUsage() const;
+
+    protected:
+    std::vector<float> values{};
+    std::vector<std::uint16_t> quantized{};
+    float offset{0};
+    float step{0};
+  };
+
+  double commandPerMps{0};
+  std::optional<PathfinderLimits> limits{};
+  bool compacted{false};
+  Channel leftCommands{};
+  Channel rightCommands{}; // Empty if every right command is equal to the left command
+  Channel x{};
+  Channel y{};
+  Channel yaw{};
+  Channel vel{};
+  Channel accel{};
+  Channel jerk{};
+  Channel curvature{};
+  Channel time{};
+
+  std::vector<Channel *> channels();
+  std::vector<const Channel *> channels() const;
+};
+} // namespace okapi
@@ -0,0 +1,127 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/logging.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace okapi {
+class LoopStats {
+  public:
+  static constexpr std::size_t bucketCount = 10;
+
+  /**
+   * The upper bound of each histogram bucket except the last one, which holds everything longer.
+   */
+  static constexpr std::array<double, bucketCount - 1> bucketLimitsMs{
+    {0.5, 1, 2, 3, 5, 7.5, 10, 15, 25}};
+
+  /**
+   * A tick which starts at least this much later than its period after the previous tick is late.
+   */
+  static constexpr QTime lateThreshold = 1_ms;
+
+  /**
+   * How often the control loops log a summary of their measurements.
+   */
+  static constexpr QTime defaultSummaryPeriod = 10_s;
+
+  struct Summary {
+    std::uint32_t ticks{0};        // The number of ticks which finished
+    std::uint32_t overruns{0};     // The number of ticks which took longer than their period
+    std::uint32_t lateTicks{0};    // The number of ticks which started late
+    QTime meanExecutionTime{0_ms}; // The mean time the ticks took
+    QTime maxExecutionTime{0_ms};  // The longest time a tick took
+    QTime maxJitter{0_ms};         // The largest difference between a period and the actual one
+    std::array<std::uint32_t, bucketCount> executionTimes{}; // Histogram of the times ticks took
+    std::array<std::uint32_t, bucketCount> jitters{};        // Histogram of the jitter
+  };
+
+  /**
+   * Measures how long each tick of a control loop takes and how far its period is from what the
+   * loop asked for. Everything is kept in counters and fixed histograms, so measuring a tick does
+   * not allocate or lock; it only reads the timer twice. The loop calls tickStarted() when it wakes
+   * up and tickFinished() before it sleeps again. Any task can read the measurements with
+   * getSummary() while the loop runs.
+   *
+   * @param itimer The timer to measure with. Its micros() is read, so the measurements are only as
+   * precise as that clock; the sub-millisecond buckets need a timer which overrides it. If it is
+   * `nullptr`, nothing is measured.
+   * @param isummaryPeriod How often to log a summary of the measurements at the info level. Use
+   * `0_ms` to never log one.
+   * @param ilogger The logger to log summaries to.
+   */
+  explicit LoopStats(std::unique_ptr<AbstractTimer> itimer,
+                     QTime isummaryPeriod = defaultSummaryPeriod,
+                     std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Marks the start of a tick.
+   *
+   * @param iperiod How long the loop means to take from the start of this tick to the start of the
+   * next one.
+   */
+  void tickStarted(QTime iperiod) noexcept;
+
+  /**
+   * Marks the end of the tick which was started last. A tick which is started but not finished
+   * only counts towards the jitter.
+   */
+  void tickFinished() noexcept;
+
+  /**
+   * Don't measure the period before the next tick, e.g. because the loop was waiting for something
+   * else in the meantime.
+   */
+  void ignoreNextPeriod() noexcept;
+
+  /**
+   * Clears every measurement.
+   */
+  void reset() noexcept;
+
+  /**
+   * @return The measurements so far. The counts can be one tick apart if the loop is running.
+   */
+  Summary getSummary() const noexcept;
+
+  /**
+   * @param itime A duration.
+   * @return The index of the histogram bucket which holds the duration.
+   */
+  static std::size_t getBucket(QTime itime) noexcept;
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  std::unique_ptr<AbstractTimer> timer;
+  QTime summaryPeriod;
+
+  // Only used by the loop's task
+  QTime tickStart{0_ms};
+  QTime period{0_ms};
+  QTime lastSummary{0_ms};
+  bool hasPreviousTick{false};
+
+  // Read by any task. Times are in microseconds.
+  std::atomic<std::uint32_t> ticks{0};
+  std::atomic<std::uint32_t> overruns{0};
+  std::atomic<std::uint32_t> lateTicks{0};
+  std::atomic<std::uint64_t> totalExecutionTime{0};
+  std::atomic<std::uint32_t> maxExecutionTime{0};
+  std::atomic<std::uint32_t> maxJitter{0};
+  std::array<std::atomic<std::uint32_t>, bucketCount> executionTimes{};
+  std::array<std::atomic<std::uint32_t>, bucketCount> jitters{};
+
+  static std::uint32_t toMicros(QTime itime) noexcept;
+
+  static QTime fromMicros(double imicros) noexcept;
+};
+} // namespace okapi
@@ -0,0 +1,93 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace okapi {
+struct PathGenerationResult {
+  std::string pathId;
+  bool successful;   // Whether the path was generated and saved
+  std::string error; // Why generation failed, or empty if it succeeded
+  QTime duration;    // How long the worker spent generating the path
+};
+
+class PathGenerationPool {
+  public:
+  struct Job {
+    std::string pathId;
+    std::function<void()> job;
+  };
+
+  /**
+   * Generates a batch of independent paths on a pool of worker tasks, so the batch takes about as
+   * long as its slowest path instead of as long as all of its paths together. The workers are
+   * created when a batch is run and deleted once it is done.
+   *
+   * Under `THREADS_STD` the workers are threads which run on every core of the host, which is
+   * useful for generating paths offline. The V5 brain runs user code on one core, so on the brain
+   * the workers take turns and a batch is not faster than generating the paths one by one.
+   *
+   * @param itimeUtil The TimeUtil.
+   * @param iworkers The number of worker tasks. Must be at least one.
+   * @param iname The name of the worker tasks.
+   * @param ilogger The logger this instance will log to.
+   */
+  PathGenerationPool(const TimeUtil &itimeUtil,
+                     std::size_t iworkers,
+                     std::string iname,
+                     const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  PathGenerationPool(PathGenerationPool &&other) = delete;
+
+  PathGenerationPool &operator=(PathGenerationPool &&other) = delete;
+
+  /**
+   * Runs every job and blocks the current task until they have all finished. If a job throws an
+   * exception, its result is marked as failed with the exception's message.
+   *
+   * @param ijobs The jobs.
+   * @return The result of each job, in the same order as the jobs.
+   */
+  std::vector<PathGenerationResult> run(const std::vector<Job> &ijobs);
+
+  /**
+   * @return The number of workers to use by default, which is the number of cores that can run
+   * them.
+   */
+  static std::size_t defaultWorkerCount();
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  static constexpr Logger::Component okapiLogComponent = Logger::Component::motionProfile;
+  TimeUtil timeUtil;
+  std::size_t workers;
+  std::string name;
+
+  // Only one batch runs at a time
+  CrossplatformMutex runMutex;
+
+  // The batch which is running
+  const std::vector<Job> *jobs{nullptr};
+  std::vector<PathGenerationResult> results{};
+  std::atomic_size_t nextJob{0};
+  std::atomic_size_t finishedWorkers{0};
+
+  // Notified by each worker as the last thing it does before returning
+  CrossplatformSignal finishedSignal;
+
+  static void trampoline(void *context);
+  void work();
+};
+} // namespace okapi
@@ -0,0 +1,181 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace okapi {
+class PathGenerationHandle {
+  public:
+  /**
+   * A handle to a path which is being generated in the background by a `PathGenerationQueue`.
+   * Instances of this class are returned by `generatePathAsync()`; users should not need to create
+   * them.
+   *
+   * @param ipathId The identifier of the path being generated.
+   */
+  explicit PathGenerationHandle(std::string ipathId);
+
+  /**
+   * @return The identifier of the path being generated.
+   */
+  const std::string &getPathId() const;
+
+  /**
+   * Returns whether generation has finished, either successfully or not.
+   *
+   * @return Whether generation has finished.
+   */
+  bool isReady() const;
+
+  /**
+   * Returns whether generation has finished successfully. Returns `false` if generation is not
+   * finished yet.
+   *
+   * @return Whether the path was generated successfully.
+   */
+  bool isSuccessful() const;
+
+  /**
+   * Returns the reason generation failed. Returns an empty string if generation has not finished or
+   * did not fail.
+   *
+   * @return The error message.
+   */
+  std::string getError() const;
+
+  /**
+   * Blocks the current task until generation has finished.
+   *
+   * @return Whether the path was generated successfully. If not, the reason is available from
+   * `getError()`.
+   */
+  bool waitUntilReady();
+
+  /**
+   * Marks the path as generated successfully. This should only be called by the
+   * `PathGenerationQueue`.
+   */
+  void markSucceeded();
+
+  /**
+   * Marks the path as failed to generate. This should only be called by the `PathGenerationQueue`.
+   *
+   * @param ierror The reason generation failed.
+   */
+  void markFailed(const std::string &ierror);
+
+  protected:
+  enum class Status { pending, succeeded, failed };
+
+  const std::string pathId;
+  std::string error{""};
+  std::atomic<Status> status{Status::pending};
+  CrossplatformSignal readySignal;
+};
+
+class PathGenerationQueue {
+  public:
+  /**
+   * Runs path generation jobs, one at a time and in the order they were submitted, on a dedicated
+   * low-priority task. The task is not created until the first job is submitted.
+   *
+   * @param itimeUtil The TimeUtil.
+   * @param iname The name of the worker task.
+   * @param ilogger The logger this instance will log to.
+   */
+  PathGenerationQueue(const TimeUtil &itimeUtil,
+                      std::string iname,
+                      const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  PathGenerationQueue(PathGenerationQueue &&other) = delete;
+
+  PathGenerationQueue &operator=(PathGenerationQueue &&other) = delete;
+
+  /**
+   * Stops the worker task after the job it is currently running, blocking until it has returned.
+   * Jobs which have not started yet are marked as failed.
+   */
+  ~PathGenerationQueue();
+
+  /**
+   * Queues a job which generates a path. If the job throws an exception, the returned handle is
+   * marked as failed with the exception's message.
+   *
+   * @param ipathId The identifier of the path the job generates.
+   * @param ijob The job.
+   * @return A handle to the path.
+   */
+  std::shared_ptr<PathGenerationHandle> submit(const std::string &ipathId,
+                                               std::function<void()> ijob);
+
+  /**
+   * Returns whether there is a job for the path which has not finished yet.
+   *
+   * @param ipathId The identifier of the path.
+   * @return Whether the path is still being generated.
+   */
+  bool isPending(const std::string &ipathId);
+
+  /**
+   * Blocks the current task until every job for the path has finished. Returns immediately if
+   * there are none.
+   *
+   * @param ipathId The identifier of the path.
+   */
+  void waitForPath(const std::string &ipathId);
+
+  /**
+   * The priority of the worker task. It is lower than the default priority so that generating
+   * paths never delays control loops.
+   */
+  static constexpr std::uint32_t workerPriority = 7;
+
+  protected:
+  struct Job {
+    std::shared_ptr<PathGenerationHandle> handle;
+    std::function<void()> job;
+  };
+
+  std::shared_ptr<Logger> logger;
+  static constexpr Logger::Component okapiLogComponent = Logger::Component::motionProfile;
+  TimeUtil timeUtil;
+  std::string name;
+
+  // This must be locked when accessing the jobs or the outstanding handles
+  CrossplatformMutex jobsMutex;
+  std::deque<Job> jobs{};
+  std::vector<std::shared_ptr<PathGenerationHandle>> outstanding{};
+
+  std::atomic_bool dtorCalled{false};
+  std::atomic_bool taskStopped{true};
+  CrossplatformThread *task{nullptr};
+
+  // Notified when a job is queued, when the queue is being destroyed, and when the worker returns
+  CrossplatformSignal workerSignal;
+
+  static void trampoline(void *context);
+  void loop();
+
+  /**
+   * Runs a single job and resolves its handle.
+   */
+  void runJob(Job &ijob);
+
+  /**
+   * Copies the outstanding handles for a path.
+   */
+  std::vector<std::shared_ptr<PathGenerationHandle>> getOutstanding(const std::string &ipathId);
+};
+} // namespace okapi
@@ -0,0 +1,69 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/util/executionPlan.hpp"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace okapi {
+class PathMemoryBudget {
+  public:
+  /**
+   * A limit on the memory used by the paths the motion profile controllers hold in RAM. One budget
+   * can be shared by any number of controllers so all of their paths are counted together. A path
+   * counts against the budget until the last reference to it is released, which includes a path
+   * that was removed while it was being followed.
+   *
+   * A path which doesn't fit is compacted (see `ExecutionPlan::compact()`) and admitted if it fits
+   * then. Paths can also be compacted as soon as they are admitted, to fit more of them.
+   *
+   * @param ilimit The maximum number of bytes of paths to hold in memory.
+   * @param icompactAll Whether to compact every path, instead of only paths which don't fit.
+   */
+  explicit PathMemoryBudget(std::size_t ilimit, bool icompactAll = false);
+
+  /**
+   * Counts a path against the budget. The returned path gives its memory back to the budget when
+   * it is freed.
+   *
+   * @param iplan The path.
+   * @return The path, or `nullptr` if it does not fit in the budget even after compacting it.
+   */
+  std::shared_ptr<const ExecutionPlan> admit(ExecutionPlan iplan);
+
+  /**
+   * @return The maximum number of bytes of paths to hold in memory.
+   */
+  std::size_t getLimit() const;
+
+  /**
+   * @return The number of bytes used by the admitted paths which have not been freed yet.
+   */
+  std::size_t getUsage() const;
+
+  /**
+   * @return Whether every path is compacted when it is admitted.
+   */
+  bool isCompactingAll() const;
+
+  protected:
+  std::size_t limit;
+  bool compactAll;
+
+  // Shared with the deleters of the admitted paths so they can outlive the budget
+  std::shared_ptr<std::atomic<std::size_t>> usage;
+
+  /**
+   * Reserves memory if it fits in the budget.
+   *
+   * @param ibytes The number of bytes.
+   * @return Whether the memory was reserved.
+   */
+  bool reserve(std::size_t ibytes);
+};
+} // namespace okapi
@@ -0,0 +1,143 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace okapi {
+template <typename T> class PathStore {
+  public:
+  using Path = std::shared_ptr<const T>;
+  using Snapshot = std::shared_ptr<const std::map<std::string, Path>>;
+
+  /**
+   * Stores paths by their ID as immutable, reference-counted snapshots (read-copy-update). Readers
+   * take a reference to the current snapshot and can keep using it, and any path in it, for as long
+   * as they like without holding a lock. Writers copy the snapshot, change the copy, and publish it
+   * in place of the old one. A removed path is freed once the last reader lets go of it, so a path
+   * can be removed or replaced while it is being followed.
+   *
+   * Writers are serialized with each other. Publishing and taking a snapshot only copy a
+   * `std::shared_ptr`, so readers are never blocked by a writer for longer than that.
+   */
+  PathStore() = default;
+
+  PathStore(const PathStore &) = delete;
+  PathStore &operator=(const PathStore &) = delete;
+
+  /**
+   * @return The current snapshot of every path.
+   */
+  Snapshot getSnapshot() const {
+    std::scoped_lock lock(publishMutex);
+    return snapshot;
+  }
+
+  /**
+   * Finds a path. The returned path stays valid even if it is removed from the store.
+   *
+   * @param ipathId The path ID.
+   * @return The path, or `nullptr` if there is no path with that ID.
+   */
+  Path find(const std::string &ipathId) const {
+    const auto paths = getSnapshot();
+    if (const auto path = paths->find(ipathId); path != paths->end()) {
+      return path->second;
+    }
+
+    return nullptr;
+  }
+
+  /**
+   * @return The IDs of every path, in order.
+   */
+  std::vector<std::string> getIds() const {
+    const auto paths = getSnapshot();
+
+    std::vector<std::string> ids;
+    ids.reserve(paths->size());
+    for (const auto &path : *paths) {
+      ids.push_back(path.first);
+    }
+
+    return ids;
+  }
+
+  /**
+   * @return The number of paths.
+   */
+  std::size_t size() const {
+    return getSnapshot()->size();
+  }
+
+  /**
+   * Adds a path, replacing any path with the same ID.
+   *
+   * @param ipathId The path ID.
+   * @param ipath The path.
+   */
+  void insert(const std::string &ipathId, T ipath) {
+    insert(ipathId, std::make_shared<const T>(std::move(ipath)));
+  }
+
+  /**
+   * Adds a path which is already shared, replacing any path with the same ID.
+   *
+   * @param ipathId The path ID.
+   * @param ipath The path.
+   */
+  void insert(const std::string &ipathId, Path ipath) {
+    update([&](std::map<std::string, Path> &paths) { paths[ipathId] = std::move(ipath); });
+  }
+
+  /**
+   * Removes a path. Readers which already found the path can keep using it.
+   *
+   * @param ipathId The path ID.
+   */
+  void erase(const std::string &ipathId) {
+    update([&](std::map<std::string, Path> &paths) { paths.erase(ipathId); });
+  }
+
+  /**
+   * Removes every path.
+   */
+  void clear() {
+    update([](std::map<std::string, Path> &paths) { paths.clear(); });
+  }
+
+  protected:
+  // Serializes writers so concurrent updates are not lost
+  mutable CrossplatformMutex writeMutex;
+
+  // Only guards copying and replacing the snapshot pointer
+  mutable CrossplatformMutex publishMutex;
+
+  Snapshot snapshot{std::make_shared<const std::map<std::string, Path>>()};
+
+  template <typename F> void update(F &&ifunc) {
+    std::scoped_lock writeLock(writeMutex);
+
+    auto next = std::make_shared<std::map<std::string, Path>>(*getSnapshot());
+    ifunc(*next);
+
+    Snapshot retired;
+    {
+      std::scoped_lock lock(publishMutex);
+      retired = std::exchange(snapshot, std::move(next));
+    }
+
+    // The retired snapshot is released here, outside of publishMutex. Its paths are only freed if
+    // no reader still holds them.
+  }
+};
+} // namespace okapi
@@ -7,6 +7,9 @@
 
 #include "okapi/api/units/QAngle.hpp"
 #include "okapi/api/units/QLength.hpp"
+#include <optional>
+#include <string>
+#include <vector>
 
 namespace okapi {
 struct PathfinderPoint {
@@ -20,4 +23,21 @@ struct PathfinderLimits {
   double maxAccel; // Maximum robot acceleration in m/s/s
   double maxJerk;  // Maximum robot jerk in m/s/s/s
 };
+
+struct PathChainSegment {
+  std::vector<PathfinderPoint> waypoints; // Waypoints relative to the start of this segment
+  bool backwards{false};                  // Whether to follow this segment backwards
+};
+
+struct PathGenerationJob {
+  std::string pathId;                      // The ID to save the path under
+  std::vector<PathfinderPoint> waypoints;  // The waypoints to hit on the path
+  std::optional<PathfinderLimits> limits{}; // The limits to use, or empty for the controller's
+};
+
+struct LinearPathGenerationJob {
+  std::string pathId;                      // The ID to save the path under
+  std::vector<QLength> waypoints;          // The waypoints to hit on the path
+  std::optional<PathfinderLimits> limits{}; // The limits to use, or empty for the controller's
+};
 } // namespace okapi
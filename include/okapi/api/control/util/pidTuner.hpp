@@ -60,6 +60,7 @@ class PIDTuner {
   };
 
   std::shared_ptr<Logger> logger;
+  static constexpr Logger::Component okapiLogComponent = Logger::Component::pid;
   TimeUtil timeUtil;
   std::shared_ptr<ControllerInput<double>> input;
   std::shared_ptr<ControllerOutput<double>> output;
@@ -0,0 +1,226 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/chassis/model/readOnlyChassisModel.hpp"
+#include "okapi/api/control/controllerInput.hpp"
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace okapi {
+class CachedChassisSensors;
+class CachedControllerInput;
+
+class SensorCache : public std::enable_shared_from_this<SensorCache> {
+  public:
+  /**
+   * Shares sensor readings between everything which reads the same sensors in one tick. A tick
+   * starts a new frame with refresh(). Sensors are read through the wrappers cache() returns, and
+   * each wrapper reads its sensors at most once per frame, the first time it is asked to. Every
+   * other read in that frame gets the same reading back. The ControlScheduler refreshes its cache
+   * at the start of every tick.
+   *
+   * A cache which is never refreshed serves its first readings forever, so only use the wrappers in
+   * code which runs in the ticks of whatever refreshes the cache.
+   *
+   * @param itimer The timer used to timestamp the frames and readings.
+   */
+  explicit SensorCache(std::unique_ptr<AbstractTimer> itimer);
+
+  /**
+   * Starts a new frame. The next read of each sensor reads the hardware again.
+   */
+  void refresh();
+
+  /**
+   * @return The number of frames so far. Readings from an older frame are stale.
+   */
+  std::uint32_t getFrame() const;
+
+  /**
+   * @return When the current frame started.
+   */
+  QTime getFrameTime() const;
+
+  /**
+   * @return The current time on the cache's timer.
+   */
+  QTime getTime() const;
+
+  /**
+   * Returns a chassis model which reads the given model's sensors through this cache. Asking for
+   * the same model again while the wrapper is in use returns the same wrapper, so its readers
+   * share the readings.
+   *
+   * @param imodel The model to read.
+   * @return The cached model.
+   */
+  std::shared_ptr<CachedChassisSensors> cache(const std::shared_ptr<ReadOnlyChassisModel> &imodel);
+
+  /**
+   * Returns a controller input which reads the given input through this cache. Asking for the same
+   * input again while the wrapper is in use returns the same wrapper, so its readers share the
+   * readings.
+   *
+   * @param iinput The input to read.
+   * @return The cached input.
+   */
+  std::shared_ptr<CachedControllerInput>
+  cache(const std::shared_ptr<ControllerInput<double>> &iinput);
+
+  protected:
+  std::unique_ptr<AbstractTimer> timer;
+  std::atomic<std::uint32_t> frame{1};
+  std::atomic<double> frameTime{0}; // In milliseconds
+
+  // The wrappers handed out so far. Only touched by cache(), never in a tick.
+  CrossplatformMutex wrappersMutex;
+  std::vector<std::weak_ptr<CachedChassisSensors>> models;
+  std::vector<std::weak_ptr<CachedControllerInput>> inputs;
+};
+
+/**
+ * The newest reading of one sensor, and when and in which frame it was read.
+ */
+template <typename T> class SensorCacheEntry {
+  public:
+  explicit SensorCacheEntry(std::shared_ptr<const SensorCache> icache) : cache(std::move(icache)) {
+  }
+
+  /**
+   * Returns the reading of the current frame, reading the sensor if it was not read yet.
+   *
+   * @param iread Reads the sensor.
+   * @return The reading.
+   */
+  template <typename Read> T get(Read iread) {
+    std::scoped_lock lock(mutex);
+    const std::uint32_t currentFrame = cache->getFrame();
+    if (frame != currentFrame) {
+      value = iread();
+      readTime = cache->getTime();
+      frame = currentFrame;
+      reads++;
+    }
+
+    return value;
+  }
+
+  /**
+   * @return Whether the sensor has not been read in the current frame yet.
+   */
+  bool isStale() const {
+    std::scoped_lock lock(mutex);
+    return frame != cache->getFrame();
+  }
+
+  /**
+   * @return How long ago the newest reading was taken, or `0_ms` if there is none.
+   */
+  QTime getAge() const {
+    std::scoped_lock lock(mutex);
+    return frame == 0 ? 0_ms : cache->getTime() - readTime;
+  }
+
+  /**
+   * @return How many times the sensor was actually read.
+   */
+  std::uint32_t getReadCount() const {
+    std::scoped_lock lock(mutex);
+    return reads;
+  }
+
+  protected:
+  std::shared_ptr<const SensorCache> cache;
+  mutable CrossplatformMutex mutex;
+  T value{};
+  QTime readTime{0_ms};
+  std::uint32_t frame{0};
+  std::uint32_t reads{0};
+};
+
+class CachedChassisSensors : public ReadOnlyChassisModel {
+  public:
+  /**
+   * Reads a chassis model's sensors at most once per frame of a SensorCache. Use
+   * SensorCache::cache() to make one.
+   *
+   * @param imodel The model to read.
+   * @param icache The cache whose frames to follow.
+   */
+  CachedChassisSensors(std::shared_ptr<ReadOnlyChassisModel> imodel,
+                       std::shared_ptr<const SensorCache> icache);
+
+  /**
+   * Read the sensors, or return the readings from earlier in the current frame.
+   *
+   * @return sensor readings (format is implementation dependent)
+   */
+  SensorValues getSensorValues() const override;
+
+  /**
+   * Read the sensors into a `std::valarray`, which allocates. This returns the readings of
+   * getSensorValues().
+   *
+   * @return sensor readings (format is implementation dependent)
+   */
+  std::valarray<std::int32_t> getSensorVals() const override;
+
+  /**
+   * @return The model this reads.
+   */
+  const std::shared_ptr<ReadOnlyChassisModel> &getModel() const;
+
+  /**
+   * @return The readings and when they were taken.
+   */
+  const SensorCacheEntry<SensorValues> &getEntry() const;
+
+  protected:
+  std::shared_ptr<ReadOnlyChassisModel> model;
+  mutable SensorCacheEntry<SensorValues> entry;
+};
+
+class CachedControllerInput : public ControllerInput<double> {
+  public:
+  /**
+   * Reads a ControllerInput at most once per frame of a SensorCache. Use SensorCache::cache() to
+   * make one.
+   *
+   * @param iinput The input to read.
+   * @param icache The cache whose frames to follow.
+   */
+  CachedControllerInput(std::shared_ptr<ControllerInput<double>> iinput,
+                        std::shared_ptr<const SensorCache> icache);
+
+  /**
+   * Get the sensor value for use in a control loop, or the value from earlier in the current
+   * frame.
+   *
+   * @return the current sensor value, or PROS_ERR on a failure.
+   */
+  double controllerGet() override;
+
+  /**
+   * @return The input this reads.
+   */
+  const std::shared_ptr<ControllerInput<double>> &getInput() const;
+
+  /**
+   * @return The reading and when it was taken.
+   */
+  const SensorCacheEntry<double> &getEntry() const;
+
+  protected:
+  std::shared_ptr<ControllerInput<double>> input;
+  SensorCacheEntry<double> entry;
+};
+} // namespace okapi
@@ -0,0 +1,153 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/util/binaryPath.hpp"
+#include "okapi/api/control/util/pathfinderUtil.hpp"
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/util/logging.hpp"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "squiggles.hpp"
+
+namespace okapi {
+struct TrajectoryCacheStats {
+  std::size_t hits;        // Lookups served from memory
+  std::size_t diskHits;    // Lookups served from the persistence directory
+  std::size_t misses;      // Lookups which required generating the trajectory
+  std::size_t evictions;   // Trajectories evicted to stay within the memory budget
+  std::size_t entries;     // Trajectories currently held in memory
+  std::size_t memoryUsage; // Approximate bytes used by the trajectories held in memory
+};
+
+class TrajectoryCache {
+  public:
+  using Trajectory = std::shared_ptr<const std::vector<squiggles::ProfilePoint>>;
+
+  /**
+   * A memoizing cache of generated trajectories. Trajectories are keyed by a hash of everything
+   * that affects generation (see `makeKey()`), so identical requests are only generated once. When
+   * the memory budget is exceeded, the least recently used trajectories are evicted.
+   *
+   * If a persistence directory is given, every trajectory put into the cache is also written there
+   * in the binary path format, and lookups which miss in memory check that directory before
+   * reporting a miss. This lets repeated runs skip generation entirely. The directory must exist;
+   * on the brain it must be on the SD card (e.g. `/usd/cache`).
+   *
+   * @param imemoryBudget The maximum number of bytes of trajectories to hold in memory.
+   * @param ipersistDirectory The directory to persist trajectories in, or empty to disable
+   * persistence.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit TrajectoryCache(std::size_t imemoryBudget = 256 * 1024,
+                           std::string ipersistDirectory = "",
+                           const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Computes the key of a trajectory, which is a 64-bit FNV-1a hash of the waypoints, limits,
+   * wheel track, time step, and boundary velocities.
+   *
+   * @param iwaypoints The waypoints the trajectory passes through.
+   * @param ilimits The limits the trajectory is generated with.
+   * @param iwheelTrack The wheel track the trajectory is generated for.
+   * @param idt The time step the trajectory is generated with in seconds.
+   * @param istartVel The velocity the trajectory starts at in m/s.
+   * @param iendVel The velocity the trajectory ends at in m/s.
+   * @return The key.
+   */
+  static std::uint64_t makeKey(const std::vector<PathfinderPoint> &iwaypoints,
+                               const PathfinderLimits &ilimits,
+                               const QLength &iwheelTrack,
+                               double idt,
+                               double istartVel = 0,
+                               double iendVel = 0);
+
+  /**
+   * Looks up a trajectory, first in memory and then in the persistence directory. A trajectory
+   * found on disk is also added to memory. Returns `nullptr` on a miss.
+   *
+   * @param ikey The key of the trajectory.
+   * @return The trajectory, or `nullptr` if it is not cached.
+   */
+  Trajectory get(std::uint64_t ikey);
+
+  /**
+   * Adds a trajectory to the cache, evicting the least recently used trajectories if the memory
+   * budget would be exceeded. Trajectories larger than the whole budget are only persisted.
+   *
+   * @param ikey The key of the trajectory.
+   * @param itrajectory The trajectory.
+   * @param iheader The header to persist the trajectory with.
+   */
+  void put(std::uint64_t ikey,
+           const std::vector<squiggles::ProfilePoint> &itrajectory,
+           const BinaryPathHeader &iheader);
+
+  /**
+   * Removes every trajectory from memory. Persisted trajectories are kept.
+   */
+  void clear();
+
+  /**
+   * @return The hit, miss, and eviction counters and the current memory usage.
+   */
+  TrajectoryCacheStats getStats();
+
+  /**
+   * Resets the hit, miss, and eviction counters.
+   */
+  void resetStats();
+
+  /**
+   * Estimates how many bytes a trajectory uses in memory.
+   *
+   * @param itrajectory The trajectory.
+   * @return The approximate number of bytes.
+   */
+  static std::size_t
+  estimateMemoryUsage(const std::vector<squiggles::ProfilePoint> &itrajectory);
+
+  protected:
+  struct Entry {
+    std::uint64_t key;
+    Trajectory trajectory;
+    std::size_t size;
+  };
+
+  std::shared_ptr<Logger> logger;
+  static constexpr Logger::Component okapiLogComponent = Logger::Component::motionProfile;
+  const std::size_t memoryBudget;
+  const std::string persistDirectory;
+
+  // This must be locked when accessing any of the members below
+  CrossplatformMutex cacheMutex;
+
+  // Ordered from most to least recently used
+  std::list<Entry> entries{};
+  std::unordered_map<std::uint64_t, std::list<Entry>::iterator> index{};
+  std::size_t memoryUsage{0};
+  TrajectoryCacheStats stats{0, 0, 0, 0, 0, 0};
+
+  /**
+   * Inserts a trajectory into memory. `cacheMutex` must be locked.
+   */
+  void insert(std::uint64_t ikey, Trajectory itrajectory);
+
+  /**
+   * @return The file a trajectory is persisted in.
+   */
+  std::string makeFilePath(std::uint64_t ikey) const;
+
+  Trajectory loadPersisted(std::uint64_t ikey);
+  void persist(std::uint64_t ikey,
+               const std::vector<squiggles::ProfilePoint> &itrajectory,
+               const BinaryPathHeader &iheader);
+};
+} // namespace okapi
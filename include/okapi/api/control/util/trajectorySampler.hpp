@@ -0,0 +1,88 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstddef>
+#include <optional>
+
+namespace okapi {
+struct TrajectorySample {
+  std::size_t index; // The point at or before the sampled time
+  std::size_t next;  // The point after the sampled time (equal to index at the end of the path)
+  double fraction;   // How far between index and next the sampled time is, in [0, 1]
+};
+
+class TrajectorySampler {
+  public:
+  /**
+   * Samples a trajectory by the time since it started instead of by point index, so a loop which
+   * runs late follows the trajectory where it should be now instead of where it would have been
+   * had it run on time. Points the loop was too late for are skipped. Sample times must not
+   * decrease between calls; the sampler only moves forward.
+   */
+  TrajectorySampler() = default;
+
+  /**
+   * Finds the points surrounding a time.
+   *
+   * @param ielapsed The time since the trajectory started in seconds.
+   * @param isize The number of points in the trajectory.
+   * @param itimeAt Returns the time (in seconds) of the point at an index. Must not decrease.
+   * @return The sample, or `std::nullopt` once the trajectory is done. The first time past the end
+   * of the trajectory is sampled on the last point, so the trajectory always finishes on it.
+   */
+  template <typename F>
+  std::optional<TrajectorySample>
+  sample(const double ielapsed, const std::size_t isize, F &&itimeAt) {
+    if (isize == 0) {
+      return std::nullopt;
+    }
+
+    const double time = itimeAt(0) + ielapsed;
+    if (time > itimeAt(isize - 1)) {
+      if (started && index == isize - 1) {
+        return std::nullopt;
+      }
+
+      skipped += isize - 1 - index - (started ? 1 : 0);
+      index = isize - 1;
+      started = true;
+      return TrajectorySample{index, index, 0};
+    }
+
+    const std::size_t previous = index;
+    while (index + 1 < isize && itimeAt(index + 1) <= time) {
+      ++index;
+    }
+
+    if (started && index > previous + 1) {
+      skipped += index - previous - 1;
+    }
+    started = true;
+
+    if (index + 1 >= isize) {
+      return TrajectorySample{index, index, 0};
+    }
+
+    const double start = itimeAt(index);
+    const double span = itimeAt(index + 1) - start;
+    const double fraction = span > 0 ? (time - start) / span : 0;
+    return TrajectorySample{index, index + 1, fraction < 0 ? 0 : (fraction > 1 ? 1 : fraction)};
+  }
+
+  /**
+   * @return The number of points which were skipped because the loop ran late.
+   */
+  std::size_t getSkippedPoints() const {
+    return skipped;
+  }
+
+  protected:
+  std::size_t index{0};
+  std::size_t skipped{0};
+  bool started{false};
+};
+} // namespace okapi
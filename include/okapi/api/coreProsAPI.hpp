@@ -5,12 +5,14 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <cstdbool>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <functional>
 #include <sstream>
 
@@ -20,6 +22,9 @@
 
 #include <mutex>
 #define CROSSPLATFORM_MUTEX_T std::mutex
+
+#include <chrono>
+#include <condition_variable>
 #else
 #include "api.h"
 #include "pros/apix.h"
@@ -38,18 +43,19 @@ class CrossplatformThread {
 #ifdef THREADS_STD
   CrossplatformThread(void (*ptr)(void *),
                       void *params,
-                      const char *const = "OkapiLibCrossplatformTask")
+                      const char *const = "OkapiLibCrossplatformTask",
+                      const std::uint32_t = 0)
 #else
   CrossplatformThread(void (*ptr)(void *),
                       void *params,
-                      const char *const name = "OkapiLibCrossplatformTask")
+                      const char *const name = "OkapiLibCrossplatformTask",
+                      const std::uint32_t priority = TASK_PRIORITY_DEFAULT)
 #endif
     :
 #ifdef THREADS_STD
       thread(ptr, params)
 #else
-      thread(
-        pros::c::task_create(ptr, params, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, name))
+      thread(pros::c::task_create(ptr, params, priority, TASK_STACK_DEPTH_DEFAULT, name))
 #endif
   {
   }
@@ -93,12 +99,31 @@ class CrossplatformThread {
 #endif
 
   static std::string getName() {
+    char name[32];
+    getName(name, sizeof(name));
+    return std::string(name);
+  }
+
+  /**
+   * Writes the current thread's name into a buffer without allocating, for code which runs inside
+   * control loops. The name is truncated to fit.
+   *
+   * @param obuffer The buffer to write the null-terminated name into.
+   * @param isize The size of the buffer.
+   */
+  static void getName(char *obuffer, const std::size_t isize) noexcept {
+    if (isize == 0) {
+      return;
+    }
+
 #ifdef THREADS_STD
-    std::ostringstream ss;
-    ss << std::this_thread::get_id();
-    return ss.str();
+    std::snprintf(obuffer,
+                  isize,
+                  "%zu",
+                  std::hash<std::thread::id>{}(std::this_thread::get_id()));
 #else
-    return std::string(pros::c::task_get_name(NULL));
+    std::strncpy(obuffer, pros::c::task_get_name(NULL), isize - 1);
+    obuffer[isize - 1] = '\0';
 #endif
   }
 
@@ -129,3 +154,150 @@ class CrossplatformMutex {
   protected:
   CROSSPLATFORM_MUTEX_T mutex;
 };
+
+class CrossplatformSignal {
+  public:
+  /**
+   * Pass this as a timeout to wait without one.
+   */
+  static constexpr std::uint32_t forever = UINT32_MAX;
+
+  CrossplatformSignal() = default;
+
+  CrossplatformSignal(const CrossplatformSignal &) = delete;
+
+  CrossplatformSignal &operator=(const CrossplatformSignal &) = delete;
+
+#ifndef THREADS_STD
+  ~CrossplatformSignal() {
+    for (auto &slot : slots) {
+      if (slot) {
+        pros::c::sem_delete(slot);
+      }
+    }
+  }
+#endif
+
+  /**
+   * Wakes the tasks blocked in waitUntil() so they check their condition again. Call this after
+   * changing the state a condition reads.
+   */
+  void notifyAll() {
+#ifdef THREADS_STD
+    {
+      std::scoped_lock lock(mutex);
+      generation++;
+    }
+    condition.notify_all();
+#else
+    mutex.lock();
+    generation++;
+    for (std::size_t i = 0; i < maxWaiters; ++i) {
+      if (slotUsed[i]) {
+        pros::c::sem_post(slots[i]);
+      }
+    }
+    mutex.unlock();
+#endif
+  }
+
+  /**
+   * Blocks the current task until a condition holds. The condition is checked now and after every
+   * notifyAll(), so it only has to read state which is changed before notifyAll() is called. Under
+   * PROS each waiting task blocks on a semaphore of its own, so the task's notifications are left
+   * alone. If more than maxWaiters tasks are waiting, the others check their condition every 10 ms.
+   *
+   * @param icondition The condition.
+   * @param itimeout The longest time to wait in milliseconds.
+   * @return Whether the condition held. This is false if the timeout passed first.
+   */
+  template <typename Condition>
+  bool waitUntil(Condition icondition, const std::uint32_t itimeout = forever) {
+#ifdef THREADS_STD
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(itimeout);
+    while (true) {
+      // Read the generation first so a notification during the check isn't lost
+      std::unique_lock lock(mutex);
+      const std::uint32_t seen = generation;
+      lock.unlock();
+
+      if (icondition()) {
+        return true;
+      }
+
+      lock.lock();
+      if (itimeout == forever) {
+        condition.wait(lock, [&]() { return generation != seen; });
+      } else if (!condition.wait_until(lock, deadline, [&]() { return generation != seen; })) {
+        lock.unlock();
+        return icondition();
+      }
+    }
+#else
+    const std::uint32_t start = pros::c::millis();
+    while (true) {
+      // Claim a free slot, creating its semaphore the first time it is used
+      mutex.lock();
+      std::size_t slot = maxWaiters;
+      for (std::size_t i = 0; i < maxWaiters; ++i) {
+        if (!slotUsed[i]) {
+          if (!slots[i]) {
+            slots[i] = pros::c::sem_binary_create();
+          }
+
+          if (slots[i]) {
+            slotUsed[i] = true;
+            slot = i;
+          }
+          break;
+        }
+      }
+      const bool registered = slot < maxWaiters;
+      mutex.unlock();
+
+      // Register first so a notification during the check isn't lost
+      const bool held = icondition();
+      const std::uint32_t elapsed = pros::c::millis() - start;
+      const bool timedOut = itimeout != forever && elapsed >= itimeout;
+      if (!held && !timedOut) {
+        const std::uint32_t remaining = itimeout == forever ? TIMEOUT_MAX : itimeout - elapsed;
+        if (registered) {
+          pros::c::sem_wait(slots[slot], remaining);
+        } else {
+          pros::c::delay(std::min<std::uint32_t>(remaining, 10));
+        }
+      }
+
+      if (registered) {
+        // Take any notification which arrived while the condition held, so the next waiter on this
+        // slot does not wake early
+        mutex.lock();
+        pros::c::sem_wait(slots[slot], 0);
+        slotUsed[slot] = false;
+        mutex.unlock();
+      }
+
+      if (held || timedOut) {
+        return held;
+      }
+    }
+#endif
+  }
+
+  /**
+   * The number of tasks which can wait on one signal without falling back to checking their
+   * condition every 10 ms.
+   */
+  static constexpr std::size_t maxWaiters = 8;
+
+  protected:
+  std::uint32_t generation{0};
+#ifdef THREADS_STD
+  std::mutex mutex;
+  std::condition_variable condition;
+#else
+  CrossplatformMutex mutex;
+  pros::c::sem_t slots[maxWaiters]{};
+  bool slotUsed[maxWaiters]{};
+#endif
+};
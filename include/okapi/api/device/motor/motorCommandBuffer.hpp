@@ -0,0 +1,225 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/util/logging.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace okapi {
+class BufferedMotor;
+
+class MotorCommandBuffer : public std::enable_shared_from_this<MotorCommandBuffer> {
+  public:
+  /**
+   * The number of commands the buffer was asked to send and how many it actually sent.
+   */
+  struct Counters {
+    std::uint32_t commits{0};   // The number of times commit() ran
+    std::uint32_t requested{0}; // The number of commands written to buffered motors
+    std::uint32_t sent{0};      // The number of commands sent to the motors
+
+    /**
+     * @return The number of writes which were not sent, because a newer command replaced them in
+     * the same commit or because the motor already had that command.
+     */
+    std::uint32_t getSaved() const {
+      return requested > sent ? requested - sent : 0;
+    }
+  };
+
+  /**
+   * Collects the velocity and voltage commands written to motors and sends them all at once. Motors
+   * are written to through the wrappers buffer() returns. A write only records the command, and
+   * commit() sends the newest command of every motor whose command changed since the last time it
+   * was sent, so writing the same command every tick costs one SDK call in total instead of one per
+   * tick. The ControlScheduler commits its buffer at the end of every tick.
+   *
+   * Nothing reaches the motors until the buffer is committed, so only use the wrappers while
+   * something commits the buffer regularly.
+   *
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit MotorCommandBuffer(std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Returns a motor whose velocity and voltage commands go through this buffer. Asking for the same
+   * motor again while the wrapper is in use returns the same wrapper. Asking for a motor which
+   * already goes through this buffer returns it as is.
+   *
+   * All commands for the motor have to go through the wrapper, otherwise the buffer does not know
+   * what the motor was last told to do.
+   *
+   * @param imotor The motor to buffer.
+   * @return The buffered motor.
+   */
+  std::shared_ptr<AbstractMotor> buffer(const std::shared_ptr<AbstractMotor> &imotor);
+
+  /**
+   * Sends the changed commands of every buffered motor, in one pass.
+   *
+   * @return The number of commands sent.
+   */
+  std::uint32_t commit();
+
+  /**
+   * @return The counters since the buffer was made.
+   */
+  Counters getCounters() const;
+
+  protected:
+  friend class BufferedMotor;
+
+  std::shared_ptr<Logger> logger;
+  static constexpr Logger::Component okapiLogComponent = Logger::Component::general;
+
+  // The wrappers handed out so far. commit() walks them, so it holds the lock while sending.
+  mutable CrossplatformMutex motorsMutex;
+  std::vector<std::weak_ptr<BufferedMotor>> motors;
+
+  std::atomic<std::uint32_t> commits{0};
+  std::atomic<std::uint32_t> requested{0};
+  std::atomic<std::uint32_t> sent{0};
+};
+
+class BufferedMotor : public AbstractMotor {
+  public:
+  /**
+   * A motor whose velocity and voltage commands are recorded, and sent when its
+   * MotorCommandBuffer is committed. Every other method goes to the motor right away. Use
+   * MotorCommandBuffer::buffer() to make one.
+   *
+   * @param imotor The motor to send the commands to.
+   * @param ibuffer The buffer which sends the commands.
+   */
+  BufferedMotor(std::shared_ptr<AbstractMotor> imotor, std::shared_ptr<MotorCommandBuffer> ibuffer);
+
+  /**
+   * Sends the pending command, so it is not lost when the motor is deleted between commits.
+   */
+  ~BufferedMotor() override;
+
+  /**
+   * Sends the pending command if it differs from the last command sent to the motor.
+   *
+   * @return Whether a command was sent.
+   */
+  bool flush();
+
+  /**
+   * @return The motor the commands are sent to.
+   */
+  const std::shared_ptr<AbstractMotor> &getMotor() const;
+
+  /**
+   * @return The buffer which sends the commands.
+   */
+  const std::shared_ptr<MotorCommandBuffer> &getBuffer() const;
+
+  /******************************************************************************/
+  /**                         Motor movement functions                         **/
+  /**                                                                          **/
+  /**   Velocity and voltage commands are sent when the buffer is committed    **/
+  /******************************************************************************/
+
+  /**
+   * Records a velocity command for the next commit.
+   *
+   * @param ivelocity The new motor velocity from -+-100, +-200, or +-600 depending on the motor's
+   * gearset
+   * @return 1 if the command was recorded
+   */
+  std::int32_t moveVelocity(std::int16_t ivelocity) override;
+
+  /**
+   * Records a voltage command for the next commit.
+   *
+   * @param ivoltage The new voltage value from -12000 to 12000.
+   * @return 1 if the command was recorded
+   */
+  std::int32_t moveVoltage(std::int16_t ivoltage) override;
+
+  /**
+   * Records a `controllerSet` command for the next commit.
+   *
+   * @param ivalue the controller's output in the range [-1, 1]
+   */
+  void controllerSet(double ivalue) override;
+
+  /**
+   * Sends the position command now. The next velocity or voltage command is sent even if it is the
+   * same as the last one, since the motor is no longer following it.
+   */
+  std::int32_t moveAbsolute(double iposition, std::int32_t ivelocity) override;
+
+  /**
+   * Sends the position command now. The next velocity or voltage command is sent even if it is the
+   * same as the last one, since the motor is no longer following it.
+   */
+  std::int32_t moveRelative(double iposition, std::int32_t ivelocity) override;
+
+  std::int32_t modifyProfiledVelocity(std::int32_t ivelocity) override;
+
+  /******************************************************************************/
+  /**               Everything else goes to the motor right away               **/
+  /******************************************************************************/
+
+  double getTargetPosition() override;
+  double getPosition() override;
+  std::int32_t tarePosition() override;
+  std::int32_t getTargetVelocity() override;
+  double getActualVelocity() override;
+  std::int32_t getCurrentDraw() override;
+  std::int32_t getDirection() override;
+  double getEfficiency() override;
+  std::int32_t isOverCurrent() override;
+  std::int32_t isOverTemp() override;
+  std::int32_t isStopped() override;
+  std::int32_t getZeroPositionFlag() override;
+  uint32_t getFaults() override;
+  uint32_t getFlags() override;
+  std::int32_t getRawPosition(std::uint32_t *timestamp) override;
+  double getPower() override;
+  double getTemperature() override;
+  double getTorque() override;
+  std::int32_t getVoltage() override;
+  std::int32_t setBrakeMode(AbstractMotor::brakeMode imode) override;
+  brakeMode getBrakeMode() override;
+  std::int32_t setCurrentLimit(std::int32_t ilimit) override;
+  std::int32_t getCurrentLimit() override;
+  std::int32_t setEncoderUnits(AbstractMotor::encoderUnits iunits) override;
+  encoderUnits getEncoderUnits() override;
+  std::int32_t setGearing(AbstractMotor::gearset igearset) override;
+  gearset getGearing() override;
+  std::int32_t setReversed(bool ireverse) override;
+  std::int32_t setVoltageLimit(std::int32_t ilimit) override;
+  std::shared_ptr<ContinuousRotarySensor> getEncoder() override;
+
+  protected:
+  struct Command {
+    enum class Kind { none, velocity, voltage, controller } kind{Kind::none};
+    double value{0};
+
+    bool operator==(const Command &other) const {
+      return kind == other.kind && value == other.value;
+    }
+  };
+
+  std::shared_ptr<Logger> logger;
+  static constexpr Logger::Component okapiLogComponent = MotorCommandBuffer::okapiLogComponent;
+  std::shared_ptr<AbstractMotor> motor;
+  std::shared_ptr<MotorCommandBuffer> buffer;
+  CrossplatformMutex commandMutex;
+  Command pending;
+  Command last;
+
+  void record(Command icommand);
+};
+} // namespace okapi
@@ -16,5 +16,14 @@ class ContinuousRotarySensor : public RotarySensor {
    * @return `1` on success, `PROS_ERR` on fail
    */
   virtual std::int32_t reset() = 0;
+
+  /**
+   * Get the current sensor value along with the device time it was sampled at. Sensors which do
+   * not report when they were sampled set the timestamp to `0`.
+   *
+   * @param timestamp Set to the device time of the sample in ms, or `0` if it is unknown.
+   * @return the current sensor value, or `PROS_ERR` on a failure.
+   */
+  virtual double getTimestamped(std::uint32_t *timestamp) const;
 };
 } // namespace okapi
@@ -0,0 +1,229 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/odometry/odomState.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/matrix.hpp"
+#include <memory>
+#include <mutex>
+
+namespace okapi {
+class PoseEKF {
+  public:
+  using State = Matrix<3, 1>;
+  using Covariance = Matrix<3, 3>;
+
+  struct ProcessNoise {
+    /**
+     * The standard deviation of the distance error, per unit distance driven.
+     */
+    double distanceError{0.02};
+
+    /**
+     * The standard deviation of the heading error, per unit angle turned.
+     */
+    double turnError{0.02};
+
+    /**
+     * The standard deviation of the heading error per meter driven, from wheel scrub.
+     */
+    QAngle driftPerMeter{1_deg};
+  };
+
+  /**
+   * Where a distance sensor is on the robot.
+   */
+  struct DistanceSensorMount {
+    QLength forward{0_m}; ///< How far in front of the robot's center the sensor is.
+    QLength right{0_m};   ///< How far to the right of the robot's center the sensor is.
+    QAngle angle{0_deg};  ///< Which way the sensor points, clockwise from the robot's front.
+  };
+
+  /**
+   * A straight wall along one of the field's axes.
+   */
+  struct Wall {
+    enum class Axis {
+      x, ///< The wall is where x is `position`.
+      y  ///< The wall is where y is `position`.
+    };
+
+    Axis axis{Axis::x};
+    QLength position{0_m};
+  };
+
+  /**
+   * An extended Kalman filter for the robot's pose (x, y, theta), unlike EKFFilter, which filters
+   * one value. Odometry is the process model: feed it the robot's motion with predict(). Absolute
+   * measurements, such as an IMU's heading, a distance sensor facing a wall, or a position fix,
+   * correct the pose whenever they arrive, independent of the odometry rate.
+   *
+   * The matrices have a fixed size, so nothing allocates after construction. Poses are in
+   * StateMode::FRAME_TRANSFORMATION format.
+   *
+   * @param iinitialState The starting pose.
+   * @param iinitialCovariance The uncertainty of the starting pose, in meters and radians squared.
+   */
+  explicit PoseEKF(const OdomState &iinitialState = OdomState{},
+                   const Covariance &iinitialCovariance = Covariance::diagonal({1e-4, 1e-4, 1e-4}));
+
+  /**
+   * An extended Kalman filter for the robot's pose. See the other constructor.
+   *
+   * @param iinitialState The starting pose.
+   * @param iinitialCovariance The uncertainty of the starting pose, in meters and radians squared.
+   * @param inoise How much error the odometry accumulates as the robot moves.
+   * @param ilogger The logger this instance will log to.
+   */
+  PoseEKF(const OdomState &iinitialState,
+          const Covariance &iinitialCovariance,
+          const ProcessNoise &inoise,
+          const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Moves the pose by the motion between two odometry states, such as the odometry's state from
+   * the last call and its current state. The motion is applied relative to the filter's heading,
+   * so the odometry's own drift does not matter.
+   *
+   * @param ifrom The odometry's previous state.
+   * @param ito The odometry's current state.
+   */
+  void predict(const OdomState &ifrom, const OdomState &ito);
+
+  /**
+   * Moves the pose by a motion relative to the robot.
+   *
+   * @param iforward The distance driven forward.
+   * @param iright The distance driven to the right.
+   * @param iturn The angle turned clockwise.
+   */
+  void predict(QLength iforward, QLength iright, QAngle iturn);
+
+  /**
+   * Corrects the heading with an absolute heading, such as from an IMU.
+   *
+   * @param iheading The measured heading.
+   * @param istdDev The standard deviation of the measurement.
+   * @return Whether the measurement was used.
+   */
+  bool correctHeading(QAngle iheading, QAngle istdDev);
+
+  /**
+   * Corrects the position with an absolute position, such as a GPS-style fix.
+   *
+   * @param ix The measured x.
+   * @param iy The measured y.
+   * @param istdDev The standard deviation of the measurement on each axis.
+   * @return Whether the measurement was used.
+   */
+  bool correctPosition(QLength ix, QLength iy, QLength istdDev);
+
+  /**
+   * Corrects the whole pose with an absolute pose.
+   *
+   * @param ipose The measured pose.
+   * @param ipositionStdDev The standard deviation of the measured position on each axis.
+   * @param iheadingStdDev The standard deviation of the measured heading.
+   * @return Whether the measurement was used.
+   */
+  bool correctPose(const OdomState &ipose, QLength ipositionStdDev, QAngle iheadingStdDev);
+
+  /**
+   * Corrects the pose with a distance sensor's range to a known wall. Readings are not used if the
+   * sensor would not see the wall from the current pose, or would see it at a shallow angle.
+   *
+   * @param irange The measured range.
+   * @param imount Where the sensor is on the robot.
+   * @param iwall The wall the sensor sees.
+   * @param istdDev The standard deviation of the measured range.
+   * @return Whether the measurement was used.
+   */
+  bool correctDistance(QLength irange,
+                       const DistanceSensorMount &imount,
+                       const Wall &iwall,
+                       QLength istdDev);
+
+  /**
+   * Corrects the pose with any measurement. Use this for sensors the other methods do not cover.
+   *
+   * @param iinnovation The measurement minus the measurement predicted from the current pose, in
+   * meters and radians.
+   * @param iH The Jacobian of the predicted measurement with respect to (x, y, theta).
+   * @param iR The covariance of the measurement noise.
+   * @return Whether the measurement was used.
+   */
+  template <std::size_t M>
+  bool correct(const Matrix<M, 1> &iinnovation, const Matrix<M, 3> &iH, const Matrix<M, M> &iR) {
+    std::scoped_lock lock(mutex);
+    return update(iinnovation, iH, iR);
+  }
+
+  /**
+   * Rejects measurements whose squared Mahalanobis distance from the predicted measurement is
+   * greater than this, such as a distance sensor seeing another robot instead of the wall. `0`
+   * accepts every measurement, which is the default.
+   *
+   * @param igate The largest squared Mahalanobis distance to accept.
+   */
+  void setOutlierGate(double igate);
+
+  /**
+   * @return The estimated pose.
+   */
+  OdomState getState() const;
+
+  /**
+   * @return The uncertainty of the estimated pose, in meters and radians squared.
+   */
+  Covariance getCovariance() const;
+
+  /**
+   * Sets the estimated pose and its uncertainty.
+   *
+   * @param istate The pose.
+   * @param icovariance The uncertainty of the pose, in meters and radians squared.
+   */
+  void setState(const OdomState &istate, const Covariance &icovariance);
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  static constexpr Logger::Component okapiLogComponent = Logger::Component::odometry;
+  ProcessNoise noise;
+  State x;
+  Covariance P;
+  double outlierGate{0};
+  mutable CrossplatformMutex mutex;
+
+  /**
+   * Does the measurement update. The caller must hold the mutex.
+   */
+  template <std::size_t M>
+  bool update(const Matrix<M, 1> &iinnovation, const Matrix<M, 3> &iH, const Matrix<M, M> &iR) {
+    const auto Ht = iH.transpose();
+    const auto S = iH * P * Ht + iR;
+    Matrix<M, M> Sinv;
+    if (!S.invert(Sinv)) {
+      LOG_WARN_S("PoseEKF: The innovation covariance is singular. Skipping this measurement.");
+      return false;
+    }
+
+    if (outlierGate > 0 && (iinnovation.transpose() * Sinv * iinnovation)(0, 0) > outlierGate) {
+      LOG_DEBUG_S("PoseEKF: Rejected an outlier measurement.");
+      return false;
+    }
+
+    const auto K = P * Ht * Sinv;
+    x = x + K * iinnovation;
+
+    // The Joseph form keeps P symmetric and positive definite
+    const auto IKH = Covariance::identity() - K * iH;
+    P = IKH * P * IKH.transpose() + K * iR * K.transpose();
+    return true;
+  }
+};
+} // namespace okapi
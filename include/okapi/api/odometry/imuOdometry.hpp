@@ -0,0 +1,86 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/device/rotarysensor/continuousRotarySensor.hpp"
+#include "okapi/api/odometry/twoEncoderOdometry.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <memory>
+
+namespace okapi {
+class IMUOdometry : public TwoEncoderOdometry {
+  public:
+  /**
+   * The default trust in the IMU. At the IMU's 100 Hz, this removes most of the encoders' heading
+   * error within about 100 ms while smoothing the IMU's noise.
+   */
+  static constexpr double defaultIMUTrust = 0.2;
+
+  /**
+   * Odometry which fuses the heading from an IMU with the left and right encoders. Each step
+   * predicts the heading from the encoders, like TwoEncoderOdometry, and then moves it part of the
+   * way towards the IMU's heading (a complementary filter). The position is integrated along the
+   * fused heading, so wheel scrub does not bend the path.
+   *
+   * The IMU's heading is taken relative to the odometry's: the first reading, and the first
+   * reading after setState() or correctStateAt(), is lined up with the odometry's heading.
+   *
+   * @param itimeUtil The TimeUtil.
+   * @param imodel The chassis model for reading the encoders.
+   * @param ichassisScales The chassis dimensions.
+   * @param iimu The IMU. It reads the heading in degrees, positive clockwise, like the IMU class.
+   * @param iimuTrust How far each IMU sample moves the heading towards the IMU's, in the range
+   * `[0, 1]`. `0` ignores the IMU and `1` uses only the IMU's heading.
+   * @param ifuseOnlyFreshSamples Whether to only fuse IMU samples which are newer than the last
+   * one. Fusing an old sample pulls the heading back to where the robot was. The IMU's timestamp
+   * tells if a sample is new. If the IMU does not report one, a sample is new if it reads
+   * differently.
+   * @param ilogger The logger this instance will log to.
+   */
+  IMUOdometry(const TimeUtil &itimeUtil,
+              const std::shared_ptr<ReadOnlyChassisModel> &imodel,
+              const ChassisScales &ichassisScales,
+              const std::shared_ptr<ContinuousRotarySensor> &iimu,
+              double iimuTrust = defaultIMUTrust,
+              bool ifuseOnlyFreshSamples = true,
+              const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * @return The IMU.
+   */
+  std::shared_ptr<ContinuousRotarySensor> getIMU() const;
+
+  /**
+   * @return How many IMU samples were fused into the heading.
+   */
+  std::uint32_t getFusedSamples() const;
+
+  protected:
+  std::shared_ptr<ContinuousRotarySensor> imu;
+  double imuTrust;
+  bool fuseOnlyFreshSamples;
+  bool headingAligned{false};
+  QAngle headingOffset{0_deg};
+  double lastReading{0};
+  std::uint32_t lastIMUTimestamp{0};
+  std::uint32_t fusedSamples{0};
+
+  /**
+   * Does the math for one odom step. Unlike TwoEncoderOdometry, this reads the IMU, so it is not
+   * side-effect free. This is called with stateMutex held.
+   *
+   * @param itickDiff The tick difference from the previous step to this step.
+   * @param ideltaT The time difference from the previous step to this step.
+   * @return The newly computed OdomState.
+   */
+  OdomState odomMathStep(const SensorValues &itickDiff, const QTime &ideltaT) override;
+
+  /**
+   * Lines the next IMU reading up with the new heading.
+   */
+  void onStateChanged() override;
+};
+} // namespace okapi
@@ -37,7 +37,6 @@ class ThreeEncoderOdometry : public TwoEncoderOdometry {
    * @param ideltaT The time difference from the previous step to this step.
    * @return The newly computed OdomState.
    */
-  OdomState odomMathStep(const std::valarray<std::int32_t> &itickDiff,
-                         const QTime &ideltaT) override;
+  OdomState odomMathStep(const SensorValues &itickDiff, const QTime &ideltaT) override;
 };
 } // namespace okapi
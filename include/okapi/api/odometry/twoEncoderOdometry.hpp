@@ -5,14 +5,17 @@
  */
 #pragma once
 
+#include "okapi/api/chassis/model/sensorValues.hpp"
+#include "okapi/api/coreProsAPI.hpp"
 #include "okapi/api/odometry/odometry.hpp"
+#include "okapi/api/units/QAngularSpeed.hpp"
 #include "okapi/api/units/QSpeed.hpp"
 #include "okapi/api/util/abstractRate.hpp"
 #include "okapi/api/util/logging.hpp"
 #include "okapi/api/util/timeUtil.hpp"
+#include <array>
 #include <atomic>
 #include <memory>
-#include <valarray>
 
 namespace okapi {
 class TwoEncoderOdometry : public Odometry {
@@ -39,7 +42,10 @@ class TwoEncoderOdometry : public Odometry {
   void setScales(const ChassisScales &ichassisScales) override;
 
   /**
-   * Do one odometry step.
+   * Do one odometry step. If the chassis model's sensors report when they were sampled, the step
+   * integrates over the time between samples and skips samples which are not newer than the last
+   * one, so this can be called faster or slower than the sensors update. Otherwise, the step
+   * integrates over the time since the last step.
    */
   void step() override;
 
@@ -52,7 +58,7 @@ class TwoEncoderOdometry : public Odometry {
   OdomState getState(const StateMode &imode = StateMode::FRAME_TRANSFORMATION) const override;
 
   /**
-   * Sets a new state to be the current state.
+   * Sets a new state to be the current state. This forgets the remembered past states.
    *
    * @param istate The new state in the given format.
    * @param imode The mode to treat the input state as.
@@ -60,6 +66,36 @@ class TwoEncoderOdometry : public Odometry {
   void setState(const OdomState &istate,
                 const StateMode &imode = StateMode::FRAME_TRANSFORMATION) override;
 
+  /**
+   * Returns the state at a past time, interpolated between the steps around it. Times before the
+   * oldest remembered step give the oldest remembered state. Times after the newest step give the
+   * current state.
+   *
+   * Times are on the sensors' clock if they report when they were sampled (see
+   * SensorValues::getTimestamp()), otherwise on the odometry's timer.
+   *
+   * @param itime The time.
+   * @param imode The mode to return the state in.
+   * @return The state at that time in the given format.
+   */
+  OdomState getStateAt(QTime itime,
+                       const StateMode &imode = StateMode::FRAME_TRANSFORMATION) const;
+
+  /**
+   * Corrects the state the robot was in at a past time, for example when a sensor reading taken
+   * then arrives late. Every later state, including the current one, moves with it: the motion
+   * since then is kept, turned by the change in heading.
+   *
+   * @param itime The time the robot was in the state, on the same clock as getStateAt().
+   * @param istate The state the robot was in.
+   * @param imode The mode to treat the input state as.
+   * @return Whether the state was corrected. It is not if the time is older than the oldest
+   * remembered step.
+   */
+  bool correctStateAt(QTime itime,
+                      const OdomState &istate,
+                      const StateMode &imode = StateMode::FRAME_TRANSFORMATION);
+
   /**
    * @return The internal ChassisModel.
    */
@@ -70,24 +106,92 @@ class TwoEncoderOdometry : public Odometry {
    */
   ChassisScales getScales() override;
 
+  /**
+   * @return The robot's speed along its heading, estimated over the last integrated sample.
+   */
+  QSpeed getLinearVelocity() const;
+
+  /**
+   * @return The robot's turning rate, estimated over the last integrated sample.
+   */
+  QAngularSpeed getAngularVelocity() const;
+
+  /**
+   * @return How many timestamped samples were skipped because they were not newer than the last
+   * integrated sample.
+   */
+  std::uint32_t getStaleSamples() const;
+
+  /**
+   * The number of past steps remembered for getStateAt() and correctStateAt(). This is one second
+   * at the usual 10 ms odometry rate.
+   */
+  static constexpr std::size_t historySize = 100;
+
   protected:
+  struct TimedState {
+    QTime time{0_ms};
+    OdomState state;
+  };
+
   std::shared_ptr<Logger> logger;
+  static constexpr Logger::Component okapiLogComponent = Logger::Component::odometry;
   std::unique_ptr<AbstractRate> rate;
   std::unique_ptr<AbstractTimer> timer;
   std::shared_ptr<ReadOnlyChassisModel> model;
   ChassisScales chassisScales;
   OdomState state;
-  std::valarray<std::int32_t> newTicks{0, 0, 0}, tickDiff{0, 0, 0}, lastTicks{0, 0, 0};
+  SensorValues newTicks{0, 0, 0}, tickDiff{0, 0, 0}, lastTicks{0, 0, 0};
+  std::uint32_t lastTimestamp{0};
+  std::uint32_t staleSamples{0};
+  QSpeed linearVelocity{0_mps};
+  QAngularSpeed angularVelocity{0_rpm};
+  std::array<TimedState, historySize> history{};
+  std::size_t historyStart{0};
+  std::size_t historyCount{0};
+  mutable CrossplatformMutex stateMutex;
   const std::int32_t maximumTickDiff{1000};
 
   /**
-   * Does the math, side-effect free, for one odom step.
+   * Does the math, side-effect free, for one odom step. This is called with stateMutex held.
    *
    * @param itickDiff The tick difference from the previous step to this step.
    * @param ideltaT The time difference from the previous step to this step.
    * @return The newly computed OdomState.
    */
-  virtual OdomState odomMathStep(const std::valarray<std::int32_t> &itickDiff,
-                                 const QTime &ideltaT);
+  virtual OdomState odomMathStep(const SensorValues &itickDiff, const QTime &ideltaT);
+
+  /**
+   * Remembers the current state as the state at a time, forgetting the oldest remembered state if
+   * there is no room. The caller must hold stateMutex.
+   *
+   * @param itime The time of the current state.
+   */
+  void recordState(QTime itime);
+
+  /**
+   * @param i The index, where `0` is the oldest remembered state.
+   * @return The remembered state at that index.
+   */
+  TimedState &historyAt(std::size_t i);
+
+  /**
+   * @param i The index, where `0` is the oldest remembered state.
+   * @return The remembered state at that index.
+   */
+  const TimedState &historyAt(std::size_t i) const;
+
+  /**
+   * Called after setState() or correctStateAt() changes the state, with stateMutex held.
+   */
+  virtual void onStateChanged();
+
+  /**
+   * Interpolates the state at a time. The caller must hold stateMutex.
+   *
+   * @param itime The time.
+   * @return The state at that time in FRAME_TRANSFORMATION format.
+   */
+  OdomState interpolateState(QTime itime) const;
 };
 } // namespace okapi
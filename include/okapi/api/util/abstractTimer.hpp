@@ -27,6 +27,15 @@ class AbstractTimer {
    */
   virtual QTime millis() const = 0;
 
+  /**
+   * Returns the current time in units of QTime, read from a microsecond clock where the platform
+   * has one. Use this to measure durations shorter than a few milliseconds. The default
+   * implementation returns millis().
+   *
+   * @return the current time
+   */
+  virtual QTime micros() const;
+
   /**
    * Returns the time passed in ms since the previous call of this function.
    *
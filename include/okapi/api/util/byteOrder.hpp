@@ -0,0 +1,54 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace okapi {
+/**
+ * @return Whether this device stores multi-byte values little-endian. The V5 brain and most
+ * desktops do.
+ */
+inline bool isLittleEndian() {
+  const std::uint16_t probe = 1;
+  std::uint8_t firstByte;
+  std::memcpy(&firstByte, &probe, 1);
+  return firstByte == 1;
+}
+
+/**
+ * Converts a value between this device's byte order and little-endian. Converting twice gives the
+ * original value back, so this is used both before writing and after reading. Does nothing on a
+ * little-endian device.
+ *
+ * @param ivalue The value to convert in place.
+ */
+template <typename T> void convertLittleEndian(T &ivalue) {
+  if (!isLittleEndian()) {
+    auto *bytes = reinterpret_cast<std::uint8_t *>(&ivalue);
+    std::reverse(bytes, bytes + sizeof(T));
+  }
+}
+
+/**
+ * Converts consecutive 32-bit words between this device's byte order and little-endian, for
+ * records made only of 32-bit fields. Does nothing on a little-endian device.
+ *
+ * @param idata The words to convert in place.
+ * @param isize The number of bytes, which must be a multiple of 4.
+ */
+inline void convertLittleEndianWords(void *idata, const std::size_t isize) {
+  if (!isLittleEndian()) {
+    auto *bytes = static_cast<std::uint8_t *>(idata);
+    for (std::size_t i = 0; i + 4 <= isize; i += 4) {
+      std::reverse(bytes + i, bytes + i + 4);
+    }
+  }
+}
+} // namespace okapi
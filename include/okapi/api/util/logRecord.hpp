@@ -0,0 +1,123 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+namespace okapi {
+/**
+ * The events which can be logged with Logger::event. An event is logged as its ID and a few numbers
+ * instead of as text, so logging it does not allocate. The text is only made when the log is read.
+ * The IDs are written to binary logs, so they must never be changed or reused; add new events at
+ * the end.
+ */
+enum class LogEvent : std::uint16_t {
+  message = 0,                                  ///< A text message
+  loggerDroppedRecords = 1,                     ///< count
+  iterativePosPidSetTarget = 2,                 ///< target
+  iterativePosPidFlipDisable = 3,               ///< disabled
+  iterativeVelPidSetTarget = 4,                 ///< target
+  iterativeVelPidFlipDisable = 5,               ///< disabled
+  asyncPosIntegratedSetTarget = 6,              ///< target
+  asyncPosIntegratedFlipDisable = 7,            ///< disabled
+  asyncVelIntegratedSetTarget = 8,              ///< target
+  asyncVelIntegratedFlipDisable = 9,            ///< disabled
+  asyncWrapperSetTarget = 10,                   ///< target
+  chassisControllerPidMoveDistance = 11,        ///< meters, motor ticks
+  chassisControllerPidTurnAngle = 12,           ///< degrees, motor ticks
+  chassisControllerPidScales = 13,              ///< scale, gearset ratio
+  chassisControllerIntegratedMoveDistance = 14, ///< meters, motor ticks
+  chassisControllerIntegratedTurnAngle = 15,    ///< degrees, motor ticks
+  loopStatsSummary = 16                         ///< ticks, overruns, max time, max jitter
+};
+
+/**
+ * One log statement. Records have the same size and layout on the brain and on a computer, and are
+ * stored little-endian in binary logs, so a binary log written on the brain can be read anywhere.
+ */
+struct LogRecord {
+  static constexpr std::size_t taskNameSize = 24;
+  static constexpr std::size_t messageSize = 88;
+  static constexpr std::size_t maxFields = 4;
+
+  std::int32_t time;           // When the record was logged in milliseconds
+  std::uint16_t event;         // The LogEvent
+  std::uint8_t level;          // The Logger::LogLevel
+  std::uint8_t fieldCount;     // The number of fields used by the event
+  char taskName[taskNameSize]; // The name of the task which logged the record, truncated
+  union {
+    char message[messageSize]; // The message if the event is LogEvent::message, truncated
+    double fields[maxFields];  // The fields of any other event
+  };
+};
+
+static_assert(sizeof(LogRecord) == 120, "LogRecord must have the same size on every platform");
+
+/**
+ * The start of a binary log file. It is followed by LogRecords until the end of the file. Its
+ * fields are stored little-endian.
+ */
+struct LogFileHeader {
+  static constexpr char expectedMagic[4] = {'O', 'K', 'L', 'G'};
+  static constexpr std::uint16_t currentVersion = 1;
+
+  char magic[4];
+  std::uint16_t version;
+  std::uint16_t recordSize;
+};
+
+/**
+ * Converts a record between this device's byte order and little-endian.
+ *
+ * @param irecord The record to convert in place.
+ */
+void convertLogRecordByteOrder(LogRecord &irecord) noexcept;
+
+/**
+ * Converts a binary log header between this device's byte order and little-endian.
+ *
+ * @param iheader The header to convert in place.
+ */
+void convertLogFileHeaderByteOrder(LogFileHeader &iheader) noexcept;
+
+/**
+ * Returns the printf-style format of an event's text. Each field is formatted as a double.
+ *
+ * @param ievent The event ID.
+ * @return The format, or nullptr if the event is unknown.
+ */
+const char *getLogEventFormat(std::uint16_t ievent) noexcept;
+
+/**
+ * @param ilevel The Logger::LogLevel.
+ * @return The name of the log level as it appears in a text log, e.g. `"WARN"`.
+ */
+const char *getLogLevelName(std::uint8_t ilevel) noexcept;
+
+/**
+ * Formats a record the same way a text log would show it, including the trailing newline.
+ *
+ * @param irecord The record.
+ * @param obuffer The buffer to write to.
+ * @param isize The size of the buffer.
+ * @return The length of the text. The text was truncated if this is at least isize.
+ */
+int formatLogRecord(const LogRecord &irecord, char *obuffer, std::size_t isize) noexcept;
+
+/**
+ * Converts a binary log to the text a text log would have contained. Several logs appended to the
+ * same file are decoded one after another.
+ *
+ * @param istream The binary log.
+ * @param ostream The stream to write the text to.
+ * @return False if the input is not a binary log OkapiLib can read or ends partway through a
+ * record. Everything before the problem is still decoded.
+ */
+bool decodeBinaryLog(std::istream &istream, std::ostream &ostream);
+} // namespace okapi
@@ -0,0 +1,61 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/util/logRecord.hpp"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace okapi {
+class LogRingBuffer {
+  public:
+  /**
+   * A bounded, lock-free queue of log records which any number of tasks can push to and one task
+   * pops from. All of the memory is allocated up front, so pushing never allocates, never blocks,
+   * and never waits for the consumer; if the buffer is full the record is rejected instead.
+   *
+   * @param icapacity The number of records the buffer can hold. Rounded up to a power of two.
+   */
+  explicit LogRingBuffer(std::size_t icapacity);
+
+  LogRingBuffer(const LogRingBuffer &) = delete;
+  LogRingBuffer &operator=(const LogRingBuffer &) = delete;
+
+  /**
+   * Adds a record to the buffer. Safe to call from any number of tasks at once.
+   *
+   * @param irecord The record.
+   * @return Whether the record was added. It is not added if the buffer is full.
+   */
+  bool push(const LogRecord &irecord) noexcept;
+
+  /**
+   * Removes the oldest record from the buffer. Must only be called from one task at a time.
+   *
+   * @param orecord The record which was removed.
+   * @return Whether a record was removed. Nothing is removed if the buffer is empty.
+   */
+  bool pop(LogRecord &orecord) noexcept;
+
+  /**
+   * @return The number of records the buffer can hold.
+   */
+  std::size_t getCapacity() const noexcept;
+
+  protected:
+  struct Slot {
+    // Equal to the slot's index when it can be written and to index + 1 when it can be read
+    std::atomic_size_t sequence;
+    LogRecord record;
+  };
+
+  std::size_t capacity;
+  std::unique_ptr<Slot[]> slots;
+  std::atomic_size_t head{0}; // The next position to write
+  std::atomic_size_t tail{0}; // The next position to read
+};
+} // namespace okapi
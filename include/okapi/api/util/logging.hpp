@@ -7,19 +7,76 @@
 
 #include "okapi/api/coreProsAPI.hpp"
 #include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/logRingBuffer.hpp"
 #include "okapi/api/util/mathUtil.hpp"
+#include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #if defined(THREADS_STD)
 #else
 #include "okapi/impl/util/timer.hpp"
 #endif
 
-#define LOG_DEBUG(msg) logger->debug([=]() { return msg; })
-#define LOG_INFO(msg) logger->info([=]() { return msg; })
-#define LOG_WARN(msg) logger->warn([=]() { return msg; })
-#define LOG_ERROR(msg) logger->error([=]() { return msg; })
+/**
+ * Log statements more verbose than this level are removed when OkapiLib is compiled, so they cost
+ * nothing at all. It uses the values of Logger::LogLevel; for example, define it as 2 to keep only
+ * warnings and errors. Defaults to 4 (debug), which keeps every log statement.
+ */
+#ifndef OKAPI_COMPILED_LOG_LEVEL
+#define OKAPI_COMPILED_LOG_LEVEL 4
+#endif
+
+// The macros log to the `logger` in scope as the `okapiLogComponent` in scope. Statements which are
+// compiled out are still type checked but never run, so their arguments do not become unused.
+#define OKAPI_DISABLED_LOG(statement)                                                              \
+  do {                                                                                             \
+    if constexpr (false) {                                                                         \
+      statement;                                                                                   \
+    }                                                                                              \
+  } while (0)
+
+#if OKAPI_COMPILED_LOG_LEVEL >= 4
+#define LOG_DEBUG(msg) logger->debug([=]() { return msg; }, okapiLogComponent)
+#define LOG_DEBUG_EVENT(...)                                                                       \
+  logger->event(okapiLogComponent, okapi::Logger::LogLevel::debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(msg) OKAPI_DISABLED_LOG(logger->debug([=]() { return msg; }, okapiLogComponent))
+#define LOG_DEBUG_EVENT(...)                                                                       \
+  OKAPI_DISABLED_LOG(logger->event(okapiLogComponent, okapi::Logger::LogLevel::debug, __VA_ARGS__))
+#endif
+
+#if OKAPI_COMPILED_LOG_LEVEL >= 3
+#define LOG_INFO(msg) logger->info([=]() { return msg; }, okapiLogComponent)
+#define LOG_INFO_EVENT(...)                                                                        \
+  logger->event(okapiLogComponent, okapi::Logger::LogLevel::info, __VA_ARGS__)
+#else
+#define LOG_INFO(msg) OKAPI_DISABLED_LOG(logger->info([=]() { return msg; }, okapiLogComponent))
+#define LOG_INFO_EVENT(...)                                                                        \
+  OKAPI_DISABLED_LOG(logger->event(okapiLogComponent, okapi::Logger::LogLevel::info, __VA_ARGS__))
+#endif
+
+#if OKAPI_COMPILED_LOG_LEVEL >= 2
+#define LOG_WARN(msg) logger->warn([=]() { return msg; }, okapiLogComponent)
+#define LOG_WARN_EVENT(...)                                                                        \
+  logger->event(okapiLogComponent, okapi::Logger::LogLevel::warn, __VA_ARGS__)
+#else
+#define LOG_WARN(msg) OKAPI_DISABLED_LOG(logger->warn([=]() { return msg; }, okapiLogComponent))
+#define LOG_WARN_EVENT(...)                                                                        \
+  OKAPI_DISABLED_LOG(logger->event(okapiLogComponent, okapi::Logger::LogLevel::warn, __VA_ARGS__))
+#endif
+
+#if OKAPI_COMPILED_LOG_LEVEL >= 1
+#define LOG_ERROR(msg) logger->error([=]() { return msg; }, okapiLogComponent)
+#define LOG_ERROR_EVENT(...)                                                                       \
+  logger->event(okapiLogComponent, okapi::Logger::LogLevel::error, __VA_ARGS__)
+#else
+#define LOG_ERROR(msg) OKAPI_DISABLED_LOG(logger->error([=]() { return msg; }, okapiLogComponent))
+#define LOG_ERROR_EVENT(...)                                                                       \
+  OKAPI_DISABLED_LOG(logger->event(okapiLogComponent, okapi::Logger::LogLevel::error, __VA_ARGS__))
+#endif
 
 #define LOG_DEBUG_S(msg) LOG_DEBUG(std::string(msg))
 #define LOG_INFO_S(msg) LOG_INFO(std::string(msg))
@@ -37,6 +94,30 @@ class Logger {
     off = 0    ///< off
   };
 
+  /**
+   * The parts of OkapiLib which can be given their own log level. A class logs as its component by
+   * declaring a static `okapiLogComponent` member; everything else logs as Component::general.
+   */
+  enum class Component {
+    general = 0,       ///< Everything which is not part of another component
+    odometry = 1,      ///< Odometry
+    chassis = 2,       ///< Chassis controllers
+    motionProfile = 3, ///< Motion profile controllers and path generation
+    pid = 4            ///< PID controllers and the PID tuner
+  };
+
+  static constexpr std::size_t componentCount = 5;
+
+  /**
+   * The most verbose level which is compiled in. See OKAPI_COMPILED_LOG_LEVEL.
+   */
+  static constexpr LogLevel compiledLevel = static_cast<LogLevel>(OKAPI_COMPILED_LOG_LEVEL);
+
+  enum class Format {
+    text,  ///< Log statements are written as lines of text
+    binary ///< Log statements are written as LogRecords, to be read with the log decoder
+  };
+
   /**
    * A logger that does nothing.
    */
@@ -49,11 +130,18 @@ class Logger {
    *
    * @param itimer A timer used to get the current time for log statements.
    * @param ifileName The name of the log file to open.
-   * @param ilevel The log level. Log statements more verbose than this level will be disabled.
+   * @param ilevel The log level of every component. Log statements more verbose than this level
+   * will be disabled. Use setComponentLevel() to change the level of one component.
+   * @param iasyncCapacity If nonzero, log statements are put in a ring buffer which can hold this
+   * many records and a background task writes them to the file. See isAsync().
+   * @param iformat Whether to write text or binary records to the file. A binary log is smaller
+   * and faster to write. Read it on a computer with the log decoder.
    */
   Logger(std::unique_ptr<AbstractTimer> itimer,
          std::string_view ifileName,
-         const LogLevel &ilevel) noexcept;
+         const LogLevel &ilevel,
+         std::size_t iasyncCapacity = 0,
+         const Format &iformat = Format::text) noexcept;
 
   /**
    * A logger that uses an existing file handle. The file will be closed when the logger is
@@ -61,82 +149,135 @@ class Logger {
    *
    * @param itimer A timer used to get the current time for log statements.
    * @param ifile The log file to open. Will be closed by the logger!
-   * @param ilevel The log level. Log statements more verbose than this level will be disabled.
+   * @param ilevel The log level of every component. Log statements more verbose than this level
+   * will be disabled. Use setComponentLevel() to change the level of one component.
+   * @param iasyncCapacity If nonzero, log statements are put in a ring buffer which can hold this
+   * many records and a background task writes them to the file. See isAsync().
+   * @param iformat Whether to write text or binary records to the file. A binary log is smaller
+   * and faster to write. Read it on a computer with the log decoder.
    */
-  Logger(std::unique_ptr<AbstractTimer> itimer, FILE *ifile, const LogLevel &ilevel) noexcept;
+  Logger(std::unique_ptr<AbstractTimer> itimer,
+         FILE *ifile,
+         const LogLevel &ilevel,
+         std::size_t iasyncCapacity = 0,
+         const Format &iformat = Format::text) noexcept;
 
   ~Logger();
 
-  constexpr bool isDebugLevelEnabled() const noexcept {
-    return toUnderlyingType(logLevel) >= toUnderlyingType(LogLevel::debug);
+  /**
+   * @param ilevel The level of a log statement.
+   * @param icomponent The component which logs it.
+   * @return Whether the log statement would be logged. This is always false if the level is more
+   * verbose than OKAPI_COMPILED_LOG_LEVEL.
+   */
+  bool isLevelEnabled(const LogLevel &ilevel, const Component &icomponent) const noexcept {
+    return toUnderlyingType(compiledLevel) >= toUnderlyingType(ilevel) &&
+           componentLevels[toUnderlyingType(icomponent)].load(std::memory_order_relaxed) >=
+             toUnderlyingType(ilevel);
+  }
+
+  bool isDebugLevelEnabled(const Component &icomponent = Component::general) const noexcept {
+    return isLevelEnabled(LogLevel::debug, icomponent);
   }
 
-  template <typename T> void debug(T ilazyMessage) noexcept {
-    if (isDebugLevelEnabled() && logfile && timer) {
-      std::scoped_lock lock(logfileMutex);
-      fprintf(logfile,
-              "%ld (%s) DEBUG: %s\n",
-              static_cast<long>(timer->millis().convert(millisecond)),
-              CrossplatformThread::getName().c_str(),
-              ilazyMessage().c_str());
+  template <typename T>
+  void debug(T ilazyMessage, const Component &icomponent = Component::general) noexcept {
+    if (isDebugLevelEnabled(icomponent) && logfile && timer) {
+      log(LogLevel::debug, ilazyMessage());
     }
   }
 
-  constexpr bool isInfoLevelEnabled() const noexcept {
-    return toUnderlyingType(logLevel) >= toUnderlyingType(LogLevel::info);
+  bool isInfoLevelEnabled(const Component &icomponent = Component::general) const noexcept {
+    return isLevelEnabled(LogLevel::info, icomponent);
   }
 
-  template <typename T> void info(T ilazyMessage) noexcept {
-    if (isInfoLevelEnabled() && logfile && timer) {
-      std::scoped_lock lock(logfileMutex);
-      fprintf(logfile,
-              "%ld (%s) INFO: %s\n",
-              static_cast<long>(timer->millis().convert(millisecond)),
-              CrossplatformThread::getName().c_str(),
-              ilazyMessage().c_str());
+  template <typename T>
+  void info(T ilazyMessage, const Component &icomponent = Component::general) noexcept {
+    if (isInfoLevelEnabled(icomponent) && logfile && timer) {
+      log(LogLevel::info, ilazyMessage());
     }
   }
 
-  constexpr bool isWarnLevelEnabled() const noexcept {
-    return toUnderlyingType(logLevel) >= toUnderlyingType(LogLevel::warn);
+  bool isWarnLevelEnabled(const Component &icomponent = Component::general) const noexcept {
+    return isLevelEnabled(LogLevel::warn, icomponent);
   }
 
-  template <typename T> void warn(T ilazyMessage) noexcept {
-    if (isWarnLevelEnabled() && logfile && timer) {
-      std::scoped_lock lock(logfileMutex);
-      fprintf(logfile,
-              "%ld (%s) WARN: %s\n",
-              static_cast<long>(timer->millis().convert(millisecond)),
-              CrossplatformThread::getName().c_str(),
-              ilazyMessage().c_str());
+  template <typename T>
+  void warn(T ilazyMessage, const Component &icomponent = Component::general) noexcept {
+    if (isWarnLevelEnabled(icomponent) && logfile && timer) {
+      log(LogLevel::warn, ilazyMessage());
     }
   }
 
-  constexpr bool isErrorLevelEnabled() const noexcept {
-    return toUnderlyingType(logLevel) >= toUnderlyingType(LogLevel::error);
+  bool isErrorLevelEnabled(const Component &icomponent = Component::general) const noexcept {
+    return isLevelEnabled(LogLevel::error, icomponent);
   }
 
-  template <typename T> void error(T ilazyMessage) noexcept {
-    if (isErrorLevelEnabled() && logfile && timer) {
-      std::scoped_lock lock(logfileMutex);
-      fprintf(logfile,
-              "%ld (%s) ERROR: %s\n",
-              static_cast<long>(timer->millis().convert(millisecond)),
-              CrossplatformThread::getName().c_str(),
-              ilazyMessage().c_str());
+  template <typename T>
+  void error(T ilazyMessage, const Component &icomponent = Component::general) noexcept {
+    if (isErrorLevelEnabled(icomponent) && logfile && timer) {
+      log(LogLevel::error, ilazyMessage());
     }
   }
 
   /**
-   * Closes the connection to the log file.
+   * Logs an event. Unlike the other log statements, this does not build a string: the record only
+   * holds the event ID and its fields, and the text is made when the record is written or decoded.
+   * Use the LOG_*_EVENT macros to call this.
+   *
+   * @param icomponent The component which logs the event.
+   * @param ilevel The level to log the event at.
+   * @param ievent The event ID. Its format determines how many fields it takes.
+   * @param ifields The event's numbers.
    */
-  constexpr void close() noexcept {
-    if (logfile) {
-      fclose(logfile);
-      logfile = nullptr;
+  template <typename... Fields>
+  void event(const Component &icomponent,
+             const LogLevel &ilevel,
+             const LogEvent ievent,
+             const Fields... ifields) noexcept {
+    static_assert(sizeof...(Fields) <= LogRecord::maxFields, "Too many fields for a log event.");
+    if (isLevelEnabled(ilevel, icomponent) && logfile && timer) {
+      log(ilevel, ievent, {static_cast<double>(ifields)...}, sizeof...(Fields));
     }
   }
 
+  /**
+   * Sets the log level of one component, e.g. to get debug output from only the odometry.
+   *
+   * @param icomponent The component.
+   * @param ilevel The new log level. Log statements from the component which are more verbose than
+   * this level will be disabled.
+   */
+  void setComponentLevel(const Component &icomponent, const LogLevel &ilevel) noexcept;
+
+  /**
+   * @param icomponent The component.
+   * @return The log level of the component.
+   */
+  LogLevel getComponentLevel(const Component &icomponent) const noexcept;
+
+  /**
+   * Closes the connection to the log file. If the logger is asynchronous, the background task is
+   * stopped and every buffered record is written first.
+   */
+  void close() noexcept;
+
+  /**
+   * An asynchronous logger only copies each record into a preallocated ring buffer, so logging
+   * never waits for the file or for another task holding it. A background task writes the records
+   * to the file in large batches. If the buffer is full when a record is logged, the record is
+   * dropped and counted instead; the background task writes how many records were dropped.
+   * Messages longer than LogRecord::messageSize - 1 characters are truncated.
+   *
+   * @return Whether this logger is asynchronous.
+   */
+  bool isAsync() const noexcept;
+
+  /**
+   * @return The number of records which were dropped because the ring buffer was full.
+   */
+  std::size_t getDroppedRecords() const noexcept;
+
   /**
    * @return The default logger.
    */
@@ -150,12 +291,53 @@ class Logger {
    */
   static void setDefaultLogger(std::shared_ptr<Logger> ilogger);
 
+  /**
+   * The priority of the task which writes the records of an asynchronous logger. It is lower than
+   * the default priority so that writing logs never delays control loops.
+   */
+  static constexpr std::uint32_t flusherPriority = 6;
+
   private:
   const std::unique_ptr<AbstractTimer> timer;
-  const LogLevel logLevel;
+  std::array<std::atomic_int, componentCount> componentLevels;
+  const Format format;
   FILE *logfile;
   CrossplatformMutex logfileMutex;
 
+  std::unique_ptr<LogRingBuffer> records;
+  std::vector<char> batch;
+  std::atomic_size_t droppedRecords{0};
+  std::atomic_size_t unreportedDroppedRecords{0};
+  std::atomic_bool flusherRunning{false};
+  std::atomic_bool flusherStopped{true};
+  std::unique_ptr<CrossplatformThread> flusher;
+
+  void log(const LogLevel &ilevel, const std::string &imessage) noexcept;
+
+  void log(const LogLevel &ilevel,
+           LogEvent ievent,
+           const std::array<double, LogRecord::maxFields> &ifields,
+           std::size_t ifieldCount) noexcept;
+
+  /**
+   * Buffers the record if the logger is asynchronous, otherwise writes it.
+   */
+  void submit(LogRecord &irecord) noexcept;
+
+  /**
+   * Appends the record to the batch in the logger's format.
+   */
+  void append(const LogRecord &irecord) noexcept;
+
+  /**
+   * Writes every buffered record to the file with as few writes as possible.
+   */
+  void flush() noexcept;
+
+  void stopFlusher() noexcept;
+
+  static void trampoline(void *context);
+
   static bool isSerialStream(std::string_view filename);
 };
 
@@ -190,3 +372,10 @@ struct DefaultLoggerInitializer {
 
 static DefaultLoggerInitializer defaultLoggerInitializer; // NOLINT(cert-err58-cpp)
 } // namespace okapi
+
+/**
+ * The component of log statements made outside of a class with its own `okapiLogComponent`
+ * member. It is in the global namespace so the log macros also work in code outside of namespace
+ * okapi, and it has a prefixed name so it does not collide with names in user code.
+ */
+inline constexpr okapi::Logger::Component okapiLogComponent = okapi::Logger::Component::general;
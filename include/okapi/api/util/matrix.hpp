@@ -0,0 +1,176 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+
+namespace okapi {
+template <std::size_t Rows, std::size_t Cols> class Matrix {
+  public:
+  /**
+   * A matrix whose size is known at compile time. The elements are stored inline, so making and
+   * multiplying matrices never allocates. This is meant for the small matrices in filters, not for
+   * general linear algebra.
+   *
+   * The matrix starts as all zeros.
+   */
+  constexpr Matrix() = default;
+
+  /**
+   * @param ivalues The elements in row-major order. Missing elements are zero.
+   */
+  constexpr Matrix(std::initializer_list<double> ivalues) {
+    std::size_t i = 0;
+    for (const double value : ivalues) {
+      if (i < Rows * Cols) {
+        values[i++] = value;
+      }
+    }
+  }
+
+  /**
+   * @return The identity matrix.
+   */
+  static constexpr Matrix identity() {
+    static_assert(Rows == Cols, "Only square matrices have an identity.");
+    Matrix out;
+    for (std::size_t i = 0; i < Rows; ++i) {
+      out(i, i) = 1;
+    }
+    return out;
+  }
+
+  /**
+   * @param idiagonal The elements of the diagonal.
+   * @return A matrix with the given diagonal and zeros elsewhere.
+   */
+  static constexpr Matrix diagonal(const std::array<double, Rows> &idiagonal) {
+    static_assert(Rows == Cols, "Only square matrices have a diagonal.");
+    Matrix out;
+    for (std::size_t i = 0; i < Rows; ++i) {
+      out(i, i) = idiagonal[i];
+    }
+    return out;
+  }
+
+  constexpr double operator()(const std::size_t irow, const std::size_t icol) const {
+    return values[irow * Cols + icol];
+  }
+
+  constexpr double &operator()(const std::size_t irow, const std::size_t icol) {
+    return values[irow * Cols + icol];
+  }
+
+  constexpr Matrix operator+(const Matrix &rhs) const {
+    Matrix out(*this);
+    for (std::size_t i = 0; i < Rows * Cols; ++i) {
+      out.values[i] += rhs.values[i];
+    }
+    return out;
+  }
+
+  constexpr Matrix operator-(const Matrix &rhs) const {
+    Matrix out(*this);
+    for (std::size_t i = 0; i < Rows * Cols; ++i) {
+      out.values[i] -= rhs.values[i];
+    }
+    return out;
+  }
+
+  constexpr Matrix operator*(const double rhs) const {
+    Matrix out(*this);
+    for (std::size_t i = 0; i < Rows * Cols; ++i) {
+      out.values[i] *= rhs;
+    }
+    return out;
+  }
+
+  template <std::size_t OtherCols>
+  constexpr Matrix<Rows, OtherCols> operator*(const Matrix<Cols, OtherCols> &rhs) const {
+    Matrix<Rows, OtherCols> out;
+    for (std::size_t r = 0; r < Rows; ++r) {
+      for (std::size_t c = 0; c < OtherCols; ++c) {
+        double sum = 0;
+        for (std::size_t k = 0; k < Cols; ++k) {
+          sum += (*this)(r, k) * rhs(k, c);
+        }
+        out(r, c) = sum;
+      }
+    }
+    return out;
+  }
+
+  /**
+   * @return The transpose.
+   */
+  constexpr Matrix<Cols, Rows> transpose() const {
+    Matrix<Cols, Rows> out;
+    for (std::size_t r = 0; r < Rows; ++r) {
+      for (std::size_t c = 0; c < Cols; ++c) {
+        out(c, r) = (*this)(r, c);
+      }
+    }
+    return out;
+  }
+
+  /**
+   * Inverts the matrix with Gauss-Jordan elimination.
+   *
+   * @param oinverse Set to the inverse if the matrix is invertible.
+   * @return Whether the matrix is invertible.
+   */
+  bool invert(Matrix &oinverse) const {
+    static_assert(Rows == Cols, "Only square matrices can be inverted.");
+    Matrix work(*this);
+    Matrix inverse = identity();
+
+    for (std::size_t col = 0; col < Cols; ++col) {
+      // Pivot on the largest element for stability
+      std::size_t pivot = col;
+      for (std::size_t r = col + 1; r < Rows; ++r) {
+        if (std::abs(work(r, col)) > std::abs(work(pivot, col))) {
+          pivot = r;
+        }
+      }
+
+      if (std::abs(work(pivot, col)) < 1e-12) {
+        return false;
+      }
+
+      for (std::size_t c = 0; c < Cols; ++c) {
+        std::swap(work(col, c), work(pivot, c));
+        std::swap(inverse(col, c), inverse(pivot, c));
+      }
+
+      const double scale = 1 / work(col, col);
+      for (std::size_t c = 0; c < Cols; ++c) {
+        work(col, c) *= scale;
+        inverse(col, c) *= scale;
+      }
+
+      for (std::size_t r = 0; r < Rows; ++r) {
+        if (r != col) {
+          const double factor = work(r, col);
+          for (std::size_t c = 0; c < Cols; ++c) {
+            work(r, c) -= factor * work(col, c);
+            inverse(r, c) -= factor * inverse(col, c);
+          }
+        }
+      }
+    }
+
+    oinverse = inverse;
+    return true;
+  }
+
+  protected:
+  std::array<double, Rows * Cols> values{};
+};
+} // namespace okapi
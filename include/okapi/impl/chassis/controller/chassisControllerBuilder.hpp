@@ -11,6 +11,8 @@
 #include "okapi/api/chassis/model/hDriveModel.hpp"
 #include "okapi/api/chassis/model/skidSteerModel.hpp"
 #include "okapi/api/chassis/model/xDriveModel.hpp"
+#include "okapi/api/control/util/controlScheduler.hpp"
+#include "okapi/api/odometry/imuOdometry.hpp"
 #include "okapi/api/util/logging.hpp"
 #include "okapi/api/util/mathUtil.hpp"
 #include "okapi/impl/device/motor/motor.hpp"
@@ -298,6 +300,30 @@ class ChassisControllerBuilder {
                                          const QLength &imoveThreshold = 0_mm,
                                          const QAngle &iturnThreshold = 0_deg);
 
+  /**
+   * Sets the odometry information, causing the builder to generate an IMUOdometry, which fuses an
+   * IMU's heading with the encoders. The odometry uses the ChassisScales from withDimensions(), or
+   * from a previous call to withOdometry() with ChassisScales. The middle encoder, if any, is not
+   * used.
+   *
+   * @param iimu The IMU.
+   * @param iimuTrust How far each IMU sample moves the heading towards the IMU's, in the range
+   * `[0, 1]`.
+   * @param ifuseOnlyFreshSamples Whether to only fuse IMU samples which are newer than the last
+   * one.
+   * @param imode The new default StateMode used to interpret target points and query the Odometry
+   * state.
+   * @param imoveThreshold The minimum length movement.
+   * @param iturnThreshold The minimum angle turn.
+   * @return An ongoing builder.
+   */
+  ChassisControllerBuilder &withOdometry(const std::shared_ptr<ContinuousRotarySensor> &iimu,
+                                         double iimuTrust = IMUOdometry::defaultIMUTrust,
+                                         bool ifuseOnlyFreshSamples = true,
+                                         const StateMode &imode = StateMode::FRAME_TRANSFORMATION,
+                                         const QLength &imoveThreshold = 0_mm,
+                                         const QAngle &iturnThreshold = 0_deg);
+
   /**
    * Sets the derivative filters. Uses a PassthroughFilter by default.
    *
@@ -388,6 +414,22 @@ class ChassisControllerBuilder {
    */
   ChassisControllerBuilder &withLogger(const std::shared_ptr<Logger> &ilogger);
 
+  /**
+   * Runs the built controllers on a scheduler's task instead of starting a task for each of them.
+   * Controllers on a scheduler are not parented to the current task, so they keep running until
+   * they are deleted. The default is to start a task for each controller.
+   *
+   * A PID chassis controller on a scheduler sends its motor commands through the scheduler's
+   * command buffer, so they reach the motors when the scheduler's task runs its next tick.
+   *
+   * Read more about this in the [builders and tasks tutorial]
+   * (docs/tutorials/concepts/builders-and-tasks.md).
+   *
+   * @param ischeduler The scheduler.
+   * @return An ongoing builder.
+   */
+  ChassisControllerBuilder &withScheduler(const std::shared_ptr<ControlScheduler> &ischeduler);
+
   /**
    * Parents the internal tasks started by this builder to the current task, meaning they will be
    * deleted once the current task is deleted. The `initialize` and `competition_initialize` tasks
@@ -482,6 +524,9 @@ class ChassisControllerBuilder {
 
   bool hasOdom{false}; // Whether odometry was passed
   std::shared_ptr<Odometry> odometry;
+  std::shared_ptr<ContinuousRotarySensor> odomIMU;
+  double odomIMUTrust{IMUOdometry::defaultIMUTrust};
+  bool odomFuseOnlyFreshSamples{true};
   StateMode stateMode;
   QLength moveThreshold;
   QAngle turnThreshold;
@@ -492,6 +537,7 @@ class ChassisControllerBuilder {
   double maxVoltage{12000};
 
   bool isParentedToCurrentTask{true};
+  std::shared_ptr<ControlScheduler> scheduler{nullptr};
 
   std::shared_ptr<ChassisControllerPID> buildCCPID();
   std::shared_ptr<ChassisControllerIntegrated> buildCCI();
@@ -499,6 +545,7 @@ class ChassisControllerBuilder {
   buildDOCC(std::shared_ptr<ChassisController> chassisController);
 
   std::shared_ptr<ChassisModel> makeChassisModel();
+  void bufferMotors(const std::shared_ptr<MotorCommandBuffer> &ibuffer);
   std::shared_ptr<SkidSteerModel> makeSkidSteerModel();
   std::shared_ptr<XDriveModel> makeXDriveModel();
   std::shared_ptr<HDriveModel> makeHDriveModel();
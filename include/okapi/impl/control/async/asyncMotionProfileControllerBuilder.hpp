@@ -8,6 +8,7 @@
 #include "okapi/api/chassis/controller/chassisController.hpp"
 #include "okapi/api/control/async/asyncLinearMotionProfileController.hpp"
 #include "okapi/api/control/async/asyncMotionProfileController.hpp"
+#include "okapi/api/control/util/controlScheduler.hpp"
 #include "okapi/api/util/logging.hpp"
 #include "okapi/impl/device/motor/motor.hpp"
 #include "okapi/impl/device/motor/motorGroup.hpp"
@@ -99,6 +100,27 @@ class AsyncMotionProfileControllerBuilder {
    */
   AsyncMotionProfileControllerBuilder &withLimits(const PathfinderLimits &ilimits);
 
+  /**
+   * Sets the trajectory cache used by the AsyncMotionProfileController to skip generating paths
+   * which have been generated before. This can only be used with buildMotionProfileController().
+   * By default, paths are not cached.
+   *
+   * @param icache The trajectory cache.
+   * @return An ongoing builder.
+   */
+  AsyncMotionProfileControllerBuilder &
+  withTrajectoryCache(const std::shared_ptr<TrajectoryCache> &icache);
+
+  /**
+   * Sets the memory budget paths are stored under. The same budget can be given to several
+   * controllers so all of their paths count against one limit. By default, there is no limit.
+   *
+   * @param ibudget The path memory budget.
+   * @return An ongoing builder.
+   */
+  AsyncMotionProfileControllerBuilder &
+  withPathMemoryBudget(const std::shared_ptr<PathMemoryBudget> &ibudget);
+
   /**
    * Sets the TimeUtilFactory used when building the controller. The default is the static
    * TimeUtilFactory.
@@ -116,6 +138,20 @@ class AsyncMotionProfileControllerBuilder {
    */
   AsyncMotionProfileControllerBuilder &withLogger(const std::shared_ptr<Logger> &ilogger);
 
+  /**
+   * Runs the built controllers on a scheduler's task instead of starting a task for each of them.
+   * Controllers on a scheduler are not parented to the current task, so they keep running until
+   * they are deleted. The default is to start a task for each controller.
+   *
+   * Read more about this in the [builders and tasks tutorial]
+   * (docs/tutorials/concepts/builders-and-tasks.md).
+   *
+   * @param ischeduler The scheduler.
+   * @return An ongoing builder.
+   */
+  AsyncMotionProfileControllerBuilder &
+  withScheduler(const std::shared_ptr<ControlScheduler> &ischeduler);
+
   /**
    * Parents the internal tasks started by this builder to the current task, meaning they will be
    * deleted once the current task is deleted. The `initialize` and `competition_initialize` tasks
@@ -169,9 +205,12 @@ class AsyncMotionProfileControllerBuilder {
   std::shared_ptr<ChassisModel> model;
   ChassisScales scales{{1, 1}, imev5GreenTPR};
   AbstractMotor::GearsetRatioPair pair{AbstractMotor::gearset::invalid};
+  std::shared_ptr<TrajectoryCache> trajectoryCache{nullptr};
+  std::shared_ptr<PathMemoryBudget> pathMemoryBudget{nullptr};
   TimeUtilFactory timeUtilFactory = TimeUtilFactory();
   std::shared_ptr<Logger> controllerLogger = Logger::getDefaultLogger();
 
   bool isParentedToCurrentTask{true};
+  std::shared_ptr<ControlScheduler> scheduler{nullptr};
 };
 } // namespace okapi
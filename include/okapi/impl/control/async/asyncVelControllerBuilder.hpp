@@ -8,6 +8,7 @@
 #include "okapi/api/control/async/asyncVelIntegratedController.hpp"
 #include "okapi/api/control/async/asyncVelPidController.hpp"
 #include "okapi/api/control/async/asyncVelocityController.hpp"
+#include "okapi/api/control/util/controlScheduler.hpp"
 #include "okapi/api/util/logging.hpp"
 #include "okapi/impl/device/motor/motor.hpp"
 #include "okapi/impl/device/motor/motorGroup.hpp"
@@ -137,6 +138,19 @@ class AsyncVelControllerBuilder {
    */
   AsyncVelControllerBuilder &withLogger(const std::shared_ptr<Logger> &ilogger);
 
+  /**
+   * Runs the built controllers on a scheduler's task instead of starting a task for each of them.
+   * Controllers on a scheduler are not parented to the current task, so they keep running until
+   * they are deleted. The default is to start a task for each controller.
+   *
+   * Read more about this in the [builders and tasks tutorial]
+   * (docs/tutorials/concepts/builders-and-tasks.md).
+   *
+   * @param ischeduler The scheduler.
+   * @return An ongoing builder.
+   */
+  AsyncVelControllerBuilder &withScheduler(const std::shared_ptr<ControlScheduler> &ischeduler);
+
   /**
    * Parents the internal tasks started by this builder to the current task, meaning they will be
    * deleted once the current task is deleted. The `initialize` and `competition_initialize` tasks
@@ -196,6 +210,7 @@ class AsyncVelControllerBuilder {
   std::shared_ptr<Logger> controllerLogger = Logger::getDefaultLogger();
 
   bool isParentedToCurrentTask{true};
+  std::shared_ptr<ControlScheduler> scheduler{nullptr};
 
   std::shared_ptr<AsyncVelIntegratedController> buildAVIC();
   std::shared_ptr<AsyncVelPIDController> buildAVPC();
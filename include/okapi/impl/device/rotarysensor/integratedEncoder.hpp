@@ -8,6 +8,8 @@
 #include "api.h"
 #include "okapi/api/device/rotarysensor/continuousRotarySensor.hpp"
 #include "okapi/impl/device/motor/motor.hpp"
+#include <array>
+#include <atomic>
 
 namespace okapi {
 class IntegratedEncoder : public ContinuousRotarySensor {
@@ -27,6 +29,13 @@ class IntegratedEncoder : public ContinuousRotarySensor {
    */
   IntegratedEncoder(std::int8_t iport, bool ireversed = false);
 
+  /**
+   * Copies the port and direction. The copy finds where the motor was tared on its own.
+   *
+   * @param iother The encoder to copy.
+   */
+  IntegratedEncoder(const IntegratedEncoder &iother);
+
   /**
    * Get the current sensor value.
    *
@@ -41,6 +50,17 @@ class IntegratedEncoder : public ContinuousRotarySensor {
    */
   virtual std::int32_t reset() override;
 
+  /**
+   * Get the current sensor value along with the time the motor sampled it. Both come from one read
+   * of the motor's raw position. The raw position ignores tares, so the first read after
+   * construction or reset() also finds where the motor was tared. Tares made through other objects,
+   * such as Motor::tarePosition(), are not seen until then.
+   *
+   * @param timestamp Set to the motor's timestamp of the sample in ms, or `0` on a failure.
+   * @return the current sensor value, or ``PROS_ERR`` on a failure.
+   */
+  double getTimestamped(std::uint32_t *timestamp) const override;
+
   /**
    * Get the sensor value for use in a control loop. This method might be automatically called in
    * another thread by the controller.
@@ -49,8 +69,48 @@ class IntegratedEncoder : public ContinuousRotarySensor {
    */
   virtual double controllerGet() override;
 
+  /**
+   * Reads the gearing and encoder units of a motor again. Every IntegratedEncoder caches them per
+   * port, when it is constructed, so timestamped reads don't need to query them.
+   * Motor::setGearing() and Motor::setEncoderUnits() call this; call it after changing them in
+   * any other way.
+   *
+   * @param iport The motor's port number in the range [1, 21].
+   */
+  static void refreshCountsPerUnit(std::uint8_t iport);
+
   protected:
   std::uint8_t port;
   std::int8_t reversed{1};
+
+  // The raw position the motor's position is relative to, found by findZero()
+  mutable std::atomic<std::int32_t> zeroCounts{0};
+  mutable std::atomic_bool zeroKnown{false};
+
+  /**
+   * Finds the raw position the motor was tared at.
+   *
+   * @return Whether it was found.
+   */
+  bool findZero() const;
+
+  static constexpr std::uint8_t portCount = 21;
+
+  // The raw encoder counts per unit of each port's motor, set by refreshCountsPerUnit()
+  static std::array<std::atomic<double>, portCount> cachedCountsPerUnit;
+
+  /**
+   * @return The number of raw encoder counts per unit of the motor's encoder units, as cached by
+   * refreshCountsPerUnit().
+   */
+  double countsPerUnit() const;
+
+  /**
+   * Queries the motor for the number of raw encoder counts per unit of its encoder units.
+   *
+   * @param iport The motor's port number.
+   * @return The number of raw encoder counts per unit.
+   */
+  static double queryCountsPerUnit(std::uint8_t iport);
 };
 } // namespace okapi
@@ -18,5 +18,12 @@ class Timer : public AbstractTimer {
    * @return the current time
    */
   QTime millis() const override;
+
+  /**
+   * Returns the current time in units of QTime, read from the brain's microsecond clock.
+   *
+   * @return the current time
+   */
+  QTime micros() const override;
 };
 } // namespace okapi
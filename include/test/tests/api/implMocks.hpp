@@ -33,7 +33,10 @@ class MockContinuousRotarySensor : public ContinuousRotarySensor {
 
   double get() const override;
 
+  double getTimestamped(std::uint32_t *itimestamp) const override;
+
   mutable std::int32_t value{0};
+  std::uint32_t timestamp{0};
 };
 
 /**
@@ -251,6 +254,8 @@ class MockTimer : public AbstractTimer {
 
   QTime millis() const override;
 
+  QTime micros() const override;
+
   std::chrono::system_clock::time_point epoch = std::chrono::high_resolution_clock::from_time_t(0);
 };
 
@@ -290,6 +295,18 @@ class ConstantMockTimer : public AbstractTimer {
   QTime dtToReturn;
 };
 
+/**
+ * A timer mock whose time is set by the test. Keep a copy of the pointer to move the time.
+ */
+class ManualTimer : public AbstractTimer {
+  public:
+  explicit ManualTimer(std::shared_ptr<QTime> inow);
+
+  QTime millis() const override;
+
+  std::shared_ptr<QTime> now;
+};
+
 class MockRate : public AbstractRate {
   public:
   MockRate();
@@ -301,6 +318,20 @@ class MockRate : public AbstractRate {
   void delayUntil(uint32_t ims) override;
 };
 
+/**
+ * A rate which always oversleeps by a fixed amount, like a loop which does too much work.
+ */
+class LateMockRate : public MockRate {
+  public:
+  explicit LateMockRate(QTime ilateness);
+
+  void delayUntil(uint32_t ims) override;
+
+  using MockRate::delayUntil;
+
+  QTime lateness;
+};
+
 class MockControllerInput : public ControllerInput<double> {
   public:
   virtual ~MockControllerInput() = default;
@@ -324,6 +355,8 @@ TimeUtil createTimeUtil(const Supplier<std::unique_ptr<AbstractTimer>> &itimerSu
 
 TimeUtil createTimeUtil(const Supplier<std::unique_ptr<SettledUtil>> &isettledUtilSupplier);
 
+TimeUtil createTimeUtil(const Supplier<std::unique_ptr<AbstractRate>> &irateSupplier);
+
 class SimulatedSystem : public ControllerInput<double>, public ControllerOutput<double> {
   public:
   explicit SimulatedSystem(FlywheelSimulator &simulator);
@@ -570,9 +603,8 @@ class MockSkidSteerModel : public SkidSteerModel {
       rightEnc(irightMtr->getMockEncoder()) {
   }
 
-  std::valarray<std::int32_t> getSensorVals() const override {
-    return std::valarray<std::int32_t>{static_cast<int>(leftEnc->get()),
-                                       static_cast<int>(rightEnc->get())};
+  SensorValues getSensorValues() const override {
+    return readSensors();
   }
 
   void setSensorVals(std::int32_t left, std::int32_t right) {
@@ -580,6 +612,11 @@ class MockSkidSteerModel : public SkidSteerModel {
     rightEnc->value = right;
   }
 
+  void setSensorTimestamps(std::uint32_t left, std::uint32_t right) {
+    leftEnc->timestamp = left;
+    rightEnc->timestamp = right;
+  }
+
   std::shared_ptr<MockMotor> leftMtr;
   std::shared_ptr<MockMotor> rightMtr;
   std::shared_ptr<MockContinuousRotarySensor> leftEnc;
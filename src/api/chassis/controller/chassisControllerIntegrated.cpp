@@ -47,9 +47,6 @@ void ChassisControllerIntegrated::moveRaw(const double itarget) {
 }
 
 void ChassisControllerIntegrated::moveDistanceAsync(const QLength itarget) {
-  LOG_INFO("ChassisControllerIntegrated: moving " + std::to_string(itarget.convert(meter)) +
-           " meters");
-
   leftController->reset();
   rightController->reset();
   leftController->flipDisable(false);
@@ -57,7 +54,8 @@ void ChassisControllerIntegrated::moveDistanceAsync(const QLength itarget) {
 
   const double newTarget = itarget.convert(meter) * scales.straight * gearsetRatioPair.ratio;
 
-  LOG_INFO("ChassisControllerIntegrated: moving " + std::to_string(newTarget) + " motor ticks");
+  LOG_INFO_EVENT(
+    LogEvent::chassisControllerIntegratedMoveDistance, itarget.convert(meter), newTarget);
 
   leftController->setTarget(newTarget + leftController->getProcessValue());
   rightController->setTarget(newTarget + rightController->getProcessValue());
@@ -79,9 +77,6 @@ void ChassisControllerIntegrated::turnRaw(const double idegTarget) {
 }
 
 void ChassisControllerIntegrated::turnAngleAsync(const QAngle idegTarget) {
-  LOG_INFO("ChassisControllerIntegrated: turning " + std::to_string(idegTarget.convert(degree)) +
-           " degrees");
-
   leftController->reset();
   rightController->reset();
   leftController->flipDisable(false);
@@ -90,7 +85,8 @@ void ChassisControllerIntegrated::turnAngleAsync(const QAngle idegTarget) {
   const double newTarget =
     idegTarget.convert(degree) * scales.turn * gearsetRatioPair.ratio * boolToSign(normalTurns);
 
-  LOG_INFO("ChassisControllerIntegrated: turning " + std::to_string(newTarget) + " motor ticks");
+  LOG_INFO_EVENT(
+    LogEvent::chassisControllerIntegratedTurnAngle, idegTarget.convert(degree), newTarget);
 
   leftController->setTarget(newTarget + leftController->getProcessValue());
   rightController->setTarget(-1 * newTarget + rightController->getProcessValue());
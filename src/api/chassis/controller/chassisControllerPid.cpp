@@ -5,6 +5,7 @@
  */
 #include "okapi/api/chassis/controller/chassisControllerPid.hpp"
 #include "okapi/api/util/mathUtil.hpp"
+#include <algorithm>
 #include <cmath>
 #include <utility>
 
@@ -20,7 +21,9 @@ ChassisControllerPID::ChassisControllerPID(
   std::shared_ptr<Logger> ilogger)
   : logger(std::move(ilogger)),
     chassisModel(std::move(ichassisModel)),
+    sensors(chassisModel),
     timeUtil(std::move(itimeUtil)),
+    loopStats(timeUtil.getTimer(), LoopStats::defaultSummaryPeriod, logger),
     distancePid(std::move(idistanceController)),
     turnPid(std::move(iturnController)),
     anglePid(std::move(iangleController)),
@@ -38,75 +41,96 @@ ChassisControllerPID::ChassisControllerPID(
 
 ChassisControllerPID::~ChassisControllerPID() {
   dtorCalled.store(true, std::memory_order_release);
+  if (scheduler) {
+    scheduler->remove(schedulerSlot);
+    stop();
+  }
   delete task;
 }
 
 void ChassisControllerPID::loop() {
   LOG_INFO_S("Started ChassisControllerPID task.");
 
-  auto encStartVals = chassisModel->getSensorVals();
-  std::valarray<std::int32_t> encVals;
-  double distanceElapsed = 0, angleChange = 0;
-  modeType pastMode = none;
+  encStartVals = sensors->getSensorValues();
   auto rate = timeUtil.getRate();
 
   while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
-    /**
-     * doneLooping is set to false by moveDistanceAsync and turnAngleAsync and then set to true by
-     * waitUntilSettled
-     */
-    if (doneLooping.load(std::memory_order_acquire)) {
-      doneLoopingSeen.store(true, std::memory_order_release);
-    } else {
-      if (mode != pastMode || newMovement.load(std::memory_order_acquire)) {
-        encStartVals = chassisModel->getSensorVals();
-        newMovement.store(false, std::memory_order_release);
-      }
+    tick();
+    rate->delayUntil(threadSleepTime);
+  }
 
-      switch (mode) {
-      case distance:
-        encVals = chassisModel->getSensorVals() - encStartVals;
-        distanceElapsed = static_cast<double>((encVals[0] + encVals[1])) / 2.0;
-        angleChange = static_cast<double>(encVals[0] - encVals[1]);
+  stop();
 
-        distancePid->step(distanceElapsed);
-        anglePid->step(angleChange);
+  LOG_INFO_S("Stopped ChassisControllerPID task.");
+}
 
-        if (velocityMode) {
-          chassisModel->driveVector(distancePid->getOutput(), anglePid->getOutput());
-        } else {
-          chassisModel->driveVectorVoltage(distancePid->getOutput(), anglePid->getOutput());
-        }
+void ChassisControllerPID::tick() {
+  loopStats.tickStarted(threadSleepTime);
+
+  /**
+   * doneLooping is set to false by moveDistanceAsync and turnAngleAsync and then set to true by
+   * waitUntilSettled
+   */
+  if (doneLooping.load(std::memory_order_acquire)) {
+    // Only the first tick after waitUntilSettled() has anyone to wake
+    if (!doneLoopingSeen.exchange(true, std::memory_order_acq_rel)) {
+      settledSignal.notifyAll();
+    }
+  } else {
+    if (mode != pastMode || newMovement.load(std::memory_order_acquire)) {
+      encStartVals = sensors->getSensorValues();
+      newMovement.store(false, std::memory_order_release);
+      wasSettled = false;
+    }
+
+    SensorValues encVals;
+    double distanceElapsed = 0, angleChange = 0;
+    switch (mode) {
+    case distance:
+      encVals = sensors->getSensorValues() - encStartVals;
+      distanceElapsed = static_cast<double>((encVals[0] + encVals[1])) / 2.0;
+      angleChange = static_cast<double>(encVals[0] - encVals[1]);
 
-        break;
+      distancePid->step(distanceElapsed);
+      anglePid->step(angleChange);
 
-      case angle:
-        encVals = chassisModel->getSensorVals() - encStartVals;
-        angleChange = (encVals[0] - encVals[1]) / 2.0;
+      if (velocityMode) {
+        chassisModel->driveVector(distancePid->getOutput(), anglePid->getOutput());
+      } else {
+        chassisModel->driveVectorVoltage(distancePid->getOutput(), anglePid->getOutput());
+      }
 
-        turnPid->step(angleChange);
+      break;
 
-        if (velocityMode) {
-          chassisModel->driveVector(0, turnPid->getOutput());
-        } else {
-          chassisModel->driveVectorVoltage(0, turnPid->getOutput());
-        }
+    case angle:
+      encVals = sensors->getSensorValues() - encStartVals;
+      angleChange = (encVals[0] - encVals[1]) / 2.0;
 
-        break;
+      turnPid->step(angleChange);
 
-      default:
-        break;
+      if (velocityMode) {
+        chassisModel->driveVector(0, turnPid->getOutput());
+      } else {
+        chassisModel->driveVectorVoltage(0, turnPid->getOutput());
       }
 
-      pastMode = mode;
+      break;
+
+    default:
+      break;
     }
 
-    rate->delayUntil(threadSleepTime);
-  }
+    pastMode = mode;
 
-  stop();
+    // Wake the waiters when the movement settles, not on every tick after
+    const bool settled = isSettled();
+    if (settled && !wasSettled) {
+      settledSignal.notifyAll();
+    }
+    wasSettled = settled;
+  }
 
-  LOG_INFO_S("Stopped ChassisControllerPID task.");
+  loopStats.tickFinished();
 }
 
 void ChassisControllerPID::trampoline(void *context) {
@@ -116,9 +140,7 @@ void ChassisControllerPID::trampoline(void *context) {
 }
 
 void ChassisControllerPID::moveDistanceAsync(const QLength itarget) {
-  LOG_INFO("ChassisControllerPID: moving " + std::to_string(itarget.convert(meter)) + " meters");
-  LOG_DEBUG("ChassisControllerPID: straight " + std::to_string(scales.straight) + " ratio " +
-            std::to_string(gearsetRatioPair.ratio));
+  LOG_DEBUG_EVENT(LogEvent::chassisControllerPidScales, scales.straight, gearsetRatioPair.ratio);
 
   distancePid->reset();
   anglePid->reset();
@@ -126,10 +148,11 @@ void ChassisControllerPID::moveDistanceAsync(const QLength itarget) {
   anglePid->flipDisable(false);
   turnPid->flipDisable(true);
   mode = distance;
+  settledSignal.notifyAll();
 
   const double newTarget = itarget.convert(meter) * scales.straight * gearsetRatioPair.ratio;
 
-  LOG_INFO("ChassisControllerPID: moving " + std::to_string(newTarget) + " motor ticks");
+  LOG_INFO_EVENT(LogEvent::chassisControllerPidMoveDistance, itarget.convert(meter), newTarget);
 
   distancePid->setTarget(newTarget);
   anglePid->setTarget(0);
@@ -154,21 +177,19 @@ void ChassisControllerPID::moveRaw(const double itarget) {
 }
 
 void ChassisControllerPID::turnAngleAsync(const QAngle idegTarget) {
-  LOG_INFO("ChassisControllerPID: turning " + std::to_string(idegTarget.convert(degree)) +
-           " degrees");
-  LOG_DEBUG("ChassisControllerPID: scales.turn " + std::to_string(scales.turn) + " ratio " +
-            std::to_string(gearsetRatioPair.ratio));
+  LOG_DEBUG_EVENT(LogEvent::chassisControllerPidScales, scales.turn, gearsetRatioPair.ratio);
 
   turnPid->reset();
   turnPid->flipDisable(false);
   distancePid->flipDisable(true);
   anglePid->flipDisable(true);
   mode = angle;
+  settledSignal.notifyAll();
 
   const double newTarget =
     idegTarget.convert(degree) * scales.turn * gearsetRatioPair.ratio * boolToSign(normalTurns);
 
-  LOG_INFO("ChassisControllerPID: turning " + std::to_string(newTarget) + " motor ticks");
+  LOG_INFO_EVENT(LogEvent::chassisControllerPidTurnAngle, idegTarget.convert(degree), newTarget);
 
   turnPid->setTarget(newTarget);
 
@@ -209,24 +230,49 @@ bool ChassisControllerPID::isSettled() {
 }
 
 void ChassisControllerPID::waitUntilSettled() {
+  waitUntilSettledFor(CrossplatformSignal::forever);
+}
+
+bool ChassisControllerPID::waitUntilSettled(const QTime itimeout) {
+  return waitUntilSettledFor(
+    static_cast<std::uint32_t>(std::max(itimeout.convert(millisecond), 0.0)));
+}
+
+bool ChassisControllerPID::waitUntilSettledFor(const std::uint32_t itimeout) {
   LOG_INFO_S("ChassisControllerPID: Waiting to settle");
 
+  const auto timer = timeUtil.getTimer();
+  const auto remaining = [&]() {
+    if (itimeout == CrossplatformSignal::forever) {
+      return itimeout;
+    }
+
+    const double elapsed = timer->getDtFromStart().convert(millisecond);
+    return static_cast<std::uint32_t>(std::max(itimeout - elapsed, 0.0));
+  };
+
   bool completelySettled = false;
 
   while (!completelySettled) {
     switch (mode) {
     case distance:
-      completelySettled = waitForDistanceSettled();
+      completelySettled = waitForDistanceSettled(remaining());
       break;
 
     case angle:
-      completelySettled = waitForAngleSettled();
+      completelySettled = waitForAngleSettled(remaining());
       break;
 
     default:
       completelySettled = true;
       break;
     }
+
+    if (!completelySettled && remaining() == 0) {
+      // Leave the movement running so the caller can decide what to do
+      LOG_INFO_S("ChassisControllerPID: Timed out waiting to settle");
+      return false;
+    }
   }
 
   // Order here is important
@@ -235,51 +281,51 @@ void ChassisControllerPID::waitUntilSettled() {
   doneLoopingSeen.store(false, std::memory_order_release);
 
   // Wait for the thread to finish if it happens to be writing to motors
-  auto rate = timeUtil.getRate();
-  while (!doneLoopingSeen.load(std::memory_order_acquire)) {
-    rate->delayUntil(threadSleepTime);
-  }
+  settledSignal.waitUntil([this]() { return doneLoopingSeen.load(std::memory_order_acquire); });
 
   // Stop after the thread has run at least once
   stopAfterSettled();
 
   LOG_INFO_S("ChassisControllerPID: Done waiting to settle");
+  return true;
 }
 
-bool ChassisControllerPID::waitForDistanceSettled() {
+bool ChassisControllerPID::waitForDistanceSettled(const std::uint32_t itimeout) {
   LOG_INFO_S("ChassisControllerPID: Waiting to settle in distance mode");
 
-  auto rate = timeUtil.getRate();
-  while (!(distancePid->isSettled() && anglePid->isSettled())) {
-    if (mode == angle) {
-      // False will cause the loop to re-enter the switch
-      LOG_WARN_S("ChassisControllerPID: Mode changed to angle while waiting in distance!");
-      return false;
-    }
+  bool settled = false;
+  settledSignal.waitUntil(
+    [&]() {
+      settled = distancePid->isSettled() && anglePid->isSettled();
+      return settled || mode == angle;
+    },
+    itimeout);
 
-    rate->delayUntil(10_ms);
+  if (!settled && mode == angle) {
+    LOG_WARN_S("ChassisControllerPID: Mode changed to angle while waiting in distance!");
   }
 
-  // True will cause the loop to exit
-  return true;
+  // False will cause the loop to re-enter the switch or time out
+  return settled;
 }
 
-bool ChassisControllerPID::waitForAngleSettled() {
+bool ChassisControllerPID::waitForAngleSettled(const std::uint32_t itimeout) {
   LOG_INFO_S("ChassisControllerPID: Waiting to settle in angle mode");
 
-  auto rate = timeUtil.getRate();
-  while (!turnPid->isSettled()) {
-    if (mode == distance) {
-      // False will cause the loop to re-enter the switch
-      LOG_WARN_S("ChassisControllerPID: Mode changed to distance while waiting in angle!");
-      return false;
-    }
+  bool settled = false;
+  settledSignal.waitUntil(
+    [&]() {
+      settled = turnPid->isSettled();
+      return settled || mode == distance;
+    },
+    itimeout);
 
-    rate->delayUntil(10_ms);
+  if (!settled && mode == distance) {
+    LOG_WARN_S("ChassisControllerPID: Mode changed to distance while waiting in angle!");
   }
 
-  // True will cause the loop to exit
-  return true;
+  // False will cause the loop to re-enter the switch or time out
+  return settled;
 }
 
 void ChassisControllerPID::stopAfterSettled() {
@@ -322,10 +368,25 @@ void ChassisControllerPID::startThread() {
   }
 }
 
+void ChassisControllerPID::startThread(const std::shared_ptr<ControlScheduler> &ischeduler,
+                                       const int iorder) {
+  if (!task && !scheduler) {
+    encStartVals = chassisModel->getSensorValues();
+    scheduler = ischeduler;
+    sensors = scheduler->getSensorCache()->cache(chassisModel);
+    schedulerSlot =
+      scheduler->add([this]() { tick(); }, iorder, scheduler->getDivider(threadSleepTime));
+  }
+}
+
 CrossplatformThread *ChassisControllerPID::getThread() const {
   return task;
 }
 
+const LoopStats &ChassisControllerPID::getLoopStats() const {
+  return loopStats;
+}
+
 void ChassisControllerPID::stop() {
   LOG_INFO_S("ChassisControllerPID: Stopping");
 
@@ -14,6 +14,7 @@ OdomChassisController::OdomChassisController(TimeUtil itimeUtil,
                                              std::shared_ptr<Logger> ilogger)
   : logger(std::move(ilogger)),
     timeUtil(std::move(itimeUtil)),
+    loopStats(timeUtil.getTimer(), LoopStats::defaultSummaryPeriod, logger),
     moveThreshold(imoveThreshold),
     turnThreshold(iturnThreshold),
     odom(std::move(iodometry)),
@@ -22,6 +23,9 @@ OdomChassisController::OdomChassisController(TimeUtil itimeUtil,
 
 OdomChassisController::~OdomChassisController() {
   dtorCalled.store(true, std::memory_order_release);
+  if (scheduler) {
+    scheduler->remove(schedulerSlot);
+  }
   delete odomTask;
 }
 
@@ -59,6 +63,15 @@ void OdomChassisController::startOdomThread() {
   }
 }
 
+void OdomChassisController::startOdomThread(const std::shared_ptr<ControlScheduler> &ischeduler,
+                                            const int iorder) {
+  if (!odomTask && !scheduler) {
+    scheduler = ischeduler;
+    schedulerSlot = scheduler->add([this]() { tick(); }, iorder, scheduler->getDivider(10_ms));
+    odomTaskRunning = true;
+  }
+}
+
 void OdomChassisController::trampoline(void *context) {
   if (context) {
     static_cast<OdomChassisController *>(context)->loop();
@@ -71,7 +84,7 @@ void OdomChassisController::loop() {
 
   auto rate = timeUtil.getRate();
   while (!dtorCalled.load(std::memory_order_acquire) && !odomTask->notifyTake(0)) {
-    odom->step();
+    tick();
     rate->delayUntil(10_ms);
   }
 
@@ -79,10 +92,20 @@ void OdomChassisController::loop() {
   LOG_INFO_S("Stopped OdomChassisController task.");
 }
 
+void OdomChassisController::tick() {
+  loopStats.tickStarted(10_ms);
+  odom->step();
+  loopStats.tickFinished();
+}
+
 CrossplatformThread *OdomChassisController::getOdomThread() const {
   return odomTask;
 }
 
+const LoopStats &OdomChassisController::getLoopStats() const {
+  return loopStats;
+}
+
 std::shared_ptr<Odometry> OdomChassisController::getOdometry() {
   return odom;
 }
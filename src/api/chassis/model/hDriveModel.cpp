@@ -7,6 +7,7 @@
 #include "okapi/api/util/mathUtil.hpp"
 #include <algorithm>
 #include <utility>
+#include <typeinfo>
 
 namespace okapi {
 HDriveModel::HDriveModel(std::shared_ptr<AbstractMotor> ileftSideMotor,
@@ -258,10 +259,27 @@ void HDriveModel::middle(const double ispeed) {
   middleMotor->moveVelocity(static_cast<int16_t>(std::clamp(ispeed, -1.0, 1.0) * maxVelocity));
 }
 
+SensorValues HDriveModel::getSensorValues() const {
+  // A subclass may only override getSensorVals(), so only read the sensors directly when this is
+  // exactly a HDriveModel
+  if (typeid(*this) != typeid(HDriveModel)) {
+    return SensorValues(getSensorVals());
+  }
+
+  return readSensors();
+}
+
 std::valarray<std::int32_t> HDriveModel::getSensorVals() const {
-  return std::valarray<std::int32_t>{static_cast<std::int32_t>(leftSensor->get()),
-                                     static_cast<std::int32_t>(rightSensor->get()),
-                                     static_cast<std::int32_t>(middleSensor->get())};
+  return readSensors().toValarray();
+}
+
+SensorValues HDriveModel::readSensors() const {
+  std::uint32_t leftTime = 0, rightTime = 0, middleTime = 0;
+  SensorValues values{static_cast<std::int32_t>(leftSensor->getTimestamped(&leftTime)),
+                      static_cast<std::int32_t>(rightSensor->getTimestamped(&rightTime)),
+                      static_cast<std::int32_t>(middleSensor->getTimestamped(&middleTime))};
+  values.setTimestamp(SensorValues::oldestTimestamp({leftTime, rightTime, middleTime}));
+  return values;
 }
 
 void HDriveModel::resetSensors() {
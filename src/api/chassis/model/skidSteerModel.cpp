@@ -7,6 +7,7 @@
 #include "okapi/api/util/mathUtil.hpp"
 #include <algorithm>
 #include <utility>
+#include <typeinfo>
 
 namespace okapi {
 SkidSteerModel::SkidSteerModel(std::shared_ptr<AbstractMotor> ileftSideMotor,
@@ -180,9 +181,26 @@ void SkidSteerModel::right(const double ispeed) {
   rightSideMotor->moveVelocity(static_cast<int16_t>(std::clamp(ispeed, -1.0, 1.0) * maxVelocity));
 }
 
+SensorValues SkidSteerModel::getSensorValues() const {
+  // A subclass may only override getSensorVals(), so only read the sensors directly when this is
+  // exactly a SkidSteerModel
+  if (typeid(*this) != typeid(SkidSteerModel)) {
+    return SensorValues(getSensorVals());
+  }
+
+  return readSensors();
+}
+
 std::valarray<std::int32_t> SkidSteerModel::getSensorVals() const {
-  return std::valarray<std::int32_t>{static_cast<std::int32_t>(leftSensor->get()),
-                                     static_cast<std::int32_t>(rightSensor->get())};
+  return readSensors().toValarray();
+}
+
+SensorValues SkidSteerModel::readSensors() const {
+  std::uint32_t leftTime = 0, rightTime = 0;
+  SensorValues values{static_cast<std::int32_t>(leftSensor->getTimestamped(&leftTime)),
+                      static_cast<std::int32_t>(rightSensor->getTimestamped(&rightTime))};
+  values.setTimestamp(SensorValues::oldestTimestamp({leftTime, rightTime}));
+  return values;
 }
 
 void SkidSteerModel::resetSensors() {
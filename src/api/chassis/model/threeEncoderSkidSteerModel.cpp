@@ -4,6 +4,7 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include "okapi/api/chassis/model/threeEncoderSkidSteerModel.hpp"
+#include <typeinfo>
 
 namespace okapi {
 ThreeEncoderSkidSteerModel::ThreeEncoderSkidSteerModel(
@@ -23,11 +24,28 @@ ThreeEncoderSkidSteerModel::ThreeEncoderSkidSteerModel(
     middleSensor(std::move(imiddleEnc)) {
 }
 
+SensorValues ThreeEncoderSkidSteerModel::getSensorValues() const {
+  // A subclass may only override getSensorVals(), so only read the sensors directly when this is
+  // exactly a ThreeEncoderSkidSteerModel
+  if (typeid(*this) != typeid(ThreeEncoderSkidSteerModel)) {
+    return SensorValues(getSensorVals());
+  }
+
+  return readSensors();
+}
+
 std::valarray<std::int32_t> ThreeEncoderSkidSteerModel::getSensorVals() const {
-  // Return the middle sensor last so this is compatible with SkidSteerModel::getSensorVals()
-  return std::valarray<std::int32_t>{static_cast<std::int32_t>(leftSensor->get()),
-                                     static_cast<std::int32_t>(rightSensor->get()),
-                                     static_cast<std::int32_t>(middleSensor->get())};
+  return readSensors().toValarray();
+}
+
+SensorValues ThreeEncoderSkidSteerModel::readSensors() const {
+  // Return the middle sensor last so this is compatible with SkidSteerModel::readSensors()
+  std::uint32_t leftTime = 0, rightTime = 0, middleTime = 0;
+  SensorValues values{static_cast<std::int32_t>(leftSensor->getTimestamped(&leftTime)),
+                      static_cast<std::int32_t>(rightSensor->getTimestamped(&rightTime)),
+                      static_cast<std::int32_t>(middleSensor->getTimestamped(&middleTime))};
+  values.setTimestamp(SensorValues::oldestTimestamp({leftTime, rightTime, middleTime}));
+  return values;
 }
 
 void ThreeEncoderSkidSteerModel::resetSensors() {
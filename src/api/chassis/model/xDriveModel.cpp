@@ -6,6 +6,7 @@
 #include "okapi/api/chassis/model/xDriveModel.hpp"
 #include "okapi/api/util/mathUtil.hpp"
 #include <utility>
+#include <typeinfo>
 
 namespace okapi {
 XDriveModel::XDriveModel(std::shared_ptr<AbstractMotor> itopLeftMotor,
@@ -298,9 +299,26 @@ void XDriveModel::right(const double ispeed) {
   bottomRightMotor->moveVelocity(static_cast<int16_t>(speed * maxVelocity));
 }
 
+SensorValues XDriveModel::getSensorValues() const {
+  // A subclass may only override getSensorVals(), so only read the sensors directly when this is
+  // exactly a XDriveModel
+  if (typeid(*this) != typeid(XDriveModel)) {
+    return SensorValues(getSensorVals());
+  }
+
+  return readSensors();
+}
+
 std::valarray<std::int32_t> XDriveModel::getSensorVals() const {
-  return std::valarray<std::int32_t>{static_cast<std::int32_t>(leftSensor->get()),
-                                     static_cast<std::int32_t>(rightSensor->get())};
+  return readSensors().toValarray();
+}
+
+SensorValues XDriveModel::readSensors() const {
+  std::uint32_t leftTime = 0, rightTime = 0;
+  SensorValues values{static_cast<std::int32_t>(leftSensor->getTimestamped(&leftTime)),
+                      static_cast<std::int32_t>(rightSensor->getTimestamped(&rightTime))};
+  values.setTimestamp(SensorValues::oldestTimestamp({leftTime, rightTime}));
+  return values;
 }
 
 void XDriveModel::resetSensors() {
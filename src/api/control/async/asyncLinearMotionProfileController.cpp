@@ -5,6 +5,7 @@
  */
 #include "okapi/api/control/async/asyncLinearMotionProfileController.hpp"
 #include "okapi/api/util/mathUtil.hpp"
+#include <algorithm>
 #include <mutex>
 #include <numeric>
 
@@ -21,7 +22,10 @@ AsyncLinearMotionProfileController::AsyncLinearMotionProfileController(
     output(ioutput),
     diameter(idiameter),
     pair(ipair),
-    timeUtil(itimeUtil) {
+    timeUtil(itimeUtil),
+    loopStats(timeUtil.getTimer(), LoopStats::defaultSummaryPeriod, logger),
+    generator(std::make_unique<PathGenerationQueue>(
+      itimeUtil, "AsyncLinearMotionProfileController generator", ilogger)) {
   if (ipair.ratio == 0) {
     std::string msg(
       "AsyncLinearMotionProfileController: The gear ratio cannot be zero! Check if you are "
@@ -34,8 +38,15 @@ AsyncLinearMotionProfileController::AsyncLinearMotionProfileController(
 AsyncLinearMotionProfileController::~AsyncLinearMotionProfileController() {
   dtorCalled.store(true, std::memory_order_release);
 
+  // Stop following paths before freeing them
+  if (scheduler) {
+    scheduler->remove(schedulerSlot);
+  }
+
+  // Stop generating paths before freeing them
+  generator.reset();
+
   // Free paths before deleting the task
-  std::scoped_lock lock(currentPathMutex);
   paths.clear();
 
   delete task;
@@ -49,11 +60,55 @@ void AsyncLinearMotionProfileController::generatePath(std::initializer_list<QLen
 void AsyncLinearMotionProfileController::generatePath(std::initializer_list<QLength> iwaypoints,
                                                       const std::string &ipathId,
                                                       const PathfinderLimits &ilimits) {
-  if (iwaypoints.size() == 0) {
+  internalGeneratePath(iwaypoints, ipathId, ilimits);
+}
+
+std::shared_ptr<PathGenerationHandle>
+AsyncLinearMotionProfileController::generatePathAsync(std::initializer_list<QLength> iwaypoints,
+                                                      const std::string &ipathId) {
+  return generatePathAsync(iwaypoints, ipathId, limits);
+}
+
+std::shared_ptr<PathGenerationHandle>
+AsyncLinearMotionProfileController::generatePathAsync(std::initializer_list<QLength> iwaypoints,
+                                                      const std::string &ipathId,
+                                                      const PathfinderLimits &ilimits) {
+  // Copy the waypoints because the initializer list won't outlive this call
+  return generator->submit(
+    ipathId, [this, waypoints = std::vector<QLength>(iwaypoints), ipathId, ilimits]() {
+      if (!internalGeneratePath(waypoints, ipathId, ilimits)) {
+        throw std::runtime_error("The path was not saved. Check the log for the reason.");
+      }
+    });
+}
+
+std::vector<PathGenerationResult> AsyncLinearMotionProfileController::generatePaths(
+  const std::vector<LinearPathGenerationJob> &ijobs,
+  const std::size_t iworkers) {
+  std::vector<PathGenerationPool::Job> jobs;
+  jobs.reserve(ijobs.size());
+  for (const auto &job : ijobs) {
+    auto generate = [this, &job]() {
+      if (!internalGeneratePath(job.waypoints, job.pathId, job.limits.value_or(limits))) {
+        throw std::runtime_error("The path was not saved. Check the log for the reason.");
+      }
+    };
+    jobs.push_back(PathGenerationPool::Job{job.pathId, generate});
+  }
+
+  PathGenerationPool pool(timeUtil, iworkers, "AsyncLinearMotionProfileController batch", logger);
+  return pool.run(jobs);
+}
+
+bool AsyncLinearMotionProfileController::internalGeneratePath(
+  const std::vector<QLength> &iwaypoints,
+  const std::string &ipathId,
+  const PathfinderLimits &ilimits) {
+  if (iwaypoints.empty()) {
     // No point in generating a path
     LOG_WARN_S("AsyncLinearMotionProfileController: Not generating a path because no "
                "waypoints were given.");
-    return;
+    return false;
   }
 
   std::vector<squiggles::Pose> points;
@@ -69,13 +124,13 @@ void AsyncLinearMotionProfileController::generatePath(std::initializer_list<QLen
     squiggles::SplineGenerator(constraints, std::make_shared<squiggles::PassthroughModel>(), 0.01);
   auto path = splineGenerator.generate(points);
 
-  // Free the old path before overwriting it
-  forceRemovePath(ipathId);
-
-  paths.emplace(ipathId, path);
+  LOG_DEBUG("AsyncLinearMotionProfileController: Path length: " + std::to_string(path.size()));
+  if (!insertPath(ipathId, compilePath(path))) {
+    return false;
+  }
 
   LOG_INFO("AsyncLinearMotionProfileController: Completely done generating path " + ipathId);
-  LOG_DEBUG("AsyncLinearMotionProfileController: Path length: " + std::to_string(path.size()));
+  return true;
 }
 
 std::string
@@ -104,12 +159,7 @@ bool AsyncLinearMotionProfileController::removePath(const std::string &ipathId)
     return false;
   }
 
-  std::scoped_lock lock(currentPathMutex);
-
-  auto oldPath = paths.find(ipathId);
-  if (oldPath != paths.end()) {
-    paths.erase(ipathId);
-  }
+  paths.erase(ipathId);
 
   /*
    * A return value of true provides no feedback about whether the
@@ -120,13 +170,7 @@ bool AsyncLinearMotionProfileController::removePath(const std::string &ipathId)
 }
 
 std::vector<std::string> AsyncLinearMotionProfileController::getPaths() {
-  std::vector<std::string> keys;
-
-  for (const auto &path : paths) {
-    keys.push_back(path.first);
-  }
-
-  return keys;
+  return paths.getIds();
 }
 
 void AsyncLinearMotionProfileController::setTarget(std::string ipathId) {
@@ -137,6 +181,9 @@ void AsyncLinearMotionProfileController::setTarget(std::string ipathId, const bo
   LOG_INFO("AsyncLinearMotionProfileController: Set target to: " + ipathId + " (ibackwards" +
            std::to_string(ibackwards) + ")");
 
+  // Only blocks if the path was queued with generatePathAsync() and isn't ready yet
+  generator->waitForPath(ipathId);
+
   currentPath = ipathId;
   direction.store(boolToSign(!ibackwards), std::memory_order_release);
   isRunning.store(true, std::memory_order_release);
@@ -165,19 +212,9 @@ void AsyncLinearMotionProfileController::loop() {
 
   while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
     if (isRunning.load(std::memory_order_acquire) && !isDisabled()) {
-      LOG_INFO("AsyncLinearMotionProfileController: Running with path: " + currentPath);
-
-      auto path = paths.find(currentPath);
-
-      if (path == paths.end()) {
-        LOG_WARN(
-          "AsyncLinearMotionProfileController: Target was set to non-existent path with name: " +
-          currentPath);
-      } else {
-        LOG_DEBUG("AsyncLinearMotionProfileController: Path length is " +
-                  std::to_string(path->second.size()));
-
-        executeSinglePath(path->second, timeUtil.getRate());
+      // Holding this reference keeps the path alive even if it is removed while it is followed
+      if (const auto path = findTargetPath()) {
+        executeSinglePath(*path, timeUtil.getRate());
 
         // Set 0 after the path because:
         // 1. We only support an exit velocity of zero
@@ -188,6 +225,7 @@ void AsyncLinearMotionProfileController::loop() {
       }
 
       isRunning.store(false, std::memory_order_release);
+      settledSignal.notifyAll();
     }
 
     rate->delayUntil(10_ms);
@@ -196,31 +234,147 @@ void AsyncLinearMotionProfileController::loop() {
   LOG_INFO_S("Stopped AsyncLinearMotionProfileController task.");
 }
 
-void AsyncLinearMotionProfileController::executeSinglePath(
-  const std::vector<squiggles::ProfilePoint> &path,
-  std::unique_ptr<AbstractRate> rate) {
-  const auto reversed = direction.load(std::memory_order_acquire);
+void AsyncLinearMotionProfileController::tick() {
+  if (!scheduledProgress) {
+    if (!isRunning.load(std::memory_order_acquire) || isDisabled()) {
+      return;
+    }
+
+    scheduledPath = findTargetPath();
+    if (!scheduledPath) {
+      isRunning.store(false, std::memory_order_release);
+      settledSignal.notifyAll();
+      return;
+    }
+
+    scheduledProgress.emplace(beginPath(*scheduledPath));
+  }
+
+  if (isDisabled() || !followPath(*scheduledProgress)) {
+    endPath(*scheduledProgress);
+    scheduledProgress.reset();
+    scheduledPath.reset();
+
+    // Set 0 after the path because:
+    // 1. We only support an exit velocity of zero
+    // 2. Because of (1), we should make sure the system is stopped
+    output->controllerSet(0);
+
+    LOG_INFO_S("AsyncLinearMotionProfileController: Done moving");
+    isRunning.store(false, std::memory_order_release);
+    settledSignal.notifyAll();
+  }
+}
+
+std::shared_ptr<const ExecutionPlan> AsyncLinearMotionProfileController::findTargetPath() {
+  LOG_INFO("AsyncLinearMotionProfileController: Running with path: " + currentPath);
+
+  auto path = paths.find(currentPath);
+  if (!path) {
+    LOG_WARN("AsyncLinearMotionProfileController: Target was set to non-existent path with name: " +
+             currentPath);
+  } else {
+    LOG_DEBUG("AsyncLinearMotionProfileController: Path length is " + std::to_string(path->size()));
+  }
+
+  return path;
+}
+
+void AsyncLinearMotionProfileController::executeSinglePath(const ExecutionPlan &path,
+                                                           std::unique_ptr<AbstractRate> rate) {
+  auto progress = beginPath(path);
+  while (!isDisabled() && followPath(progress)) {
+    rate->delayUntil(10_ms);
+  }
+  endPath(progress);
+}
 
-  std::scoped_lock pathLock(currentPathMutex);
-  // store this locally so we aren't accessing the path when we don't know if it's valid
-  std::size_t pathSize = path.size();
-  currentPathMutex.unlock();
-  for (std::size_t i = 0; i < pathSize && !isDisabled(); ++i) {
-    // This mutex is used to combat an edge case of an edge case
-    // if a running path is asked to be removed at the moment this loop is executing
-    std::scoped_lock lock(currentPathMutex);
+AsyncLinearMotionProfileController::PathProgress
+AsyncLinearMotionProfileController::beginPath(const ExecutionPlan &path) {
+  maxLag.store(0, std::memory_order_release);
 
-    const auto segDT = path[i].time * millisecond;
-    currentProfilePosition = path[i].vector.pose.x;
+  // The task was idle before this path, so that period isn't one of the loop's
+  loopStats.ignoreNextPeriod();
 
-    const auto motorRPM = convertLinearToRotational(path[i].vector.vel * mps).convert(rpm);
-    output->controllerSet(motorRPM / toUnderlyingType(pair.internalGearset) * reversed);
+  PathProgress progress{&path, timeUtil.getTimer()};
+  progress.start = progress.timer->millis();
+  progress.lastIteration = progress.start;
+  progress.reversed = direction.load(std::memory_order_acquire);
+  return progress;
+}
 
-    // Unlock before the delay to be nice to other tasks
-    currentPathMutex.unlock();
+bool AsyncLinearMotionProfileController::followPath(PathProgress &iprogress) {
+  const ExecutionPlan &path = *iprogress.path;
+  const auto segDT = 10_ms;
 
-    rate->delayUntil(segDT);
+  loopStats.tickStarted(segDT);
+  const QTime now = iprogress.timer->millis();
+  const double lag = (now - iprogress.lastIteration - segDT).convert(second);
+  if (lag > maxLag.load(std::memory_order_acquire)) {
+    maxLag.store(lag, std::memory_order_release);
   }
+  iprogress.lastIteration = now;
+
+  // Sample by the time since the path started so a late iteration skips ahead
+  const auto sample = iprogress.sampler.sample((now - iprogress.start).convert(second),
+                                               path.size(),
+                                               [&path](std::size_t i) { return path.getTime(i); });
+  if (!sample) {
+    // The path is done, but this was still a tick
+    loopStats.tickFinished();
+    return false;
+  }
+
+  const double position = path.getPose(sample->index).x;
+  currentProfilePosition = position + (path.getPose(sample->next).x - position) * sample->fraction;
+  const double command =
+    path.getLeftCommand(sample->index) +
+    (path.getLeftCommand(sample->next) - path.getLeftCommand(sample->index)) * sample->fraction;
+
+  output->controllerSet(command * iprogress.reversed);
+
+  loopStats.tickFinished();
+  return true;
+}
+
+void AsyncLinearMotionProfileController::endPath(const PathProgress &iprogress) {
+  const auto skippedPoints = iprogress.sampler.getSkippedPoints();
+  if (skippedPoints > 0) {
+    LOG_WARN("AsyncLinearMotionProfileController: Skipped " + std::to_string(skippedPoints) +
+             " points because the loop ran late. The maximum lag was " +
+             std::to_string(maxLag.load() * 1000) + " ms.");
+  }
+}
+
+ExecutionPlan AsyncLinearMotionProfileController::compilePath(
+  const std::vector<squiggles::ProfilePoint> &ipath) const {
+  return ExecutionPlan::compile(ipath,
+                                convertLinearToRotational(1_mps).convert(rpm) /
+                                  toUnderlyingType(pair.internalGearset));
+}
+
+bool AsyncLinearMotionProfileController::insertPath(const std::string &ipathId,
+                                                    ExecutionPlan iplan) {
+  if (!pathMemoryBudget) {
+    forceRemovePath(ipathId);
+    paths.insert(ipathId, std::move(iplan));
+    return true;
+  }
+
+  const std::size_t size = iplan.getMemoryUsage();
+  auto path = pathMemoryBudget->admit(std::move(iplan));
+  if (!path) {
+    LOG_WARN("AsyncLinearMotionProfileController: Not saving path " + ipathId +
+             " because it needs " + std::to_string(size) + " bytes and only " +
+             std::to_string(pathMemoryBudget->getLimit() - pathMemoryBudget->getUsage()) +
+             " bytes of the path memory budget are free.");
+    return false;
+  }
+
+  // Only replace the old path once the new one has been admitted
+  forceRemovePath(ipathId);
+  paths.insert(ipathId, std::move(path));
+  return true;
 }
 
 QAngularSpeed AsyncLinearMotionProfileController::convertLinearToRotational(QSpeed linear) const {
@@ -235,15 +389,20 @@ void AsyncLinearMotionProfileController::trampoline(void *context) {
 
 void AsyncLinearMotionProfileController::waitUntilSettled() {
   LOG_INFO_S("AsyncLinearMotionProfileController: Waiting to settle");
-
-  auto rate = timeUtil.getRate();
-  while (!isSettled()) {
-    rate->delayUntil(10_ms);
-  }
-
+  settledSignal.waitUntil([this]() { return isSettled(); });
   LOG_INFO_S("AsyncLinearMotionProfileController: Done waiting to settle");
 }
 
+bool AsyncLinearMotionProfileController::waitUntilSettled(const QTime itimeout) {
+  LOG_INFO_S("AsyncLinearMotionProfileController: Waiting to settle");
+  const bool settled = settledSignal.waitUntil(
+    [this]() { return isSettled(); },
+    static_cast<std::uint32_t>(std::max(itimeout.convert(millisecond), 0.0)));
+  LOG_INFO("AsyncLinearMotionProfileController: Done waiting to settle, settled: " +
+           std::to_string(settled));
+  return settled;
+}
+
 void AsyncLinearMotionProfileController::moveTo(const QLength &iposition,
                                                 const QLength &itarget,
                                                 bool ibackwards) {
@@ -266,11 +425,11 @@ void AsyncLinearMotionProfileController::moveTo(const QLength &iposition,
 }
 
 double AsyncLinearMotionProfileController::getError() const {
-  if (const auto path = paths.find(getTarget()); path == paths.end()) {
+  if (const auto path = paths.find(getTarget()); !path || path->empty()) {
     return 0;
   } else {
     // The last position in the path is the target position
-    return path->second.back().vector.pose.x - currentProfilePosition;
+    return path->getPose(path->size() - 1).x - currentProfilePosition;
   }
 }
 
@@ -284,10 +443,7 @@ void AsyncLinearMotionProfileController::reset() {
 
   LOG_INFO_S("AsyncLinearMotionProfileController: Waiting to reset");
 
-  auto rate = timeUtil.getRate();
-  while (isRunning.load(std::memory_order_acquire)) {
-    rate->delayUntil(1_ms);
-  }
+  settledSignal.waitUntil([this]() { return !isRunning.load(std::memory_order_acquire); });
 
   flipDisable(false);
 }
@@ -299,6 +455,7 @@ void AsyncLinearMotionProfileController::flipDisable() {
 void AsyncLinearMotionProfileController::flipDisable(const bool iisDisabled) {
   LOG_INFO("AsyncLinearMotionProfileController: flipDisable " + std::to_string(iisDisabled));
   disabled.store(iisDisabled, std::memory_order_release);
+  settledSignal.notifyAll();
   // loop() will set the output to 0 when executeSinglePath() is done
   // the default implementation of executeSinglePath() breaks when disabled
 }
@@ -313,16 +470,47 @@ void AsyncLinearMotionProfileController::startThread() {
   }
 }
 
+void AsyncLinearMotionProfileController::startThread(
+  const std::shared_ptr<ControlScheduler> &ischeduler, const int iorder) {
+  if (!task && !scheduler) {
+    scheduler = ischeduler;
+    schedulerSlot = scheduler->add([this]() { tick(); }, iorder, scheduler->getDivider(10_ms));
+  }
+}
+
 CrossplatformThread *AsyncLinearMotionProfileController::getThread() const {
   return task;
 }
 
+const LoopStats &AsyncLinearMotionProfileController::getLoopStats() const {
+  return loopStats;
+}
+
 void AsyncLinearMotionProfileController::tarePosition() {
 }
 
 void AsyncLinearMotionProfileController::setMaxVelocity(std::int32_t) {
 }
 
+QTime AsyncLinearMotionProfileController::getMaxLag() const {
+  return maxLag.load(std::memory_order_acquire) * second;
+}
+
+void AsyncLinearMotionProfileController::setPathMemoryBudget(
+  const std::shared_ptr<PathMemoryBudget> &ibudget) {
+  pathMemoryBudget = ibudget;
+}
+
+std::shared_ptr<PathMemoryBudget> AsyncLinearMotionProfileController::getPathMemoryBudget() const {
+  return pathMemoryBudget;
+}
+
+std::size_t
+AsyncLinearMotionProfileController::getPathMemoryUsage(const std::string &ipathId) const {
+  const auto path = paths.find(ipathId);
+  return path ? path->getMemoryUsage() : 0;
+}
+
 void AsyncLinearMotionProfileController::forceRemovePath(const std::string &ipathId) {
   if (!removePath(ipathId)) {
     LOG_WARN("AsyncLinearMotionProfileController: Disabling controller to remove path " + ipathId);
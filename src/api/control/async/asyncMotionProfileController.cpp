@@ -25,7 +25,10 @@ AsyncMotionProfileController::AsyncMotionProfileController(
     model(imodel),
     scales(iscales),
     pair(ipair),
-    timeUtil(itimeUtil) {
+    timeUtil(itimeUtil),
+    loopStats(timeUtil.getTimer(), LoopStats::defaultSummaryPeriod, logger),
+    generator(std::make_unique<PathGenerationQueue>(
+      itimeUtil, "AsyncMotionProfileController generator", ilogger)) {
   if (ipair.ratio == 0) {
     std::string msg("AsyncMotionProfileController: The gear ratio cannot be zero! Check if you are "
                     "using integer division.");
@@ -37,8 +40,15 @@ AsyncMotionProfileController::AsyncMotionProfileController(
 AsyncMotionProfileController::~AsyncMotionProfileController() {
   dtorCalled.store(true, std::memory_order_release);
 
+  // Stop following paths before freeing them
+  if (scheduler) {
+    scheduler->remove(schedulerSlot);
+  }
+
+  // Stop generating paths before freeing them
+  generator.reset();
+
   // Free paths before deleting the task
-  std::scoped_lock lock(currentPathMutex);
   paths.clear();
 
   delete task;
@@ -52,11 +62,153 @@ void AsyncMotionProfileController::generatePath(std::initializer_list<Pathfinder
 void AsyncMotionProfileController::generatePath(std::initializer_list<PathfinderPoint> iwaypoints,
                                                 const std::string &ipathId,
                                                 const PathfinderLimits &ilimits) {
-  if (iwaypoints.size() == 0) {
+  internalGeneratePath(iwaypoints, ipathId, ilimits);
+}
+
+std::shared_ptr<PathGenerationHandle>
+AsyncMotionProfileController::generatePathAsync(std::initializer_list<PathfinderPoint> iwaypoints,
+                                                const std::string &ipathId) {
+  return generatePathAsync(iwaypoints, ipathId, limits);
+}
+
+std::shared_ptr<PathGenerationHandle>
+AsyncMotionProfileController::generatePathAsync(std::initializer_list<PathfinderPoint> iwaypoints,
+                                                const std::string &ipathId,
+                                                const PathfinderLimits &ilimits) {
+  // Copy the waypoints because the initializer list won't outlive this call
+  return generator->submit(
+    ipathId, [this, waypoints = std::vector<PathfinderPoint>(iwaypoints), ipathId, ilimits]() {
+      if (!internalGeneratePath(waypoints, ipathId, ilimits)) {
+        throw std::runtime_error("The path was not saved. Check the log for the reason.");
+      }
+    });
+}
+
+std::vector<PathGenerationResult> AsyncMotionProfileController::generatePaths(
+  const std::vector<PathGenerationJob> &ijobs,
+  const std::size_t iworkers) {
+  std::vector<PathGenerationPool::Job> jobs;
+  jobs.reserve(ijobs.size());
+  for (const auto &job : ijobs) {
+    auto generate = [this, &job]() {
+      if (!internalGeneratePath(job.waypoints, job.pathId, job.limits.value_or(limits))) {
+        throw std::runtime_error("The path was not saved. Check the log for the reason.");
+      }
+    };
+    jobs.push_back(PathGenerationPool::Job{job.pathId, generate});
+  }
+
+  PathGenerationPool pool(timeUtil, iworkers, "AsyncMotionProfileController batch", logger);
+  return pool.run(jobs);
+}
+
+bool AsyncMotionProfileController::internalGeneratePath(
+  const std::vector<PathfinderPoint> &iwaypoints,
+  const std::string &ipathId,
+  const PathfinderLimits &ilimits) {
+  if (iwaypoints.empty()) {
     // No point in generating a path
     LOG_WARN_S(
       "AsyncMotionProfileController: Not generating a path because no waypoints were given.");
-    return;
+    return false;
+  }
+
+  const auto path = generateTrajectory(iwaypoints, ilimits, 0, 0);
+
+  auto plan = compilePath(path);
+  plan.setLimits(ilimits);
+  if (!insertPath(ipathId, std::move(plan))) {
+    return false;
+  }
+
+  LOG_INFO("AsyncMotionProfileController: Completely done generating path " + ipathId);
+  LOG_DEBUG("AsyncMotionProfileController: Path length: " + std::to_string(path.size()));
+  return true;
+}
+
+bool AsyncMotionProfileController::generatePathChain(
+  const std::vector<PathChainSegment> &isegments,
+  const std::string &ipathId) {
+  return generatePathChain(isegments, ipathId, limits, limits.maxVel);
+}
+
+bool AsyncMotionProfileController::generatePathChain(
+  const std::vector<PathChainSegment> &isegments,
+  const std::string &ipathId,
+  const PathfinderLimits &ilimits,
+  const double ijunctionVelocity) {
+  if (isegments.empty()) {
+    // No point in generating a path
+    LOG_WARN_S(
+      "AsyncMotionProfileController: Not generating a path chain because no segments were given.");
+    return false;
+  }
+
+  std::vector<squiggles::ProfilePoint> chain;
+  double startVel = 0;
+  double timeOffset = 0;
+  for (std::size_t i = 0; i < isegments.size(); ++i) {
+    const auto &segment = isegments[i];
+    if (segment.waypoints.empty()) {
+      LOG_WARN("AsyncMotionProfileController: Skipping segment " + std::to_string(i) +
+               " of path chain " + ipathId + " because it has no waypoints.");
+      continue;
+    }
+
+    // Keep moving into the next segment unless the robot has to turn around for it
+    const bool continues =
+      i + 1 < isegments.size() && isegments[i + 1].backwards == segment.backwards;
+    const double endVel = continues ? ijunctionVelocity : 0;
+
+    const auto trajectory = generateTrajectory(segment.waypoints, ilimits, startVel, endVel);
+    const double sign = segment.backwards ? -1 : 1;
+    for (auto point : trajectory) {
+      point.vector.vel *= sign;
+      point.vector.accel *= sign;
+      point.vector.jerk *= sign;
+      for (auto &wheelVelocity : point.wheel_velocities) {
+        wheelVelocity *= sign;
+      }
+      point.time += timeOffset;
+      chain.push_back(std::move(point));
+    }
+
+    if (!chain.empty()) {
+      timeOffset = chain.back().time + DT;
+    }
+    startVel = endVel;
+  }
+
+  if (chain.empty()) {
+    LOG_WARN("AsyncMotionProfileController: Not generating path chain " + ipathId +
+             " because none of its segments have waypoints.");
+    return false;
+  }
+
+  auto plan = compilePath(chain);
+  plan.setLimits(ilimits);
+  if (!insertPath(ipathId, std::move(plan))) {
+    return false;
+  }
+
+  LOG_INFO("AsyncMotionProfileController: Completely done generating path chain " + ipathId);
+  LOG_DEBUG("AsyncMotionProfileController: Path length: " + std::to_string(chain.size()));
+  return true;
+}
+
+std::vector<squiggles::ProfilePoint>
+AsyncMotionProfileController::generateTrajectory(const std::vector<PathfinderPoint> &iwaypoints,
+                                                 const PathfinderLimits &ilimits,
+                                                 const double istartVel,
+                                                 const double iendVel) {
+  std::uint64_t cacheKey = 0;
+  if (trajectoryCache) {
+    cacheKey =
+      TrajectoryCache::makeKey(iwaypoints, ilimits, scales.wheelTrack, DT, istartVel, iendVel);
+    if (const auto cachedPath = trajectoryCache->get(cacheKey)) {
+      LOG_INFO_S("AsyncMotionProfileController: Using cached trajectory");
+      return *cachedPath;
+    }
   }
 
   std::vector<squiggles::Pose> points;
@@ -73,15 +225,28 @@ void AsyncMotionProfileController::generatePath(std::initializer_list<Pathfinder
     constraints,
     std::make_shared<squiggles::TankModel>(scales.wheelTrack.convert(meter), constraints),
     DT);
-  auto path = splineGenerator.generate(points);
 
-  // Free the old path before overwriting it
-  forceRemovePath(ipathId);
+  std::vector<squiggles::ProfilePoint> path;
+  if (istartVel == 0 && iendVel == 0) {
+    path = splineGenerator.generate(points);
+  } else {
+    // Control vectors let the ends of the path have a velocity
+    std::vector<squiggles::ControlVector> vectors;
+    vectors.reserve(points.size());
+    for (const auto &point : points) {
+      vectors.emplace_back(point);
+    }
+    vectors.front().vel = istartVel;
+    vectors.back().vel = iendVel;
 
-  paths.insert({ipathId, path});
+    path = splineGenerator.generate(vectors);
+  }
 
-  LOG_INFO("AsyncMotionProfileController: Completely done generating path " + ipathId);
-  LOG_DEBUG("AsyncMotionProfileController: Path length: " + std::to_string(path.size()));
+  if (trajectoryCache) {
+    trajectoryCache->put(cacheKey, path, BinaryPath::makeHeader(0, DT, ilimits, scales));
+  }
+
+  return path;
 }
 
 std::string
@@ -109,12 +274,7 @@ bool AsyncMotionProfileController::removePath(const std::string &ipathId) {
     return false;
   }
 
-  std::scoped_lock lock(currentPathMutex);
-
-  auto oldPath = paths.find(ipathId);
-  if (oldPath != paths.end()) {
-    paths.erase(ipathId);
-  }
+  paths.erase(ipathId);
 
   // A return value of true provides no feedback about whether the path was actually removed but
   // instead tells us that the path does not exist at this moment
@@ -122,13 +282,7 @@ bool AsyncMotionProfileController::removePath(const std::string &ipathId) {
 }
 
 std::vector<std::string> AsyncMotionProfileController::getPaths() {
-  std::vector<std::string> keys;
-
-  for (const auto &path : paths) {
-    keys.push_back(path.first);
-  }
-
-  return keys;
+  return paths.getIds();
 }
 
 void AsyncMotionProfileController::setTarget(std::string ipathId) {
@@ -141,6 +295,9 @@ void AsyncMotionProfileController::setTarget(std::string ipathId,
   LOG_INFO("AsyncMotionProfileController: Set target to: " + ipathId + " (ibackwards=" +
            std::to_string(ibackwards) + ", imirrored=" + std::to_string(imirrored) + ")");
 
+  // Only blocks if the path was queued with generatePathAsync() and isn't ready yet
+  generator->waitForPath(ipathId);
+
   currentPath = ipathId;
   direction.store(boolToSign(!ibackwards), std::memory_order_release);
   mirrored.store(imirrored, std::memory_order_release);
@@ -166,17 +323,9 @@ void AsyncMotionProfileController::loop() {
 
   while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
     if (isRunning.load(std::memory_order_acquire) && !isDisabled()) {
-      LOG_INFO("AsyncMotionProfileController: Running with path: " + currentPath);
-
-      auto path = paths.find(currentPath);
-      if (path == paths.end()) {
-        LOG_WARN("AsyncMotionProfileController: Target was set to non-existent path with name: " +
-                 currentPath);
-      } else {
-        LOG_DEBUG("AsyncMotionProfileController: Path length is " +
-                  std::to_string(path->second.size()));
-
-        executeSinglePath(path->second, timeUtil.getRate());
+      // Holding this reference keeps the path alive even if it is removed while it is followed
+      if (const auto path = findTargetPath()) {
+        executeSinglePath(*path, timeUtil.getRate());
 
         // Stop the chassis after the path because:
         // 1. We only support an exit velocity of zero
@@ -187,6 +336,7 @@ void AsyncMotionProfileController::loop() {
       }
 
       isRunning.store(false, std::memory_order_release);
+      settledSignal.notifyAll();
     }
 
     rate->delayUntil(10_ms);
@@ -195,40 +345,150 @@ void AsyncMotionProfileController::loop() {
   LOG_INFO_S("Stopped AsyncMotionProfileController task.");
 }
 
-void AsyncMotionProfileController::executeSinglePath(
-  const std::vector<squiggles::ProfilePoint> &path,
-  std::unique_ptr<AbstractRate> rate) {
-  const int reversed = direction.load(std::memory_order_acquire);
-  const bool followMirrored = mirrored.load(std::memory_order_acquire);
-
-  currentPathMutex.lock();
-  // store this locally so we aren't accessing the path when we don't know if it's valid
-  std::size_t pathSize = path.size();
-  currentPathMutex.unlock();
-  for (std::size_t i = 0; i < pathSize && !isDisabled(); ++i) {
-    // This mutex is used to combat an edge case of an edge case
-    // if a running path is asked to be removed at the moment this loop is executing
-    std::scoped_lock lock(currentPathMutex);
-
-    const auto segDT = DT * second;
-    const auto leftRPM = convertLinearToRotational(path[i].wheel_velocities[0] * mps).convert(rpm);
-    const auto rightRPM = convertLinearToRotational(path[i].wheel_velocities[1] * mps).convert(rpm);
-
-    const double rightSpeed = rightRPM / toUnderlyingType(pair.internalGearset) * reversed;
-    const double leftSpeed = leftRPM / toUnderlyingType(pair.internalGearset) * reversed;
-    if (followMirrored) {
-      model->left(rightSpeed);
-      model->right(leftSpeed);
-    } else {
-      model->left(leftSpeed);
-      model->right(rightSpeed);
+void AsyncMotionProfileController::tick() {
+  if (!scheduledProgress) {
+    if (!isRunning.load(std::memory_order_acquire) || isDisabled()) {
+      return;
     }
 
-    // Unlock before the delay to be nice to other tasks
-    currentPathMutex.unlock();
+    scheduledPath = findTargetPath();
+    if (!scheduledPath) {
+      isRunning.store(false, std::memory_order_release);
+      settledSignal.notifyAll();
+      return;
+    }
+
+    scheduledProgress.emplace(beginPath(*scheduledPath));
+  }
+
+  if (isDisabled() || !followPath(*scheduledProgress)) {
+    endPath(*scheduledProgress);
+    scheduledProgress.reset();
+    scheduledPath.reset();
+
+    // Stop the chassis after the path because:
+    // 1. We only support an exit velocity of zero
+    // 2. Because of (1), we should make sure the system is stopped
+    model->stop();
+
+    LOG_INFO_S("AsyncMotionProfileController: Done moving");
+    isRunning.store(false, std::memory_order_release);
+    settledSignal.notifyAll();
+  }
+}
+
+std::shared_ptr<const ExecutionPlan> AsyncMotionProfileController::findTargetPath() {
+  LOG_INFO("AsyncMotionProfileController: Running with path: " + currentPath);
+
+  auto path = paths.find(currentPath);
+  if (!path) {
+    LOG_WARN("AsyncMotionProfileController: Target was set to non-existent path with name: " +
+             currentPath);
+  } else {
+    LOG_DEBUG("AsyncMotionProfileController: Path length is " + std::to_string(path->size()));
+  }
+
+  return path;
+}
+
+void AsyncMotionProfileController::executeSinglePath(const ExecutionPlan &path,
+                                                     std::unique_ptr<AbstractRate> rate) {
+  auto progress = beginPath(path);
+  while (!isDisabled() && followPath(progress)) {
+    rate->delayUntil(DT * second);
+  }
+  endPath(progress);
+}
+
+AsyncMotionProfileController::PathProgress
+AsyncMotionProfileController::beginPath(const ExecutionPlan &path) {
+  maxLag.store(0, std::memory_order_release);
+
+  // The task was idle before this path, so that period isn't one of the loop's
+  loopStats.ignoreNextPeriod();
+
+  PathProgress progress{&path, timeUtil.getTimer()};
+  progress.start = progress.timer->millis();
+  progress.lastIteration = progress.start;
+  progress.reversed = direction.load(std::memory_order_acquire);
+  progress.mirrored = mirrored.load(std::memory_order_acquire);
+  return progress;
+}
+
+bool AsyncMotionProfileController::followPath(PathProgress &iprogress) {
+  const ExecutionPlan &path = *iprogress.path;
+  const auto segDT = DT * second;
+
+  loopStats.tickStarted(segDT);
+  const QTime now = iprogress.timer->millis();
+  const double lag = (now - iprogress.lastIteration - segDT).convert(second);
+  if (lag > maxLag.load(std::memory_order_acquire)) {
+    maxLag.store(lag, std::memory_order_release);
+  }
+  iprogress.lastIteration = now;
+
+  // Sample by the time since the path started so a late iteration skips ahead
+  const auto sample = iprogress.sampler.sample((now - iprogress.start).convert(second),
+                                               path.size(),
+                                               [&path](std::size_t i) { return path.getTime(i); });
+  if (!sample) {
+    // The path is done, but this was still a tick
+    loopStats.tickFinished();
+    return false;
+  }
 
-    rate->delayUntil(segDT);
+  const double left =
+    path.getLeftCommand(sample->index) +
+    (path.getLeftCommand(sample->next) - path.getLeftCommand(sample->index)) * sample->fraction;
+  const double right =
+    path.getRightCommand(sample->index) +
+    (path.getRightCommand(sample->next) - path.getRightCommand(sample->index)) * sample->fraction;
+
+  // Following the path mirrored just swaps which side gets which commands
+  model->left((iprogress.mirrored ? right : left) * iprogress.reversed);
+  model->right((iprogress.mirrored ? left : right) * iprogress.reversed);
+
+  loopStats.tickFinished();
+  return true;
+}
+
+void AsyncMotionProfileController::endPath(const PathProgress &iprogress) {
+  const auto skippedPoints = iprogress.sampler.getSkippedPoints();
+  if (skippedPoints > 0) {
+    LOG_WARN("AsyncMotionProfileController: Skipped " + std::to_string(skippedPoints) +
+             " points because the loop ran late. The maximum lag was " +
+             std::to_string(maxLag.load() * 1000) + " ms.");
+  }
+}
+
+bool AsyncMotionProfileController::insertPath(const std::string &ipathId, ExecutionPlan iplan) {
+  if (!pathMemoryBudget) {
+    forceRemovePath(ipathId);
+    paths.insert(ipathId, std::move(iplan));
+    return true;
+  }
+
+  const std::size_t size = iplan.getMemoryUsage();
+  auto path = pathMemoryBudget->admit(std::move(iplan));
+  if (!path) {
+    LOG_WARN("AsyncMotionProfileController: Not saving path " + ipathId + " because it needs " +
+             std::to_string(size) + " bytes and only " +
+             std::to_string(pathMemoryBudget->getLimit() - pathMemoryBudget->getUsage()) +
+             " bytes of the path memory budget are free.");
+    return false;
   }
+
+  // Only replace the old path once the new one has been admitted
+  forceRemovePath(ipathId);
+  paths.insert(ipathId, std::move(path));
+  return true;
+}
+
+ExecutionPlan
+AsyncMotionProfileController::compilePath(const std::vector<squiggles::ProfilePoint> &ipath) const {
+  return ExecutionPlan::compile(ipath,
+                                convertLinearToRotational(1_mps).convert(rpm) /
+                                  toUnderlyingType(pair.internalGearset));
 }
 
 QAngularSpeed AsyncMotionProfileController::convertLinearToRotational(QSpeed linear) const {
@@ -243,15 +503,20 @@ void AsyncMotionProfileController::trampoline(void *context) {
 
 void AsyncMotionProfileController::waitUntilSettled() {
   LOG_INFO_S("AsyncMotionProfileController: Waiting to settle");
-
-  auto rate = timeUtil.getRate();
-  while (!isSettled()) {
-    rate->delayUntil(10_ms);
-  }
-
+  settledSignal.waitUntil([this]() { return isSettled(); });
   LOG_INFO_S("AsyncMotionProfileController: Done waiting to settle");
 }
 
+bool AsyncMotionProfileController::waitUntilSettled(const QTime itimeout) {
+  LOG_INFO_S("AsyncMotionProfileController: Waiting to settle");
+  const bool settled = settledSignal.waitUntil(
+    [this]() { return isSettled(); },
+    static_cast<std::uint32_t>(std::max(itimeout.convert(millisecond), 0.0)));
+  LOG_INFO("AsyncMotionProfileController: Done waiting to settle, settled: " +
+           std::to_string(settled));
+  return settled;
+}
+
 void AsyncMotionProfileController::moveTo(std::initializer_list<PathfinderPoint> iwaypoints,
                                           bool ibackwards,
                                           bool imirrored) {
@@ -284,10 +549,7 @@ void AsyncMotionProfileController::reset() {
 
   LOG_INFO_S("AsyncMotionProfileController: Waiting to reset");
 
-  auto rate = timeUtil.getRate();
-  while (isRunning.load(std::memory_order_acquire)) {
-    rate->delayUntil(1_ms);
-  }
+  settledSignal.waitUntil([this]() { return !isRunning.load(std::memory_order_acquire); });
 
   flipDisable(false);
 }
@@ -299,6 +561,7 @@ void AsyncMotionProfileController::flipDisable() {
 void AsyncMotionProfileController::flipDisable(const bool iisDisabled) {
   LOG_INFO("AsyncMotionProfileController: flipDisable " + std::to_string(iisDisabled));
   disabled.store(iisDisabled, std::memory_order_release);
+  settledSignal.notifyAll();
   // loop() will stop the chassis when executeSinglePath() is done
   // the default implementation of executeSinglePath() breaks when disabled
 }
@@ -319,10 +582,23 @@ void AsyncMotionProfileController::startThread() {
   }
 }
 
+void AsyncMotionProfileController::startThread(
+  const std::shared_ptr<ControlScheduler> &ischeduler, const int iorder) {
+  if (!task && !scheduler) {
+    scheduler = ischeduler;
+    schedulerSlot =
+      scheduler->add([this]() { tick(); }, iorder, scheduler->getDivider(DT * second));
+  }
+}
+
 CrossplatformThread *AsyncMotionProfileController::getThread() const {
   return task;
 }
 
+const LoopStats &AsyncMotionProfileController::getLoopStats() const {
+  return loopStats;
+}
+
 void AsyncMotionProfileController::storePath(const std::string &idirectory,
                                              const std::string &ipathId) {
   std::string filePath = makeFilePath(idirectory, ipathId + ".csv");
@@ -340,8 +616,40 @@ void AsyncMotionProfileController::storePath(const std::string &idirectory,
   file.close();
 }
 
+void AsyncMotionProfileController::storeBinaryPath(const std::string &idirectory,
+                                                   const std::string &ipathId) {
+  std::string filePath = makeFilePath(idirectory, ipathId + ".bin");
+  std::ofstream file;
+  file.open(filePath, std::ofstream::out | std::ofstream::binary);
+
+  // Make sure we can open the file successfully
+  if (!file.good()) {
+    LOG_WARN("AsyncMotionProfileController: Couldn't open file " + filePath + " for writing");
+    return;
+  }
+
+  internalStoreBinaryPath(file, ipathId);
+
+  file.close();
+}
+
 void AsyncMotionProfileController::loadPath(const std::string &idirectory,
                                             const std::string &ipathId) {
+  std::string binaryPath = makeFilePath(idirectory, ipathId + ".bin");
+  std::ifstream binaryPathFile;
+  binaryPathFile.open(binaryPath, std::ifstream::in | std::ifstream::binary);
+  if (binaryPathFile.good()) {
+    // give preference to a binary path because it is the fastest to load
+    const bool loaded = internalLoadBinaryPath(binaryPathFile, ipathId);
+    binaryPathFile.close();
+    if (loaded) {
+      return;
+    }
+
+    LOG_WARN("AsyncMotionProfileController: Couldn't load binary path " + binaryPath +
+             ", falling back to CSV");
+  }
+
   std::string squigglesPath = makeFilePath(idirectory, ipathId + ".csv");
   std::ifstream squigglesPathFile;
   squigglesPathFile.open(squigglesPath, std::ifstream::in);
@@ -381,33 +689,72 @@ void AsyncMotionProfileController::loadPath(const std::string &idirectory,
 
 void AsyncMotionProfileController::internalStorePath(std::ostream &file,
                                                      const std::string &ipathId) {
-  auto pathData = this->paths.find(ipathId);
+  const auto pathData = paths.find(ipathId);
 
   // Make sure path exists
-  if (pathData == paths.end()) {
+  if (!pathData) {
     LOG_WARN("AsyncMotionProfileController: Controller was asked to serialize non-existent path " +
              ipathId);
     // Do nothing- can't serialize nonexistent path
   } else {
-    squiggles::serialize_path(file, pathData->second);
+    squiggles::serialize_path(file, pathData->toProfilePoints());
   }
 }
 
-void AsyncMotionProfileController::internalLoadPath(std::istream &file,
+void AsyncMotionProfileController::internalStoreBinaryPath(std::ostream &file,
+                                                           const std::string &ipathId) {
+  const auto pathData = paths.find(ipathId);
+
+  // Make sure path exists
+  if (!pathData) {
+    LOG_WARN("AsyncMotionProfileController: Controller was asked to serialize non-existent path " +
+             ipathId);
+    // Do nothing- can't serialize nonexistent path
+  } else if (!BinaryPath::write(
+               file,
+               BinaryPath::makeHeader(0, DT, pathData->getLimits().value_or(limits), scales),
+               pathData->toProfilePoints())) {
+    LOG_WARN("AsyncMotionProfileController: Couldn't write binary path " + ipathId);
+  }
+}
+
+bool AsyncMotionProfileController::internalLoadBinaryPath(std::istream &file,
+                                                          const std::string &ipathId) {
+  BinaryPathHeader header;
+  auto records = BinaryPath::read(file, header, logger);
+  if (!records) {
+    return false;
+  }
+
+  if (header.dt != static_cast<float>(DT)) {
+    LOG_WARN("AsyncMotionProfileController: Binary path " + ipathId +
+             " was generated with a dt of " + std::to_string(header.dt) +
+             " but this controller runs with a dt of " + std::to_string(DT));
+  }
+
+  if (header.wheelTrack != static_cast<float>(scales.wheelTrack.convert(meter))) {
+    LOG_WARN("AsyncMotionProfileController: Binary path " + ipathId +
+             " was generated for a different wheel track");
+  }
+
+  auto plan = compilePath(BinaryPath::toProfilePoints(records.value()));
+  plan.setLimits({header.maxVel, header.maxAccel, header.maxJerk});
+  return insertPath(ipathId, std::move(plan));
+}
+
+bool AsyncMotionProfileController::internalLoadPath(std::istream &file,
                                                     const std::string &ipathId) {
 
   auto path = squiggles::deserialize_path(file);
-  forceRemovePath(ipathId);
-  paths.emplace(ipathId, path.value());
+  return insertPath(ipathId, compilePath(path.value()));
 }
 
-void AsyncMotionProfileController::internalLoadPathfinderPath(std::istream &leftFile,
+bool AsyncMotionProfileController::internalLoadPathfinderPath(std::istream &leftFile,
                                                               std::istream &rightFile,
                                                               const std::string &ipathId) {
 
   auto path = squiggles::deserialize_pathfinder_path(leftFile, rightFile);
-  forceRemovePath(ipathId);
-  paths.emplace(ipathId, path.value());
+  return insertPath(ipathId, compilePath(path.value()));
 }
 
 std::string AsyncMotionProfileController::makeFilePath(const std::string &directory,
@@ -447,6 +794,33 @@ std::string AsyncMotionProfileController::makeFilePath(const std::string &direct
   return path;
 }
 
+void AsyncMotionProfileController::setTrajectoryCache(
+  const std::shared_ptr<TrajectoryCache> &icache) {
+  trajectoryCache = icache;
+}
+
+std::shared_ptr<TrajectoryCache> AsyncMotionProfileController::getTrajectoryCache() const {
+  return trajectoryCache;
+}
+
+void AsyncMotionProfileController::setPathMemoryBudget(
+  const std::shared_ptr<PathMemoryBudget> &ibudget) {
+  pathMemoryBudget = ibudget;
+}
+
+std::shared_ptr<PathMemoryBudget> AsyncMotionProfileController::getPathMemoryBudget() const {
+  return pathMemoryBudget;
+}
+
+std::size_t AsyncMotionProfileController::getPathMemoryUsage(const std::string &ipathId) const {
+  const auto path = paths.find(ipathId);
+  return path ? path->getMemoryUsage() : 0;
+}
+
+QTime AsyncMotionProfileController::getMaxLag() const {
+  return maxLag.load(std::memory_order_acquire) * second;
+}
+
 void AsyncMotionProfileController::forceRemovePath(const std::string &ipathId) {
   if (!removePath(ipathId)) {
     LOG_WARN("AsyncMotionProfileController: Disabling controller to remove path " + ipathId);
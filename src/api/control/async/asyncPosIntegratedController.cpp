@@ -30,7 +30,7 @@ AsyncPosIntegratedController::AsyncPosIntegratedController(
 }
 
 void AsyncPosIntegratedController::setTarget(const double itarget) {
-  LOG_INFO("AsyncPosIntegratedController: Set target to " + std::to_string(itarget));
+  LOG_INFO_EVENT(LogEvent::asyncPosIntegratedSetTarget, itarget);
 
   hasFirstTarget = true;
 
@@ -68,7 +68,7 @@ void AsyncPosIntegratedController::flipDisable() {
 }
 
 void AsyncPosIntegratedController::flipDisable(const bool iisDisabled) {
-  LOG_INFO("AsyncPosIntegratedController: flipDisable " + std::to_string(iisDisabled));
+  LOG_INFO_EVENT(LogEvent::asyncPosIntegratedFlipDisable, iisDisabled);
   controllerIsDisabled = iisDisabled;
   resumeMovement();
 }
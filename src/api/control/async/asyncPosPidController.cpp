@@ -49,7 +49,7 @@ AsyncPosPIDController::AsyncPosPIDController(
                                                   ikBias,
                                                   itimeUtil,
                                                   std::move(iderivativeFilter)),
-      itimeUtil.getRateSupplier(),
+      itimeUtil,
       iratio,
       ilogger),
     offsettableInput(iinput),
@@ -70,4 +70,12 @@ void AsyncPosPIDController::setGains(const IterativePosPIDController::Gains &iga
 IterativePosPIDController::Gains AsyncPosPIDController::getGains() const {
   return internalController->getGains();
 }
+
+void AsyncPosPIDController::setTelemetry(std::shared_ptr<ControllerTelemetry> itelemetry) {
+  internalController->setTelemetry(std::move(itelemetry));
+}
+
+std::shared_ptr<ControllerTelemetry> AsyncPosPIDController::getTelemetry() const {
+  return internalController->getTelemetry();
+}
 } // namespace okapi
@@ -36,7 +36,7 @@ void AsyncVelIntegratedController::setTarget(const double itarget) {
     boundedTarget = maxVelocity;
   }
 
-  LOG_INFO("AsyncVelIntegratedController: Set target to " + std::to_string(boundedTarget));
+  LOG_INFO_EVENT(LogEvent::asyncVelIntegratedSetTarget, boundedTarget);
 
   hasFirstTarget = true;
 
@@ -74,7 +74,7 @@ void AsyncVelIntegratedController::flipDisable() {
 }
 
 void AsyncVelIntegratedController::flipDisable(const bool iisDisabled) {
-  LOG_INFO("AsyncVelIntegratedController: flipDisable " + std::to_string(iisDisabled));
+  LOG_INFO_EVENT(LogEvent::asyncVelIntegratedFlipDisable, iisDisabled);
   controllerIsDisabled = iisDisabled;
   resumeMovement();
 }
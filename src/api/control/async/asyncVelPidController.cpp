@@ -29,7 +29,7 @@ AsyncVelPIDController::AsyncVelPIDController(
                                                   std::move(ivelMath),
                                                   itimeUtil,
                                                   std::move(iderivativeFilter)),
-      itimeUtil.getRateSupplier(),
+      itimeUtil,
       iratio,
       ilogger),
     internalController(std::static_pointer_cast<IterativeVelPIDController>(controller)) {
@@ -42,4 +42,12 @@ void AsyncVelPIDController::setGains(const IterativeVelPIDController::Gains &iga
 IterativeVelPIDController::Gains AsyncVelPIDController::getGains() const {
   return internalController->getGains();
 }
+
+void AsyncVelPIDController::setTelemetry(std::shared_ptr<ControllerTelemetry> itelemetry) {
+  internalController->setTelemetry(std::move(itelemetry));
+}
+
+std::shared_ptr<ControllerTelemetry> AsyncVelPIDController::getTelemetry() const {
+  return internalController->getTelemetry();
+}
 } // namespace okapi
@@ -40,7 +40,7 @@ IterativePosPIDController::IterativePosPIDController(const Gains &igains,
 }
 
 void IterativePosPIDController::setTarget(const double itarget) {
-  LOG_INFO("IterativePosPIDController: Set target to " + std::to_string(itarget));
+  LOG_INFO_EVENT(LogEvent::iterativePosPidSetTarget, itarget);
   target = itarget;
 }
 
@@ -148,6 +148,10 @@ double IterativePosPIDController::step(const double inewReading) {
       loopDtTimer->clearHardMark(); // Important that we only clear if dt >= sampleTime
 
       settledUtil->isSettled(error);
+
+      if (auto *const recorder = activeTelemetry.load(std::memory_order_acquire)) {
+        recorder->record(target, lastReading, error, integral, derivative, output);
+      }
     }
   }
 
@@ -174,7 +178,7 @@ void IterativePosPIDController::flipDisable() {
 }
 
 void IterativePosPIDController::flipDisable(const bool iisDisabled) {
-  LOG_INFO("IterativePosPIDController: flipDisable " + std::to_string(iisDisabled));
+  LOG_INFO_EVENT(LogEvent::iterativePosPidFlipDisable, iisDisabled);
   controllerIsDisabled = iisDisabled;
 }
 
@@ -217,6 +221,15 @@ IterativePosPIDController::Gains IterativePosPIDController::getGains() const {
   return {kP, kI / sampleTime.convert(second), kD * sampleTime.convert(second), kBias};
 }
 
+void IterativePosPIDController::setTelemetry(std::shared_ptr<ControllerTelemetry> itelemetry) {
+  activeTelemetry.store(itelemetry.get(), std::memory_order_release);
+  telemetry = std::move(itelemetry);
+}
+
+std::shared_ptr<ControllerTelemetry> IterativePosPIDController::getTelemetry() const {
+  return telemetry;
+}
+
 bool IterativePosPIDController::Gains::operator==(
   const IterativePosPIDController::Gains &rhs) const {
   return kP == rhs.kP && kI == rhs.kI && kD == rhs.kD && kBias == rhs.kBias;
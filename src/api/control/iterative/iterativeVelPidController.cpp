@@ -80,7 +80,9 @@ double IterativeVelPIDController::step(const double inewReading) {
   if (!controllerIsDisabled) {
     loopDtTimer->placeHardMark();
 
+    bool stepped = false;
     if (loopDtTimer->getDtFromHardMark() >= sampleTime) {
+      stepped = true;
       stepVel(inewReading);
       error = getError();
 
@@ -97,6 +99,13 @@ double IterativeVelPIDController::step(const double inewReading) {
 
     output =
       std::clamp(outputSum + kF * target + kSF * std::copysign(1.0, target), outputMin, outputMax);
+
+    if (stepped) {
+      if (auto *const recorder = activeTelemetry.load(std::memory_order_acquire)) {
+        recorder->record(target, getProcessValue(), error, outputSum, derivative, output);
+      }
+    }
+
     return output;
   }
 
@@ -104,7 +113,7 @@ double IterativeVelPIDController::step(const double inewReading) {
 }
 
 void IterativeVelPIDController::setTarget(const double itarget) {
-  LOG_INFO("IterativeVelPIDController: Set target to " + std::to_string(itarget));
+  LOG_INFO_EVENT(LogEvent::iterativeVelPidSetTarget, itarget);
   target = itarget;
 }
 
@@ -158,7 +167,7 @@ void IterativeVelPIDController::flipDisable() {
 }
 
 void IterativeVelPIDController::flipDisable(const bool iisDisabled) {
-  LOG_INFO("IterativeVelPIDController: flipDisable " + std::to_string(iisDisabled));
+  LOG_INFO_EVENT(LogEvent::iterativeVelPidFlipDisable, iisDisabled);
   controllerIsDisabled = iisDisabled;
 }
 
@@ -189,6 +198,15 @@ QTime IterativeVelPIDController::getSampleTime() const {
   return sampleTime;
 }
 
+void IterativeVelPIDController::setTelemetry(std::shared_ptr<ControllerTelemetry> itelemetry) {
+  activeTelemetry.store(itelemetry.get(), std::memory_order_release);
+  telemetry = std::move(itelemetry);
+}
+
+std::shared_ptr<ControllerTelemetry> IterativeVelPIDController::getTelemetry() const {
+  return telemetry;
+}
+
 bool IterativeVelPIDController::Gains::operator==(
   const IterativeVelPIDController::Gains &rhs) const {
   return kP == rhs.kP && kD == rhs.kD && kF == rhs.kF && kSF == rhs.kSF;
@@ -0,0 +1,180 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/binaryPath.hpp"
+#include "okapi/api/units/QLength.hpp"
+#include "okapi/api/util/byteOrder.hpp"
+
+namespace okapi {
+namespace {
+void convertLittleEndian(BinaryPathHeader &iheader) {
+  okapi::convertLittleEndian(iheader.magic);
+  okapi::convertLittleEndian(iheader.version);
+  okapi::convertLittleEndian(iheader.recordSize);
+  okapi::convertLittleEndian(iheader.count);
+  okapi::convertLittleEndian(iheader.checksum);
+  okapi::convertLittleEndian(iheader.dt);
+  okapi::convertLittleEndian(iheader.maxVel);
+  okapi::convertLittleEndian(iheader.maxAccel);
+  okapi::convertLittleEndian(iheader.maxJerk);
+  okapi::convertLittleEndian(iheader.wheelDiameter);
+  okapi::convertLittleEndian(iheader.wheelTrack);
+}
+} // namespace
+
+BinaryPathHeader BinaryPath::makeHeader(const std::size_t icount,
+                                        const double idt,
+                                        const PathfinderLimits &ilimits,
+                                        const ChassisScales &iscales) {
+  return BinaryPathHeader{magic,
+                          version,
+                          static_cast<std::uint16_t>(sizeof(BinaryPathRecord)),
+                          static_cast<std::uint32_t>(icount),
+                          0,
+                          static_cast<float>(idt),
+                          static_cast<float>(ilimits.maxVel),
+                          static_cast<float>(ilimits.maxAccel),
+                          static_cast<float>(ilimits.maxJerk),
+                          static_cast<float>(iscales.wheelDiameter.convert(meter)),
+                          static_cast<float>(iscales.wheelTrack.convert(meter))};
+}
+
+bool BinaryPath::write(std::ostream &ostream,
+                       BinaryPathHeader iheader,
+                       const std::vector<squiggles::ProfilePoint> &ipath) {
+  std::vector<BinaryPathRecord> records;
+  records.reserve(ipath.size());
+  for (const auto &point : ipath) {
+    const auto &vector = point.vector;
+    const bool hasWheels = point.wheel_velocities.size() >= 2;
+    records.push_back(
+      BinaryPathRecord{static_cast<float>(vector.pose.x),
+                       static_cast<float>(vector.pose.y),
+                       static_cast<float>(vector.pose.yaw),
+                       static_cast<float>(vector.vel),
+                       static_cast<float>(vector.accel),
+                       static_cast<float>(vector.jerk),
+                       static_cast<float>(point.curvature),
+                       static_cast<float>(point.time),
+                       hasWheels ? static_cast<float>(point.wheel_velocities[0]) : 0.0f,
+                       hasWheels ? static_cast<float>(point.wheel_velocities[1]) : 0.0f});
+  }
+
+  // Every field of a record is a float, so the records can be converted as 32-bit words
+  const std::size_t recordsSize = records.size() * sizeof(BinaryPathRecord);
+  convertLittleEndianWords(records.data(), recordsSize);
+
+  iheader.magic = magic;
+  iheader.version = version;
+  iheader.recordSize = sizeof(BinaryPathRecord);
+  iheader.count = static_cast<std::uint32_t>(records.size());
+  iheader.checksum = checksum(records.data(), recordsSize);
+  convertLittleEndian(iheader);
+
+  ostream.write(reinterpret_cast<const char *>(&iheader), sizeof(BinaryPathHeader));
+  ostream.write(reinterpret_cast<const char *>(records.data()),
+                static_cast<std::streamsize>(recordsSize));
+  return ostream.good();
+}
+
+std::optional<std::vector<BinaryPathRecord>>
+BinaryPath::read(std::istream &istream,
+                 BinaryPathHeader &oheader,
+                 const std::shared_ptr<Logger> &logger) {
+  if (!istream.read(reinterpret_cast<char *>(&oheader), sizeof(BinaryPathHeader))) {
+    LOG_WARN_S("BinaryPath: The file is too short to contain a header.");
+    return std::nullopt;
+  }
+  convertLittleEndian(oheader);
+
+  if (oheader.magic != magic) {
+    LOG_WARN_S("BinaryPath: The file is not a binary path.");
+    return std::nullopt;
+  }
+
+  if (oheader.version != version || oheader.recordSize != sizeof(BinaryPathRecord)) {
+    LOG_WARN("BinaryPath: Unsupported binary path version " + std::to_string(oheader.version) +
+             " (expected " + std::to_string(version) + ").");
+    return std::nullopt;
+  }
+
+  if (oheader.count > maxCount) {
+    LOG_WARN("BinaryPath: The file claims to contain " + std::to_string(oheader.count) +
+             " points, which is more than the maximum of " + std::to_string(maxCount) + ".");
+    return std::nullopt;
+  }
+
+  // Allocate the whole buffer up front and fill it with one read
+  std::vector<BinaryPathRecord> records(oheader.count);
+  const std::size_t recordsSize = records.size() * sizeof(BinaryPathRecord);
+  if (!istream.read(reinterpret_cast<char *>(records.data()),
+                    static_cast<std::streamsize>(recordsSize))) {
+    LOG_WARN_S("BinaryPath: The file is shorter than its header says.");
+    return std::nullopt;
+  }
+
+  if (checksum(records.data(), recordsSize) != oheader.checksum) {
+    LOG_WARN_S("BinaryPath: The checksum does not match. The file is corrupt.");
+    return std::nullopt;
+  }
+
+  convertLittleEndianWords(records.data(), recordsSize);
+  return records;
+}
+
+std::vector<squiggles::ProfilePoint>
+BinaryPath::toProfilePoints(const std::vector<BinaryPathRecord> &irecords) {
+  std::vector<squiggles::ProfilePoint> path;
+  path.reserve(irecords.size());
+  for (const auto &record : irecords) {
+    path.emplace_back(
+      squiggles::ControlVector(
+        squiggles::Pose(record.x, record.y, record.yaw), record.vel, record.accel, record.jerk),
+      std::vector<double>{record.leftVelocity, record.rightVelocity},
+      record.curvature,
+      record.time);
+  }
+
+  return path;
+}
+
+bool BinaryPath::convertSquigglesCSV(std::istream &icsv,
+                                     std::ostream &ostream,
+                                     const BinaryPathHeader &iheader,
+                                     const std::shared_ptr<Logger> &logger) {
+  const auto path = squiggles::deserialize_path(icsv);
+  if (!path) {
+    LOG_WARN_S("BinaryPath: Could not parse the Squiggles CSV path.");
+    return false;
+  }
+
+  return write(ostream, iheader, path.value());
+}
+
+bool BinaryPath::convertPathfinderCSV(std::istream &ileftCSV,
+                                      std::istream &irightCSV,
+                                      std::ostream &ostream,
+                                      const BinaryPathHeader &iheader,
+                                      const std::shared_ptr<Logger> &logger) {
+  const auto path = squiggles::deserialize_pathfinder_path(ileftCSV, irightCSV);
+  if (!path) {
+    LOG_WARN_S("BinaryPath: Could not parse the Pathfinder CSV paths.");
+    return false;
+  }
+
+  return write(ostream, iheader, path.value());
+}
+
+std::uint32_t BinaryPath::checksum(const void *idata, const std::size_t isize) {
+  const auto *bytes = static_cast<const std::uint8_t *>(idata);
+  std::uint32_t hash = 2166136261u;
+  for (std::size_t i = 0; i < isize; ++i) {
+    hash ^= bytes[i];
+    hash *= 16777619u;
+  }
+
+  return hash;
+}
+} // namespace okapi
@@ -0,0 +1,185 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/controlScheduler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace okapi {
+constexpr int ControlScheduler::senseOrder;
+constexpr int ControlScheduler::odometryOrder;
+constexpr int ControlScheduler::chassisOrder;
+constexpr int ControlScheduler::mechanismOrder;
+constexpr int ControlScheduler::actuateOrder;
+
+ControlScheduler::ControlScheduler(const TimeUtil &itimeUtil,
+                                   const QTime iperiod,
+                                   std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)),
+    timeUtil(itimeUtil),
+    period(iperiod),
+    loopStats(timeUtil.getTimer(), LoopStats::defaultSummaryPeriod, logger),
+    latencyTimer(timeUtil.getTimer()),
+    sensorCache(std::make_shared<SensorCache>(timeUtil.getTimer())),
+    commandBuffer(std::make_shared<MotorCommandBuffer>(logger)) {
+}
+
+ControlScheduler::~ControlScheduler() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+ControlScheduler::SlotId ControlScheduler::add(std::function<void()> istep,
+                                               const int iorder,
+                                               const std::uint32_t idivider) {
+  std::scoped_lock lock(slotsMutex);
+  const SlotId id = nextId++;
+
+  // Keep the slots sorted so a tick only has to walk them. Equal orders keep their insertion order.
+  const auto position = std::upper_bound(
+    slots.begin(), slots.end(), iorder, [](int order, const Slot &slot) {
+      return order < slot.order;
+    });
+  slots.insert(position, Slot{id, iorder, std::max<std::uint32_t>(idivider, 1), std::move(istep)});
+
+  LOG_INFO("ControlScheduler: Added step " + std::to_string(id) + " with order " +
+           std::to_string(iorder) + " every " + std::to_string(idivider) + " ticks.");
+  return id;
+}
+
+ControlScheduler::SlotId ControlScheduler::add(std::function<void()> istep,
+                                               const Stage istage,
+                                               const std::uint32_t idivider) {
+  switch (istage) {
+  case Stage::sense:
+    return add(std::move(istep), senseOrder, idivider);
+
+  case Stage::estimate:
+    return add(std::move(istep), odometryOrder, idivider);
+
+  case Stage::control:
+    return add(std::move(istep), mechanismOrder, idivider);
+
+  default:
+    return add(std::move(istep), actuateOrder, idivider);
+  }
+}
+
+void ControlScheduler::remove(const SlotId islot) {
+  std::scoped_lock lock(slotsMutex);
+  slots.erase(std::remove_if(
+                slots.begin(), slots.end(), [islot](const Slot &slot) { return slot.id == islot; }),
+              slots.end());
+}
+
+void ControlScheduler::tick() {
+  std::scoped_lock lock(slotsMutex);
+  const QTime sensed = latencyTimer->micros();
+  sensorCache->refresh();
+  bool commanded = false;
+
+  for (const auto &slot : slots) {
+    if (ticks % slot.divider == 0) {
+      slot.step();
+      commanded = commanded || slot.order >= chassisOrder;
+    }
+  }
+  ticks++;
+
+  // The control and actuate stages come last, so every command has been written by now
+  commanded = commandBuffer->commit() > 0 || commanded;
+  if (commanded) {
+    const auto latency = static_cast<std::uint32_t>(
+      std::lround(std::max(0.0, (latencyTimer->micros() - sensed).convert(millisecond) * 1000)));
+    latencyTicks.fetch_add(1, std::memory_order_relaxed);
+    totalLatency.fetch_add(latency, std::memory_order_relaxed);
+    if (latency > maxLatency.load(std::memory_order_relaxed)) {
+      maxLatency.store(latency, std::memory_order_relaxed);
+    }
+  }
+}
+
+void ControlScheduler::startThread() {
+  if (!task) {
+    task = new CrossplatformThread(trampoline, this, "ControlScheduler");
+  }
+}
+
+CrossplatformThread *ControlScheduler::getThread() const {
+  return task;
+}
+
+QTime ControlScheduler::getPeriod() const {
+  return period;
+}
+
+std::uint32_t ControlScheduler::getDivider(const QTime iperiod) const {
+  const long divider = std::lround(iperiod.convert(millisecond) / period.convert(millisecond));
+  return static_cast<std::uint32_t>(std::max(divider, 1L));
+}
+
+std::size_t ControlScheduler::getStepCount() const {
+  std::scoped_lock lock(slotsMutex);
+  return slots.size();
+}
+
+const LoopStats &ControlScheduler::getLoopStats() const {
+  return loopStats;
+}
+
+ControlScheduler::LatencySummary ControlScheduler::getLatency() const {
+  LatencySummary summary;
+  summary.ticks = latencyTicks.load(std::memory_order_relaxed);
+  summary.mean =
+    summary.ticks > 0
+      ? static_cast<double>(totalLatency.load(std::memory_order_relaxed)) / summary.ticks / 1000 *
+          millisecond
+      : 0_ms;
+  summary.max = maxLatency.load(std::memory_order_relaxed) / 1000.0 * millisecond;
+  return summary;
+}
+
+const std::shared_ptr<SensorCache> &ControlScheduler::getSensorCache() const {
+  return sensorCache;
+}
+
+const std::shared_ptr<MotorCommandBuffer> &ControlScheduler::getCommandBuffer() const {
+  return commandBuffer;
+}
+
+ControlScheduler::Stage ControlScheduler::getStage(const int iorder) {
+  if (iorder < odometryOrder) {
+    return Stage::sense;
+  } else if (iorder < chassisOrder) {
+    return Stage::estimate;
+  } else if (iorder < actuateOrder) {
+    return Stage::control;
+  } else {
+    return Stage::actuate;
+  }
+}
+
+void ControlScheduler::trampoline(void *context) {
+  if (context) {
+    static_cast<ControlScheduler *>(context)->loop();
+  }
+}
+
+void ControlScheduler::loop() {
+  LOG_INFO_S("Started ControlScheduler task.");
+
+  auto rate = timeUtil.getRate();
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    loopStats.tickStarted(period);
+    tick();
+    loopStats.tickFinished();
+
+    rate->delayUntil(period);
+  }
+
+  LOG_INFO_S("Stopped ControlScheduler task.");
+}
+} // namespace okapi
@@ -0,0 +1,160 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/controllerTelemetry.hpp"
+#include "okapi/api/util/byteOrder.hpp"
+#include <algorithm>
+
+namespace okapi {
+constexpr std::uint32_t ControllerTelemetry::magic;
+constexpr std::uint16_t ControllerTelemetry::version;
+
+ControllerTelemetry::ControllerTelemetry(std::unique_ptr<AbstractTimer> itimer,
+                                         const std::size_t icapacity,
+                                         const std::size_t idecimation)
+  : timer(std::move(itimer)),
+    capacity(std::max<std::size_t>(icapacity, 1)),
+    decimation(std::max<std::size_t>(idecimation, 1)),
+    samples(new TelemetrySample[capacity]) {
+  if (timer) {
+    timer->placeMark();
+  }
+}
+
+void ControllerTelemetry::record(const double itarget,
+                                 const double iprocessValue,
+                                 const double ierror,
+                                 const double iintegral,
+                                 const double iderivative,
+                                 const double ioutput) noexcept {
+  const std::uint32_t step = steps++;
+  if (step % decimation != 0) {
+    return;
+  }
+
+  // Readers check started after copying, so it has to be visible before the sample changes
+  const std::uint32_t index = written.load(std::memory_order_relaxed);
+  started.store(index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  samples[index % capacity] = {step,
+                               timer ? static_cast<float>(timer->getDtFromMark().convert(second))
+                                     : 0.0f,
+                               static_cast<float>(itarget),
+                               static_cast<float>(iprocessValue),
+                               static_cast<float>(ierror),
+                               static_cast<float>(iintegral),
+                               static_cast<float>(iderivative),
+                               static_cast<float>(ioutput)};
+  written.store(index + 1, std::memory_order_release);
+}
+
+std::vector<TelemetrySample> ControllerTelemetry::getSamples() const {
+  const std::size_t end = written.load(std::memory_order_acquire);
+  const std::size_t begin = end > capacity ? end - capacity : 0;
+
+  std::vector<TelemetrySample> out;
+  out.reserve(end - begin);
+  for (std::size_t i = begin; i < end; ++i) {
+    out.push_back(samples[i % capacity]);
+  }
+
+  // Any sample which was started during the copy replaced one of the oldest ones
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const std::size_t after = started.load(std::memory_order_relaxed);
+  if (after > begin + capacity) {
+    const std::size_t stale = std::min(after - capacity - begin, out.size());
+    out.erase(out.begin(), out.begin() + stale);
+  }
+
+  return out;
+}
+
+void ControllerTelemetry::clear() {
+  steps = 0;
+  started.store(0, std::memory_order_relaxed);
+  written.store(0, std::memory_order_release);
+  if (timer) {
+    timer->placeMark();
+  }
+}
+
+std::size_t ControllerTelemetry::getRecordedCount() const {
+  return written.load(std::memory_order_acquire);
+}
+
+std::size_t ControllerTelemetry::getOverwrittenCount() const {
+  const std::size_t count = getRecordedCount();
+  return count > capacity ? count - capacity : 0;
+}
+
+std::size_t ControllerTelemetry::getCapacity() const {
+  return capacity;
+}
+
+std::size_t ControllerTelemetry::getDecimation() const {
+  return decimation;
+}
+
+bool ControllerTelemetry::writeCSV(std::ostream &ostream) const {
+  ostream << "step,time,target,processValue,error,integral,derivative,output\n";
+  for (const auto &sample : getSamples()) {
+    ostream << sample.step << ',' << sample.time << ',' << sample.target << ','
+            << sample.processValue << ',' << sample.error << ',' << sample.integral << ','
+            << sample.derivative << ',' << sample.output << '\n';
+  }
+
+  return ostream.good();
+}
+
+void ControllerTelemetry::convertHeaderByteOrder(TelemetryFileHeader &iheader) {
+  convertLittleEndian(iheader.magic);
+  convertLittleEndian(iheader.version);
+  convertLittleEndian(iheader.recordSize);
+  convertLittleEndian(iheader.count);
+  convertLittleEndian(iheader.decimation);
+}
+
+bool ControllerTelemetry::writeBinary(std::ostream &ostream) const {
+  auto out = getSamples();
+  TelemetryFileHeader header{magic,
+                             version,
+                             sizeof(TelemetrySample),
+                             static_cast<std::uint32_t>(out.size()),
+                             static_cast<std::uint32_t>(decimation)};
+  convertHeaderByteOrder(header);
+  convertLittleEndianWords(out.data(), out.size() * sizeof(TelemetrySample));
+
+  ostream.write(reinterpret_cast<const char *>(&header), sizeof(TelemetryFileHeader));
+  ostream.write(reinterpret_cast<const char *>(out.data()),
+                static_cast<std::streamsize>(out.size() * sizeof(TelemetrySample)));
+  return ostream.good();
+}
+
+std::optional<std::vector<TelemetrySample>> ControllerTelemetry::readBinary(std::istream &istream) {
+  TelemetryFileHeader header{};
+  if (!istream.read(reinterpret_cast<char *>(&header), sizeof(TelemetryFileHeader))) {
+    return std::nullopt;
+  }
+
+  convertHeaderByteOrder(header);
+  if (header.magic != magic || header.version != version ||
+      header.recordSize != sizeof(TelemetrySample)) {
+    return std::nullopt;
+  }
+
+  // Read one sample at a time so a corrupt count can't make us allocate a huge buffer up front
+  std::vector<TelemetrySample> out;
+  for (std::uint32_t i = 0; i < header.count; ++i) {
+    TelemetrySample sample{};
+    if (!istream.read(reinterpret_cast<char *>(&sample), sizeof(TelemetrySample))) {
+      return std::nullopt;
+    }
+    convertLittleEndianWords(&sample, sizeof(TelemetrySample));
+    out.push_back(sample);
+  }
+
+  return out;
+}
+} // namespace okapi
@@ -0,0 +1,195 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/executionPlan.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace okapi {
+ExecutionPlan ExecutionPlan::compile(const std::vector<squiggles::ProfilePoint> &ipath,
+                                     const double icommandPerMps) {
+  ExecutionPlan plan;
+  plan.commandPerMps = icommandPerMps;
+
+  const std::size_t size = ipath.size();
+  for (auto *channel : plan.channels()) {
+    channel->reserve(size);
+  }
+
+  bool increasing = true;
+  bool symmetric = true;
+  for (std::size_t i = 0; i < size; ++i) {
+    const auto &point = ipath[i];
+    const bool hasWheels = point.wheel_velocities.size() >= 2;
+    const double leftVel = hasWheels ? point.wheel_velocities[0] : point.vector.vel;
+    const double rightVel = hasWheels ? point.wheel_velocities[1] : point.vector.vel;
+    const auto left = static_cast<float>(leftVel * icommandPerMps);
+    const auto right = static_cast<float>(rightVel * icommandPerMps);
+
+    plan.leftCommands.push_back(left);
+    plan.rightCommands.push_back(right);
+    plan.x.push_back(static_cast<float>(point.vector.pose.x));
+    plan.y.push_back(static_cast<float>(point.vector.pose.y));
+    plan.yaw.push_back(static_cast<float>(point.vector.pose.yaw));
+    plan.vel.push_back(static_cast<float>(point.vector.vel));
+    plan.accel.push_back(static_cast<float>(point.vector.accel));
+    plan.jerk.push_back(static_cast<float>(point.vector.jerk));
+    plan.curvature.push_back(static_cast<float>(point.curvature));
+
+    symmetric = symmetric && left == right;
+    increasing = increasing && (i == 0 || point.time > ipath[i - 1].time);
+  }
+
+  // Straight paths (and every linear path) don't need the right commands stored separately
+  if (symmetric) {
+    plan.rightCommands.clear();
+  }
+
+  // Otherwise the times are the durations of each point, so add them up
+  double elapsed = 0;
+  for (const auto &point : ipath) {
+    plan.time.push_back(static_cast<float>(increasing ? point.time : elapsed));
+    elapsed += point.time;
+  }
+
+  return plan;
+}
+
+void ExecutionPlan::compact() {
+  for (auto *channel : channels()) {
+    // Keep the times exact so the end of a long path is not shifted
+    if (channel != &time) {
+      channel->quantize();
+    }
+  }
+  compacted = true;
+}
+
+bool ExecutionPlan::isCompact() const {
+  return compacted;
+}
+
+std::vector<squiggles::ProfilePoint> ExecutionPlan::toProfilePoints() const {
+  std::vector<squiggles::ProfilePoint> path;
+  path.reserve(size());
+  for (std::size_t i = 0; i < size(); ++i) {
+    path.emplace_back(
+      squiggles::ControlVector(getPose(i), vel[i], accel[i], jerk[i]),
+      std::vector<double>{getLeftCommand(i) / commandPerMps, getRightCommand(i) / commandPerMps},
+      curvature[i],
+      time[i]);
+  }
+
+  return path;
+}
+
+std::size_t ExecutionPlan::size() const {
+  return leftCommands.size();
+}
+
+bool ExecutionPlan::empty() const {
+  return leftCommands.empty();
+}
+
+float ExecutionPlan::getLeftCommand(const std::size_t i) const {
+  return leftCommands[i];
+}
+
+float ExecutionPlan::getRightCommand(const std::size_t i) const {
+  return rightCommands.empty() ? leftCommands[i] : rightCommands[i];
+}
+
+float ExecutionPlan::getTime(const std::size_t i) const {
+  return time[i];
+}
+
+squiggles::Pose ExecutionPlan::getPose(const std::size_t i) const {
+  return squiggles::Pose(x[i], y[i], yaw[i]);
+}
+
+double ExecutionPlan::getCommandPerMps() const {
+  return commandPerMps;
+}
+
+void ExecutionPlan::setLimits(const PathfinderLimits &ilimits) {
+  limits = ilimits;
+}
+
+const std::optional<PathfinderLimits> &ExecutionPlan::getLimits() const {
+  return limits;
+}
+
+std::size_t ExecutionPlan::getMemoryUsage() const {
+  std::size_t size = sizeof(ExecutionPlan);
+  for (const auto *channel : channels()) {
+    size += channel->getMemoryUsage();
+  }
+
+  return size;
+}
+
+std::vector<ExecutionPlan::Channel *> ExecutionPlan::channels() {
+  return {&leftCommands, &rightCommands, &x, &y, &yaw, &vel, &accel, &jerk, &curvature, &time};
+}
+
+std::vector<const ExecutionPlan::Channel *> ExecutionPlan::channels() const {
+  return {&leftCommands, &rightCommands, &x, &y, &yaw, &vel, &accel, &jerk, &curvature, &time};
+}
+
+float ExecutionPlan::Channel::operator[](const std::size_t i) const {
+  return values.empty() ? offset + quantized[i] * step : values[i];
+}
+
+std::size_t ExecutionPlan::Channel::size() const {
+  return values.empty() ? quantized.size() : values.size();
+}
+
+bool ExecutionPlan::Channel::empty() const {
+  return size() == 0;
+}
+
+void ExecutionPlan::Channel::reserve(const std::size_t isize) {
+  values.reserve(isize);
+}
+
+void ExecutionPlan::Channel::push_back(const float ivalue) {
+  values.push_back(ivalue);
+}
+
+void ExecutionPlan::Channel::clear() {
+  std::vector<float>().swap(values);
+  std::vector<std::uint16_t>().swap(quantized);
+}
+
+void ExecutionPlan::Channel::quantize() {
+  if (values.empty()) {
+    return;
+  }
+
+  const auto [min, max] = std::minmax_element(values.begin(), values.end());
+  constexpr auto levels = std::numeric_limits<std::uint16_t>::max();
+  if (*min < 0 && *max > 0) {
+    // Put zero exactly on a level so a stopped wheel stays stopped. This costs one level.
+    step = (*max - *min) / (levels - 1);
+    offset = -(static_cast<float>(std::ceil(-*min / step)) * step);
+  } else {
+    offset = *min;
+    step = (*max - *min) / levels;
+  }
+
+  quantized.resize(values.size());
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    const long level = step > 0 ? std::lround((values[i] - offset) / step) : 0;
+    quantized[i] = static_cast<std::uint16_t>(std::clamp(level, 0L, static_cast<long>(levels)));
+  }
+
+  std::vector<float>().swap(values);
+}
+
+std::size_t ExecutionPlan::Channel::getMemoryUsage() const {
+  return values.capacity() * sizeof(float) + quantized.capacity() * sizeof(std::uint16_t);
+}
+} // namespace okapi
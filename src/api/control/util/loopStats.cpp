@@ -0,0 +1,128 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/loopStats.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace okapi {
+constexpr std::array<double, LoopStats::bucketCount - 1> LoopStats::bucketLimitsMs;
+constexpr QTime LoopStats::lateThreshold;
+constexpr QTime LoopStats::defaultSummaryPeriod;
+
+LoopStats::LoopStats(std::unique_ptr<AbstractTimer> itimer,
+                     const QTime isummaryPeriod,
+                     std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)), timer(std::move(itimer)), summaryPeriod(isummaryPeriod) {
+  if (timer) {
+    lastSummary = timer->micros();
+  }
+}
+
+void LoopStats::tickStarted(const QTime iperiod) noexcept {
+  if (!timer) {
+    return;
+  }
+
+  const QTime now = timer->micros();
+  if (hasPreviousTick) {
+    const QTime actualPeriod = now - tickStart;
+    const QTime jitter = abs(actualPeriod - period);
+    const std::uint32_t jitterMicros = toMicros(jitter);
+
+    jitters[getBucket(jitter)].fetch_add(1, std::memory_order_relaxed);
+    if (jitterMicros > maxJitter.load(std::memory_order_relaxed)) {
+      maxJitter.store(jitterMicros, std::memory_order_relaxed);
+    }
+    if (actualPeriod - period >= lateThreshold) {
+      lateTicks.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  tickStart = now;
+  period = iperiod;
+  hasPreviousTick = true;
+}
+
+void LoopStats::tickFinished() noexcept {
+  if (!timer) {
+    return;
+  }
+
+  const QTime now = timer->micros();
+  const QTime executionTime = now - tickStart;
+  const std::uint32_t executionMicros = toMicros(executionTime);
+
+  executionTimes[getBucket(executionTime)].fetch_add(1, std::memory_order_relaxed);
+  totalExecutionTime.fetch_add(executionMicros, std::memory_order_relaxed);
+  if (executionMicros > maxExecutionTime.load(std::memory_order_relaxed)) {
+    maxExecutionTime.store(executionMicros, std::memory_order_relaxed);
+  }
+  if (executionTime > period) {
+    overruns.fetch_add(1, std::memory_order_relaxed);
+  }
+  const std::uint32_t tickCount = ticks.fetch_add(1, std::memory_order_relaxed) + 1;
+
+  if (summaryPeriod > 0_ms && now - lastSummary >= summaryPeriod) {
+    lastSummary = now;
+    LOG_INFO_EVENT(LogEvent::loopStatsSummary,
+                   tickCount,
+                   overruns.load(std::memory_order_relaxed),
+                   maxExecutionTime.load(std::memory_order_relaxed) / 1000.0,
+                   maxJitter.load(std::memory_order_relaxed) / 1000.0);
+  }
+}
+
+void LoopStats::ignoreNextPeriod() noexcept {
+  hasPreviousTick = false;
+}
+
+void LoopStats::reset() noexcept {
+  ticks.store(0, std::memory_order_relaxed);
+  overruns.store(0, std::memory_order_relaxed);
+  lateTicks.store(0, std::memory_order_relaxed);
+  totalExecutionTime.store(0, std::memory_order_relaxed);
+  maxExecutionTime.store(0, std::memory_order_relaxed);
+  maxJitter.store(0, std::memory_order_relaxed);
+  for (std::size_t i = 0; i < bucketCount; ++i) {
+    executionTimes[i].store(0, std::memory_order_relaxed);
+    jitters[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+LoopStats::Summary LoopStats::getSummary() const noexcept {
+  Summary summary;
+  summary.ticks = ticks.load(std::memory_order_relaxed);
+  summary.overruns = overruns.load(std::memory_order_relaxed);
+  summary.lateTicks = lateTicks.load(std::memory_order_relaxed);
+  summary.meanExecutionTime =
+    summary.ticks > 0
+      ? fromMicros(static_cast<double>(totalExecutionTime.load(std::memory_order_relaxed)) /
+                   summary.ticks)
+      : 0_ms;
+  summary.maxExecutionTime = fromMicros(maxExecutionTime.load(std::memory_order_relaxed));
+  summary.maxJitter = fromMicros(maxJitter.load(std::memory_order_relaxed));
+  for (std::size_t i = 0; i < bucketCount; ++i) {
+    summary.executionTimes[i] = executionTimes[i].load(std::memory_order_relaxed);
+    summary.jitters[i] = jitters[i].load(std::memory_order_relaxed);
+  }
+
+  return summary;
+}
+
+std::size_t LoopStats::getBucket(const QTime itime) noexcept {
+  const double ms = itime.convert(millisecond);
+  return std::upper_bound(bucketLimitsMs.begin(), bucketLimitsMs.end(), ms) -
+         bucketLimitsMs.begin();
+}
+
+std::uint32_t LoopStats::toMicros(const QTime itime) noexcept {
+  return static_cast<std::uint32_t>(std::lround(std::max(0.0, itime.convert(millisecond) * 1000)));
+}
+
+QTime LoopStats::fromMicros(const double imicros) noexcept {
+  return imicros / 1000 * millisecond;
+}
+} // namespace okapi
@@ -0,0 +1,102 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/pathGenerationPool.hpp"
+#include "okapi/api/control/util/pathGenerationQueue.hpp"
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#ifdef THREADS_STD
+#include <thread>
+#endif
+
+namespace okapi {
+PathGenerationPool::PathGenerationPool(const TimeUtil &itimeUtil,
+                                       const std::size_t iworkers,
+                                       std::string iname,
+                                       const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger), timeUtil(itimeUtil), workers(iworkers), name(std::move(iname)) {
+  if (workers == 0) {
+    std::string msg("PathGenerationPool: The number of workers must be at least one.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+
+std::vector<PathGenerationResult> PathGenerationPool::run(const std::vector<Job> &ijobs) {
+  std::scoped_lock lock(runMutex);
+
+  jobs = &ijobs;
+  results.assign(ijobs.size(), PathGenerationResult{"", false, "", 0_ms});
+  nextJob.store(0, std::memory_order_release);
+  finishedWorkers.store(0, std::memory_order_release);
+
+  // There is no point in starting more workers than there are jobs
+  const std::size_t workerCount = std::min(workers, ijobs.size());
+  LOG_INFO("PathGenerationPool: Generating " + std::to_string(ijobs.size()) + " paths on " +
+           std::to_string(workerCount) + " workers");
+
+  std::vector<std::unique_ptr<CrossplatformThread>> tasks;
+  tasks.reserve(workerCount);
+  for (std::size_t i = 0; i < workerCount; ++i) {
+    tasks.push_back(std::make_unique<CrossplatformThread>(
+      trampoline, this, name.c_str(), PathGenerationQueue::workerPriority));
+  }
+
+  finishedSignal.waitUntil(
+    [&]() { return finishedWorkers.load(std::memory_order_acquire) >= workerCount; });
+
+  // Every worker has destroyed its locals and is only returning, so deleting them is safe
+  tasks.clear();
+  jobs = nullptr;
+
+  return std::move(results);
+}
+
+std::size_t PathGenerationPool::defaultWorkerCount() {
+#ifdef THREADS_STD
+  return std::max(1u, std::thread::hardware_concurrency());
+#else
+  return 1;
+#endif
+}
+
+void PathGenerationPool::trampoline(void *context) {
+  if (context) {
+    auto *pool = static_cast<PathGenerationPool *>(context);
+    pool->work();
+
+    // work()'s locals are gone by now, so the caller can't delete this task in the middle of them
+    pool->finishedWorkers.fetch_add(1, std::memory_order_acq_rel);
+    pool->finishedSignal.notifyAll();
+  }
+}
+
+void PathGenerationPool::work() {
+  const auto timer = timeUtil.getTimer();
+
+  for (std::size_t i = nextJob.fetch_add(1, std::memory_order_acq_rel); i < jobs->size();
+       i = nextJob.fetch_add(1, std::memory_order_acq_rel)) {
+    const auto &job = (*jobs)[i];
+    auto &result = results[i];
+    result.pathId = job.pathId;
+
+    const QTime start = timer->millis();
+    try {
+      job.job();
+      result.successful = true;
+    } catch (const std::exception &e) {
+      result.error = e.what();
+      LOG_ERROR("PathGenerationPool: Failed to generate path " + job.pathId + ": " + result.error);
+    }
+    result.duration = timer->millis() - start;
+
+    if (result.successful) {
+      LOG_INFO("PathGenerationPool: Generated path " + job.pathId + " in " +
+               std::to_string(result.duration.convert(millisecond)) + " ms");
+    }
+  }
+}
+} // namespace okapi
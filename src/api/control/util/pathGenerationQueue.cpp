@@ -0,0 +1,181 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/pathGenerationQueue.hpp"
+#include <algorithm>
+#include <mutex>
+
+namespace okapi {
+PathGenerationHandle::PathGenerationHandle(std::string ipathId) : pathId(std::move(ipathId)) {
+}
+
+const std::string &PathGenerationHandle::getPathId() const {
+  return pathId;
+}
+
+bool PathGenerationHandle::isReady() const {
+  return status.load(std::memory_order_acquire) != Status::pending;
+}
+
+bool PathGenerationHandle::isSuccessful() const {
+  return status.load(std::memory_order_acquire) == Status::succeeded;
+}
+
+std::string PathGenerationHandle::getError() const {
+  // The error is only written before the status is released, so it is safe to read once the status
+  // says generation failed
+  if (status.load(std::memory_order_acquire) == Status::failed) {
+    return error;
+  }
+
+  return "";
+}
+
+bool PathGenerationHandle::waitUntilReady() {
+  readySignal.waitUntil([&]() { return isReady(); });
+  return isSuccessful();
+}
+
+void PathGenerationHandle::markSucceeded() {
+  status.store(Status::succeeded, std::memory_order_release);
+  readySignal.notifyAll();
+}
+
+void PathGenerationHandle::markFailed(const std::string &ierror) {
+  error = ierror;
+  status.store(Status::failed, std::memory_order_release);
+  readySignal.notifyAll();
+}
+
+PathGenerationQueue::PathGenerationQueue(const TimeUtil &itimeUtil,
+                                         std::string iname,
+                                         const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger), timeUtil(itimeUtil), name(std::move(iname)) {
+}
+
+PathGenerationQueue::~PathGenerationQueue() {
+  dtorCalled.store(true, std::memory_order_release);
+
+  if (task) {
+    // Let the job which is currently running finish and the worker return on its own instead of
+    // deleting it while it might hold a lock
+    workerSignal.notifyAll();
+    workerSignal.waitUntil([&]() { return taskStopped.load(std::memory_order_acquire); });
+    delete task;
+  }
+
+  std::scoped_lock lock(jobsMutex);
+  for (auto &job : jobs) {
+    job.handle->markFailed("The path generator was destroyed before the path was generated.");
+  }
+  jobs.clear();
+  outstanding.clear();
+}
+
+std::shared_ptr<PathGenerationHandle>
+PathGenerationQueue::submit(const std::string &ipathId, std::function<void()> ijob) {
+  auto handle = std::make_shared<PathGenerationHandle>(ipathId);
+
+  {
+    std::scoped_lock lock(jobsMutex);
+    jobs.push_back(Job{handle, std::move(ijob)});
+    outstanding.push_back(handle);
+
+    if (!task) {
+      taskStopped.store(false, std::memory_order_release);
+      task = new CrossplatformThread(trampoline, this, name.c_str(), workerPriority);
+    }
+  }
+
+  workerSignal.notifyAll();
+
+  LOG_INFO("PathGenerationQueue: Queued path " + ipathId);
+
+  return handle;
+}
+
+bool PathGenerationQueue::isPending(const std::string &ipathId) {
+  return !getOutstanding(ipathId).empty();
+}
+
+void PathGenerationQueue::waitForPath(const std::string &ipathId) {
+  for (auto &handle : getOutstanding(ipathId)) {
+    LOG_INFO("PathGenerationQueue: Waiting for path " + ipathId);
+    handle->waitUntilReady();
+  }
+}
+
+std::vector<std::shared_ptr<PathGenerationHandle>>
+PathGenerationQueue::getOutstanding(const std::string &ipathId) {
+  std::vector<std::shared_ptr<PathGenerationHandle>> handles;
+
+  std::scoped_lock lock(jobsMutex);
+  for (const auto &handle : outstanding) {
+    if (handle->getPathId() == ipathId) {
+      handles.push_back(handle);
+    }
+  }
+
+  return handles;
+}
+
+void PathGenerationQueue::trampoline(void *context) {
+  if (context) {
+    static_cast<PathGenerationQueue *>(context)->loop();
+  }
+}
+
+void PathGenerationQueue::loop() {
+  LOG_INFO_S("Started PathGenerationQueue task.");
+
+  while (true) {
+    Job job;
+
+    // Sleep until there is a job or the queue is being destroyed
+    workerSignal.waitUntil([&]() {
+      if (dtorCalled.load(std::memory_order_acquire)) {
+        return true;
+      }
+
+      std::scoped_lock lock(jobsMutex);
+      if (jobs.empty()) {
+        return false;
+      }
+
+      job = std::move(jobs.front());
+      jobs.pop_front();
+      return true;
+    });
+
+    if (!job.handle) {
+      break;
+    }
+
+    runJob(job);
+  }
+
+  LOG_INFO_S("Stopped PathGenerationQueue task.");
+  taskStopped.store(true, std::memory_order_release);
+  workerSignal.notifyAll();
+}
+
+void PathGenerationQueue::runJob(Job &ijob) {
+  const auto &pathId = ijob.handle->getPathId();
+
+  try {
+    ijob.job();
+    ijob.handle->markSucceeded();
+    LOG_INFO("PathGenerationQueue: Done generating path " + pathId);
+  } catch (const std::exception &e) {
+    const std::string msg(e.what());
+    ijob.handle->markFailed(msg);
+    LOG_ERROR("PathGenerationQueue: Failed to generate path " + pathId + ": " + msg);
+  }
+
+  std::scoped_lock lock(jobsMutex);
+  outstanding.erase(std::remove(outstanding.begin(), outstanding.end(), ijob.handle),
+                    outstanding.end());
+}
+} // namespace okapi
@@ -0,0 +1,60 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/pathMemoryBudget.hpp"
+
+namespace okapi {
+PathMemoryBudget::PathMemoryBudget(const std::size_t ilimit, const bool icompactAll)
+  : limit(ilimit), compactAll(icompactAll), usage(std::make_shared<std::atomic<std::size_t>>(0)) {
+}
+
+std::shared_ptr<const ExecutionPlan> PathMemoryBudget::admit(ExecutionPlan iplan) {
+  if (compactAll) {
+    iplan.compact();
+  }
+
+  std::size_t bytes = iplan.getMemoryUsage();
+  if (!reserve(bytes)) {
+    if (iplan.isCompact()) {
+      return nullptr;
+    }
+
+    iplan.compact();
+    bytes = iplan.getMemoryUsage();
+    if (!reserve(bytes)) {
+      return nullptr;
+    }
+  }
+
+  return std::shared_ptr<const ExecutionPlan>(
+    new ExecutionPlan(std::move(iplan)), [counter = usage, bytes](const ExecutionPlan *plan) {
+      counter->fetch_sub(bytes, std::memory_order_acq_rel);
+      delete plan;
+    });
+}
+
+std::size_t PathMemoryBudget::getLimit() const {
+  return limit;
+}
+
+std::size_t PathMemoryBudget::getUsage() const {
+  return usage->load(std::memory_order_acquire);
+}
+
+bool PathMemoryBudget::isCompactingAll() const {
+  return compactAll;
+}
+
+bool PathMemoryBudget::reserve(const std::size_t ibytes) {
+  std::size_t current = usage->load(std::memory_order_acquire);
+  do {
+    if (ibytes > limit || current > limit - ibytes) {
+      return false;
+    }
+  } while (!usage->compare_exchange_weak(current, current + ibytes, std::memory_order_acq_rel));
+
+  return true;
+}
+} // namespace okapi
@@ -0,0 +1,105 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/sensorCache.hpp"
+
+namespace okapi {
+SensorCache::SensorCache(std::unique_ptr<AbstractTimer> itimer) : timer(std::move(itimer)) {
+  frameTime.store(getTime().convert(millisecond), std::memory_order_relaxed);
+}
+
+void SensorCache::refresh() {
+  frameTime.store(getTime().convert(millisecond), std::memory_order_relaxed);
+  frame.fetch_add(1, std::memory_order_acq_rel);
+}
+
+std::uint32_t SensorCache::getFrame() const {
+  return frame.load(std::memory_order_acquire);
+}
+
+QTime SensorCache::getFrameTime() const {
+  return frameTime.load(std::memory_order_relaxed) * millisecond;
+}
+
+QTime SensorCache::getTime() const {
+  return timer ? timer->millis() : 0_ms;
+}
+
+std::shared_ptr<CachedChassisSensors>
+SensorCache::cache(const std::shared_ptr<ReadOnlyChassisModel> &imodel) {
+  std::scoped_lock lock(wrappersMutex);
+  for (auto it = models.begin(); it != models.end();) {
+    auto wrapper = it->lock();
+    if (!wrapper) {
+      it = models.erase(it);
+    } else if (wrapper->getModel() == imodel) {
+      return wrapper;
+    } else {
+      ++it;
+    }
+  }
+
+  auto wrapper = std::make_shared<CachedChassisSensors>(imodel, shared_from_this());
+  models.push_back(wrapper);
+  return wrapper;
+}
+
+std::shared_ptr<CachedControllerInput>
+SensorCache::cache(const std::shared_ptr<ControllerInput<double>> &iinput) {
+  std::scoped_lock lock(wrappersMutex);
+  for (auto it = inputs.begin(); it != inputs.end();) {
+    auto wrapper = it->lock();
+    if (!wrapper) {
+      it = inputs.erase(it);
+    } else if (wrapper->getInput() == iinput) {
+      return wrapper;
+    } else {
+      ++it;
+    }
+  }
+
+  auto wrapper = std::make_shared<CachedControllerInput>(iinput, shared_from_this());
+  inputs.push_back(wrapper);
+  return wrapper;
+}
+
+CachedChassisSensors::CachedChassisSensors(std::shared_ptr<ReadOnlyChassisModel> imodel,
+                                           std::shared_ptr<const SensorCache> icache)
+  : model(std::move(imodel)), entry(std::move(icache)) {
+}
+
+SensorValues CachedChassisSensors::getSensorValues() const {
+  return entry.get([this]() { return model->getSensorValues(); });
+}
+
+std::valarray<std::int32_t> CachedChassisSensors::getSensorVals() const {
+  return getSensorValues().toValarray();
+}
+
+const std::shared_ptr<ReadOnlyChassisModel> &CachedChassisSensors::getModel() const {
+  return model;
+}
+
+const SensorCacheEntry<SensorValues> &CachedChassisSensors::getEntry() const {
+  return entry;
+}
+
+CachedControllerInput::CachedControllerInput(std::shared_ptr<ControllerInput<double>> iinput,
+                                             std::shared_ptr<const SensorCache> icache)
+  : input(std::move(iinput)), entry(std::move(icache)) {
+}
+
+double CachedControllerInput::controllerGet() {
+  return entry.get([this]() { return input->controllerGet(); });
+}
+
+const std::shared_ptr<ControllerInput<double>> &CachedControllerInput::getInput() const {
+  return input;
+}
+
+const SensorCacheEntry<double> &CachedControllerInput::getEntry() const {
+  return entry;
+}
+} // namespace okapi
@@ -0,0 +1,204 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/trajectoryCache.hpp"
+#include "okapi/api/units/QAngle.hpp"
+#include <fstream>
+#include <mutex>
+
+namespace okapi {
+namespace {
+void hashBytes(std::uint64_t &hash, const void *idata, const std::size_t isize) {
+  const auto *bytes = static_cast<const std::uint8_t *>(idata);
+  for (std::size_t i = 0; i < isize; ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+}
+
+void hashDouble(std::uint64_t &hash, const double ivalue) {
+  // Treat -0 and 0 as the same value so they produce the same key
+  const double value = ivalue == 0 ? 0 : ivalue;
+  hashBytes(hash, &value, sizeof(value));
+}
+} // namespace
+
+TrajectoryCache::TrajectoryCache(const std::size_t imemoryBudget,
+                                 std::string ipersistDirectory,
+                                 const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger), memoryBudget(imemoryBudget), persistDirectory(std::move(ipersistDirectory)) {
+}
+
+std::uint64_t TrajectoryCache::makeKey(const std::vector<PathfinderPoint> &iwaypoints,
+                                       const PathfinderLimits &ilimits,
+                                       const QLength &iwheelTrack,
+                                       const double idt,
+                                       const double istartVel,
+                                       const double iendVel) {
+  std::uint64_t hash = 14695981039346656037ull;
+
+  const std::uint64_t count = iwaypoints.size();
+  hashBytes(hash, &count, sizeof(count));
+  for (const auto &point : iwaypoints) {
+    hashDouble(hash, point.x.convert(meter));
+    hashDouble(hash, point.y.convert(meter));
+    hashDouble(hash, point.theta.convert(radian));
+  }
+
+  hashDouble(hash, ilimits.maxVel);
+  hashDouble(hash, ilimits.maxAccel);
+  hashDouble(hash, ilimits.maxJerk);
+  hashDouble(hash, iwheelTrack.convert(meter));
+  hashDouble(hash, idt);
+
+  // Only hash nonzero boundary velocities so paths which start and end at rest keep the same key
+  if (istartVel != 0 || iendVel != 0) {
+    hashDouble(hash, istartVel);
+    hashDouble(hash, iendVel);
+  }
+
+  return hash;
+}
+
+TrajectoryCache::Trajectory TrajectoryCache::get(const std::uint64_t ikey) {
+  {
+    std::scoped_lock lock(cacheMutex);
+    if (auto entry = index.find(ikey); entry != index.end()) {
+      // Move the entry to the front because it is now the most recently used
+      entries.splice(entries.begin(), entries, entry->second);
+      stats.hits++;
+      return entry->second->trajectory;
+    }
+  }
+
+  if (auto trajectory = loadPersisted(ikey)) {
+    std::scoped_lock lock(cacheMutex);
+    stats.diskHits++;
+    insert(ikey, trajectory);
+    return trajectory;
+  }
+
+  std::scoped_lock lock(cacheMutex);
+  stats.misses++;
+  return nullptr;
+}
+
+void TrajectoryCache::put(const std::uint64_t ikey,
+                          const std::vector<squiggles::ProfilePoint> &itrajectory,
+                          const BinaryPathHeader &iheader) {
+  {
+    std::scoped_lock lock(cacheMutex);
+    insert(ikey, std::make_shared<const std::vector<squiggles::ProfilePoint>>(itrajectory));
+  }
+
+  persist(ikey, itrajectory, iheader);
+}
+
+void TrajectoryCache::insert(const std::uint64_t ikey, Trajectory itrajectory) {
+  const std::size_t size = estimateMemoryUsage(*itrajectory);
+  if (size > memoryBudget) {
+    LOG_INFO("TrajectoryCache: Not caching a trajectory of " + std::to_string(size) +
+             " bytes because it is larger than the memory budget");
+    return;
+  }
+
+  if (auto existing = index.find(ikey); existing != index.end()) {
+    memoryUsage -= existing->second->size;
+    entries.erase(existing->second);
+    index.erase(existing);
+  }
+
+  while (!entries.empty() && memoryUsage + size > memoryBudget) {
+    const auto &lru = entries.back();
+    memoryUsage -= lru.size;
+    index.erase(lru.key);
+    entries.pop_back();
+    stats.evictions++;
+  }
+
+  entries.push_front(Entry{ikey, std::move(itrajectory), size});
+  index.emplace(ikey, entries.begin());
+  memoryUsage += size;
+}
+
+void TrajectoryCache::clear() {
+  std::scoped_lock lock(cacheMutex);
+  entries.clear();
+  index.clear();
+  memoryUsage = 0;
+}
+
+TrajectoryCacheStats TrajectoryCache::getStats() {
+  std::scoped_lock lock(cacheMutex);
+  auto out = stats;
+  out.entries = entries.size();
+  out.memoryUsage = memoryUsage;
+  return out;
+}
+
+void TrajectoryCache::resetStats() {
+  std::scoped_lock lock(cacheMutex);
+  stats = TrajectoryCacheStats{0, 0, 0, 0, 0, 0};
+}
+
+std::size_t
+TrajectoryCache::estimateMemoryUsage(const std::vector<squiggles::ProfilePoint> &itrajectory) {
+  std::size_t size = sizeof(std::vector<squiggles::ProfilePoint>) +
+                     itrajectory.capacity() * sizeof(squiggles::ProfilePoint);
+  for (const auto &point : itrajectory) {
+    size += point.wheel_velocities.capacity() * sizeof(double);
+  }
+
+  return size;
+}
+
+std::string TrajectoryCache::makeFilePath(const std::uint64_t ikey) const {
+  char name[24];
+  snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(ikey));
+
+  std::string path(persistDirectory);
+  if (!path.empty() && path.back() != '/') {
+    path.append("/");
+  }
+  path.append(name);
+
+  return path;
+}
+
+TrajectoryCache::Trajectory TrajectoryCache::loadPersisted(const std::uint64_t ikey) {
+  if (persistDirectory.empty()) {
+    return nullptr;
+  }
+
+  std::ifstream file(makeFilePath(ikey), std::ifstream::in | std::ifstream::binary);
+  if (!file.good()) {
+    return nullptr;
+  }
+
+  BinaryPathHeader header;
+  const auto records = BinaryPath::read(file, header, logger);
+  if (!records) {
+    LOG_WARN("TrajectoryCache: Ignoring unreadable cache file " + makeFilePath(ikey));
+    return nullptr;
+  }
+
+  return std::make_shared<const std::vector<squiggles::ProfilePoint>>(
+    BinaryPath::toProfilePoints(records.value()));
+}
+
+void TrajectoryCache::persist(const std::uint64_t ikey,
+                              const std::vector<squiggles::ProfilePoint> &itrajectory,
+                              const BinaryPathHeader &iheader) {
+  if (persistDirectory.empty()) {
+    return;
+  }
+
+  const auto filePath = makeFilePath(ikey);
+  std::ofstream file(filePath, std::ofstream::out | std::ofstream::binary);
+  if (!file.good() || !BinaryPath::write(file, iheader, itrajectory)) {
+    LOG_WARN("TrajectoryCache: Couldn't write cache file " + filePath);
+  }
+}
+} // namespace okapi
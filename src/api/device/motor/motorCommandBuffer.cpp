@@ -0,0 +1,278 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/motor/motorCommandBuffer.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <mutex>
+
+namespace okapi {
+MotorCommandBuffer::MotorCommandBuffer(std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)) {
+}
+
+std::shared_ptr<AbstractMotor>
+MotorCommandBuffer::buffer(const std::shared_ptr<AbstractMotor> &imotor) {
+  if (const auto buffered = std::dynamic_pointer_cast<BufferedMotor>(imotor);
+      buffered && buffered->getBuffer().get() == this) {
+    return imotor;
+  }
+
+  std::scoped_lock lock(motorsMutex);
+  for (auto it = motors.begin(); it != motors.end();) {
+    auto wrapper = it->lock();
+    if (!wrapper) {
+      it = motors.erase(it);
+    } else if (wrapper->getMotor() == imotor) {
+      return wrapper;
+    } else {
+      ++it;
+    }
+  }
+
+  auto wrapper = std::make_shared<BufferedMotor>(imotor, shared_from_this());
+  motors.push_back(wrapper);
+  return wrapper;
+}
+
+std::uint32_t MotorCommandBuffer::commit() {
+  std::uint32_t count = 0;
+
+  {
+    std::scoped_lock lock(motorsMutex);
+    for (const auto &weak : motors) {
+      // A motor which is being deleted flushes itself
+      if (auto motor = weak.lock()) {
+        count += motor->flush() ? 1 : 0;
+      }
+    }
+  }
+
+  commits.fetch_add(1, std::memory_order_relaxed);
+  return count;
+}
+
+MotorCommandBuffer::Counters MotorCommandBuffer::getCounters() const {
+  Counters counters;
+  counters.commits = commits.load(std::memory_order_relaxed);
+  counters.requested = requested.load(std::memory_order_relaxed);
+  counters.sent = sent.load(std::memory_order_relaxed);
+  return counters;
+}
+
+BufferedMotor::BufferedMotor(std::shared_ptr<AbstractMotor> imotor,
+                             std::shared_ptr<MotorCommandBuffer> ibuffer)
+  : logger(ibuffer->logger), motor(std::move(imotor)), buffer(std::move(ibuffer)) {
+}
+
+BufferedMotor::~BufferedMotor() {
+  flush();
+}
+
+bool BufferedMotor::flush() {
+  std::scoped_lock lock(commandMutex);
+  if (pending.kind == Command::Kind::none || pending == last) {
+    pending = Command{};
+    return false;
+  }
+
+  std::int32_t result = 1;
+  switch (pending.kind) {
+  case Command::Kind::velocity:
+    result = motor->moveVelocity(static_cast<std::int16_t>(pending.value));
+    break;
+
+  case Command::Kind::voltage:
+    result = motor->moveVoltage(static_cast<std::int16_t>(pending.value));
+    break;
+
+  default:
+    motor->controllerSet(pending.value);
+    break;
+  }
+
+  buffer->sent.fetch_add(1, std::memory_order_relaxed);
+  if (result == OKAPI_PROS_ERR) {
+    // Send it again next commit
+    LOG_WARN_S("BufferedMotor: Sending a command failed, retrying on the next commit.");
+    last = Command{};
+    return true;
+  }
+
+  last = pending;
+  pending = Command{};
+  return true;
+}
+
+const std::shared_ptr<AbstractMotor> &BufferedMotor::getMotor() const {
+  return motor;
+}
+
+const std::shared_ptr<MotorCommandBuffer> &BufferedMotor::getBuffer() const {
+  return buffer;
+}
+
+void BufferedMotor::record(const Command icommand) {
+  std::scoped_lock lock(commandMutex);
+  pending = icommand;
+  buffer->requested.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::int32_t BufferedMotor::moveVelocity(const std::int16_t ivelocity) {
+  record(Command{Command::Kind::velocity, static_cast<double>(ivelocity)});
+  return 1;
+}
+
+std::int32_t BufferedMotor::moveVoltage(const std::int16_t ivoltage) {
+  record(Command{Command::Kind::voltage, static_cast<double>(ivoltage)});
+  return 1;
+}
+
+void BufferedMotor::controllerSet(const double ivalue) {
+  record(Command{Command::Kind::controller, ivalue});
+}
+
+std::int32_t BufferedMotor::moveAbsolute(const double iposition, const std::int32_t ivelocity) {
+  std::scoped_lock lock(commandMutex);
+  pending = Command{};
+  last = Command{};
+  return motor->moveAbsolute(iposition, ivelocity);
+}
+
+std::int32_t BufferedMotor::moveRelative(const double iposition, const std::int32_t ivelocity) {
+  std::scoped_lock lock(commandMutex);
+  pending = Command{};
+  last = Command{};
+  return motor->moveRelative(iposition, ivelocity);
+}
+
+std::int32_t BufferedMotor::modifyProfiledVelocity(const std::int32_t ivelocity) {
+  return motor->modifyProfiledVelocity(ivelocity);
+}
+
+double BufferedMotor::getTargetPosition() {
+  return motor->getTargetPosition();
+}
+
+double BufferedMotor::getPosition() {
+  return motor->getPosition();
+}
+
+std::int32_t BufferedMotor::tarePosition() {
+  return motor->tarePosition();
+}
+
+std::int32_t BufferedMotor::getTargetVelocity() {
+  return motor->getTargetVelocity();
+}
+
+double BufferedMotor::getActualVelocity() {
+  return motor->getActualVelocity();
+}
+
+std::int32_t BufferedMotor::getCurrentDraw() {
+  return motor->getCurrentDraw();
+}
+
+std::int32_t BufferedMotor::getDirection() {
+  return motor->getDirection();
+}
+
+double BufferedMotor::getEfficiency() {
+  return motor->getEfficiency();
+}
+
+std::int32_t BufferedMotor::isOverCurrent() {
+  return motor->isOverCurrent();
+}
+
+std::int32_t BufferedMotor::isOverTemp() {
+  return motor->isOverTemp();
+}
+
+std::int32_t BufferedMotor::isStopped() {
+  return motor->isStopped();
+}
+
+std::int32_t BufferedMotor::getZeroPositionFlag() {
+  return motor->getZeroPositionFlag();
+}
+
+uint32_t BufferedMotor::getFaults() {
+  return motor->getFaults();
+}
+
+uint32_t BufferedMotor::getFlags() {
+  return motor->getFlags();
+}
+
+std::int32_t BufferedMotor::getRawPosition(std::uint32_t *timestamp) {
+  return motor->getRawPosition(timestamp);
+}
+
+double BufferedMotor::getPower() {
+  return motor->getPower();
+}
+
+double BufferedMotor::getTemperature() {
+  return motor->getTemperature();
+}
+
+double BufferedMotor::getTorque() {
+  return motor->getTorque();
+}
+
+std::int32_t BufferedMotor::getVoltage() {
+  return motor->getVoltage();
+}
+
+std::int32_t BufferedMotor::setBrakeMode(const AbstractMotor::brakeMode imode) {
+  return motor->setBrakeMode(imode);
+}
+
+AbstractMotor::brakeMode BufferedMotor::getBrakeMode() {
+  return motor->getBrakeMode();
+}
+
+std::int32_t BufferedMotor::setCurrentLimit(const std::int32_t ilimit) {
+  return motor->setCurrentLimit(ilimit);
+}
+
+std::int32_t BufferedMotor::getCurrentLimit() {
+  return motor->getCurrentLimit();
+}
+
+std::int32_t BufferedMotor::setEncoderUnits(const AbstractMotor::encoderUnits iunits) {
+  return motor->setEncoderUnits(iunits);
+}
+
+AbstractMotor::encoderUnits BufferedMotor::getEncoderUnits() {
+  return motor->getEncoderUnits();
+}
+
+std::int32_t BufferedMotor::setGearing(const AbstractMotor::gearset igearset) {
+  // The same command means a different velocity on another gearset, so send it again
+  std::scoped_lock lock(commandMutex);
+  last = Command{};
+  return motor->setGearing(igearset);
+}
+
+AbstractMotor::gearset BufferedMotor::getGearing() {
+  return motor->getGearing();
+}
+
+std::int32_t BufferedMotor::setReversed(const bool ireverse) {
+  std::scoped_lock lock(commandMutex);
+  last = Command{};
+  return motor->setReversed(ireverse);
+}
+
+std::int32_t BufferedMotor::setVoltageLimit(const std::int32_t ilimit) {
+  return motor->setVoltageLimit(ilimit);
+}
+
+std::shared_ptr<ContinuousRotarySensor> BufferedMotor::getEncoder() {
+  return motor->getEncoder();
+}
+} // namespace okapi
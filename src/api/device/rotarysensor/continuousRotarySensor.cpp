@@ -0,0 +1,16 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/rotarysensor/continuousRotarySensor.hpp"
+
+namespace okapi {
+double ContinuousRotarySensor::getTimestamped(std::uint32_t *timestamp) const {
+  if (timestamp) {
+    *timestamp = 0;
+  }
+
+  return get();
+}
+} // namespace okapi
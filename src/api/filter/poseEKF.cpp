@@ -0,0 +1,177 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/filter/poseEKF.hpp"
+#include "okapi/api/odometry/odomMath.hpp"
+#include <cmath>
+
+namespace okapi {
+PoseEKF::PoseEKF(const OdomState &iinitialState, const Covariance &iinitialCovariance)
+  : PoseEKF(iinitialState, iinitialCovariance, ProcessNoise{}) {
+}
+
+PoseEKF::PoseEKF(const OdomState &iinitialState,
+                 const Covariance &iinitialCovariance,
+                 const ProcessNoise &inoise,
+                 const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger), noise(inoise) {
+  setState(iinitialState, iinitialCovariance);
+}
+
+void PoseEKF::predict(const OdomState &ifrom, const OdomState &ito) {
+  // Express the odometry's motion relative to the robot, along the middle of its turn
+  const auto turn = ito.theta - ifrom.theta;
+  const double mid = (ifrom.theta + turn / 2).convert(radian);
+  const auto dX = ito.x - ifrom.x;
+  const auto dY = ito.y - ifrom.y;
+  predict(dX * std::cos(mid) + dY * std::sin(mid), dY * std::cos(mid) - dX * std::sin(mid), turn);
+}
+
+void PoseEKF::predict(const QLength iforward, const QLength iright, const QAngle iturn) {
+  const double forward = iforward.convert(meter);
+  const double right = iright.convert(meter);
+  const double turn = iturn.convert(radian);
+
+  std::scoped_lock lock(mutex);
+  const double mid = x(2, 0) + turn / 2;
+  const double cosMid = std::cos(mid);
+  const double sinMid = std::sin(mid);
+
+  // How the new pose changes with the old heading
+  Covariance F = Covariance::identity();
+  F(0, 2) = -forward * sinMid - right * cosMid;
+  F(1, 2) = forward * cosMid - right * sinMid;
+
+  // How the new pose changes with errors in the motion (forward, right, turn)
+  const Covariance G{cosMid,
+                     -sinMid,
+                     F(0, 2) / 2,
+                     sinMid,
+                     cosMid,
+                     F(1, 2) / 2,
+                     0,
+                     0,
+                     1};
+
+  const double distance = std::hypot(forward, right);
+  const double turnStdDev = noise.turnError * std::abs(turn);
+  const double driftStdDev = noise.driftPerMeter.convert(radian) * distance;
+  const auto N = Covariance::diagonal({std::pow(noise.distanceError * forward, 2),
+                                       std::pow(noise.distanceError * right, 2),
+                                       turnStdDev * turnStdDev + driftStdDev * driftStdDev});
+
+  x(0, 0) += forward * cosMid - right * sinMid;
+  x(1, 0) += forward * sinMid + right * cosMid;
+  x(2, 0) += turn;
+  P = F * P * F.transpose() + G * N * G.transpose();
+}
+
+bool PoseEKF::correctHeading(const QAngle iheading, const QAngle istdDev) {
+  std::scoped_lock lock(mutex);
+
+  // The measured heading may have wrapped around, but the filter's does not
+  const auto error = OdomMath::constrainAngle180(iheading - x(2, 0) * radian);
+  return update(Matrix<1, 1>{error.convert(radian)},
+                Matrix<1, 3>{0, 0, 1},
+                Matrix<1, 1>{std::pow(istdDev.convert(radian), 2)});
+}
+
+bool PoseEKF::correctPosition(const QLength ix, const QLength iy, const QLength istdDev) {
+  const double variance = std::pow(istdDev.convert(meter), 2);
+
+  std::scoped_lock lock(mutex);
+  return update(Matrix<2, 1>{ix.convert(meter) - x(0, 0), iy.convert(meter) - x(1, 0)},
+                Matrix<2, 3>{1, 0, 0, 0, 1, 0},
+                Matrix<2, 2>::diagonal({variance, variance}));
+}
+
+bool PoseEKF::correctPose(const OdomState &ipose,
+                          const QLength ipositionStdDev,
+                          const QAngle iheadingStdDev) {
+  const double positionVariance = std::pow(ipositionStdDev.convert(meter), 2);
+
+  std::scoped_lock lock(mutex);
+  const auto headingError = OdomMath::constrainAngle180(ipose.theta - x(2, 0) * radian);
+  return update(
+    Matrix<3, 1>{ipose.x.convert(meter) - x(0, 0),
+                 ipose.y.convert(meter) - x(1, 0),
+                 headingError.convert(radian)},
+    Covariance::identity(),
+    Covariance::diagonal(
+      {positionVariance, positionVariance, std::pow(iheadingStdDev.convert(radian), 2)}));
+}
+
+bool PoseEKF::correctDistance(const QLength irange,
+                              const DistanceSensorMount &imount,
+                              const Wall &iwall,
+                              const QLength istdDev) {
+  const double forward = imount.forward.convert(meter);
+  const double right = imount.right.convert(meter);
+  const double wall = iwall.position.convert(meter);
+
+  std::scoped_lock lock(mutex);
+  const double theta = x(2, 0);
+  const double beam = theta + imount.angle.convert(radian);
+  const double cosTheta = std::cos(theta);
+  const double sinTheta = std::sin(theta);
+
+  // The range is the distance along the beam from the sensor to the wall. Work along the axis
+  // across the wall: the sensor's coordinate on it, how that moves with the heading, and how much
+  // of the beam points across the wall.
+  double sensor, sensorDTheta, across, acrossDTheta;
+  Matrix<1, 3> H;
+  if (iwall.axis == Wall::Axis::x) {
+    sensor = x(0, 0) + forward * cosTheta - right * sinTheta;
+    sensorDTheta = -forward * sinTheta - right * cosTheta;
+    across = std::cos(beam);
+    acrossDTheta = -std::sin(beam);
+  } else {
+    sensor = x(1, 0) + forward * sinTheta + right * cosTheta;
+    sensorDTheta = forward * cosTheta - right * sinTheta;
+    across = std::sin(beam);
+    acrossDTheta = std::cos(beam);
+  }
+
+  // Near-parallel beams are too sensitive to the heading to be useful
+  if (std::abs(across) < 0.1) {
+    return false;
+  }
+
+  const double expected = (wall - sensor) / across;
+  if (expected <= 0) {
+    // The wall is behind the sensor
+    return false;
+  }
+
+  const int axis = iwall.axis == Wall::Axis::x ? 0 : 1;
+  H(0, axis) = -1 / across;
+  H(0, 2) = (-sensorDTheta * across - (wall - sensor) * acrossDTheta) / (across * across);
+
+  return update(Matrix<1, 1>{irange.convert(meter) - expected},
+                H,
+                Matrix<1, 1>{std::pow(istdDev.convert(meter), 2)});
+}
+
+void PoseEKF::setOutlierGate(const double igate) {
+  std::scoped_lock lock(mutex);
+  outlierGate = igate;
+}
+
+OdomState PoseEKF::getState() const {
+  std::scoped_lock lock(mutex);
+  return OdomState{x(0, 0) * meter, x(1, 0) * meter, x(2, 0) * radian};
+}
+
+PoseEKF::Covariance PoseEKF::getCovariance() const {
+  std::scoped_lock lock(mutex);
+  return P;
+}
+
+void PoseEKF::setState(const OdomState &istate, const Covariance &icovariance) {
+  std::scoped_lock lock(mutex);
+  x = State{istate.x.convert(meter), istate.y.convert(meter), istate.theta.convert(radian)};
+  P = icovariance;
+}
+} // namespace okapi
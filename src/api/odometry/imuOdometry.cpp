@@ -0,0 +1,87 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/odometry/imuOdometry.hpp"
+#include "okapi/api/odometry/odomMath.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <cmath>
+
+namespace okapi {
+IMUOdometry::IMUOdometry(const TimeUtil &itimeUtil,
+                         const std::shared_ptr<ReadOnlyChassisModel> &imodel,
+                         const ChassisScales &ichassisScales,
+                         const std::shared_ptr<ContinuousRotarySensor> &iimu,
+                         const double iimuTrust,
+                         const bool ifuseOnlyFreshSamples,
+                         const std::shared_ptr<Logger> &ilogger)
+  : TwoEncoderOdometry(itimeUtil, imodel, ichassisScales, ilogger),
+    imu(iimu),
+    imuTrust(iimuTrust),
+    fuseOnlyFreshSamples(ifuseOnlyFreshSamples) {
+  if (imu == nullptr) {
+    std::string msg = "IMUOdometry: The IMU cannot be null.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  if (imuTrust < 0 || imuTrust > 1) {
+    std::string msg = "IMUOdometry: The IMU trust must be in the range [0, 1].";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+
+std::shared_ptr<ContinuousRotarySensor> IMUOdometry::getIMU() const {
+  return imu;
+}
+
+std::uint32_t IMUOdometry::getFusedSamples() const {
+  return fusedSamples;
+}
+
+OdomState IMUOdometry::odomMathStep(const SensorValues &itickDiff, const QTime &ideltaT) {
+  const auto encoderStep = TwoEncoderOdometry::odomMathStep(itickDiff, ideltaT);
+  const auto predicted = state.theta + encoderStep.theta;
+
+  std::uint32_t timestamp = 0;
+  const double reading = imu->getTimestamped(&timestamp);
+  if (reading == OKAPI_PROS_ERR) {
+    LOG_WARN_S("IMUOdometry: Reading the IMU failed. Using the encoders' heading for this step.");
+    return encoderStep;
+  }
+
+  const bool fresh = timestamp != 0 ? static_cast<std::int32_t>(timestamp - lastIMUTimestamp) > 0
+                                    : reading != lastReading;
+  lastReading = reading;
+  lastIMUTimestamp = timestamp;
+
+  if (!headingAligned) {
+    headingOffset = predicted - reading * degree;
+    headingAligned = true;
+    return encoderStep;
+  }
+
+  if (fuseOnlyFreshSamples && !fresh) {
+    return encoderStep;
+  }
+
+  // The IMU wraps around, but the odometry's heading does not
+  const auto error = OdomMath::constrainAngle180(reading * degree + headingOffset - predicted);
+  const auto correction = error * imuTrust;
+  fusedSamples++;
+
+  // The step moved along the middle of its turn, which the correction moves by half as much
+  const double halfTurn = correction.convert(radian) / 2;
+  const double cosTurn = std::cos(halfTurn);
+  const double sinTurn = std::sin(halfTurn);
+  return OdomState{encoderStep.x * cosTurn - encoderStep.y * sinTurn,
+                   encoderStep.y * cosTurn + encoderStep.x * sinTurn,
+                   encoderStep.theta + correction};
+}
+
+void IMUOdometry::onStateChanged() {
+  headingAligned = false;
+}
+} // namespace okapi
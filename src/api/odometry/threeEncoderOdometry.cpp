@@ -20,8 +20,7 @@ ThreeEncoderOdometry::ThreeEncoderOdometry(const TimeUtil &itimeUtil,
   }
 }
 
-OdomState ThreeEncoderOdometry::odomMathStep(const std::valarray<std::int32_t> &itickDiff,
-                                             const QTime &) {
+OdomState ThreeEncoderOdometry::odomMathStep(const SensorValues &itickDiff, const QTime &) {
   if (itickDiff.size() < 3) {
     LOG_ERROR_S("ThreeEncoderOdometry: itickDiff did not have at least three elements.");
     return OdomState{};
@@ -7,6 +7,7 @@
 #include "okapi/api/units/QAngularSpeed.hpp"
 #include "okapi/api/util/mathUtil.hpp"
 #include <cmath>
+#include <mutex>
 
 namespace okapi {
 TwoEncoderOdometry::TwoEncoderOdometry(const TimeUtil &itimeUtil,
@@ -25,23 +26,50 @@ void TwoEncoderOdometry::setScales(const ChassisScales &ichassisScales) {
 }
 
 void TwoEncoderOdometry::step() {
-  const auto deltaT = timer->getDt();
+  // Take the dt every step so it is current if the sensors stop reporting timestamps
+  auto deltaT = timer->getDt();
+  newTicks = model->getSensorValues();
+
+  if (const auto timestamp = newTicks.getTimestamp(); timestamp != 0) {
+    if (lastTimestamp != 0) {
+      // Compare the difference so the device clock wrapping around does not matter
+      const auto sampleDt = static_cast<std::int32_t>(timestamp - lastTimestamp);
+      if (sampleDt <= 0) {
+        // Nothing new since the last step. Keep lastTicks so no motion is lost.
+        staleSamples++;
+        return;
+      }
+
+      deltaT = sampleDt * millisecond;
+    }
+
+    lastTimestamp = timestamp;
+  } else {
+    lastTimestamp = 0;
+  }
 
   if (deltaT.getValue() != 0) {
-    newTicks = model->getSensorVals();
     tickDiff = newTicks - lastTicks;
     lastTicks = newTicks;
 
+    std::scoped_lock lock(stateMutex);
     const auto newState = odomMathStep(tickDiff, deltaT);
+    const auto avgTheta = state.theta + newState.theta / 2;
 
     state.x += newState.x;
     state.y += newState.y;
     state.theta += newState.theta;
+
+    recordState(lastTimestamp != 0 ? lastTimestamp * millisecond : timer->millis());
+
+    linearVelocity = (newState.x * std::cos(avgTheta.convert(radian)) +
+                      newState.y * std::sin(avgTheta.convert(radian))) /
+                     deltaT;
+    angularVelocity = newState.theta / deltaT;
   }
 }
 
-OdomState TwoEncoderOdometry::odomMathStep(const std::valarray<std::int32_t> &itickDiff,
-                                           const QTime &) {
+OdomState TwoEncoderOdometry::odomMathStep(const SensorValues &itickDiff, const QTime &) {
   if (itickDiff.size() < 2) {
     LOG_ERROR_S("TwoEncoderOdometry: itickDiff did not have at least two elements.");
     return OdomState{};
@@ -95,6 +123,7 @@ OdomState TwoEncoderOdometry::odomMathStep(const std::valarray<std::int32_t> &it
 }
 
 OdomState TwoEncoderOdometry::getState(const StateMode &imode) const {
+  std::scoped_lock lock(stateMutex);
   if (imode == StateMode::FRAME_TRANSFORMATION) {
     return state;
   } else {
@@ -104,11 +133,115 @@ OdomState TwoEncoderOdometry::getState(const StateMode &imode) const {
 
 void TwoEncoderOdometry::setState(const OdomState &istate, const StateMode &imode) {
   LOG_DEBUG("State set to: " + istate.str());
+  std::scoped_lock lock(stateMutex);
   if (imode == StateMode::FRAME_TRANSFORMATION) {
     state = istate;
   } else {
     state = OdomState{istate.y, istate.x, istate.theta};
   }
+
+  // The remembered states were in the old frame
+  historyCount = 0;
+  onStateChanged();
+}
+
+OdomState TwoEncoderOdometry::getStateAt(const QTime itime, const StateMode &imode) const {
+  std::scoped_lock lock(stateMutex);
+  const auto out = interpolateState(itime);
+  if (imode == StateMode::FRAME_TRANSFORMATION) {
+    return out;
+  } else {
+    return OdomState{out.y, out.x, out.theta};
+  }
+}
+
+bool TwoEncoderOdometry::correctStateAt(const QTime itime,
+                                        const OdomState &istate,
+                                        const StateMode &imode) {
+  const auto corrected = imode == StateMode::FRAME_TRANSFORMATION
+                           ? istate
+                           : OdomState{istate.y, istate.x, istate.theta};
+
+  std::scoped_lock lock(stateMutex);
+  if (historyCount == 0 || itime < historyAt(0).time) {
+    LOG_WARN_S("TwoEncoderOdometry: Can't correct the state at a time older than the oldest "
+               "remembered step.");
+    return false;
+  }
+
+  // Move every later state rigidly so it keeps its motion relative to the corrected state. This
+  // is the same as integrating the steps since then again, starting from the corrected state.
+  const auto old = interpolateState(itime);
+  const auto turn = corrected.theta - old.theta;
+  const double cosTurn = std::cos(turn.convert(radian));
+  const double sinTurn = std::sin(turn.convert(radian));
+  const auto move = [&](OdomState &ostate) {
+    const auto dX = ostate.x - old.x;
+    const auto dY = ostate.y - old.y;
+    ostate.x = corrected.x + dX * cosTurn - dY * sinTurn;
+    ostate.y = corrected.y + dY * cosTurn + dX * sinTurn;
+    ostate.theta += turn;
+  };
+
+  for (std::size_t i = 0; i < historyCount; ++i) {
+    if (historyAt(i).time >= itime) {
+      move(historyAt(i).state);
+    }
+  }
+
+  move(state);
+  onStateChanged();
+  return true;
+}
+
+void TwoEncoderOdometry::recordState(const QTime itime) {
+  if (historyCount < historySize) {
+    historyCount++;
+  } else {
+    historyStart = (historyStart + 1) % historySize;
+  }
+
+  historyAt(historyCount - 1) = TimedState{itime, state};
+}
+
+TwoEncoderOdometry::TimedState &TwoEncoderOdometry::historyAt(const std::size_t i) {
+  return history[(historyStart + i) % historySize];
+}
+
+const TwoEncoderOdometry::TimedState &TwoEncoderOdometry::historyAt(const std::size_t i) const {
+  return history[(historyStart + i) % historySize];
+}
+
+void TwoEncoderOdometry::onStateChanged() {
+}
+
+OdomState TwoEncoderOdometry::interpolateState(const QTime itime) const {
+  if (historyCount == 0 || itime >= historyAt(historyCount - 1).time) {
+    return state;
+  }
+
+  if (itime <= historyAt(0).time) {
+    return historyAt(0).state;
+  }
+
+  // Search from the newest state since recent times are the most common
+  for (std::size_t i = historyCount - 1; i > 0; --i) {
+    const auto &before = historyAt(i - 1);
+    if (before.time <= itime) {
+      const auto &after = historyAt(i);
+      const auto span = after.time - before.time;
+      if (span.getValue() <= 0) {
+        return after.state;
+      }
+
+      const double t = ((itime - before.time) / span).getValue();
+      return OdomState{before.state.x + (after.state.x - before.state.x) * t,
+                       before.state.y + (after.state.y - before.state.y) * t,
+                       before.state.theta + (after.state.theta - before.state.theta) * t};
+    }
+  }
+
+  return historyAt(0).state;
 }
 
 std::shared_ptr<ReadOnlyChassisModel> TwoEncoderOdometry::getModel() {
@@ -118,4 +251,16 @@ std::shared_ptr<ReadOnlyChassisModel> TwoEncoderOdometry::getModel() {
 ChassisScales TwoEncoderOdometry::getScales() {
   return chassisScales;
 }
+
+QSpeed TwoEncoderOdometry::getLinearVelocity() const {
+  return linearVelocity;
+}
+
+QAngularSpeed TwoEncoderOdometry::getAngularVelocity() const {
+  return angularVelocity;
+}
+
+std::uint32_t TwoEncoderOdometry::getStaleSamples() const {
+  return staleSamples;
+}
 } // namespace okapi
@@ -12,6 +12,10 @@ AbstractTimer::AbstractTimer(const QTime ifirstCalled)
 
 AbstractTimer::~AbstractTimer() = default;
 
+QTime AbstractTimer::micros() const {
+  return millis();
+}
+
 QTime AbstractTimer::getDt() {
   const QTime currTime = millis();
   const QTime dt = currTime - lastCalled;
@@ -0,0 +1,153 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/logRecord.hpp"
+#include "okapi/api/util/byteOrder.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace okapi {
+namespace {
+// Indexed by LogEvent
+constexpr const char *eventFormats[] = {
+  nullptr,
+  "Logger: Dropped %.0f records because the buffer was full",
+  "IterativePosPIDController: Set target to %f",
+  "IterativePosPIDController: flipDisable %.0f",
+  "IterativeVelPIDController: Set target to %f",
+  "IterativeVelPIDController: flipDisable %.0f",
+  "AsyncPosIntegratedController: Set target to %f",
+  "AsyncPosIntegratedController: flipDisable %.0f",
+  "AsyncVelIntegratedController: Set target to %f",
+  "AsyncVelIntegratedController: flipDisable %.0f",
+  "AsyncWrapper: Set target to %f",
+  "ChassisControllerPID: moving %f meters (%f motor ticks)",
+  "ChassisControllerPID: turning %f degrees (%f motor ticks)",
+  "ChassisControllerPID: scale %f ratio %f",
+  "ChassisControllerIntegrated: moving %f meters (%f motor ticks)",
+  "ChassisControllerIntegrated: turning %f degrees (%f motor ticks)",
+  "LoopStats: %.0f ticks, %.0f overruns, max execution time %.3f ms, max jitter %.3f ms"};
+
+// Indexed by Logger::LogLevel
+constexpr const char *levelNames[] = {"OFF", "ERROR", "WARN", "INFO", "DEBUG"};
+} // namespace
+
+constexpr char LogFileHeader::expectedMagic[4];
+
+void convertLogRecordByteOrder(LogRecord &irecord) noexcept {
+  // LogEvent::message is zero in either byte order, so the event can be checked before or after
+  // it is converted
+  if (irecord.event != static_cast<std::uint16_t>(LogEvent::message)) {
+    for (auto &field : irecord.fields) {
+      convertLittleEndian(field);
+    }
+  }
+
+  convertLittleEndian(irecord.time);
+  convertLittleEndian(irecord.event);
+}
+
+void convertLogFileHeaderByteOrder(LogFileHeader &iheader) noexcept {
+  convertLittleEndian(iheader.version);
+  convertLittleEndian(iheader.recordSize);
+}
+
+const char *getLogEventFormat(const std::uint16_t ievent) noexcept {
+  if (ievent >= sizeof(eventFormats) / sizeof(eventFormats[0])) {
+    return nullptr;
+  }
+
+  return eventFormats[ievent];
+}
+
+const char *getLogLevelName(const std::uint8_t ilevel) noexcept {
+  return ilevel < sizeof(levelNames) / sizeof(levelNames[0]) ? levelNames[ilevel] : "?";
+}
+
+int formatLogRecord(const LogRecord &irecord, char *obuffer, const std::size_t isize) noexcept {
+  // Each piece is written after the previous one, or only measured once the buffer is full
+  int length = 0;
+  const auto append = [&](const int ipieceLength) {
+    length = (length < 0 || ipieceLength < 0) ? -1 : length + ipieceLength;
+  };
+  const auto position = [&]() {
+    return static_cast<std::size_t>(length) < isize ? obuffer + length : nullptr;
+  };
+  const auto remaining = [&]() {
+    return static_cast<std::size_t>(length) < isize ? isize - length : 0;
+  };
+
+  // The task name and message might fill their whole array, so limit how much is read
+  append(snprintf(position(),
+                  remaining(),
+                  "%ld (%.*s) %s: ",
+                  static_cast<long>(irecord.time),
+                  static_cast<int>(LogRecord::taskNameSize),
+                  irecord.taskName,
+                  getLogLevelName(irecord.level)));
+
+  if (irecord.event == static_cast<std::uint16_t>(LogEvent::message)) {
+    append(snprintf(position(),
+                    remaining(),
+                    "%.*s",
+                    static_cast<int>(LogRecord::messageSize),
+                    irecord.message));
+  } else if (const char *format = getLogEventFormat(irecord.event)) {
+    // Every field is passed; printf ignores the ones the format doesn't use
+    const auto &f = irecord.fields;
+    append(snprintf(position(), remaining(), format, f[0], f[1], f[2], f[3]));
+  } else {
+    append(snprintf(position(), remaining(), "Unknown event %u", irecord.event));
+  }
+
+  append(snprintf(position(), remaining(), "\n"));
+  return length;
+}
+
+bool decodeBinaryLog(std::istream &istream, std::ostream &ostream) {
+  LogFileHeader header;
+  if (!istream.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+      std::memcmp(header.magic, LogFileHeader::expectedMagic, sizeof(header.magic)) != 0) {
+    return false;
+  }
+  convertLogFileHeaderByteOrder(header);
+
+  char line[sizeof(LogRecord) + 64];
+  while (true) {
+    if (header.version != LogFileHeader::currentVersion || header.recordSize != sizeof(LogRecord)) {
+      return false;
+    }
+
+    LogRecord record;
+    if (!istream.read(reinterpret_cast<char *>(&record), sizeof(LogFileHeader::expectedMagic))) {
+      // The file ended cleanly between records
+      return istream.gcount() == 0;
+    }
+
+    // Another log was appended to this one, so read its header and continue
+    if (std::memcmp(&record, LogFileHeader::expectedMagic, sizeof(header.magic)) == 0) {
+      std::memcpy(header.magic, &record, sizeof(header.magic));
+      if (!istream.read(reinterpret_cast<char *>(&header) + sizeof(header.magic),
+                    sizeof(header) - sizeof(header.magic))) {
+        return false;
+      }
+      convertLogFileHeaderByteOrder(header);
+      continue;
+    }
+
+    if (!istream.read(reinterpret_cast<char *>(&record) + sizeof(header.magic),
+                  sizeof(record) - sizeof(header.magic))) {
+      return false;
+    }
+    convertLogRecordByteOrder(record);
+
+    const int length = formatLogRecord(record, line, sizeof(line));
+    if (length > 0) {
+      ostream.write(line, std::min<std::size_t>(length, sizeof(line) - 1));
+    }
+  }
+}
+} // namespace okapi
@@ -0,0 +1,61 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/logRingBuffer.hpp"
+
+namespace okapi {
+LogRingBuffer::LogRingBuffer(const std::size_t icapacity) : capacity(1) {
+  while (capacity < icapacity) {
+    capacity <<= 1;
+  }
+
+  slots = std::make_unique<Slot[]>(capacity);
+  for (std::size_t i = 0; i < capacity; ++i) {
+    slots[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+bool LogRingBuffer::push(const LogRecord &irecord) noexcept {
+  std::size_t position = head.load(std::memory_order_relaxed);
+  while (true) {
+    Slot &slot = slots[position & (capacity - 1)];
+    const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+    if (sequence == position) {
+      // The slot is free; claim it unless another producer got there first
+      if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+        slot.record = irecord;
+        slot.sequence.store(position + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (sequence < position) {
+      // The slot still holds a record from the previous lap, so the buffer is full
+      return false;
+    } else {
+      // Another producer claimed this position, so try the next one
+      position = head.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+bool LogRingBuffer::pop(LogRecord &orecord) noexcept {
+  const std::size_t position = tail.load(std::memory_order_relaxed);
+  Slot &slot = slots[position & (capacity - 1)];
+
+  if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+    // The record at this position has not been written yet
+    return false;
+  }
+
+  orecord = slot.record;
+  slot.sequence.store(position + capacity, std::memory_order_release);
+  tail.store(position + 1, std::memory_order_relaxed);
+  return true;
+}
+
+std::size_t LogRingBuffer::getCapacity() const noexcept {
+  return capacity;
+}
+} // namespace okapi
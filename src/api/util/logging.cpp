@@ -4,8 +4,30 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include "okapi/api/util/logging.hpp"
+#include <algorithm>
+#include <cstring>
+#ifdef THREADS_STD
+#include <chrono>
+#include <thread>
+#endif
 
 namespace okapi {
+namespace {
+// How long the flusher sleeps between batches
+constexpr std::uint32_t flushPeriodMs = 10;
+
+// Records are written to the file once this much text is batched
+constexpr std::size_t batchSize = 4096;
+
+void sleepMs(const std::uint32_t ims) {
+#ifdef THREADS_STD
+  std::this_thread::sleep_for(std::chrono::milliseconds(ims));
+#else
+  pros::c::delay(ims);
+#endif
+}
+} // namespace
+
 std::shared_ptr<Logger> defaultLogger;
 
 int DefaultLoggerInitializer::count;
@@ -15,25 +37,230 @@ Logger::Logger() noexcept : Logger(nullptr, nullptr, LogLevel::off) {
 
 Logger::Logger(std::unique_ptr<AbstractTimer> itimer,
                std::string_view ifileName,
-               const Logger::LogLevel &ilevel) noexcept
+               const Logger::LogLevel &ilevel,
+               const std::size_t iasyncCapacity,
+               const Format &iformat) noexcept
   : Logger(std::move(itimer),
-           fopen(ifileName.data(), isSerialStream(ifileName) ? "w" : "a"),
-           ilevel) {
+           fopen(ifileName.data(),
+                 isSerialStream(ifileName) ? (iformat == Format::binary ? "wb" : "w")
+                                           : (iformat == Format::binary ? "ab" : "a")),
+           ilevel,
+           iasyncCapacity,
+           iformat) {
 }
 
 Logger::Logger(std::unique_ptr<AbstractTimer> itimer,
                FILE *const ifile,
-               const Logger::LogLevel &ilevel) noexcept
-  : timer(std::move(itimer)), logLevel(ilevel), logfile(ifile) {
+               const Logger::LogLevel &ilevel,
+               const std::size_t iasyncCapacity,
+               const Format &iformat) noexcept
+  : timer(std::move(itimer)), format(iformat), logfile(ifile) {
+  for (auto &level : componentLevels) {
+    level.store(toUnderlyingType(ilevel), std::memory_order_relaxed);
+  }
+
+  if (!logfile) {
+    return;
+  }
+
+  batch.reserve(batchSize + sizeof(LogRecord) + 64);
+
+  if (format == Format::binary) {
+    // The decoder also accepts a header in the middle of a file, so appending to a log is fine
+    LogFileHeader header{{LogFileHeader::expectedMagic[0],
+                          LogFileHeader::expectedMagic[1],
+                          LogFileHeader::expectedMagic[2],
+                          LogFileHeader::expectedMagic[3]},
+                         LogFileHeader::currentVersion,
+                         static_cast<std::uint16_t>(sizeof(LogRecord))};
+    convertLogFileHeaderByteOrder(header);
+    fwrite(&header, sizeof(header), 1, logfile);
+  }
+
+  if (iasyncCapacity > 0) {
+    records = std::make_unique<LogRingBuffer>(iasyncCapacity);
+    flusherRunning.store(true, std::memory_order_release);
+    flusherStopped.store(false, std::memory_order_release);
+    flusher =
+      std::make_unique<CrossplatformThread>(trampoline, this, "Logger", flusherPriority);
+  }
 }
 
 Logger::~Logger() {
+  close();
+}
+
+void Logger::close() noexcept {
+  stopFlusher();
+
   if (logfile) {
     fclose(logfile);
     logfile = nullptr;
   }
 }
 
+void Logger::setComponentLevel(const Component &icomponent, const LogLevel &ilevel) noexcept {
+  componentLevels[toUnderlyingType(icomponent)].store(toUnderlyingType(ilevel),
+                                                      std::memory_order_relaxed);
+}
+
+Logger::LogLevel Logger::getComponentLevel(const Component &icomponent) const noexcept {
+  return static_cast<LogLevel>(
+    componentLevels[toUnderlyingType(icomponent)].load(std::memory_order_relaxed));
+}
+
+bool Logger::isAsync() const noexcept {
+  return records != nullptr;
+}
+
+std::size_t Logger::getDroppedRecords() const noexcept {
+  return droppedRecords.load(std::memory_order_relaxed);
+}
+
+void Logger::log(const LogLevel &ilevel, const std::string &imessage) noexcept {
+  if (!records && format == Format::text) {
+    // Nothing to gain from a record here, and this way long messages aren't truncated
+    char taskName[LogRecord::taskNameSize];
+    CrossplatformThread::getName(taskName, sizeof(taskName));
+
+    std::scoped_lock lock(logfileMutex);
+    fprintf(logfile,
+            "%ld (%s) %s: %s\n",
+            static_cast<long>(timer->millis().convert(millisecond)),
+            taskName,
+            getLogLevelName(static_cast<std::uint8_t>(ilevel)),
+            imessage.c_str());
+    return;
+  }
+
+  LogRecord record;
+  record.event = static_cast<std::uint16_t>(LogEvent::message);
+  record.level = static_cast<std::uint8_t>(ilevel);
+  record.fieldCount = 0;
+  std::strncpy(record.message, imessage.c_str(), LogRecord::messageSize - 1);
+  record.message[LogRecord::messageSize - 1] = '\0';
+  submit(record);
+}
+
+void Logger::log(const LogLevel &ilevel,
+                 const LogEvent ievent,
+                 const std::array<double, LogRecord::maxFields> &ifields,
+                 const std::size_t ifieldCount) noexcept {
+  LogRecord record;
+  record.event = static_cast<std::uint16_t>(ievent);
+  record.level = static_cast<std::uint8_t>(ilevel);
+  record.fieldCount = static_cast<std::uint8_t>(ifieldCount);
+  std::copy(ifields.begin(), ifields.end(), record.fields);
+  submit(record);
+}
+
+void Logger::submit(LogRecord &irecord) noexcept {
+  irecord.time = static_cast<std::int32_t>(timer->millis().convert(millisecond));
+  CrossplatformThread::getName(irecord.taskName, LogRecord::taskNameSize);
+
+  if (records) {
+    if (!records->push(irecord)) {
+      droppedRecords.fetch_add(1, std::memory_order_relaxed);
+      unreportedDroppedRecords.fetch_add(1, std::memory_order_relaxed);
+    }
+    return;
+  }
+
+  std::scoped_lock lock(logfileMutex);
+  if (logfile) {
+    append(irecord);
+    fwrite(batch.data(), 1, batch.size(), logfile);
+    batch.clear();
+  }
+}
+
+void Logger::append(const LogRecord &irecord) noexcept {
+  if (format == Format::binary) {
+    LogRecord stored = irecord;
+    convertLogRecordByteOrder(stored);
+    const auto *bytes = reinterpret_cast<const char *>(&stored);
+    batch.insert(batch.end(), bytes, bytes + sizeof(LogRecord));
+    return;
+  }
+
+  // Long enough for any record
+  char line[sizeof(LogRecord) + 64];
+  const int length = formatLogRecord(irecord, line, sizeof(line));
+  if (length > 0) {
+    batch.insert(
+      batch.end(), line, line + std::min(static_cast<std::size_t>(length), sizeof(line) - 1));
+  }
+}
+
+void Logger::flush() noexcept {
+  std::scoped_lock lock(logfileMutex);
+  if (!logfile) {
+    return;
+  }
+
+  const auto write = [&]() {
+    if (!batch.empty()) {
+      fwrite(batch.data(), 1, batch.size(), logfile);
+      batch.clear();
+    }
+  };
+
+  bool wroteAnything = false;
+  LogRecord record;
+  while (records->pop(record)) {
+    append(record);
+    wroteAnything = true;
+    if (batch.size() >= batchSize) {
+      write();
+    }
+  }
+
+  const std::size_t dropped = unreportedDroppedRecords.exchange(0, std::memory_order_relaxed);
+  if (dropped > 0) {
+    record.time = static_cast<std::int32_t>(timer->millis().convert(millisecond));
+    record.event = static_cast<std::uint16_t>(LogEvent::loggerDroppedRecords);
+    record.level = static_cast<std::uint8_t>(LogLevel::warn);
+    record.fieldCount = 1;
+    std::strncpy(record.taskName, "Logger", LogRecord::taskNameSize);
+    record.fields[0] = static_cast<double>(dropped);
+    append(record);
+    wroteAnything = true;
+  }
+
+  write();
+  if (wroteAnything) {
+    fflush(logfile);
+  }
+}
+
+void Logger::stopFlusher() noexcept {
+  if (!flusher) {
+    return;
+  }
+
+  // Let the flusher finish its current batch and return on its own instead of deleting it while it
+  // might hold the file
+  flusherRunning.store(false, std::memory_order_release);
+  while (!flusherStopped.load(std::memory_order_acquire)) {
+    sleepMs(1);
+  }
+  flusher.reset();
+
+  // Write anything logged after the flusher's last batch
+  flush();
+}
+
+void Logger::trampoline(void *context) {
+  if (context) {
+    auto *logger = static_cast<Logger *>(context);
+    while (logger->flusherRunning.load(std::memory_order_acquire)) {
+      logger->flush();
+      sleepMs(flushPeriodMs);
+    }
+    logger->flusherStopped.store(true, std::memory_order_release);
+  }
+}
+
 std::shared_ptr<Logger> Logger::getDefaultLogger() {
   return defaultLogger;
 }
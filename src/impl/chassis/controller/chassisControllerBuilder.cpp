@@ -227,6 +227,7 @@ ChassisControllerBuilder &ChassisControllerBuilder::withOdometry(const StateMode
                                                                  const QAngle &iturnThreshold) {
   hasOdom = true;
   odometry = nullptr;
+  odomIMU = nullptr;
   stateMode = imode;
   moveThreshold = imoveThreshold;
   turnThreshold = iturnThreshold;
@@ -241,6 +242,7 @@ ChassisControllerBuilder &ChassisControllerBuilder::withOdometry(const ChassisSc
   differentOdomScales = true;
   odomScales = iodomScales;
   odometry = nullptr;
+  odomIMU = nullptr;
   stateMode = imode;
   moveThreshold = imoveThreshold;
   turnThreshold = iturnThreshold;
@@ -260,6 +262,31 @@ ChassisControllerBuilder::withOdometry(std::shared_ptr<Odometry> iodometry,
 
   hasOdom = true;
   odometry = std::move(iodometry);
+  odomIMU = nullptr;
+  stateMode = imode;
+  moveThreshold = imoveThreshold;
+  turnThreshold = iturnThreshold;
+  return *this;
+}
+
+ChassisControllerBuilder &
+ChassisControllerBuilder::withOdometry(const std::shared_ptr<ContinuousRotarySensor> &iimu,
+                                       const double iimuTrust,
+                                       const bool ifuseOnlyFreshSamples,
+                                       const StateMode &imode,
+                                       const QLength &imoveThreshold,
+                                       const QAngle &iturnThreshold) {
+  if (iimu == nullptr) {
+    std::string msg = "ChassisControllerBuilder: The odometry IMU cannot be null.";
+    LOG_ERROR(msg);
+    throw std::runtime_error(msg);
+  }
+
+  hasOdom = true;
+  odometry = nullptr;
+  odomIMU = iimu;
+  odomIMUTrust = iimuTrust;
+  odomFuseOnlyFreshSamples = ifuseOnlyFreshSamples;
   stateMode = imode;
   moveThreshold = imoveThreshold;
   turnThreshold = iturnThreshold;
@@ -327,6 +354,12 @@ ChassisControllerBuilder::withLogger(const std::shared_ptr<Logger> &ilogger) {
   return *this;
 }
 
+ChassisControllerBuilder &
+ChassisControllerBuilder::withScheduler(const std::shared_ptr<ControlScheduler> &ischeduler) {
+  scheduler = ischeduler;
+  return *this;
+}
+
 ChassisControllerBuilder &ChassisControllerBuilder::parentedToCurrentTask() {
   isParentedToCurrentTask = true;
   return *this;
@@ -382,14 +415,32 @@ std::shared_ptr<OdomChassisController> ChassisControllerBuilder::buildOdometry()
 std::shared_ptr<DefaultOdomChassisController>
 ChassisControllerBuilder::buildDOCC(std::shared_ptr<ChassisController> chassisController) {
   if (odometry == nullptr) {
-    if (middleSensor == nullptr) {
+    // On a scheduler, the odometry and the chassis controller share each tick's sensor readings
+    std::shared_ptr<ReadOnlyChassisModel> sensors = chassisController->getModel();
+    if (scheduler) {
+      sensors = scheduler->getSensorCache()->cache(sensors);
+    }
+
+    if (odomIMU) {
+      if (middleSensor) {
+        LOG_WARN_S("ChassisControllerBuilder: IMUOdometry does not use the middle encoder.");
+      }
+
+      odometry = std::make_shared<IMUOdometry>(odometryTimeUtilFactory.create(),
+                                               sensors,
+                                               odomScales,
+                                               odomIMU,
+                                               odomIMUTrust,
+                                               odomFuseOnlyFreshSamples,
+                                               controllerLogger);
+    } else if (middleSensor == nullptr) {
       odometry = std::make_shared<TwoEncoderOdometry>(odometryTimeUtilFactory.create(),
-                                                      chassisController->getModel(),
+                                                      sensors,
                                                       odomScales,
                                                       controllerLogger);
     } else {
       odometry = std::make_shared<ThreeEncoderOdometry>(odometryTimeUtilFactory.create(),
-                                                        chassisController->getModel(),
+                                                        sensors,
                                                         odomScales,
                                                         controllerLogger);
     }
@@ -404,10 +455,14 @@ ChassisControllerBuilder::buildDOCC(std::shared_ptr<ChassisController> chassisCo
                                                    turnThreshold,
                                                    controllerLogger);
 
-  out->startOdomThread();
+  if (scheduler) {
+    out->startOdomThread(scheduler);
+  } else {
+    out->startOdomThread();
 
-  if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
-    out->getOdomThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+    if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
+      out->getOdomThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+    }
   }
 
   return out;
@@ -420,6 +475,11 @@ std::shared_ptr<ChassisControllerPID> ChassisControllerBuilder::buildCCPID() {
     odomScales.straight = odomScales.straight / gearset.ratio;
     odomScales.turn = odomScales.turn / gearset.ratio;
   }
+
+  if (scheduler) {
+    bufferMotors(scheduler->getCommandBuffer());
+  }
+
   auto out = std::make_shared<ChassisControllerPID>(
     chassisControllerTimeUtilFactory.create(),
     makeChassisModel(),
@@ -439,10 +499,14 @@ std::shared_ptr<ChassisControllerPID> ChassisControllerBuilder::buildCCPID() {
     odomScales,
     controllerLogger);
 
-  out->startThread();
+  if (scheduler) {
+    out->startThread(scheduler);
+  } else {
+    out->startThread();
 
-  if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
-    out->getThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+    if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
+      out->getThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+    }
   }
 
   return out;
@@ -514,6 +578,28 @@ std::shared_ptr<ChassisModel> ChassisControllerBuilder::makeChassisModel() {
   }
 }
 
+void ChassisControllerBuilder::bufferMotors(const std::shared_ptr<MotorCommandBuffer> &ibuffer) {
+  switch (driveMode) {
+  case DriveMode::SkidSteer:
+    skidSteerMotors.left = ibuffer->buffer(skidSteerMotors.left);
+    skidSteerMotors.right = ibuffer->buffer(skidSteerMotors.right);
+    break;
+
+  case DriveMode::XDrive:
+    xDriveMotors.topLeft = ibuffer->buffer(xDriveMotors.topLeft);
+    xDriveMotors.topRight = ibuffer->buffer(xDriveMotors.topRight);
+    xDriveMotors.bottomRight = ibuffer->buffer(xDriveMotors.bottomRight);
+    xDriveMotors.bottomLeft = ibuffer->buffer(xDriveMotors.bottomLeft);
+    break;
+
+  case DriveMode::HDrive:
+    hDriveMotors.left = ibuffer->buffer(hDriveMotors.left);
+    hDriveMotors.right = ibuffer->buffer(hDriveMotors.right);
+    hDriveMotors.middle = ibuffer->buffer(hDriveMotors.middle);
+    break;
+  }
+}
+
 std::shared_ptr<SkidSteerModel> ChassisControllerBuilder::makeSkidSteerModel() {
   if (middleSensor != nullptr) {
     return std::make_shared<ThreeEncoderSkidSteerModel>(skidSteerMotors.left,
@@ -68,6 +68,18 @@ AsyncMotionProfileControllerBuilder::withLimits(const PathfinderLimits &ilimits)
   return *this;
 }
 
+AsyncMotionProfileControllerBuilder &AsyncMotionProfileControllerBuilder::withTrajectoryCache(
+  const std::shared_ptr<TrajectoryCache> &icache) {
+  trajectoryCache = icache;
+  return *this;
+}
+
+AsyncMotionProfileControllerBuilder &AsyncMotionProfileControllerBuilder::withPathMemoryBudget(
+  const std::shared_ptr<PathMemoryBudget> &ibudget) {
+  pathMemoryBudget = ibudget;
+  return *this;
+}
+
 AsyncMotionProfileControllerBuilder &
 AsyncMotionProfileControllerBuilder::withTimeUtilFactory(const TimeUtilFactory &itimeUtilFactory) {
   timeUtilFactory = itimeUtilFactory;
@@ -80,6 +92,12 @@ AsyncMotionProfileControllerBuilder::withLogger(const std::shared_ptr<Logger> &i
   return *this;
 }
 
+AsyncMotionProfileControllerBuilder &AsyncMotionProfileControllerBuilder::withScheduler(
+  const std::shared_ptr<ControlScheduler> &ischeduler) {
+  scheduler = ischeduler;
+  return *this;
+}
+
 AsyncMotionProfileControllerBuilder &AsyncMotionProfileControllerBuilder::parentedToCurrentTask() {
   isParentedToCurrentTask = true;
   return *this;
@@ -107,10 +125,15 @@ AsyncMotionProfileControllerBuilder::buildLinearMotionProfileController() {
 
   auto out = std::make_shared<AsyncLinearMotionProfileController>(
     timeUtilFactory.create(), limits, output, diameter, pair, controllerLogger);
-  out->startThread();
-
-  if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
-    out->getThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+  out->setPathMemoryBudget(pathMemoryBudget);
+  if (scheduler) {
+    out->startThread(scheduler);
+  } else {
+    out->startThread();
+
+    if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
+      out->getThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+    }
   }
 
   return out;
@@ -132,10 +155,16 @@ AsyncMotionProfileControllerBuilder::buildMotionProfileController() {
 
   auto out = std::make_shared<AsyncMotionProfileController>(
     timeUtilFactory.create(), limits, model, scales, pair, controllerLogger);
-  out->startThread();
-
-  if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
-    out->getThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+  out->setTrajectoryCache(trajectoryCache);
+  out->setPathMemoryBudget(pathMemoryBudget);
+  if (scheduler) {
+    out->startThread(scheduler);
+  } else {
+    out->startThread();
+
+    if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
+      out->getThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+    }
   }
 
   return out;
@@ -94,6 +94,12 @@ AsyncPosControllerBuilder::withLogger(const std::shared_ptr<Logger> &ilogger) {
   return *this;
 }
 
+AsyncPosControllerBuilder &
+AsyncPosControllerBuilder::withScheduler(const std::shared_ptr<ControlScheduler> &ischeduler) {
+  scheduler = ischeduler;
+  return *this;
+}
+
 AsyncPosControllerBuilder &AsyncPosControllerBuilder::parentedToCurrentTask() {
   isParentedToCurrentTask = true;
   return *this;
@@ -139,10 +145,14 @@ std::shared_ptr<AsyncPosPIDController> AsyncPosControllerBuilder::buildAPPC() {
                                                      pair.ratio,
                                                      std::move(derivativeFilter),
                                                      controllerLogger);
-  out->startThread();
+  if (scheduler) {
+    out->startThread(scheduler);
+  } else {
+    out->startThread();
 
-  if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
-    out->getThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+    if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
+      out->getThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+    }
   }
 
   return out;
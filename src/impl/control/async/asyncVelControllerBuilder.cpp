@@ -101,6 +101,12 @@ AsyncVelControllerBuilder::withLogger(const std::shared_ptr<Logger> &ilogger) {
   return *this;
 }
 
+AsyncVelControllerBuilder &
+AsyncVelControllerBuilder::withScheduler(const std::shared_ptr<ControlScheduler> &ischeduler) {
+  scheduler = ischeduler;
+  return *this;
+}
+
 AsyncVelControllerBuilder &AsyncVelControllerBuilder::parentedToCurrentTask() {
   isParentedToCurrentTask = true;
   return *this;
@@ -154,10 +160,14 @@ std::shared_ptr<AsyncVelPIDController> AsyncVelControllerBuilder::buildAVPC() {
                                                      pair.ratio,
                                                      std::move(derivativeFilter),
                                                      controllerLogger);
-  out->startThread();
+  if (scheduler) {
+    out->startThread(scheduler);
+  } else {
+    out->startThread();
 
-  if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
-    out->getThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+    if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
+      out->getThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+    }
   }
 
   return out;
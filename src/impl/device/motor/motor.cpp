@@ -173,17 +173,28 @@ std::int32_t Motor::getCurrentLimit() {
 }
 
 std::int32_t Motor::setEncoderUnits(const AbstractMotor::encoderUnits iunits) {
+  pros::motor_encoder_units_e_t units;
   switch (iunits) {
   case AbstractMotor::encoderUnits::counts:
-    return pros::c::motor_set_encoder_units(port, pros::E_MOTOR_ENCODER_COUNTS);
+    units = pros::E_MOTOR_ENCODER_COUNTS;
+    break;
   case AbstractMotor::encoderUnits::degrees:
-    return pros::c::motor_set_encoder_units(port, pros::E_MOTOR_ENCODER_DEGREES);
+    units = pros::E_MOTOR_ENCODER_DEGREES;
+    break;
   case AbstractMotor::encoderUnits::rotations:
-    return pros::c::motor_set_encoder_units(port, pros::E_MOTOR_ENCODER_ROTATIONS);
+    units = pros::E_MOTOR_ENCODER_ROTATIONS;
+    break;
   case AbstractMotor::encoderUnits::invalid:
   default:
-    return pros::c::motor_set_encoder_units(port, pros::E_MOTOR_ENCODER_INVALID);
+    units = pros::E_MOTOR_ENCODER_INVALID;
+    break;
   }
+
+  const auto result = pros::c::motor_set_encoder_units(port, units);
+
+  // The encoders on this port cache the units
+  IntegratedEncoder::refreshCountsPerUnit(port);
+  return result;
 }
 
 AbstractMotor::encoderUnits Motor::getEncoderUnits() {
@@ -201,17 +212,28 @@ AbstractMotor::encoderUnits Motor::getEncoderUnits() {
 }
 
 std::int32_t Motor::setGearing(const AbstractMotor::gearset igearset) {
+  pros::motor_gearset_e_t gearset;
   switch (igearset) {
   case AbstractMotor::gearset::blue:
-    return pros::c::motor_set_gearing(port, pros::E_MOTOR_GEARSET_06);
+    gearset = pros::E_MOTOR_GEARSET_06;
+    break;
   case AbstractMotor::gearset::green:
-    return pros::c::motor_set_gearing(port, pros::E_MOTOR_GEARSET_18);
+    gearset = pros::E_MOTOR_GEARSET_18;
+    break;
   case AbstractMotor::gearset::red:
-    return pros::c::motor_set_gearing(port, pros::E_MOTOR_GEARSET_36);
+    gearset = pros::E_MOTOR_GEARSET_36;
+    break;
   case AbstractMotor::gearset::invalid:
   default:
-    return pros::c::motor_set_gearing(port, pros::E_MOTOR_GEARSET_INVALID);
+    gearset = pros::E_MOTOR_GEARSET_INVALID;
+    break;
   }
+
+  const auto result = pros::c::motor_set_gearing(port, gearset);
+
+  // The encoders on this port cache the gearing
+  IntegratedEncoder::refreshCountsPerUnit(port);
+  return result;
 }
 
 AbstractMotor::gearset Motor::getGearing() {
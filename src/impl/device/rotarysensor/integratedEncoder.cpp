@@ -4,22 +4,119 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include "okapi/impl/device/rotarysensor/integratedEncoder.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <cmath>
 
 namespace okapi {
+std::array<std::atomic<double>, IntegratedEncoder::portCount>
+  IntegratedEncoder::cachedCountsPerUnit{};
+
 IntegratedEncoder::IntegratedEncoder(const okapi::Motor &imotor)
   : IntegratedEncoder(imotor.getPort(), imotor.isReversed()) {
 }
 
 IntegratedEncoder::IntegratedEncoder(const std::int8_t iport, const bool ireversed)
   : port(iport), reversed(ireversed ? -1 : 1) {
+  refreshCountsPerUnit(port);
+}
+
+IntegratedEncoder::IntegratedEncoder(const IntegratedEncoder &iother)
+  : ContinuousRotarySensor(iother), port(iother.port), reversed(iother.reversed) {
 }
 
 double IntegratedEncoder::get() const {
   return pros::c::motor_get_position(port) * reversed;
 }
 
+double IntegratedEncoder::getTimestamped(std::uint32_t *timestamp) const {
+  if (timestamp) {
+    *timestamp = 0;
+  }
+
+  if (!zeroKnown.load(std::memory_order_acquire) && !findZero()) {
+    // Without the zero the raw position means nothing, so fall back to an untimed read
+    return get();
+  }
+
+  // Take the position and its timestamp from the same read so they come from the same packet
+  std::uint32_t time = 0;
+  const std::int32_t raw = pros::c::motor_get_raw_position(port, &time);
+  if (raw == PROS_ERR) {
+    return PROS_ERR_F;
+  }
+
+  if (timestamp) {
+    *timestamp = time;
+  }
+
+  return (raw - zeroCounts.load(std::memory_order_acquire)) / countsPerUnit() * reversed;
+}
+
 std::int32_t IntegratedEncoder::reset() {
-  return pros::c::motor_tare_position(port);
+  const auto result = pros::c::motor_tare_position(port);
+
+  // The tare moved the zero, so find it again on the next timestamped read
+  zeroKnown.store(false, std::memory_order_release);
+  return result;
+}
+
+bool IntegratedEncoder::findZero() const {
+  // Read the position on both sides of the raw position. If they match, all three came from the
+  // same packet, so the difference between them is where the motor was tared.
+  for (int attempt = 0; attempt < 3; ++attempt) {
+    const double before = pros::c::motor_get_position(port);
+    const std::int32_t raw = pros::c::motor_get_raw_position(port, nullptr);
+    const double after = pros::c::motor_get_position(port);
+    if (before == PROS_ERR_F || raw == PROS_ERR) {
+      return false;
+    }
+
+    if (before == after) {
+      zeroCounts.store(raw - static_cast<std::int32_t>(std::lround(before * countsPerUnit())),
+                       std::memory_order_release);
+      zeroKnown.store(true, std::memory_order_release);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void IntegratedEncoder::refreshCountsPerUnit(const std::uint8_t iport) {
+  if (iport >= 1 && iport <= portCount) {
+    cachedCountsPerUnit[iport - 1].store(queryCountsPerUnit(iport), std::memory_order_release);
+  }
+}
+
+double IntegratedEncoder::countsPerUnit() const {
+  if (port < 1 || port > portCount) {
+    return queryCountsPerUnit(port);
+  }
+
+  return cachedCountsPerUnit[port - 1].load(std::memory_order_acquire);
+}
+
+double IntegratedEncoder::queryCountsPerUnit(const std::uint8_t iport) {
+  double countsPerRev = imev5GreenTPR;
+  switch (pros::c::motor_get_gearing(iport)) {
+  case pros::E_MOTOR_GEARSET_36:
+    countsPerRev = imev5RedTPR;
+    break;
+  case pros::E_MOTOR_GEARSET_06:
+    countsPerRev = imev5BlueTPR;
+    break;
+  default:
+    break;
+  }
+
+  switch (pros::c::motor_get_encoder_units(iport)) {
+  case pros::E_MOTOR_ENCODER_DEGREES:
+    return countsPerRev / 360;
+  case pros::E_MOTOR_ENCODER_ROTATIONS:
+    return countsPerRev;
+  default:
+    return 1;
+  }
 }
 
 double IntegratedEncoder::controllerGet() {
@@ -6,6 +6,9 @@
 #include "okapi/impl/util/timer.hpp"
 #include "api.h"
 
+// The microsecond clock from the VEX SDK, which PROS links against. PROS 3.3 does not declare it.
+extern "C" std::uint64_t vexSystemHighResTimeGet(void);
+
 namespace okapi {
 Timer::Timer() : AbstractTimer(millis()) {
 }
@@ -13,4 +16,8 @@ Timer::Timer() : AbstractTimer(millis()) {
 QTime Timer::millis() const {
   return pros::millis() * millisecond;
 }
+
+QTime Timer::micros() const {
+  return vexSystemHighResTimeGet() / 1000.0 * millisecond;
+}
 } // namespace okapi
@@ -13,8 +13,7 @@ class MockAsyncLinearMotionProfileController : public AsyncLinearMotionProfileCo
   public:
   using AsyncLinearMotionProfileController::AsyncLinearMotionProfileController;
 
-  void executeSinglePath(const std::vector<squiggles::ProfilePoint> &path,
-                         std::unique_ptr<AbstractRate> rate) override {
+  void executeSinglePath(const ExecutionPlan &path, std::unique_ptr<AbstractRate> rate) override {
     executeSinglePathCalled = true;
     AsyncLinearMotionProfileController::executeSinglePath(path, std::move(rate));
   }
@@ -65,6 +64,31 @@ TEST_F(AsyncLinearMotionProfileControllerTest, MoveToTest) {
   EXPECT_GT(output->maxControllerOutputSet, 0);
 }
 
+TEST_F(AsyncLinearMotionProfileControllerTest, LateLoopSkipsAheadInsteadOfFallingBehind) {
+  // Every iteration runs 20 ms late, so following one point per iteration would take 3x as long
+  MockAsyncLinearMotionProfileController lateController(
+    createTimeUtil(Supplier<std::unique_ptr<AbstractRate>>(
+      []() { return std::make_unique<LateMockRate>(20_ms); })),
+    {1.0, 2.0, 10.0},
+    std::make_shared<MockAsyncVelIntegratedController>(),
+    1_m,
+    AbstractMotor::gearset::red);
+  lateController.startThread();
+
+  lateController.generatePath({0_m, 1_m}, "A");
+
+  auto timer = createTimeUtil().getTimer();
+  const QTime start = timer->millis();
+  lateController.setTarget("A");
+  lateController.waitUntilSettled();
+  const QTime elapsed = timer->millis() - start;
+
+  // Reaching 1 m at 1 m/s and 2 m/s/s takes well under 2 seconds
+  EXPECT_LT(elapsed, 2_s);
+  EXPECT_GE(lateController.getMaxLag(), 15_ms);
+  EXPECT_NEAR(lateController.getError(), 0, 0.05);
+}
+
 TEST_F(AsyncLinearMotionProfileControllerTest, MotorsAreStoppedAfterSettling) {
   controller->generatePath({0_m, 3_m}, "A");
 
@@ -107,6 +131,29 @@ TEST_F(AsyncLinearMotionProfileControllerTest, ZeroWaypointsDoesNothing) {
   EXPECT_EQ(controller->getPaths().size(), 0);
 }
 
+TEST_F(AsyncLinearMotionProfileControllerTest, GeneratePathAsyncSavesPath) {
+  auto handle = controller->generatePathAsync({0_m, 3_m}, "A");
+
+  EXPECT_EQ(handle->getPathId(), "A");
+  EXPECT_TRUE(handle->waitUntilReady());
+
+  EXPECT_EQ(controller->getPaths().front(), "A");
+  EXPECT_EQ(controller->getPaths().size(), 1);
+}
+
+TEST_F(AsyncLinearMotionProfileControllerTest, SetTargetWaitsForAsyncPath) {
+  controller->generatePathAsync({0_m, 3_m}, "A");
+  controller->setTarget("A");
+
+  EXPECT_EQ(controller->getPaths().size(), 1);
+
+  controller->waitUntilSettled();
+
+  EXPECT_TRUE(controller->executeSinglePathCalled);
+  EXPECT_EQ(output->lastControllerOutputSet, 0);
+  EXPECT_GT(output->maxControllerOutputSet, 0);
+}
+
 TEST_F(AsyncLinearMotionProfileControllerTest, RemoveAPath) {
   controller->generatePath({0_m, 3_m}, "A");
 
@@ -233,3 +280,48 @@ TEST_F(AsyncLinearMotionProfileControllerTest, FollowPathBackwards) {
   // still running
   controller->flipDisable(true);
 }
+
+TEST_F(AsyncLinearMotionProfileControllerTest, PathsCountAgainstTheMemoryBudget) {
+  auto budget = std::make_shared<PathMemoryBudget>(1024 * 1024);
+  controller->setPathMemoryBudget(budget);
+  EXPECT_EQ(controller->getPathMemoryBudget(), budget);
+
+  controller->generatePath({0_m, 3_m}, "A");
+  EXPECT_GT(controller->getPathMemoryUsage("A"), 0);
+  EXPECT_EQ(controller->getPathMemoryUsage("A"), budget->getUsage());
+
+  controller->removePath("A");
+  EXPECT_EQ(controller->getPathMemoryUsage("A"), 0);
+  EXPECT_EQ(budget->getUsage(), 0);
+}
+
+TEST_F(AsyncLinearMotionProfileControllerTest, PathWhichDoesNotFitInTheBudgetIsNotSaved) {
+  controller->setPathMemoryBudget(std::make_shared<PathMemoryBudget>(16));
+
+  controller->generatePath({0_m, 3_m}, "A");
+  EXPECT_TRUE(controller->getPaths().empty());
+}
+
+TEST_F(AsyncLinearMotionProfileControllerTest,
+       RegeneratedPathWhichDoesNotFitInTheBudgetKeepsTheOldPath) {
+  controller->generatePath({0_m, 3_m}, "A");
+  const auto size = controller->getPathMemoryUsage("A");
+
+  auto budget = std::make_shared<PathMemoryBudget>(16);
+  controller->setPathMemoryBudget(budget);
+  controller->generatePath({0_m, 5_m}, "A");
+
+  EXPECT_EQ(controller->getPaths(), std::vector<std::string>{"A"});
+  EXPECT_EQ(controller->getPathMemoryUsage("A"), size);
+  EXPECT_EQ(budget->getUsage(), 0);
+}
+
+TEST_F(AsyncLinearMotionProfileControllerTest, GeneratePathsSavesEveryPath) {
+  const auto results =
+    controller->generatePaths({{"A", {0_m, 3_m}}, {"B", {0_m, 1_m}, {{2.0, 4.0, 20.0}}}}, 2);
+
+  ASSERT_EQ(results.size(), 2);
+  EXPECT_TRUE(results[0].successful);
+  EXPECT_TRUE(results[1].successful);
+  EXPECT_EQ(controller->getPaths(), (std::vector<std::string>{"A", "B"}));
+}
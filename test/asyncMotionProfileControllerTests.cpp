@@ -6,6 +6,7 @@
 #include "okapi/api/control/async/asyncMotionProfileController.hpp"
 #include "test/tests/api/implMocks.hpp"
 #include <fstream>
+#include <thread>
 #ifdef WINDOWS
 #include <direct.h>
 #define getcwd _getcwd
@@ -19,20 +20,22 @@ using namespace okapi;
 class MockAsyncMotionProfileController : public AsyncMotionProfileController {
   public:
   using AsyncMotionProfileController::AsyncMotionProfileController;
+  using AsyncMotionProfileController::compilePath;
   using AsyncMotionProfileController::convertLinearToRotational;
+  using AsyncMotionProfileController::internalLoadBinaryPath;
   using AsyncMotionProfileController::internalLoadPath;
   using AsyncMotionProfileController::internalLoadPathfinderPath;
+  using AsyncMotionProfileController::internalStoreBinaryPath;
   using AsyncMotionProfileController::internalStorePath;
   using AsyncMotionProfileController::makeFilePath;
 
-  void executeSinglePath(const std::vector<squiggles::ProfilePoint> &path,
-                         std::unique_ptr<AbstractRate> rate) override {
+  void executeSinglePath(const ExecutionPlan &path, std::unique_ptr<AbstractRate> rate) override {
     executeSinglePathCalled = true;
     AsyncMotionProfileController::executeSinglePath(path, std::move(rate));
   }
 
-  std::vector<squiggles::ProfilePoint> &getPathData(std::string ipathId) {
-    return paths.at(ipathId);
+  std::shared_ptr<const ExecutionPlan> getPathData(std::string ipathId) {
+    return paths.find(ipathId);
   }
 
   bool executeSinglePathCalled{false};
@@ -163,6 +166,150 @@ TEST_F(AsyncMotionProfileControllerTest, ZeroWaypointsDoesNothing) {
   EXPECT_EQ(controller->getPaths().size(), 0);
 }
 
+TEST_F(AsyncMotionProfileControllerTest, GeneratePathAsyncSavesPath) {
+  auto handle = controller->generatePathAsync(
+    {PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 45_deg}}, "A");
+
+  EXPECT_EQ(handle->getPathId(), "A");
+  EXPECT_TRUE(handle->waitUntilReady());
+  EXPECT_TRUE(handle->isReady());
+  EXPECT_EQ(handle->getError(), "");
+
+  EXPECT_EQ(controller->getPaths().front(), "A");
+  EXPECT_EQ(controller->getPaths().size(), 1);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, ImpossibleAsyncPathFailsHandle) {
+  auto handle = controller->generatePathAsync(
+    {PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{9999_m, 0_m, 0_deg}}, "A");
+
+  EXPECT_FALSE(handle->waitUntilReady());
+  EXPECT_FALSE(handle->isSuccessful());
+  EXPECT_NE(handle->getError(), "");
+  EXPECT_EQ(controller->getPaths().size(), 0);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, SetTargetWaitsForAsyncPath) {
+  controller->generatePathAsync(
+    {PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 45_deg}}, "A");
+  controller->setTarget("A");
+
+  EXPECT_EQ(controller->getPaths().size(), 1);
+
+  controller->waitUntilSettled();
+
+  EXPECT_TRUE(controller->executeSinglePathCalled);
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+  EXPECT_GT(leftMotor->maxVelocity, 0);
+  EXPECT_GT(rightMotor->maxVelocity, 0);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, RegeneratingAPathHitsTheTrajectoryCache) {
+  auto cache = std::make_shared<TrajectoryCache>();
+  controller->setTrajectoryCache(cache);
+  EXPECT_EQ(controller->getTrajectoryCache(), cache);
+
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 45_deg}},
+                           "A");
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 45_deg}},
+                           "B");
+
+  const auto stats = cache->getStats();
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.entries, 1);
+
+  const auto pathA = controller->getPathData("A")->toProfilePoints();
+  const auto pathB = controller->getPathData("B")->toProfilePoints();
+  ASSERT_EQ(pathA.size(), pathB.size());
+  for (std::size_t i = 0; i < pathA.size(); ++i) {
+    EXPECT_EQ(pathA[i], pathB[i]);
+  }
+}
+
+TEST_F(AsyncMotionProfileControllerTest, GenerateNextPathWhileExecuting) {
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}},
+                           "A");
+  controller->setTarget("A");
+
+  auto handle = controller->generatePathAsync(
+    {PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 45_deg}}, "B");
+  EXPECT_TRUE(handle->waitUntilReady());
+
+  // Generating the next path must not interrupt the one being followed
+  EXPECT_FALSE(controller->isDisabled());
+  EXPECT_FALSE(controller->isSettled());
+  EXPECT_EQ(controller->getPaths().size(), 2);
+
+  controller->waitUntilSettled();
+  controller->setTarget("B");
+  controller->waitUntilSettled();
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+}
+
+TEST_F(AsyncMotionProfileControllerTest, PathChainDoesNotStopBetweenSegments) {
+  const PathChainSegment segment{
+    {PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}}};
+  EXPECT_TRUE(controller->generatePathChain({segment, segment}, "C"));
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}},
+                           "A");
+
+  const auto chain = controller->getPathData("C")->toProfilePoints();
+  const auto single = controller->getPathData("A")->toProfilePoints();
+  ASSERT_FALSE(chain.empty());
+  ASSERT_FALSE(single.empty());
+
+  // Stopping between the segments would take at least as long as following each on its own
+  EXPECT_LT(chain.back().time, 2 * single.back().time);
+
+  // The robot keeps moving through the middle of the chain, where the segments join
+  for (std::size_t i = chain.size() / 3; i < chain.size() * 2 / 3; ++i) {
+    EXPECT_GT(chain[i].vector.vel, 0.5) << "at point " << i;
+  }
+
+  // Times keep increasing across the junction
+  for (std::size_t i = 1; i < chain.size(); ++i) {
+    EXPECT_GT(chain[i].time, chain[i - 1].time) << "at point " << i;
+  }
+
+  controller->setTarget("C");
+  controller->waitUntilSettled();
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+  EXPECT_GT(leftMotor->maxVelocity, 0);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, PathChainReversesDirection) {
+  controller->generatePathChain(
+    {PathChainSegment{{PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}}},
+     PathChainSegment{{PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}},
+                      true}},
+    "C");
+
+  const auto plan = controller->getPathData("C");
+  ASSERT_FALSE(plan->empty());
+  EXPECT_GT(plan->getLeftCommand(0), 0);
+  EXPECT_LT(plan->getLeftCommand(plan->size() - 1), 0);
+
+  // The commands change sign exactly once, where the robot turns around
+  int signChanges = 0;
+  for (std::size_t i = 1; i < plan->size(); ++i) {
+    if ((plan->getLeftCommand(i) < 0) != (plan->getLeftCommand(i - 1) < 0)) {
+      signChanges++;
+    }
+  }
+  EXPECT_EQ(signChanges, 1);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, EmptyPathChainDoesNothing) {
+  EXPECT_FALSE(controller->generatePathChain({}, "C"));
+  EXPECT_EQ(controller->getPaths().size(), 0);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, PathChainWithoutWaypointsDoesNothing) {
+  EXPECT_FALSE(controller->generatePathChain({PathChainSegment{{}}, PathChainSegment{{}}}, "C"));
+  EXPECT_EQ(controller->getPaths().size(), 0);
+}
+
 TEST_F(AsyncMotionProfileControllerTest, RemoveAPath) {
   controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 45_deg}},
                            "A");
@@ -203,6 +350,43 @@ TEST_F(AsyncMotionProfileControllerTest, ReplaceRunningPath) {
   EXPECT_EQ(controller->getPaths().size(), 1);
 }
 
+TEST_F(AsyncMotionProfileControllerTest, AddAndRemovePathsFromOtherThreadsWhileExecuting) {
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 45_deg}},
+                           "A");
+  std::stringstream binaryPathFile;
+  controller->internalStoreBinaryPath(binaryPathFile, "A");
+  const std::string binaryPath = binaryPathFile.str();
+
+  controller->setTarget("A");
+
+  std::atomic_bool running{true};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; running.load(); ++i) {
+        const std::string id = "T" + std::to_string(t) + "_" + std::to_string(i % 4);
+        std::stringstream file(binaryPath);
+        EXPECT_TRUE(controller->internalLoadBinaryPath(file, id));
+        EXPECT_NE(controller->getPaths().size(), 0);
+        EXPECT_TRUE(controller->removePath(id));
+        std::this_thread::yield();
+      }
+    });
+  }
+
+  controller->waitUntilSettled();
+  running.store(false);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_FALSE(controller->isDisabled());
+  EXPECT_EQ(controller->getPaths(), std::vector<std::string>{"A"});
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+  EXPECT_GT(leftMotor->maxVelocity, 0);
+  EXPECT_GT(rightMotor->maxVelocity, 0);
+}
+
 TEST_F(AsyncMotionProfileControllerTest, RemoveAPathWhichDoesNotExist) {
   EXPECT_EQ(controller->getPaths().size(), 0);
 
@@ -269,6 +453,135 @@ TEST_F(AsyncMotionProfileControllerTest, SpeedConversionTest) {
   EXPECT_NEAR(controller->convertLinearToRotational(1_mps).convert(rpm), 93.989, 0.001);
 }
 
+TEST_F(AsyncMotionProfileControllerTest, CompiledCommandsMatchSpeedConversion) {
+  const std::vector<squiggles::ProfilePoint> path{
+    squiggles::ProfilePoint(squiggles::ControlVector(squiggles::Pose(0, 0, 0), 1, 0, 0),
+                            std::vector<double>{1, 0.5},
+                            0,
+                            0)};
+  const auto plan = controller->compilePath(path);
+
+  ASSERT_EQ(plan.size(), 1);
+  EXPECT_NEAR(plan.getLeftCommand(0),
+              controller->convertLinearToRotational(1_mps).convert(rpm) / 200,
+              1e-6);
+  EXPECT_NEAR(plan.getRightCommand(0),
+              controller->convertLinearToRotational(0.5_mps).convert(rpm) / 200,
+              1e-6);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, GeneratePathsSavesEveryPath) {
+  const auto results = controller->generatePaths(
+    {{"A", {PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}}},
+     {"B",
+      {PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 2_ft, 0_deg}},
+      {{2.0, 4.0, 20.0}}},
+     {"C", {}}},
+    2);
+
+  ASSERT_EQ(results.size(), 3);
+  EXPECT_EQ(results[0].pathId, "A");
+  EXPECT_TRUE(results[0].successful);
+  EXPECT_EQ(results[1].pathId, "B");
+  EXPECT_TRUE(results[1].successful);
+  EXPECT_EQ(results[2].pathId, "C");
+  EXPECT_FALSE(results[2].successful);
+  EXPECT_NE(results[2].error, "");
+
+  EXPECT_EQ(controller->getPaths(), (std::vector<std::string>{"A", "B"}));
+
+  // The batch generates the same paths as generating them one by one
+  const auto batched = controller->getPathData("A");
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}},
+                           "A");
+  EXPECT_EQ(batched->size(), controller->getPathData("A")->size());
+}
+
+TEST_F(AsyncMotionProfileControllerTest, PathWhichDoesNotFitInTheBudgetIsCompacted) {
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 45_deg}},
+                           "A");
+  const std::size_t size = controller->getPathMemoryUsage("A");
+  EXPECT_GT(size, 0);
+  EXPECT_EQ(controller->getPathMemoryUsage("B"), 0);
+
+  auto budget = std::make_shared<PathMemoryBudget>(size - 1);
+  controller->setPathMemoryBudget(budget);
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 45_deg}},
+                           "B");
+
+  const auto original = controller->getPathData("A");
+  const auto compacted = controller->getPathData("B");
+  ASSERT_NE(compacted, nullptr);
+  EXPECT_TRUE(compacted->isCompact());
+  EXPECT_LT(controller->getPathMemoryUsage("B"), size);
+  EXPECT_EQ(controller->getPathMemoryUsage("B"), budget->getUsage());
+
+  ASSERT_EQ(compacted->size(), original->size());
+  for (std::size_t i = 0; i < original->size(); ++i) {
+    EXPECT_NEAR(compacted->getLeftCommand(i), original->getLeftCommand(i), 1e-3);
+    EXPECT_NEAR(compacted->getRightCommand(i), original->getRightCommand(i), 1e-3);
+  }
+
+  // There is no room for a second path
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 45_deg}},
+                           "C");
+  EXPECT_EQ(controller->getPathData("C"), nullptr);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, LoadedPathWhichDoesNotFitInTheBudgetKeepsTheOldPath) {
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 45_deg}},
+                           "A");
+  std::stringstream binaryPathFile;
+  controller->internalStoreBinaryPath(binaryPathFile, "A");
+  std::stringstream csvPathFile;
+  controller->internalStorePath(csvPathFile, "A");
+  const auto original = controller->getPathData("A");
+
+  auto budget = std::make_shared<PathMemoryBudget>(1);
+  controller->setPathMemoryBudget(budget);
+  EXPECT_FALSE(controller->internalLoadBinaryPath(binaryPathFile, "A"));
+  EXPECT_FALSE(controller->internalLoadPath(csvPathFile, "A"));
+
+  EXPECT_EQ(controller->getPathData("A"), original);
+  EXPECT_EQ(budget->getUsage(), 0);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, LateLoopSkipsAheadInsteadOfFallingBehind) {
+  auto lateLeftMotor = std::make_shared<MockMotor>();
+  auto lateRightMotor = std::make_shared<MockMotor>();
+
+  // Every iteration runs 20 ms late, so following one point per iteration would take 3x as long
+  MockAsyncMotionProfileController lateController(
+    createTimeUtil(Supplier<std::unique_ptr<AbstractRate>>(
+      []() { return std::make_unique<LateMockRate>(20_ms); })),
+    {1.0, 2.0, 10.0},
+    std::make_shared<SkidSteerModel>(lateLeftMotor,
+                                     lateRightMotor,
+                                     lateLeftMotor->getEncoder(),
+                                     lateRightMotor->getEncoder(),
+                                     100,
+                                     v5MotorMaxVoltage),
+    {{4_in, 10.5_in}, quadEncoderTPR},
+    AbstractMotor::gearset::green * (1.0 / 2));
+  lateController.startThread();
+
+  lateController.generatePath(
+    {PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 45_deg}}, "A");
+  const auto path = lateController.getPathData("A");
+  const double duration = path->getTime(path->size() - 1);
+
+  auto timer = createTimeUtil().getTimer();
+  const QTime start = timer->millis();
+  lateController.setTarget("A");
+  lateController.waitUntilSettled();
+  const QTime elapsed = timer->millis() - start;
+
+  EXPECT_LT(elapsed.convert(second), duration * 1.5 + 0.1);
+  EXPECT_GE(lateController.getMaxLag(), 15_ms);
+  assertMotorsHaveBeenStopped(lateLeftMotor.get(), lateRightMotor.get());
+  EXPECT_GT(lateLeftMotor->maxVelocity, 0);
+}
+
 TEST_F(AsyncMotionProfileControllerTest, FollowPathBackwards) {
   controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}},
                            "A");
@@ -369,13 +682,13 @@ TEST_F(AsyncMotionProfileControllerTest, SaveLoadPath) {
     {PathfinderPoint{0_in, 0_in, 0_deg}, PathfinderPoint{3_ft, 0_in, 45_deg}}, "A");
   controller->internalStorePath(squigglesPathFile, "A");
 
-  auto startingPath = controller->getPathData("A");
+  auto startingPath = controller->getPathData("A")->toProfilePoints();
 
   controller->removePath("A");
   controller->internalLoadPath(squigglesPathFile, "A");
   EXPECT_EQ(controller->getPaths().front(), "A");
   EXPECT_EQ(controller->getPaths().size(), 1);
-  auto loadedPath = controller->getPathData("A");
+  auto loadedPath = controller->getPathData("A")->toProfilePoints();
   for (std::size_t i = 0; i < startingPath.size(); ++i) {
     ASSERT_EQ(loadedPath[i], startingPath[i]);
   }
@@ -384,6 +697,49 @@ TEST_F(AsyncMotionProfileControllerTest, SaveLoadPath) {
   EXPECT_EQ(controller->getTarget(), "A");
 }
 
+TEST_F(AsyncMotionProfileControllerTest, SaveLoadBinaryPath) {
+  controller->generatePath(
+    {PathfinderPoint{0_in, 0_in, 0_deg}, PathfinderPoint{3_ft, 0_in, 45_deg}}, "A");
+  std::stringstream binaryPathFile;
+  controller->internalStoreBinaryPath(binaryPathFile, "A");
+
+  auto startingPath = controller->getPathData("A")->toProfilePoints();
+
+  controller->removePath("A");
+  EXPECT_TRUE(controller->internalLoadBinaryPath(binaryPathFile, "A"));
+  EXPECT_EQ(controller->getPaths().front(), "A");
+  EXPECT_EQ(controller->getPaths().size(), 1);
+  auto loadedPath = controller->getPathData("A")->toProfilePoints();
+  ASSERT_EQ(loadedPath.size(), startingPath.size());
+  for (std::size_t i = 0; i < startingPath.size(); ++i) {
+    ASSERT_NEAR(loadedPath[i].wheel_velocities[0], startingPath[i].wheel_velocities[0], 1e-5);
+    ASSERT_NEAR(loadedPath[i].wheel_velocities[1], startingPath[i].wheel_velocities[1], 1e-5);
+    ASSERT_NEAR(loadedPath[i].vector.vel, startingPath[i].vector.vel, 1e-5);
+  }
+
+  controller->setTarget("A");
+  EXPECT_EQ(controller->getTarget(), "A");
+}
+
+TEST_F(AsyncMotionProfileControllerTest, BinaryPathStoresTheLimitsItWasGeneratedWith) {
+  controller->generatePath(
+    {PathfinderPoint{0_in, 0_in, 0_deg}, PathfinderPoint{3_ft, 0_in, 45_deg}}, "A", {0.5, 1, 4});
+  std::stringstream binaryPathFile;
+  controller->internalStoreBinaryPath(binaryPathFile, "A");
+
+  BinaryPathHeader header;
+  ASSERT_TRUE(BinaryPath::read(binaryPathFile, header).has_value());
+  EXPECT_FLOAT_EQ(header.maxVel, 0.5);
+  EXPECT_FLOAT_EQ(header.maxAccel, 1);
+  EXPECT_FLOAT_EQ(header.maxJerk, 4);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, LoadCorruptBinaryPathFails) {
+  std::stringstream binaryPathFile("not a binary path");
+  EXPECT_FALSE(controller->internalLoadBinaryPath(binaryPathFile, "A"));
+  EXPECT_EQ(controller->getPaths().size(), 0);
+}
+
 TEST_F(AsyncMotionProfileControllerTest, LoadPathfinderPath) {
   controller->removePath("A");
   controller->internalLoadPathfinderPath(leftPathFile, rightPathFile, "A");
@@ -397,7 +753,7 @@ TEST_F(AsyncMotionProfileControllerTest, LoadPathfinderPath) {
     std::getline(leftPathFile, buf);
     numLines++;
   }
-  EXPECT_EQ(controller->getPathData("A").size(), numLines - 2);
+  EXPECT_EQ(controller->getPathData("A")->size(), numLines - 2);
 
   controller->setTarget("A");
   EXPECT_EQ(controller->getTarget(), "A");
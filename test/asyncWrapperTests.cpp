@@ -5,6 +5,7 @@
  */
 #include "okapi/api/control/async/asyncPosPidController.hpp"
 #include "okapi/api/control/async/asyncVelPidController.hpp"
+#include "okapi/api/control/util/controlScheduler.hpp"
 #include "test/tests/api/implMocks.hpp"
 #include <gtest/gtest.h>
 
@@ -116,3 +117,27 @@ TEST_F(AsyncWrapperTest, TestRatioWorks) {
   velController.setTarget(10);
   EXPECT_EQ(velController.getError(), 20);
 }
+
+TEST_F(AsyncWrapperTest, WaitUntilSettledTimesOutAndThenWakesWhenDisabled) {
+  posPIDController->startThread();
+  posPIDController->setTarget(100);
+
+  // The input never moves, so the controller can't settle
+  EXPECT_FALSE(posPIDController->waitUntilSettled(30_ms));
+
+  posPIDController->flipDisable(true);
+  EXPECT_TRUE(posPIDController->waitUntilSettled(1000_ms));
+}
+
+TEST_F(AsyncWrapperTest, MeasuresLoopWithTimeUtilTimer) {
+  ControlScheduler scheduler(createTimeUtil());
+  AsyncWrapper<double, double> wrapper(
+    input,
+    output,
+    std::make_shared<IterativePosPIDController>(0.1, 0, 0, 0, createTimeUtil()),
+    createTimeUtil());
+  wrapper.startThread(std::shared_ptr<ControlScheduler>(&scheduler, [](auto) {}));
+
+  scheduler.tick();
+  EXPECT_EQ(wrapper.getLoopStats().getSummary().ticks, 1);
+}
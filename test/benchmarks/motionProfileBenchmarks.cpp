@@ -0,0 +1,290 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/async/asyncMotionProfileController.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * Benchmarks for the motion profiling pipeline. Each result is printed as one JSON object per line
+ * so the output can be collected and compared between runs:
+ *
+ *   {"benchmark":"generatePath","params":"waypoints=4 maxVel=1",
+ *    "iterations":10,"min_us":...,"median_us":...,"mean_us":...,"max_us":...}
+ *
+ * Pass `--filter=<text>` to only run the benchmarks whose name contains `<text>`, and
+ * `--iterations=<n>` to change how many times each benchmark runs.
+ */
+
+using namespace okapi;
+
+namespace {
+class BenchmarkAsyncMotionProfileController : public AsyncMotionProfileController {
+  public:
+  using AsyncMotionProfileController::AsyncMotionProfileController;
+  using AsyncMotionProfileController::executeSinglePath;
+  using AsyncMotionProfileController::internalGeneratePath;
+  using AsyncMotionProfileController::internalLoadBinaryPath;
+  using AsyncMotionProfileController::internalLoadPath;
+  using AsyncMotionProfileController::internalStoreBinaryPath;
+  using AsyncMotionProfileController::internalStorePath;
+
+  std::shared_ptr<const ExecutionPlan> getPathData(const std::string &ipathId) {
+    return paths.find(ipathId);
+  }
+};
+
+/**
+ * A clock which only moves when a SimulatedRate delays, so a path can be followed as fast as the
+ * CPU allows while the controller still sees 10 ms between iterations.
+ */
+struct SimulatedClock {
+  QTime now{0_ms};
+  std::size_t ticks{0};
+};
+
+class SimulatedTimer : public AbstractTimer {
+  public:
+  explicit SimulatedTimer(std::shared_ptr<SimulatedClock> iclock)
+    : AbstractTimer(iclock->now), clock(std::move(iclock)) {
+  }
+
+  QTime millis() const override {
+    return clock->now;
+  }
+
+  protected:
+  std::shared_ptr<SimulatedClock> clock;
+};
+
+class SimulatedRate : public AbstractRate {
+  public:
+  explicit SimulatedRate(std::shared_ptr<SimulatedClock> iclock) : clock(std::move(iclock)) {
+  }
+
+  void delay(QFrequency ihz) override {
+    delayUntil(1 / ihz);
+  }
+
+  void delayUntil(QTime itime) override {
+    clock->now += itime;
+    clock->ticks++;
+  }
+
+  void delayUntil(uint32_t ims) override {
+    delayUntil(ims * millisecond);
+  }
+
+  protected:
+  std::shared_ptr<SimulatedClock> clock;
+};
+
+struct BenchmarkOptions {
+  std::string filter{};
+  std::size_t iterations{10};
+};
+
+/**
+ * Runs a benchmark and prints its result. The function returns the number of operations it timed
+ * so a result can be reported per operation (e.g. per tick) instead of per call.
+ */
+template <typename F>
+void run(const BenchmarkOptions &ioptions,
+         const std::string &iname,
+         const std::string &iparams,
+         F &&ifunc) {
+  if (iname.find(ioptions.filter) == std::string::npos) {
+    return;
+  }
+
+  std::vector<double> samples;
+  samples.reserve(ioptions.iterations);
+  for (std::size_t i = 0; i < ioptions.iterations; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    const std::size_t operations = ifunc();
+    const auto end = std::chrono::steady_clock::now();
+    samples.push_back(std::chrono::duration<double, std::micro>(end - start).count() /
+                      std::max<std::size_t>(operations, 1));
+  }
+
+  std::sort(samples.begin(), samples.end());
+  double sum = 0;
+  for (const auto sample : samples) {
+    sum += sample;
+  }
+
+  std::printf("{\"benchmark\":\"%s\",\"params\":\"%s\",\"iterations\":%zu,\"min_us\":%.3f,"
+              "\"median_us\":%.3f,\"mean_us\":%.3f,\"max_us\":%.3f}\n",
+              iname.c_str(),
+              iparams.c_str(),
+              samples.size(),
+              samples.front(),
+              samples[samples.size() / 2],
+              sum / samples.size(),
+              samples.back());
+  std::fflush(stdout);
+}
+
+/**
+ * Makes a path which weaves left and right while driving forward.
+ */
+std::vector<PathfinderPoint> makeWaypoints(const std::size_t icount) {
+  std::vector<PathfinderPoint> waypoints;
+  for (std::size_t i = 0; i < icount; ++i) {
+    waypoints.push_back({static_cast<double>(i) * 2_ft, (i % 2 == 0 ? 0_ft : 1_ft), 0_deg});
+  }
+  return waypoints;
+}
+
+std::shared_ptr<BenchmarkAsyncMotionProfileController>
+makeController(const std::shared_ptr<ChassisModel> &imodel,
+               const std::shared_ptr<SimulatedClock> &iclock) {
+  return std::make_shared<BenchmarkAsyncMotionProfileController>(
+    TimeUtil(Supplier<std::unique_ptr<AbstractTimer>>(
+               [=]() { return std::make_unique<SimulatedTimer>(iclock); }),
+             Supplier<std::unique_ptr<AbstractRate>>(
+               [=]() { return std::make_unique<SimulatedRate>(iclock); }),
+             Supplier<std::unique_ptr<SettledUtil>>([]() { return createSettledUtilPtr(); })),
+    PathfinderLimits{1.0, 2.0, 10.0},
+    imodel,
+    ChassisScales({4_in, 11.5_in}, imev5GreenTPR),
+    AbstractMotor::gearset::green);
+}
+
+void benchmarkGeneratePath(const BenchmarkOptions &ioptions) {
+  auto clock = std::make_shared<SimulatedClock>();
+  auto controller = makeController(std::make_shared<MockChassisModel>(), clock);
+
+  for (const std::size_t count : {2, 4, 8, 16}) {
+    const auto waypoints = makeWaypoints(count);
+    for (const auto &limits :
+         {PathfinderLimits{1.0, 2.0, 10.0}, PathfinderLimits{2.0, 4.0, 20.0}}) {
+      std::ostringstream params;
+      params << "waypoints=" << count << " maxVel=" << limits.maxVel
+             << " maxAccel=" << limits.maxAccel << " maxJerk=" << limits.maxJerk;
+      run(ioptions, "generatePath", params.str(), [&]() {
+        controller->internalGeneratePath(waypoints, "A", limits);
+        return 1;
+      });
+    }
+  }
+}
+
+void benchmarkGeneratePaths(const BenchmarkOptions &ioptions) {
+  auto clock = std::make_shared<SimulatedClock>();
+  auto controller = makeController(std::make_shared<MockChassisModel>(), clock);
+
+  std::vector<PathGenerationJob> jobs;
+  for (std::size_t i = 0; i < 12; ++i) {
+    jobs.push_back({std::to_string(i), makeWaypoints(8)});
+  }
+
+  std::vector<std::size_t> workerCounts{1};
+  if (PathGenerationPool::defaultWorkerCount() > 1) {
+    workerCounts.push_back(PathGenerationPool::defaultWorkerCount());
+  }
+
+  for (const std::size_t workers : workerCounts) {
+    run(ioptions,
+        "generatePaths",
+        "paths=" + std::to_string(jobs.size()) + " workers=" + std::to_string(workers),
+        [&]() {
+          controller->generatePaths(jobs, workers);
+          return 1;
+        });
+  }
+}
+
+void benchmarkStoreAndLoad(const BenchmarkOptions &ioptions) {
+  auto clock = std::make_shared<SimulatedClock>();
+  auto controller = makeController(std::make_shared<MockChassisModel>(), clock);
+
+  // Serialization is timed against in-memory streams so the results don't depend on the disk
+  for (const std::size_t count : {2, 8}) {
+    controller->internalGeneratePath(makeWaypoints(count), "A", PathfinderLimits{1.0, 2.0, 10.0});
+    const std::string params = "waypoints=" + std::to_string(count) +
+                               " points=" + std::to_string(controller->getPathData("A")->size());
+
+    std::ostringstream csvOut;
+    controller->internalStorePath(csvOut, "A");
+    const std::string csv = csvOut.str();
+
+    std::ostringstream binaryOut(std::ios::binary);
+    controller->internalStoreBinaryPath(binaryOut, "A");
+    const std::string binary = binaryOut.str();
+
+    run(ioptions, "storePath.csv", params, [&]() {
+      std::ostringstream out;
+      controller->internalStorePath(out, "A");
+      return 1;
+    });
+
+    run(ioptions, "storePath.binary", params, [&]() {
+      std::ostringstream out(std::ios::binary);
+      controller->internalStoreBinaryPath(out, "A");
+      return 1;
+    });
+
+    run(ioptions, "loadPath.csv", params, [&]() {
+      std::istringstream in(csv);
+      controller->internalLoadPath(in, "B");
+      return 1;
+    });
+
+    run(ioptions, "loadPath.binary", params, [&]() {
+      std::istringstream in(binary, std::ios::binary);
+      controller->internalLoadBinaryPath(in, "B");
+      return 1;
+    });
+  }
+}
+
+void benchmarkExecuteSinglePath(const BenchmarkOptions &ioptions) {
+  auto clock = std::make_shared<SimulatedClock>();
+  auto model = std::make_shared<MockChassisModel>();
+  auto controller = makeController(model, clock);
+
+  for (const std::size_t count : {2, 8}) {
+    controller->internalGeneratePath(makeWaypoints(count), "A", PathfinderLimits{1.0, 2.0, 10.0});
+    const auto path = controller->getPathData("A");
+    const std::string params =
+      "waypoints=" + std::to_string(count) + " points=" + std::to_string(path->size());
+
+    // Reported per tick rather than per path
+    run(ioptions, "executeSinglePath.tick", params, [&]() {
+      clock->ticks = 0;
+      controller->executeSinglePath(*path, std::make_unique<SimulatedRate>(clock));
+      return clock->ticks;
+    });
+  }
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  BenchmarkOptions options;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strncmp(argv[i], "--filter=", 9) == 0) {
+      options.filter = argv[i] + 9;
+    } else if (std::strncmp(argv[i], "--iterations=", 13) == 0) {
+      options.iterations = std::max(1, std::atoi(argv[i] + 13));
+    } else {
+      std::fprintf(stderr, "Usage: %s [--filter=<text>] [--iterations=<n>]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  benchmarkGeneratePath(options);
+  benchmarkGeneratePaths(options);
+  benchmarkStoreAndLoad(options);
+  benchmarkExecuteSinglePath(options);
+  return 0;
+}
@@ -0,0 +1,180 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/binaryPath.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <cstring>
+#include <fstream>
+#ifdef WINDOWS
+#include <direct.h>
+#define getcwd _getcwd
+#else
+#include <unistd.h>
+#endif
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class BinaryPathTest : public ::testing::Test {
+  protected:
+  std::string get_working_path() {
+    char temp[FILENAME_MAX];
+    return (getcwd(temp, sizeof(temp)) ? std::string(temp) : std::string(""));
+  }
+
+  void SetUp() override {
+    leftFilePath = get_working_path() + "/../test/leftFile.csv";
+    rightFilePath = get_working_path() + "/../test/rightFile.csv";
+  }
+
+  std::vector<squiggles::ProfilePoint> loadPathfinderPath() {
+    std::ifstream leftFile(leftFilePath);
+    std::ifstream rightFile(rightFilePath);
+    return squiggles::deserialize_pathfinder_path(leftFile, rightFile).value();
+  }
+
+  static void assertPathsEqual(const std::vector<squiggles::ProfilePoint> &expected,
+                               const std::vector<squiggles::ProfilePoint> &actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      EXPECT_NEAR(expected[i].vector.pose.x, actual[i].vector.pose.x, 1e-5);
+      EXPECT_NEAR(expected[i].vector.pose.y, actual[i].vector.pose.y, 1e-5);
+      EXPECT_NEAR(expected[i].vector.pose.yaw, actual[i].vector.pose.yaw, 1e-5);
+      EXPECT_NEAR(expected[i].vector.vel, actual[i].vector.vel, 1e-5);
+      EXPECT_NEAR(expected[i].vector.accel, actual[i].vector.accel, 1e-5);
+      EXPECT_NEAR(expected[i].vector.jerk, actual[i].vector.jerk, 1e-4);
+      EXPECT_NEAR(expected[i].curvature, actual[i].curvature, 1e-5);
+      EXPECT_NEAR(expected[i].time, actual[i].time, 1e-5);
+      ASSERT_EQ(actual[i].wheel_velocities.size(), 2);
+      EXPECT_NEAR(expected[i].wheel_velocities[0], actual[i].wheel_velocities[0], 1e-5);
+      EXPECT_NEAR(expected[i].wheel_velocities[1], actual[i].wheel_velocities[1], 1e-5);
+    }
+  }
+
+  BinaryPathHeader header = BinaryPath::makeHeader(
+    0, 0.01, {1.0, 2.0, 10.0}, ChassisScales({4_in, 10.5_in}, quadEncoderTPR));
+  std::string leftFilePath;
+  std::string rightFilePath;
+};
+
+TEST_F(BinaryPathTest, HeaderDescribesPath) {
+  EXPECT_EQ(header.magic, BinaryPath::magic);
+  EXPECT_EQ(header.version, BinaryPath::version);
+  EXPECT_EQ(header.recordSize, sizeof(BinaryPathRecord));
+  EXPECT_FLOAT_EQ(header.dt, 0.01f);
+  EXPECT_FLOAT_EQ(header.maxVel, 1.0f);
+  EXPECT_FLOAT_EQ(header.maxAccel, 2.0f);
+  EXPECT_FLOAT_EQ(header.maxJerk, 10.0f);
+  EXPECT_FLOAT_EQ(header.wheelDiameter, (4_in).convert(meter));
+  EXPECT_FLOAT_EQ(header.wheelTrack, (10.5_in).convert(meter));
+}
+
+TEST_F(BinaryPathTest, RoundTripPathfinderCSV) {
+  std::ifstream leftFile(leftFilePath);
+  std::ifstream rightFile(rightFilePath);
+  std::stringstream binaryFile;
+  ASSERT_TRUE(BinaryPath::convertPathfinderCSV(leftFile, rightFile, binaryFile, header));
+
+  BinaryPathHeader readHeader;
+  auto records = BinaryPath::read(binaryFile, readHeader);
+  ASSERT_TRUE(records.has_value());
+
+  const auto expected = loadPathfinderPath();
+  EXPECT_EQ(readHeader.count, expected.size());
+  EXPECT_FLOAT_EQ(readHeader.wheelTrack, header.wheelTrack);
+  assertPathsEqual(expected, BinaryPath::toProfilePoints(records.value()));
+}
+
+TEST_F(BinaryPathTest, RoundTripSquigglesCSV) {
+  const auto expected = loadPathfinderPath();
+  std::stringstream csvFile;
+  squiggles::serialize_path(csvFile, expected);
+
+  std::stringstream binaryFile;
+  ASSERT_TRUE(BinaryPath::convertSquigglesCSV(csvFile, binaryFile, header));
+
+  BinaryPathHeader readHeader;
+  auto records = BinaryPath::read(binaryFile, readHeader);
+  ASSERT_TRUE(records.has_value());
+  assertPathsEqual(expected, BinaryPath::toProfilePoints(records.value()));
+}
+
+TEST_F(BinaryPathTest, BinaryFileIsSmallerThanCSV) {
+  std::ifstream leftFile(leftFilePath);
+  std::ifstream rightFile(rightFilePath);
+  std::stringstream binaryFile;
+  ASSERT_TRUE(BinaryPath::convertPathfinderCSV(leftFile, rightFile, binaryFile, header));
+
+  std::stringstream csvFile;
+  squiggles::serialize_path(csvFile, loadPathfinderPath());
+
+  EXPECT_LT(binaryFile.str().size(), csvFile.str().size());
+}
+
+TEST_F(BinaryPathTest, CorruptRecordsAreRejected) {
+  std::stringstream binaryFile;
+  ASSERT_TRUE(BinaryPath::write(binaryFile, header, loadPathfinderPath()));
+
+  std::string contents = binaryFile.str();
+  contents[sizeof(BinaryPathHeader) + 5] ^= 0x10;
+  std::stringstream corruptFile(contents);
+
+  BinaryPathHeader readHeader;
+  EXPECT_FALSE(BinaryPath::read(corruptFile, readHeader).has_value());
+}
+
+TEST_F(BinaryPathTest, TruncatedFileIsRejected) {
+  std::stringstream binaryFile;
+  ASSERT_TRUE(BinaryPath::write(binaryFile, header, loadPathfinderPath()));
+
+  std::string contents = binaryFile.str();
+  std::stringstream truncatedFile(contents.substr(0, contents.size() - 1));
+
+  BinaryPathHeader readHeader;
+  EXPECT_FALSE(BinaryPath::read(truncatedFile, readHeader).has_value());
+}
+
+TEST_F(BinaryPathTest, WrongVersionIsRejected) {
+  std::stringstream binaryFile;
+  ASSERT_TRUE(BinaryPath::write(binaryFile, header, loadPathfinderPath()));
+
+  std::string contents = binaryFile.str();
+  const std::uint16_t newerVersion = BinaryPath::version + 1;
+  std::memcpy(&contents[offsetof(BinaryPathHeader, version)], &newerVersion, sizeof(newerVersion));
+  std::stringstream newerFile(contents);
+
+  BinaryPathHeader readHeader;
+  EXPECT_FALSE(BinaryPath::read(newerFile, readHeader).has_value());
+}
+
+TEST_F(BinaryPathTest, FileIsLittleEndian) {
+  std::stringstream binaryFile;
+  ASSERT_TRUE(BinaryPath::write(
+    binaryFile,
+    header,
+    {squiggles::ProfilePoint(squiggles::ControlVector(squiggles::Pose(1, 0, 0), 0, 0, 0),
+                             {0, 0},
+                             0,
+                             0)}));
+
+  const std::string contents = binaryFile.str();
+  ASSERT_EQ(contents.size(), sizeof(BinaryPathHeader) + sizeof(BinaryPathRecord));
+
+  // The magic number reads "PATH"
+  EXPECT_EQ(contents.substr(0, 4), "PATH");
+  EXPECT_EQ(contents[offsetof(BinaryPathHeader, version)], BinaryPath::version);
+  EXPECT_EQ(contents[offsetof(BinaryPathHeader, version) + 1], 0);
+
+  // The x of the first record is 1.0f, which is 0x3F800000
+  const std::string x = contents.substr(sizeof(BinaryPathHeader), 4);
+  EXPECT_EQ(x, std::string("\x00\x00\x80\x3F", 4));
+}
+
+TEST_F(BinaryPathTest, TextFileIsRejected) {
+  std::ifstream leftFile(leftFilePath);
+
+  BinaryPathHeader readHeader;
+  EXPECT_FALSE(BinaryPath::read(leftFile, readHeader).has_value());
+}
@@ -399,3 +399,17 @@ TEST_F(ChassisControllerPIDTest, isSettledInModeNone) {
   controller->mode = CCPIDUnderTest::modeType::none;
   EXPECT_TRUE(controller->isSettled());
 }
+
+TEST_F(ChassisControllerPIDTest, WaitUntilSettledTimesOutAndThenWakesWhenSettled) {
+  distanceController->isSettledOverride = IsSettledOverride::neverSettled;
+  angleController->isSettledOverride = IsSettledOverride::neverSettled;
+  controller->moveDistanceAsync(10_in);
+
+  EXPECT_FALSE(controller->waitUntilSettled(30_ms));
+  EXPECT_EQ(controller->mode, CCPIDUnderTest::modeType::distance);
+
+  distanceController->isSettledOverride = IsSettledOverride::alwaysSettled;
+  angleController->isSettledOverride = IsSettledOverride::alwaysSettled;
+  EXPECT_TRUE(controller->waitUntilSettled(1000_ms));
+  EXPECT_EQ(controller->mode, CCPIDUnderTest::modeType::none);
+}
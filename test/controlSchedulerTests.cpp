@@ -0,0 +1,203 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/chassis/controller/chassisControllerPid.hpp"
+#include "okapi/api/chassis/controller/defaultOdomChassisController.hpp"
+#include "okapi/api/control/async/asyncLinearMotionProfileController.hpp"
+#include "okapi/api/control/async/asyncPosPidController.hpp"
+#include "okapi/api/control/util/controlScheduler.hpp"
+#include "okapi/api/odometry/twoEncoderOdometry.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class RecordingControllerOutput : public ControllerOutput<double> {
+  public:
+  void controllerSet(const double ivalue) override {
+    lastValue = ivalue;
+  }
+
+  double lastValue{0};
+};
+
+class ControlSchedulerTest : public ::testing::Test {
+  protected:
+  ControlScheduler scheduler{createTimeUtil()};
+  std::vector<int> ran;
+};
+
+TEST_F(ControlSchedulerTest, RunsStepsLowestOrderFirst) {
+  scheduler.add([&]() { ran.push_back(3); }, ControlScheduler::mechanismOrder);
+  scheduler.add([&]() { ran.push_back(1); }, ControlScheduler::odometryOrder);
+  scheduler.add([&]() { ran.push_back(2); }, ControlScheduler::chassisOrder);
+  scheduler.add([&]() { ran.push_back(4); }, ControlScheduler::mechanismOrder);
+
+  scheduler.tick();
+  EXPECT_EQ(ran, std::vector<int>({1, 2, 3, 4}));
+}
+
+TEST_F(ControlSchedulerTest, RunsStagesInPipelineOrder) {
+  scheduler.add([&]() { ran.push_back(4); }, ControlScheduler::Stage::actuate);
+  scheduler.add([&]() { ran.push_back(3); }, ControlScheduler::Stage::control);
+  scheduler.add([&]() { ran.push_back(2); }, ControlScheduler::Stage::estimate);
+  scheduler.add([&]() { ran.push_back(1); }, ControlScheduler::Stage::sense);
+
+  scheduler.tick();
+  EXPECT_EQ(ran, std::vector<int>({1, 2, 3, 4}));
+}
+
+TEST_F(ControlSchedulerTest, GetStage) {
+  EXPECT_EQ(ControlScheduler::getStage(ControlScheduler::senseOrder),
+            ControlScheduler::Stage::sense);
+  EXPECT_EQ(ControlScheduler::getStage(ControlScheduler::odometryOrder),
+            ControlScheduler::Stage::estimate);
+  EXPECT_EQ(ControlScheduler::getStage(ControlScheduler::chassisOrder),
+            ControlScheduler::Stage::control);
+  EXPECT_EQ(ControlScheduler::getStage(ControlScheduler::mechanismOrder),
+            ControlScheduler::Stage::control);
+  EXPECT_EQ(ControlScheduler::getStage(ControlScheduler::actuateOrder),
+            ControlScheduler::Stage::actuate);
+}
+
+TEST_F(ControlSchedulerTest, LatencyCoversTicksWhichSendCommands) {
+  const auto estimator = scheduler.add([]() {}, ControlScheduler::Stage::estimate);
+  scheduler.tick();
+  EXPECT_EQ(scheduler.getLatency().ticks, 0);
+
+  scheduler.add([]() { std::this_thread::sleep_for(std::chrono::milliseconds(5)); },
+                ControlScheduler::Stage::control);
+  scheduler.tick();
+  scheduler.remove(estimator);
+  scheduler.tick();
+
+  const auto latency = scheduler.getLatency();
+  EXPECT_EQ(latency.ticks, 2);
+  EXPECT_GE(latency.max, 5_ms);
+  EXPECT_GE(latency.mean, 4_ms);
+}
+
+TEST_F(ControlSchedulerTest, DividerSkipsTicks) {
+  scheduler.add([&]() { ran.push_back(1); }, 0);
+  scheduler.add([&]() { ran.push_back(3); }, 1, 3);
+
+  for (int i = 0; i < 7; ++i) {
+    scheduler.tick();
+  }
+
+  EXPECT_EQ(std::count(ran.begin(), ran.end(), 1), 7);
+  EXPECT_EQ(std::count(ran.begin(), ran.end(), 3), 3);
+}
+
+TEST_F(ControlSchedulerTest, RemovedStepDoesNotRun) {
+  const auto first = scheduler.add([&]() { ran.push_back(1); }, 0);
+  scheduler.add([&]() { ran.push_back(2); }, 0);
+  EXPECT_EQ(scheduler.getStepCount(), 2);
+
+  scheduler.remove(first);
+  EXPECT_EQ(scheduler.getStepCount(), 1);
+
+  scheduler.tick();
+  EXPECT_EQ(ran, std::vector<int>({2}));
+}
+
+TEST_F(ControlSchedulerTest, GetDivider) {
+  EXPECT_EQ(scheduler.getPeriod(), 10_ms);
+  EXPECT_EQ(scheduler.getDivider(10_ms), 1);
+  EXPECT_EQ(scheduler.getDivider(1_ms), 1);
+  EXPECT_EQ(scheduler.getDivider(20_ms), 2);
+  EXPECT_EQ(scheduler.getDivider(24_ms), 2);
+  EXPECT_EQ(scheduler.getDivider(50_ms), 5);
+}
+
+TEST_F(ControlSchedulerTest, TaskRunsTicks) {
+  std::atomic_int count{0};
+  scheduler.add([&]() { count++; }, 0);
+  scheduler.startThread();
+  ASSERT_NE(scheduler.getThread(), nullptr);
+
+  auto rate = createTimeUtil().getRate();
+  for (int i = 0; i < 100 && count < 3; ++i) {
+    rate->delayUntil(10_ms);
+  }
+
+  EXPECT_GE(count, 3);
+  EXPECT_GE(scheduler.getLoopStats().getSummary().ticks, 2);
+}
+
+TEST_F(ControlSchedulerTest, AsyncWrapperRunsOnScheduler) {
+  auto output = std::make_shared<RecordingControllerOutput>();
+  {
+    AsyncPosPIDController controller(std::make_shared<MockContinuousRotarySensor>(),
+                                     output,
+                                     createConstantTimeUtil(10_ms),
+                                     0.1,
+                                     0,
+                                     0);
+    controller.startThread(std::shared_ptr<ControlScheduler>(&scheduler, [](auto) {}));
+    EXPECT_EQ(controller.getThread(), nullptr);
+    EXPECT_EQ(scheduler.getStepCount(), 1);
+
+    controller.setTarget(100);
+    scheduler.tick();
+    EXPECT_DOUBLE_EQ(output->lastValue, 1);
+    EXPECT_EQ(controller.getLoopStats().getSummary().ticks, 1);
+  }
+
+  // Deleting the controller removes its step
+  EXPECT_EQ(scheduler.getStepCount(), 0);
+  scheduler.tick();
+}
+
+TEST_F(ControlSchedulerTest, ChassisAndOdometryRunOnScheduler) {
+  auto shared = std::shared_ptr<ControlScheduler>(&scheduler, [](auto) {});
+  auto model = std::make_shared<MockSkidSteerModel>();
+  const ChassisScales scales({4_in, 8_in}, imev5GreenTPR);
+  auto chassis = std::make_shared<ChassisControllerPID>(createTimeUtil(),
+                                                        model,
+                                                        std::make_unique<MockIterativeController>(),
+                                                        std::make_unique<MockIterativeController>(),
+                                                        std::make_unique<MockIterativeController>(),
+                                                        AbstractMotor::gearset::green,
+                                                        scales);
+  chassis->startThread(shared);
+
+  {
+    DefaultOdomChassisController odomChassis(
+      createTimeUtil(),
+      std::make_shared<TwoEncoderOdometry>(createTimeUtil(), model, scales),
+      chassis);
+    odomChassis.startOdomThread(shared);
+    EXPECT_EQ(odomChassis.getOdomThread(), nullptr);
+    EXPECT_EQ(scheduler.getStepCount(), 2);
+
+    scheduler.tick();
+    EXPECT_EQ(chassis->getLoopStats().getSummary().ticks, 1);
+    EXPECT_EQ(odomChassis.getLoopStats().getSummary().ticks, 1);
+  }
+
+  EXPECT_EQ(scheduler.getStepCount(), 1);
+  chassis.reset();
+  EXPECT_EQ(scheduler.getStepCount(), 0);
+}
+
+TEST_F(ControlSchedulerTest, MotionProfileControllerFollowsPathOnScheduler) {
+  auto shared = std::make_shared<ControlScheduler>(createTimeUtil());
+  auto output = std::make_shared<MockAsyncVelIntegratedController>();
+  AsyncLinearMotionProfileController controller(
+    createTimeUtil(), {1.0, 2.0, 10.0}, output, 1_m, AbstractMotor::gearset::red);
+  controller.startThread(shared);
+  EXPECT_EQ(controller.getThread(), nullptr);
+  shared->startThread();
+
+  controller.moveTo(0_m, 1_m);
+  EXPECT_TRUE(controller.isSettled());
+  EXPECT_EQ(output->lastControllerOutputSet, 0);
+  EXPECT_GT(output->maxControllerOutputSet, 0);
+}
@@ -0,0 +1,248 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/iterative/iterativePosPidController.hpp"
+#include "okapi/api/control/iterative/iterativeVelPidController.hpp"
+#include "okapi/api/control/util/controllerTelemetry.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <atomic>
+#include <cstddef>
+#include <sstream>
+#include <thread>
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class ControllerTelemetryTest : public ::testing::Test {
+  protected:
+  /**
+   * Records isteps steps where every value is the step number.
+   */
+  static void recordSteps(ControllerTelemetry &itelemetry, const int isteps) {
+    for (int i = 0; i < isteps; ++i) {
+      itelemetry.record(i, i, i, i, i, i);
+    }
+  }
+
+  ControllerTelemetry telemetry{std::make_unique<ConstantMockTimer>(10_ms), 8};
+};
+
+TEST_F(ControllerTelemetryTest, StartsEmpty) {
+  EXPECT_TRUE(telemetry.getSamples().empty());
+  EXPECT_EQ(telemetry.getRecordedCount(), 0);
+  EXPECT_EQ(telemetry.getOverwrittenCount(), 0);
+  EXPECT_EQ(telemetry.getCapacity(), 8);
+  EXPECT_EQ(telemetry.getDecimation(), 1);
+}
+
+TEST_F(ControllerTelemetryTest, RecordsEveryStep) {
+  telemetry.record(1, 2, 3, 4, 5, 6);
+
+  const auto samples = telemetry.getSamples();
+  ASSERT_EQ(samples.size(), 1);
+  EXPECT_EQ(samples[0].step, 0);
+  EXPECT_FLOAT_EQ(samples[0].time, 0.01f);
+  EXPECT_FLOAT_EQ(samples[0].target, 1);
+  EXPECT_FLOAT_EQ(samples[0].processValue, 2);
+  EXPECT_FLOAT_EQ(samples[0].error, 3);
+  EXPECT_FLOAT_EQ(samples[0].integral, 4);
+  EXPECT_FLOAT_EQ(samples[0].derivative, 5);
+  EXPECT_FLOAT_EQ(samples[0].output, 6);
+}
+
+TEST_F(ControllerTelemetryTest, KeepsNewestSamplesWhenFull) {
+  recordSteps(telemetry, 20);
+
+  const auto samples = telemetry.getSamples();
+  ASSERT_EQ(samples.size(), 8);
+  for (std::size_t i = 0; i < samples.size(); ++i) {
+    EXPECT_EQ(samples[i].step, 12 + i);
+    EXPECT_FLOAT_EQ(samples[i].output, 12 + i);
+  }
+  EXPECT_EQ(telemetry.getRecordedCount(), 20);
+  EXPECT_EQ(telemetry.getOverwrittenCount(), 12);
+}
+
+TEST_F(ControllerTelemetryTest, Decimation) {
+  ControllerTelemetry decimated(nullptr, 8, 3);
+  recordSteps(decimated, 10);
+
+  const auto samples = decimated.getSamples();
+  ASSERT_EQ(samples.size(), 4);
+  for (std::size_t i = 0; i < samples.size(); ++i) {
+    EXPECT_EQ(samples[i].step, i * 3);
+    EXPECT_FLOAT_EQ(samples[i].time, 0);
+  }
+}
+
+TEST_F(ControllerTelemetryTest, ClearForgetsSamples) {
+  recordSteps(telemetry, 5);
+  telemetry.clear();
+  EXPECT_TRUE(telemetry.getSamples().empty());
+
+  telemetry.record(1, 1, 1, 1, 1, 1);
+  ASSERT_EQ(telemetry.getSamples().size(), 1);
+  EXPECT_EQ(telemetry.getSamples()[0].step, 0);
+}
+
+TEST_F(ControllerTelemetryTest, WritesCSV) {
+  telemetry.record(1, 2, 3, 4, 5, 6);
+
+  std::ostringstream out;
+  EXPECT_TRUE(telemetry.writeCSV(out));
+  EXPECT_EQ(out.str(),
+            "step,time,target,processValue,error,integral,derivative,output\n"
+            "0,0.01,1,2,3,4,5,6\n");
+}
+
+TEST_F(ControllerTelemetryTest, BinaryRoundTrip) {
+  recordSteps(telemetry, 12);
+
+  std::stringstream file(std::ios::in | std::ios::out | std::ios::binary);
+  EXPECT_TRUE(telemetry.writeBinary(file));
+
+  const auto samples = ControllerTelemetry::readBinary(file);
+  ASSERT_TRUE(samples.has_value());
+  const auto expected = telemetry.getSamples();
+  ASSERT_EQ(samples->size(), expected.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(samples->at(i).step, expected[i].step);
+    EXPECT_FLOAT_EQ(samples->at(i).output, expected[i].output);
+  }
+}
+
+TEST_F(ControllerTelemetryTest, BinaryFileIsLittleEndian) {
+  telemetry.record(1, 2, 3, 4, 5, 6);
+
+  std::stringstream file(std::ios::in | std::ios::out | std::ios::binary);
+  EXPECT_TRUE(telemetry.writeBinary(file));
+
+  const std::string contents = file.str();
+  ASSERT_EQ(contents.size(), sizeof(TelemetryFileHeader) + sizeof(TelemetrySample));
+
+  // The magic number reads "TLMY"
+  EXPECT_EQ(contents.substr(0, 4), "TLMY");
+  EXPECT_EQ(contents[offsetof(TelemetryFileHeader, version)], ControllerTelemetry::version);
+  EXPECT_EQ(contents[offsetof(TelemetryFileHeader, version) + 1], 0);
+
+  // The target of the sample is 1.0f, which is 0x3F800000
+  const std::string target =
+    contents.substr(sizeof(TelemetryFileHeader) + offsetof(TelemetrySample, target), 4);
+  EXPECT_EQ(target, std::string("\x00\x00\x80\x3F", 4));
+}
+
+TEST_F(ControllerTelemetryTest, ReadBinaryRejectsOtherFiles) {
+  std::istringstream notTelemetry("step,time,target\n0,0,0\n");
+  EXPECT_FALSE(ControllerTelemetry::readBinary(notTelemetry).has_value());
+
+  recordSteps(telemetry, 4);
+  std::ostringstream out(std::ios::binary);
+  telemetry.writeBinary(out);
+  const std::string file = out.str();
+
+  std::istringstream truncated(file.substr(0, file.size() - 1), std::ios::binary);
+  EXPECT_FALSE(ControllerTelemetry::readBinary(truncated).has_value());
+}
+
+TEST_F(ControllerTelemetryTest, ReadingWhileRecordingNeverReturnsTornSamples) {
+  ControllerTelemetry shared(nullptr, 16);
+  std::atomic_bool done{false};
+
+  std::thread writer([&]() {
+    for (int i = 0; i < 200000; ++i) {
+      shared.record(i, i, i, i, i, i);
+    }
+    done = true;
+  });
+
+  while (!done) {
+    const auto samples = shared.getSamples();
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+      EXPECT_FLOAT_EQ(samples[i].output, static_cast<float>(samples[i].step));
+      if (i > 0) {
+        EXPECT_EQ(samples[i].step, samples[i - 1].step + 1);
+      }
+    }
+  }
+
+  writer.join();
+}
+
+TEST_F(ControllerTelemetryTest, PosPIDControllerRecordsItsTerms) {
+  IterativePosPIDController controller(0.1, 0.01, 0, 0, createConstantTimeUtil(10_ms));
+  auto recorder = std::make_shared<ControllerTelemetry>(nullptr, 8);
+  controller.setTelemetry(recorder);
+  EXPECT_EQ(controller.getTelemetry(), recorder);
+
+  controller.setTarget(5);
+  const double output = controller.step(2);
+
+  const auto samples = recorder->getSamples();
+  ASSERT_EQ(samples.size(), 1);
+  EXPECT_FLOAT_EQ(samples[0].target, 5);
+  EXPECT_FLOAT_EQ(samples[0].processValue, 2);
+  EXPECT_FLOAT_EQ(samples[0].error, 3);
+  EXPECT_GT(samples[0].integral, 0);
+  EXPECT_FLOAT_EQ(samples[0].output, static_cast<float>(output));
+}
+
+TEST_F(ControllerTelemetryTest, DisabledPosPIDControllerRecordsNothing) {
+  IterativePosPIDController controller(0.1, 0, 0, 0, createConstantTimeUtil(10_ms));
+  auto recorder = std::make_shared<ControllerTelemetry>(nullptr, 8);
+  controller.setTelemetry(recorder);
+
+  controller.flipDisable(true);
+  controller.step(2);
+  EXPECT_EQ(recorder->getRecordedCount(), 0);
+}
+
+TEST_F(ControllerTelemetryTest, AttachingWhileSteppingRecordsEveryStepOnce) {
+  IterativePosPIDController controller(0.1, 0, 0, 0, createConstantTimeUtil(10_ms));
+  auto first = std::make_shared<ControllerTelemetry>(nullptr, 8);
+  auto second = std::make_shared<ControllerTelemetry>(nullptr, 8);
+  controller.setTelemetry(first);
+  controller.setTarget(5);
+
+  constexpr int steps = 100000;
+  std::atomic_bool done{false};
+  std::thread stepper([&]() {
+    for (int i = 0; i < steps; ++i) {
+      controller.step(2);
+    }
+    done = true;
+  });
+
+  for (bool useSecond = true; !done; useSecond = !useSecond) {
+    controller.setTelemetry(useSecond ? second : first);
+  }
+
+  stepper.join();
+  EXPECT_EQ(first->getRecordedCount() + second->getRecordedCount(), steps);
+}
+
+TEST_F(ControllerTelemetryTest, VelPIDControllerRecordsItsTerms) {
+  IterativeVelPIDController controller(
+    0.1,
+    0,
+    0.01,
+    0,
+    std::make_unique<VelMath>(imev5GreenTPR,
+                              std::make_unique<PassthroughFilter>(),
+                              0_ms,
+                              std::make_unique<ConstantMockTimer>(10_ms)),
+    createConstantTimeUtil(10_ms));
+  auto recorder = std::make_shared<ControllerTelemetry>(nullptr, 8);
+  controller.setTelemetry(recorder);
+
+  controller.setTarget(10);
+  controller.step(0);
+  const double output = controller.step(0);
+
+  const auto samples = recorder->getSamples();
+  ASSERT_EQ(samples.size(), 2);
+  EXPECT_FLOAT_EQ(samples[1].target, 10);
+  EXPECT_FLOAT_EQ(samples[1].error, static_cast<float>(controller.getError()));
+  EXPECT_FLOAT_EQ(samples[1].output, static_cast<float>(output));
+}
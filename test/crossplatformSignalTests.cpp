@@ -0,0 +1,72 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/coreProsAPI.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <gtest/gtest.h>
+
+TEST(CrossplatformSignalTest, ReturnsRightAwayWhenConditionHolds) {
+  CrossplatformSignal signal;
+  EXPECT_TRUE(signal.waitUntil([]() { return true; }));
+}
+
+TEST(CrossplatformSignalTest, TimesOutWithoutNotification) {
+  CrossplatformSignal signal;
+  const auto start = std::chrono::steady_clock::now();
+
+  EXPECT_FALSE(signal.waitUntil([]() { return false; }, 30));
+  EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(30));
+}
+
+TEST(CrossplatformSignalTest, NotificationWakesWaiters) {
+  CrossplatformSignal signal;
+  std::atomic_bool ready{false};
+  std::atomic_int woken{0};
+
+  std::thread first([&]() {
+    if (signal.waitUntil([&]() { return ready.load(); })) {
+      woken++;
+    }
+  });
+  std::thread second([&]() {
+    if (signal.waitUntil([&]() { return ready.load(); }, 5000)) {
+      woken++;
+    }
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  ready = true;
+  signal.notifyAll();
+
+  first.join();
+  second.join();
+  EXPECT_EQ(woken, 2);
+}
+
+TEST(CrossplatformSignalTest, NotificationWithoutChangeKeepsWaiting) {
+  CrossplatformSignal signal;
+  std::atomic_int checks{0};
+
+  std::thread notifier([&]() {
+    for (int i = 0; i < 3; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      signal.notifyAll();
+    }
+  });
+
+  EXPECT_FALSE(signal.waitUntil(
+    [&]() {
+      checks++;
+      return false;
+    },
+    60));
+  notifier.join();
+
+  // Checked once up front, once per notification, and once when the time ran out
+  EXPECT_GE(checks, 2);
+  EXPECT_LE(checks, 5);
+}
@@ -0,0 +1,147 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/executionPlan.hpp"
+#include "okapi/api/control/util/trajectoryCache.hpp"
+#include <fstream>
+#ifdef WINDOWS
+#include <direct.h>
+#define getcwd _getcwd
+#else
+#include <unistd.h>
+#endif
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class ExecutionPlanTest : public ::testing::Test {
+  protected:
+  std::string get_working_path() {
+    char temp[FILENAME_MAX];
+    return (getcwd(temp, sizeof(temp)) ? std::string(temp) : std::string(""));
+  }
+
+  void SetUp() override {
+    std::ifstream leftFile(get_working_path() + "/../test/leftFile.csv");
+    std::ifstream rightFile(get_working_path() + "/../test/rightFile.csv");
+    path = squiggles::deserialize_pathfinder_path(leftFile, rightFile).value();
+  }
+
+  std::vector<squiggles::ProfilePoint> path;
+};
+
+TEST_F(ExecutionPlanTest, EmptyPlan) {
+  ExecutionPlan plan;
+  EXPECT_TRUE(plan.empty());
+  EXPECT_EQ(plan.size(), 0);
+  EXPECT_TRUE(plan.toProfilePoints().empty());
+}
+
+TEST_F(ExecutionPlanTest, CommandsAreScaledWheelVelocities) {
+  const auto plan = ExecutionPlan::compile(path, 0.5);
+
+  ASSERT_EQ(plan.size(), path.size());
+  EXPECT_DOUBLE_EQ(plan.getCommandPerMps(), 0.5);
+  for (std::size_t i = 0; i < path.size(); ++i) {
+    EXPECT_NEAR(plan.getLeftCommand(i), path[i].wheel_velocities[0] * 0.5, 1e-6);
+    EXPECT_NEAR(plan.getRightCommand(i), path[i].wheel_velocities[1] * 0.5, 1e-6);
+  }
+}
+
+TEST_F(ExecutionPlanTest, RoundTripToProfilePoints) {
+  auto generated = path;
+  for (std::size_t i = 0; i < generated.size(); ++i) {
+    generated[i].time = i * 0.01;
+  }
+
+  const auto points = ExecutionPlan::compile(generated, 0.3).toProfilePoints();
+
+  ASSERT_EQ(points.size(), generated.size());
+  for (std::size_t i = 0; i < generated.size(); ++i) {
+    EXPECT_EQ(points[i], generated[i]);
+  }
+}
+
+TEST_F(ExecutionPlanTest, PathfinderDurationsBecomeTimes) {
+  // Every point in the Pathfinder files lasts 10 ms
+  const auto plan = ExecutionPlan::compile(path, 0.3);
+
+  ASSERT_EQ(plan.size(), path.size());
+  for (std::size_t i = 0; i < path.size(); ++i) {
+    EXPECT_NEAR(plan.getTime(i), i * 0.01, 1e-4);
+  }
+}
+
+TEST_F(ExecutionPlanTest, UsesLessMemoryThanProfilePoints) {
+  const auto plan = ExecutionPlan::compile(path, 0.3);
+  EXPECT_LT(plan.getMemoryUsage() * 2, TrajectoryCache::estimateMemoryUsage(path));
+}
+
+TEST_F(ExecutionPlanTest, EqualCommandsAreStoredOnce) {
+  auto straight = path;
+  for (auto &point : straight) {
+    point.wheel_velocities = {point.vector.vel, point.vector.vel};
+  }
+
+  const auto plan = ExecutionPlan::compile(straight, 0.3);
+  for (std::size_t i = 0; i < plan.size(); ++i) {
+    EXPECT_FLOAT_EQ(plan.getRightCommand(i), plan.getLeftCommand(i));
+  }
+  EXPECT_LT(plan.getMemoryUsage(), ExecutionPlan::compile(path, 0.3).getMemoryUsage());
+}
+
+TEST_F(ExecutionPlanTest, CompactingHalvesMemoryAndKeepsValuesClose) {
+  const auto plan = ExecutionPlan::compile(path, 0.3);
+  auto compacted = plan;
+  compacted.compact();
+
+  EXPECT_FALSE(plan.isCompact());
+  EXPECT_TRUE(compacted.isCompact());
+  EXPECT_LT(compacted.getMemoryUsage() * 10, plan.getMemoryUsage() * 6);
+
+  ASSERT_EQ(compacted.size(), plan.size());
+  for (std::size_t i = 0; i < plan.size(); ++i) {
+    EXPECT_NEAR(compacted.getLeftCommand(i), plan.getLeftCommand(i), 1e-4);
+    EXPECT_NEAR(compacted.getRightCommand(i), plan.getRightCommand(i), 1e-4);
+    EXPECT_NEAR(compacted.getTime(i), plan.getTime(i), 1e-4);
+    EXPECT_NEAR(compacted.getPose(i).x, plan.getPose(i).x, 1e-4);
+    EXPECT_NEAR(compacted.getPose(i).yaw, plan.getPose(i).yaw, 1e-4);
+  }
+}
+
+TEST_F(ExecutionPlanTest, CompactingKeepsZeroCommandsAndTimesExact) {
+  // A long path which starts and ends stopped, and has one wheel stopped in the middle
+  std::vector<squiggles::ProfilePoint> longPath;
+  for (std::size_t i = 0; i < 6000; ++i) {
+    const double vel = i == 0 || i == 5999 ? 0 : 1.7;
+    const double rightVel = i == 3000 ? 0 : -0.3 * vel;
+    longPath.emplace_back(squiggles::ControlVector(squiggles::Pose(i * 0.01, 0, 0), vel, 0, 0),
+                          std::vector<double>{vel, rightVel},
+                          0,
+                          i * 0.01);
+  }
+
+  auto plan = ExecutionPlan::compile(longPath, 0.3);
+  const float lastTime = plan.getTime(plan.size() - 1);
+  plan.compact();
+
+  EXPECT_EQ(plan.getLeftCommand(0), 0);
+  EXPECT_EQ(plan.getRightCommand(0), 0);
+  EXPECT_EQ(plan.getRightCommand(3000), 0);
+  EXPECT_EQ(plan.getLeftCommand(plan.size() - 1), 0);
+  EXPECT_EQ(plan.getRightCommand(plan.size() - 1), 0);
+  EXPECT_EQ(plan.getTime(plan.size() - 1), lastTime);
+  EXPECT_NEAR(plan.getLeftCommand(1), 1.7 * 0.3, 1e-4);
+  EXPECT_NEAR(plan.getRightCommand(1), -0.3 * 1.7 * 0.3, 1e-4);
+}
+
+TEST_F(ExecutionPlanTest, CompactingKeepsTimesInOrder) {
+  auto plan = ExecutionPlan::compile(path, 0.3);
+  plan.compact();
+
+  for (std::size_t i = 1; i < plan.size(); ++i) {
+    EXPECT_GE(plan.getTime(i), plan.getTime(i - 1));
+  }
+}
@@ -24,6 +24,14 @@ double MockContinuousRotarySensor::get() const {
   return value;
 }
 
+double MockContinuousRotarySensor::getTimestamped(std::uint32_t *itimestamp) const {
+  if (itimestamp) {
+    *itimestamp = timestamp;
+  }
+
+  return value;
+}
+
 MockMotor::MockMotor() : encoder(std::make_shared<MockContinuousRotarySensor>()) {
 }
 
@@ -197,6 +205,13 @@ QTime MockTimer::millis() const {
          millisecond;
 }
 
+QTime MockTimer::micros() const {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+           std::chrono::high_resolution_clock::now() - epoch)
+           .count() /
+         1000.0 * millisecond;
+}
+
 ConstantMockTimer::ConstantMockTimer(const QTime idt) : AbstractTimer(0_ms), dtToReturn(idt) {
 }
 
@@ -250,6 +265,13 @@ QTime ConstantMockTimer::clearMark() {
   return 0_ms;
 }
 
+ManualTimer::ManualTimer(std::shared_ptr<QTime> inow) : AbstractTimer(*inow), now(std::move(inow)) {
+}
+
+QTime ManualTimer::millis() const {
+  return *now;
+}
+
 MockRate::MockRate() = default;
 
 void MockRate::delay(QFrequency ihz) {
@@ -264,6 +286,13 @@ void MockRate::delayUntil(uint32_t ims) {
   std::this_thread::sleep_for(std::chrono::milliseconds(ims));
 }
 
+LateMockRate::LateMockRate(const QTime ilateness) : lateness(ilateness) {
+}
+
+void LateMockRate::delayUntil(const uint32_t ims) {
+  MockRate::delayUntil(ims + static_cast<uint32_t>(lateness.convert(millisecond)));
+}
+
 std::unique_ptr<SettledUtil> createSettledUtilPtr(const double iatTargetError,
                                                   const double iatTargetDerivative,
                                                   const QTime iatTargetTime) {
@@ -300,6 +329,13 @@ TimeUtil createTimeUtil(const Supplier<std::unique_ptr<SettledUtil>> &isettledUt
     isettledUtilSupplier);
 }
 
+TimeUtil createTimeUtil(const Supplier<std::unique_ptr<AbstractRate>> &irateSupplier) {
+  return TimeUtil(
+    Supplier<std::unique_ptr<AbstractTimer>>([]() { return std::make_unique<MockTimer>(); }),
+    irateSupplier,
+    Supplier<std::unique_ptr<SettledUtil>>([]() { return createSettledUtilPtr(); }));
+}
+
 SimulatedSystem::SimulatedSystem(FlywheelSimulator &isimulator) : simulator(isimulator) {
 }
 
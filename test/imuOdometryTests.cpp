@@ -0,0 +1,144 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/odometry/imuOdometry.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class IMUOdometryTest : public ::testing::Test {
+  protected:
+  std::unique_ptr<IMUOdometry> makeOdom(const double itrust, const bool ifuseOnlyFresh = true) {
+    return std::make_unique<IMUOdometry>(
+      createConstantTimeUtil(10_ms), model, scales, imu, itrust, ifuseOnlyFresh);
+  }
+
+  void expectThetaNear(const IMUOdometry &iodom, const QAngle &iexpected) {
+    EXPECT_NEAR(iodom.getState().theta.convert(degree), iexpected.convert(degree), 1e-9);
+  }
+
+  std::shared_ptr<MockSkidSteerModel> model = std::make_shared<MockSkidSteerModel>();
+  std::shared_ptr<MockContinuousRotarySensor> imu = std::make_shared<MockContinuousRotarySensor>();
+  ChassisScales scales{{4_in, 10_in}, 360};
+};
+
+TEST_F(IMUOdometryTest, ZeroTrustMatchesEncoders) {
+  auto odom = makeOdom(0);
+  TwoEncoderOdometry encoders(createConstantTimeUtil(10_ms), model, scales);
+
+  for (int i = 1; i <= 10; ++i) {
+    model->setSensorVals(30 * i, 10 * i);
+    imu->value = -7 * i;
+    odom->step();
+    encoders.step();
+  }
+
+  EXPECT_EQ(odom->getState(), encoders.getState());
+}
+
+TEST_F(IMUOdometryTest, FullTrustFollowsIMU) {
+  auto odom = makeOdom(1);
+  odom->step();
+
+  // The encoders say the robot drove straight, but it turned 90 degrees on the way
+  model->setSensorVals(36, 36);
+  imu->value = 90;
+  odom->step();
+
+  expectThetaNear(*odom, 90_deg);
+  EXPECT_NEAR(odom->getState().x.convert(meter), odom->getState().y.convert(meter), 1e-9);
+  EXPECT_GT(odom->getState().y.convert(meter), 0);
+  EXPECT_EQ(odom->getFusedSamples(), 1);
+}
+
+TEST_F(IMUOdometryTest, PartialTrustBlends) {
+  auto odom = makeOdom(0.5);
+  odom->step();
+
+  imu->value = 10;
+  odom->step();
+  expectThetaNear(*odom, 5_deg);
+
+  imu->value = 11;
+  odom->step();
+  expectThetaNear(*odom, 8_deg);
+}
+
+TEST_F(IMUOdometryTest, StartingHeadingIsAligned) {
+  imu->value = 45;
+  auto odom = makeOdom(1);
+  odom->step();
+  expectThetaNear(*odom, 0_deg);
+
+  imu->value = 55;
+  odom->step();
+  expectThetaNear(*odom, 10_deg);
+}
+
+TEST_F(IMUOdometryTest, HeadingWrapsAround) {
+  imu->value = 170;
+  auto odom = makeOdom(1);
+  odom->step();
+
+  imu->value = -170;
+  odom->step();
+  expectThetaNear(*odom, 20_deg);
+}
+
+TEST_F(IMUOdometryTest, OnlyFreshSamplesAreFused) {
+  auto fresh = makeOdom(0.5);
+  auto every = makeOdom(0.5, false);
+  TwoEncoderOdometry encoders(createConstantTimeUtil(10_ms), model, scales);
+  fresh->step();
+  every->step();
+  encoders.step();
+
+  // The IMU has not updated while the encoders turned
+  model->setSensorVals(20, -20);
+  fresh->step();
+  every->step();
+  encoders.step();
+
+  expectThetaNear(*fresh, encoders.getState().theta);
+  EXPECT_EQ(fresh->getFusedSamples(), 0);
+  EXPECT_LT(every->getState().theta, encoders.getState().theta);
+  EXPECT_EQ(every->getFusedSamples(), 1);
+}
+
+TEST_F(IMUOdometryTest, IMUTimestampsTellFreshSamples) {
+  auto odom = makeOdom(1);
+  imu->timestamp = 100;
+  odom->step();
+
+  // A new value with an old timestamp is not a new sample
+  imu->value = 10;
+  odom->step();
+  expectThetaNear(*odom, 0_deg);
+
+  imu->timestamp = 110;
+  odom->step();
+  expectThetaNear(*odom, 10_deg);
+}
+
+TEST_F(IMUOdometryTest, SetStateRealignsIMU) {
+  auto odom = makeOdom(1);
+  odom->step();
+
+  odom->setState(OdomState{0_m, 0_m, 90_deg});
+  odom->step();
+  expectThetaNear(*odom, 90_deg);
+
+  imu->value = 10;
+  odom->step();
+  expectThetaNear(*odom, 100_deg);
+}
+
+TEST_F(IMUOdometryTest, BadArgumentsThrow) {
+  EXPECT_THROW(makeOdom(1.5), std::invalid_argument);
+  EXPECT_THROW(makeOdom(-0.1), std::invalid_argument);
+  EXPECT_THROW(IMUOdometry(createConstantTimeUtil(10_ms), model, scales, nullptr),
+               std::invalid_argument);
+}
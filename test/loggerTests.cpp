@@ -5,10 +5,35 @@
  */
 #include "okapi/api/util/logging.hpp"
 #include "test/tests/api/implMocks.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
 #include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+
+// User code may use common names, so the log macros must not take them
+static const char *const logComponent = "user";
+
+// Code outside of namespace okapi which only declares a logger, as user code does
+static void logFromUserCode(const std::shared_ptr<okapi::Logger> &logger) {
+  LOG_WARN_S("User");
+  LOG_WARN_EVENT(okapi::LogEvent::iterativePosPidSetTarget, 2);
+}
 
 using namespace okapi;
 
+namespace {
+struct PidComponent {
+  static constexpr Logger::Component okapiLogComponent = Logger::Component::pid;
+
+  static void logData(const std::shared_ptr<Logger> &logger) {
+    LOG_DEBUG_S("PID");
+    LOG_INFO_EVENT(LogEvent::iterativePosPidSetTarget, 1);
+  }
+};
+} // namespace
+
 class LoggerTest : public ::testing::Test {
   protected:
   virtual void SetUp() {
@@ -172,3 +197,308 @@ TEST_F(LoggerTest, TestLazyLogging) {
     free(line);
   }
 }
+
+TEST_F(LoggerTest, AsyncLoggerWritesRecordsInOrder) {
+  logger = std::make_shared<Logger>(
+    std::make_unique<ConstantMockTimer>(0_ms), logFile, Logger::LogLevel::debug, 16);
+  EXPECT_TRUE(logger->isAsync());
+
+  logData(logger);
+  logger->close();
+
+  const std::string name = CrossplatformThread::getName();
+  EXPECT_EQ(std::string(logBuffer, logSize),
+            "0 (" + name + ") ERROR: MSG\n" + "0 (" + name + ") WARN: MSG\n" + "0 (" + name +
+              ") INFO: MSG\n" + "0 (" + name + ") DEBUG: MSG\n");
+  EXPECT_EQ(logger->getDroppedRecords(), 0);
+}
+
+TEST_F(LoggerTest, AsyncLoggerTruncatesLongMessages) {
+  logger = std::make_shared<Logger>(
+    std::make_unique<ConstantMockTimer>(0_ms), logFile, Logger::LogLevel::info, 16);
+
+  LOG_INFO(std::string(500, 'a'));
+  logger->close();
+
+  const std::string expected = "0 (" + CrossplatformThread::getName() + ") INFO: " +
+                               std::string(LogRecord::messageSize - 1, 'a') + "\n";
+  EXPECT_EQ(std::string(logBuffer, logSize), expected);
+}
+
+TEST_F(LoggerTest, AsyncLoggerCountsDroppedRecords) {
+  logger = std::make_shared<Logger>(
+    std::make_unique<ConstantMockTimer>(0_ms), logFile, Logger::LogLevel::info, 4);
+
+  // Log much faster than the flusher runs so the buffer fills up
+  for (int i = 0; i < 1000; ++i) {
+    LOG_INFO(std::to_string(i));
+  }
+  const std::size_t dropped = logger->getDroppedRecords();
+  logger->close();
+
+  EXPECT_GT(dropped, 0);
+  const std::string log(logBuffer, logSize);
+  EXPECT_NE(log.find("Logger: Dropped"), std::string::npos);
+
+  // Every record is either written or dropped
+  std::size_t written = 0;
+  for (std::size_t i = log.find(") INFO: "); i != std::string::npos;
+       i = log.find(") INFO: ", i + 1)) {
+    written++;
+  }
+  EXPECT_EQ(written + dropped, 1000);
+}
+
+TEST_F(LoggerTest, AsyncLoggerAcceptsManyProducers) {
+  logger = std::make_shared<Logger>(
+    std::make_unique<ConstantMockTimer>(0_ms), logFile, Logger::LogLevel::info, 4096);
+
+  std::vector<std::thread> producers;
+  for (int i = 0; i < 4; ++i) {
+    producers.emplace_back([&]() {
+      for (int j = 0; j < 250; ++j) {
+        LOG_INFO_S("MSG");
+      }
+    });
+  }
+  for (auto &producer : producers) {
+    producer.join();
+  }
+  logger->close();
+
+  const std::string log(logBuffer, logSize);
+  EXPECT_EQ(std::count(log.begin(), log.end(), '\n'), 1000);
+  EXPECT_EQ(logger->getDroppedRecords(), 0);
+}
+
+TEST_F(LoggerTest, EventsAreFormattedLikeMessages) {
+  logger = std::make_shared<Logger>(
+    std::make_unique<ConstantMockTimer>(0_ms), logFile, Logger::LogLevel::info);
+
+  LOG_INFO_EVENT(LogEvent::iterativePosPidSetTarget, 2.5);
+  LOG_INFO_EVENT(LogEvent::chassisControllerPidMoveDistance, 1, 900);
+  LOG_DEBUG_EVENT(LogEvent::iterativePosPidFlipDisable, true);
+  logger->close();
+
+  const std::string name = CrossplatformThread::getName();
+  EXPECT_EQ(std::string(logBuffer, logSize),
+            "0 (" + name + ") INFO: IterativePosPIDController: Set target to 2.500000\n" + "0 (" +
+              name + ") INFO: ChassisControllerPID: moving 1.000000 meters (900.000000 motor " +
+              "ticks)\n");
+}
+
+TEST_F(LoggerTest, AsyncLoggerWritesEvents) {
+  logger = std::make_shared<Logger>(
+    std::make_unique<ConstantMockTimer>(0_ms), logFile, Logger::LogLevel::info, 16);
+
+  LOG_INFO_EVENT(LogEvent::asyncWrapperSetTarget, 3);
+  logger->close();
+
+  EXPECT_EQ(std::string(logBuffer, logSize),
+            "0 (" + CrossplatformThread::getName() + ") INFO: AsyncWrapper: Set target to " +
+              "3.000000\n");
+}
+
+TEST_F(LoggerTest, BinaryLogDecodesToTheTextLog) {
+  char *textBuffer;
+  size_t textSize;
+  auto binaryLogger = std::make_shared<Logger>(std::make_unique<ConstantMockTimer>(5_ms),
+                                               logFile,
+                                               Logger::LogLevel::debug,
+                                               0,
+                                               Logger::Format::binary);
+  auto textLogger = std::make_shared<Logger>(std::make_unique<ConstantMockTimer>(5_ms),
+                                             open_memstream(&textBuffer, &textSize),
+                                             Logger::LogLevel::debug);
+
+  for (const auto &l : {binaryLogger, textLogger}) {
+    logger = l;
+    logData(logger);
+    LOG_WARN_EVENT(LogEvent::asyncVelIntegratedSetTarget, -120);
+    logger->close();
+  }
+
+  std::istringstream binary(std::string(logBuffer, logSize));
+  std::ostringstream decoded;
+  EXPECT_TRUE(decodeBinaryLog(binary, decoded));
+  EXPECT_EQ(decoded.str(), std::string(textBuffer, textSize));
+  EXPECT_EQ(logSize, sizeof(LogFileHeader) + 5 * sizeof(LogRecord));
+
+  free(textBuffer);
+}
+
+TEST_F(LoggerTest, AsyncBinaryLogDecodesAppendedLogs) {
+  char *secondBuffer;
+  size_t secondSize;
+  FILE *secondFile = open_memstream(&secondBuffer, &secondSize);
+
+  for (FILE *file : {logFile, secondFile}) {
+    logger = std::make_shared<Logger>(std::make_unique<ConstantMockTimer>(0_ms),
+                                      file,
+                                      Logger::LogLevel::info,
+                                      8,
+                                      Logger::Format::binary);
+    LOG_INFO_EVENT(LogEvent::iterativeVelPidSetTarget, file == logFile ? 0 : 1);
+    logger->close();
+  }
+
+  // Both logs in one file, as if the second logger had opened the first one's file to append
+  std::istringstream binary(std::string(logBuffer, logSize) +
+                            std::string(secondBuffer, secondSize));
+  std::ostringstream decoded;
+  EXPECT_TRUE(decodeBinaryLog(binary, decoded));
+
+  const std::string name = CrossplatformThread::getName();
+  EXPECT_EQ(decoded.str(),
+            "0 (" + name + ") INFO: IterativeVelPIDController: Set target to 0.000000\n" + "0 (" +
+              name + ") INFO: IterativeVelPIDController: Set target to 1.000000\n");
+
+  free(secondBuffer);
+}
+
+TEST_F(LoggerTest, ComponentsStartAtTheLoggerLevel) {
+  logger = std::make_shared<Logger>(
+    std::make_unique<ConstantMockTimer>(0_ms), logFile, Logger::LogLevel::warn);
+
+  EXPECT_EQ(logger->getComponentLevel(Logger::Component::general), Logger::LogLevel::warn);
+  EXPECT_EQ(logger->getComponentLevel(Logger::Component::odometry), Logger::LogLevel::warn);
+  EXPECT_EQ(logger->getComponentLevel(Logger::Component::pid), Logger::LogLevel::warn);
+  EXPECT_TRUE(logger->isWarnLevelEnabled(Logger::Component::chassis));
+  EXPECT_FALSE(logger->isInfoLevelEnabled(Logger::Component::chassis));
+}
+
+TEST_F(LoggerTest, ComponentLevelOnlyAffectsThatComponent) {
+  logger = std::make_shared<Logger>(
+    std::make_unique<ConstantMockTimer>(0_ms), logFile, Logger::LogLevel::warn);
+  logger->setComponentLevel(Logger::Component::pid, Logger::LogLevel::debug);
+
+  logData(logger);
+  PidComponent::logData(logger);
+  logger->close();
+
+  const std::string name = CrossplatformThread::getName();
+  EXPECT_EQ(std::string(logBuffer, logSize),
+            "0 (" + name + ") ERROR: MSG\n" + "0 (" + name + ") WARN: MSG\n" + "0 (" + name +
+              ") DEBUG: PID\n" + "0 (" + name +
+              ") INFO: IterativePosPIDController: Set target to 1.000000\n");
+}
+
+TEST_F(LoggerTest, ComponentLevelCanBeLowered) {
+  logger = std::make_shared<Logger>(
+    std::make_unique<ConstantMockTimer>(0_ms), logFile, Logger::LogLevel::debug);
+  logger->setComponentLevel(Logger::Component::pid, Logger::LogLevel::off);
+
+  PidComponent::logData(logger);
+  logger->close();
+
+  EXPECT_EQ(logSize, 0);
+}
+
+TEST_F(LoggerTest, CodeOutsideOfOkapiLogsAsGeneral) {
+  logger = std::make_shared<Logger>(
+    std::make_unique<ConstantMockTimer>(0_ms), logFile, Logger::LogLevel::off);
+  logger->setComponentLevel(Logger::Component::general, Logger::LogLevel::warn);
+
+  logFromUserCode(logger);
+  logger->close();
+
+  const std::string name = CrossplatformThread::getName();
+  EXPECT_EQ(std::string(logBuffer, logSize),
+            "0 (" + name + ") WARN: User\n" + "0 (" + name +
+              ") WARN: IterativePosPIDController: Set target to 2.000000\n");
+}
+
+TEST_F(LoggerTest, BinaryLogIsLittleEndian) {
+  logger = std::make_shared<Logger>(std::make_unique<ConstantMockTimer>(0_ms),
+                                    logFile,
+                                    Logger::LogLevel::debug,
+                                    0,
+                                    Logger::Format::binary);
+  LOG_INFO_EVENT(LogEvent::asyncWrapperSetTarget, 1);
+  logger->close();
+
+  const std::string contents(logBuffer, logSize);
+  ASSERT_EQ(contents.size(), sizeof(LogFileHeader) + sizeof(LogRecord));
+  EXPECT_EQ(contents.substr(offsetof(LogFileHeader, version), 2),
+            std::string("\x01\x00", 2));
+  EXPECT_EQ(contents.substr(offsetof(LogFileHeader, recordSize), 2),
+            std::string("\x78\x00", 2));
+
+  const std::string record = contents.substr(sizeof(LogFileHeader));
+  EXPECT_EQ(record.substr(offsetof(LogRecord, event), 2), std::string("\x0a\x00", 2));
+
+  // The first field is 1.0, which is 0x3FF0000000000000
+  EXPECT_EQ(record.substr(offsetof(LogRecord, fields), 8),
+            std::string("\x00\x00\x00\x00\x00\x00\xf0\x3f", 8));
+}
+
+TEST(LoggerCompiledLevelTest, EveryLevelIsCompiledByDefault) {
+  EXPECT_EQ(Logger::compiledLevel, Logger::LogLevel::debug);
+}
+
+TEST(LogRecordTest, DecodingRejectsTextAndTruncatedLogs) {
+  std::ostringstream decoded;
+
+  std::istringstream text("0 (main) INFO: MSG\n");
+  EXPECT_FALSE(decodeBinaryLog(text, decoded));
+
+  LogRecord record{};
+  record.level = 3;
+  std::strcpy(record.message, "MSG");
+  LogFileHeader header{{'O', 'K', 'L', 'G'}, 1, sizeof(LogRecord)};
+  convertLogFileHeaderByteOrder(header);
+  convertLogRecordByteOrder(record);
+  std::string binary(reinterpret_cast<const char *>(&header), sizeof(header));
+  binary.append(reinterpret_cast<const char *>(&record), sizeof(record));
+
+  std::istringstream truncated(binary.substr(0, binary.size() - 1));
+  EXPECT_FALSE(decodeBinaryLog(truncated, decoded));
+  EXPECT_EQ(decoded.str(), "");
+
+  std::istringstream complete(binary);
+  EXPECT_TRUE(decodeBinaryLog(complete, decoded));
+  EXPECT_EQ(decoded.str(), "0 () INFO: MSG\n");
+}
+
+TEST(LogRecordTest, FormattingReportsTheFullLength) {
+  LogRecord record{};
+  record.event = static_cast<std::uint16_t>(LogEvent::asyncWrapperSetTarget);
+  record.level = 2;
+  record.fields[0] = 1;
+
+  const std::string expected = "0 () WARN: AsyncWrapper: Set target to 1.000000\n";
+  char buffer[16];
+  EXPECT_EQ(formatLogRecord(record, buffer, sizeof(buffer)), expected.size());
+  EXPECT_EQ(std::string(buffer), expected.substr(0, sizeof(buffer) - 1));
+}
+
+TEST(LogRingBufferTest, CapacityIsRoundedUpToAPowerOfTwo) {
+  EXPECT_EQ(LogRingBuffer(1).getCapacity(), 1);
+  EXPECT_EQ(LogRingBuffer(5).getCapacity(), 8);
+  EXPECT_EQ(LogRingBuffer(64).getCapacity(), 64);
+}
+
+TEST(LogRingBufferTest, PushFailsWhenFull) {
+  LogRingBuffer buffer(2);
+  LogRecord record{};
+
+  EXPECT_TRUE(buffer.push(record));
+  EXPECT_TRUE(buffer.push(record));
+  EXPECT_FALSE(buffer.push(record));
+
+  EXPECT_TRUE(buffer.pop(record));
+  EXPECT_TRUE(buffer.push(record));
+}
+
+TEST(LogRingBufferTest, PopsInOrderAcrossLaps) {
+  LogRingBuffer buffer(4);
+  LogRecord record{};
+
+  for (long i = 0; i < 20; ++i) {
+    record.time = i;
+    ASSERT_TRUE(buffer.push(record));
+    ASSERT_TRUE(buffer.pop(record));
+    EXPECT_EQ(record.time, i);
+  }
+  EXPECT_FALSE(buffer.pop(record));
+}
@@ -0,0 +1,180 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/loopStats.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class LoopStatsTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    stats = std::make_unique<LoopStats>(std::make_unique<ManualTimer>(now), 0_ms);
+  }
+
+  /**
+   * Runs one tick which takes iexecution and then sleeps until isleep after it started.
+   */
+  void tick(const QTime iexecution, const QTime isleep, const QTime iperiod = 10_ms) {
+    stats->tickStarted(iperiod);
+    *now += iexecution;
+    stats->tickFinished();
+    *now += isleep - iexecution;
+  }
+
+  std::shared_ptr<QTime> now = std::make_shared<QTime>(0_ms);
+  std::unique_ptr<LoopStats> stats;
+};
+
+TEST_F(LoopStatsTest, BucketsAreUpperBounds) {
+  EXPECT_EQ(LoopStats::getBucket(0_ms), 0);
+  EXPECT_EQ(LoopStats::getBucket(0.4_ms), 0);
+  EXPECT_EQ(LoopStats::getBucket(1.5_ms), 2);
+  EXPECT_EQ(LoopStats::getBucket(10_ms), 7);
+  EXPECT_EQ(LoopStats::getBucket(1_s), LoopStats::bucketCount - 1);
+}
+
+TEST_F(LoopStatsTest, NothingIsMeasuredAtFirst) {
+  const auto summary = stats->getSummary();
+  EXPECT_EQ(summary.ticks, 0);
+  EXPECT_EQ(summary.overruns, 0);
+  EXPECT_EQ(summary.lateTicks, 0);
+  EXPECT_EQ(summary.meanExecutionTime, 0_ms);
+  EXPECT_EQ(summary.maxExecutionTime, 0_ms);
+  EXPECT_EQ(summary.maxJitter, 0_ms);
+}
+
+TEST_F(LoopStatsTest, MeasuresExecutionTime) {
+  tick(2_ms, 10_ms);
+  tick(4_ms, 10_ms);
+
+  const auto summary = stats->getSummary();
+  EXPECT_EQ(summary.ticks, 2);
+  EXPECT_EQ(summary.overruns, 0);
+  EXPECT_NEAR(summary.meanExecutionTime.convert(millisecond), 3, 1e-3);
+  EXPECT_NEAR(summary.maxExecutionTime.convert(millisecond), 4, 1e-3);
+  EXPECT_EQ(summary.executionTimes[LoopStats::getBucket(2_ms)], 1);
+  EXPECT_EQ(summary.executionTimes[LoopStats::getBucket(4_ms)], 1);
+}
+
+TEST_F(LoopStatsTest, MeasuresWithTheMicrosecondClock) {
+  // Like the brain's timer, millis() only counts whole milliseconds
+  class CoarseTimer : public ManualTimer {
+    public:
+    using ManualTimer::ManualTimer;
+
+    QTime millis() const override {
+      return std::floor(now->convert(millisecond)) * millisecond;
+    }
+
+    QTime micros() const override {
+      return *now;
+    }
+  };
+
+  stats = std::make_unique<LoopStats>(std::make_unique<CoarseTimer>(now), 0_ms);
+  *now = 0.7_ms;
+  tick(0.2_ms, 10_ms);
+
+  const auto summary = stats->getSummary();
+  EXPECT_NEAR(summary.maxExecutionTime.convert(millisecond), 0.2, 1e-3);
+  EXPECT_EQ(summary.executionTimes[0], 1);
+}
+
+TEST_F(LoopStatsTest, OnTimeTicksHaveNoJitter) {
+  for (int i = 0; i < 5; ++i) {
+    tick(1_ms, 10_ms);
+  }
+
+  const auto summary = stats->getSummary();
+  EXPECT_EQ(summary.lateTicks, 0);
+  EXPECT_EQ(summary.maxJitter, 0_ms);
+  EXPECT_EQ(summary.jitters[0], 4);
+}
+
+TEST_F(LoopStatsTest, CountsOverrunsAndLateTicks) {
+  tick(1_ms, 10_ms);
+  tick(15_ms, 16_ms);
+  tick(1_ms, 10_ms);
+
+  const auto summary = stats->getSummary();
+  EXPECT_EQ(summary.ticks, 3);
+  EXPECT_EQ(summary.overruns, 1);
+  EXPECT_EQ(summary.lateTicks, 1);
+  EXPECT_NEAR(summary.maxJitter.convert(millisecond), 6, 1e-3);
+  EXPECT_EQ(summary.jitters[LoopStats::getBucket(6_ms)], 1);
+}
+
+TEST_F(LoopStatsTest, EarlyTicksAreJitterButNotLate) {
+  tick(1_ms, 7_ms);
+  tick(1_ms, 10_ms);
+
+  const auto summary = stats->getSummary();
+  EXPECT_EQ(summary.lateTicks, 0);
+  EXPECT_NEAR(summary.maxJitter.convert(millisecond), 3, 1e-3);
+}
+
+TEST_F(LoopStatsTest, IgnoredPeriodIsNotJitter) {
+  tick(1_ms, 10_ms);
+  *now += 1_s;
+  stats->ignoreNextPeriod();
+  tick(1_ms, 10_ms);
+
+  const auto summary = stats->getSummary();
+  EXPECT_EQ(summary.ticks, 2);
+  EXPECT_EQ(summary.lateTicks, 0);
+  EXPECT_EQ(summary.maxJitter, 0_ms);
+}
+
+TEST_F(LoopStatsTest, ResetClearsMeasurements) {
+  tick(15_ms, 20_ms);
+  tick(1_ms, 10_ms);
+  stats->reset();
+
+  const auto summary = stats->getSummary();
+  EXPECT_EQ(summary.ticks, 0);
+  EXPECT_EQ(summary.overruns, 0);
+  EXPECT_EQ(summary.lateTicks, 0);
+  EXPECT_EQ(summary.maxExecutionTime, 0_ms);
+  for (std::size_t i = 0; i < LoopStats::bucketCount; ++i) {
+    EXPECT_EQ(summary.executionTimes[i], 0);
+    EXPECT_EQ(summary.jitters[i], 0);
+  }
+}
+
+TEST_F(LoopStatsTest, NullTimerMeasuresNothing) {
+  LoopStats unmeasured(nullptr);
+  unmeasured.tickStarted(10_ms);
+  unmeasured.tickFinished();
+
+  EXPECT_EQ(unmeasured.getSummary().ticks, 0);
+}
+
+TEST_F(LoopStatsTest, LogsSummaryEveryPeriod) {
+  char *logBuffer = nullptr;
+  size_t logSize = 0;
+  auto logger = std::make_shared<Logger>(std::make_unique<ConstantMockTimer>(0_ms),
+                                         open_memstream(&logBuffer, &logSize),
+                                         Logger::LogLevel::info);
+  stats = std::make_unique<LoopStats>(std::make_unique<ManualTimer>(now), 50_ms, logger);
+
+  for (int i = 0; i < 11; ++i) {
+    tick(2_ms, 10_ms);
+  }
+  logger->close();
+
+  const std::string log(logBuffer, logSize);
+  free(logBuffer);
+
+  // The ticks finish at 2 ms, 12 ms, ..., so the summaries come after 52 ms and 102 ms
+  EXPECT_NE(log.find("LoopStats: 6 ticks, 0 overruns, max execution time 2.000 ms"),
+            std::string::npos);
+  EXPECT_NE(log.find("LoopStats: 11 ticks"), std::string::npos);
+}
@@ -0,0 +1,146 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/chassis/model/skidSteerModel.hpp"
+#include "okapi/api/control/util/controlScheduler.hpp"
+#include "okapi/api/device/motor/motorCommandBuffer.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+namespace {
+class CountingMotor : public MockMotor {
+  public:
+  std::int32_t moveVelocity(const std::int16_t ivelocity) override {
+    commands++;
+    return MockMotor::moveVelocity(ivelocity);
+  }
+
+  std::int32_t moveVoltage(const std::int16_t ivoltage) override {
+    commands++;
+    return MockMotor::moveVoltage(ivoltage);
+  }
+
+  int commands{0};
+};
+} // namespace
+
+class MotorCommandBufferTest : public ::testing::Test {
+  protected:
+  std::shared_ptr<MotorCommandBuffer> buffer = std::make_shared<MotorCommandBuffer>();
+  std::shared_ptr<CountingMotor> motor = std::make_shared<CountingMotor>();
+  std::shared_ptr<AbstractMotor> buffered = buffer->buffer(motor);
+};
+
+TEST_F(MotorCommandBufferTest, CommandsWaitForCommit) {
+  buffered->moveVelocity(50);
+  EXPECT_EQ(motor->commands, 0);
+
+  EXPECT_EQ(buffer->commit(), 1);
+  EXPECT_EQ(motor->commands, 1);
+  EXPECT_EQ(motor->lastVelocity, 50);
+}
+
+TEST_F(MotorCommandBufferTest, OnlyNewestCommandIsSent) {
+  buffered->moveVelocity(10);
+  buffered->moveVoltage(3000);
+  buffered->moveVelocity(20);
+  buffer->commit();
+
+  EXPECT_EQ(motor->commands, 1);
+  EXPECT_EQ(motor->lastVelocity, 20);
+  EXPECT_EQ(motor->lastVoltage, 0);
+}
+
+TEST_F(MotorCommandBufferTest, UnchangedCommandIsNotSentAgain) {
+  for (int i = 0; i < 5; ++i) {
+    buffered->moveVelocity(30);
+    buffer->commit();
+  }
+  EXPECT_EQ(motor->commands, 1);
+
+  buffered->moveVoltage(30);
+  buffer->commit();
+  EXPECT_EQ(motor->commands, 2);
+  EXPECT_EQ(motor->lastVoltage, 30);
+
+  const auto counters = buffer->getCounters();
+  EXPECT_EQ(counters.commits, 6);
+  EXPECT_EQ(counters.requested, 6);
+  EXPECT_EQ(counters.sent, 2);
+  EXPECT_EQ(counters.getSaved(), 4);
+}
+
+TEST_F(MotorCommandBufferTest, PositionCommandResendsVelocity) {
+  buffered->moveVelocity(30);
+  buffer->commit();
+  buffered->moveAbsolute(100, 50);
+  EXPECT_EQ(motor->lastPosition, 100);
+
+  buffered->moveVelocity(30);
+  buffer->commit();
+  EXPECT_EQ(motor->commands, 2);
+}
+
+TEST_F(MotorCommandBufferTest, SameMotorGetsSameWrapper) {
+  EXPECT_EQ(buffer->buffer(motor), buffered);
+  EXPECT_EQ(buffer->buffer(buffered), buffered);
+  EXPECT_NE(buffer->buffer(std::make_shared<CountingMotor>()), buffered);
+}
+
+TEST_F(MotorCommandBufferTest, DeletedMotorSendsPendingCommand) {
+  buffered->moveVelocity(40);
+  buffered.reset();
+  EXPECT_EQ(motor->lastVelocity, 40);
+  EXPECT_EQ(buffer->commit(), 0);
+}
+
+TEST_F(MotorCommandBufferTest, SkidSteerDrivesThroughBuffer) {
+  auto right = std::make_shared<CountingMotor>();
+  SkidSteerModel model(buffered,
+                       buffer->buffer(right),
+                       motor->getEncoder(),
+                       right->getEncoder(),
+                       200,
+                       12000);
+
+  for (int i = 0; i < 10; ++i) {
+    model.driveVector(0.5, 0);
+    buffer->commit();
+  }
+
+  EXPECT_EQ(motor->lastVelocity, 100);
+  EXPECT_EQ(right->lastVelocity, 100);
+  EXPECT_EQ(motor->commands + right->commands, 2);
+  EXPECT_EQ(buffer->getCounters().getSaved(), 18);
+}
+
+TEST_F(MotorCommandBufferTest, ThreadedMockMotorThroughBuffer) {
+  auto threaded = std::make_shared<ThreadedMockMotor>();
+  auto wrapper = buffer->buffer(threaded);
+  wrapper->moveVoltage(6000);
+  EXPECT_EQ(threaded->setVoltage, 0);
+
+  buffer->commit();
+  EXPECT_EQ(threaded->setVoltage, 6000);
+  EXPECT_EQ(threaded->mode, ThreadedMockMotor::voltage);
+}
+
+TEST_F(MotorCommandBufferTest, SchedulerCommitsAtEndOfTick) {
+  ControlScheduler scheduler(createTimeUtil());
+  auto wrapper = scheduler.getCommandBuffer()->buffer(motor);
+  scheduler.add([&]() { wrapper->moveVelocity(25); }, ControlScheduler::Stage::control);
+  std::vector<int> commandsBeforeCommit;
+  scheduler.add([&]() { commandsBeforeCommit.push_back(motor->commands); },
+                ControlScheduler::Stage::actuate);
+
+  scheduler.tick();
+  scheduler.tick();
+  EXPECT_EQ(commandsBeforeCommit, std::vector<int>({0, 1}));
+  EXPECT_EQ(motor->commands, 1);
+  EXPECT_EQ(motor->lastVelocity, 25);
+  EXPECT_EQ(scheduler.getCommandBuffer()->getCounters().getSaved(), 1);
+}
@@ -0,0 +1,69 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/pathGenerationPool.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+TEST(PathGenerationPoolTest, ZeroWorkersThrows) {
+  EXPECT_THROW(PathGenerationPool(createTimeUtil(), 0, "pool"), std::invalid_argument);
+}
+
+TEST(PathGenerationPoolTest, EmptyBatch) {
+  PathGenerationPool pool(createTimeUtil(), 2, "pool");
+  EXPECT_TRUE(pool.run({}).empty());
+}
+
+TEST(PathGenerationPoolTest, ResultsAreInJobOrder) {
+  std::atomic_int runs{0};
+  std::vector<PathGenerationPool::Job> jobs;
+  for (int i = 0; i < 10; ++i) {
+    jobs.push_back({std::to_string(i), [&]() { runs++; }});
+  }
+
+  PathGenerationPool pool(createTimeUtil(), 3, "pool");
+  const auto results = pool.run(jobs);
+
+  EXPECT_EQ(runs, 10);
+  ASSERT_EQ(results.size(), 10);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(results[i].pathId, std::to_string(i));
+    EXPECT_TRUE(results[i].successful);
+    EXPECT_EQ(results[i].error, "");
+  }
+}
+
+TEST(PathGenerationPoolTest, FailedJobDoesNotStopTheOthers) {
+  PathGenerationPool pool(createTimeUtil(), 2, "pool");
+  const auto results = pool.run({{"A", []() { throw std::runtime_error("impossible"); }},
+                                 {"B", []() {}}});
+
+  ASSERT_EQ(results.size(), 2);
+  EXPECT_FALSE(results[0].successful);
+  EXPECT_EQ(results[0].error, "impossible");
+  EXPECT_TRUE(results[1].successful);
+}
+
+TEST(PathGenerationPoolTest, JobsRunInParallel) {
+  std::vector<PathGenerationPool::Job> jobs;
+  for (int i = 0; i < 4; ++i) {
+    jobs.push_back({std::to_string(i), []() { createTimeUtil().getRate()->delayUntil(200_ms); }});
+  }
+
+  PathGenerationPool pool(createTimeUtil(), 4, "pool");
+  auto timer = createTimeUtil().getTimer();
+  const QTime start = timer->millis();
+  const auto results = pool.run(jobs);
+  const QTime elapsed = timer->millis() - start;
+
+  // The batch takes about as long as one job, not as long as all of them
+  EXPECT_LT(elapsed, 600_ms);
+  for (const auto &result : results) {
+    EXPECT_TRUE(result.successful);
+    EXPECT_GE(result.duration, 190_ms);
+  }
+}
@@ -0,0 +1,82 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/pathMemoryBudget.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class PathMemoryBudgetTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    for (int i = 0; i < 100; ++i) {
+      path.emplace_back(squiggles::ControlVector(squiggles::Pose(i * 0.01, 0, 0), 1, 0, 0),
+                        std::vector<double>{1, 0.5},
+                        0,
+                        i * 0.01);
+    }
+  }
+
+  ExecutionPlan makePlan() const {
+    return ExecutionPlan::compile(path, 0.3);
+  }
+
+  std::vector<squiggles::ProfilePoint> path;
+};
+
+TEST_F(PathMemoryBudgetTest, AdmittedPathsCountUntilFreed) {
+  PathMemoryBudget budget(100000);
+  const std::size_t size = makePlan().getMemoryUsage();
+
+  auto first = budget.admit(makePlan());
+  ASSERT_NE(first, nullptr);
+  EXPECT_FALSE(first->isCompact());
+  EXPECT_EQ(budget.getUsage(), size);
+
+  auto second = budget.admit(makePlan());
+  ASSERT_NE(second, nullptr);
+  EXPECT_EQ(budget.getUsage(), 2 * size);
+
+  first.reset();
+  EXPECT_EQ(budget.getUsage(), size);
+  second.reset();
+  EXPECT_EQ(budget.getUsage(), 0);
+}
+
+TEST_F(PathMemoryBudgetTest, PathWhichDoesNotFitIsCompacted) {
+  PathMemoryBudget budget(makePlan().getMemoryUsage() - 1);
+
+  auto plan = budget.admit(makePlan());
+  ASSERT_NE(plan, nullptr);
+  EXPECT_TRUE(plan->isCompact());
+  EXPECT_EQ(budget.getUsage(), plan->getMemoryUsage());
+}
+
+TEST_F(PathMemoryBudgetTest, PathWhichDoesNotFitCompactedIsRejected) {
+  auto compacted = makePlan();
+  compacted.compact();
+  PathMemoryBudget budget(compacted.getMemoryUsage() - 1);
+
+  EXPECT_EQ(budget.admit(makePlan()), nullptr);
+  EXPECT_EQ(budget.getUsage(), 0);
+}
+
+TEST_F(PathMemoryBudgetTest, CompactAll) {
+  PathMemoryBudget budget(100000, true);
+  EXPECT_TRUE(budget.isCompactingAll());
+
+  auto plan = budget.admit(makePlan());
+  ASSERT_NE(plan, nullptr);
+  EXPECT_TRUE(plan->isCompact());
+}
+
+TEST_F(PathMemoryBudgetTest, PathCanOutliveBudget) {
+  auto budget = std::make_unique<PathMemoryBudget>(100000);
+  auto plan = budget->admit(makePlan());
+  budget.reset();
+
+  EXPECT_EQ(plan->size(), path.size());
+  plan.reset();
+}
@@ -0,0 +1,72 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/pathStore.hpp"
+#include <thread>
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+TEST(PathStoreTest, FindMissingPathReturnsNull) {
+  PathStore<std::vector<int>> store;
+  EXPECT_EQ(store.find("A"), nullptr);
+  EXPECT_EQ(store.size(), 0);
+}
+
+TEST(PathStoreTest, InsertReplacesPathWithSameId) {
+  PathStore<std::vector<int>> store;
+  store.insert("A", {1, 2, 3});
+  store.insert("A", {4});
+
+  ASSERT_NE(store.find("A"), nullptr);
+  EXPECT_EQ(*store.find("A"), std::vector<int>{4});
+  EXPECT_EQ(store.getIds(), std::vector<std::string>{"A"});
+}
+
+TEST(PathStoreTest, ErasedPathStaysAliveForReaders) {
+  PathStore<std::vector<int>> store;
+  store.insert("A", {1, 2, 3});
+
+  const auto path = store.find("A");
+  store.erase("A");
+  store.clear();
+
+  EXPECT_EQ(store.find("A"), nullptr);
+  ASSERT_NE(path, nullptr);
+  EXPECT_EQ(*path, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(PathStoreTest, SnapshotIsNotChangedByLaterWrites) {
+  PathStore<std::vector<int>> store;
+  store.insert("A", {1});
+
+  const auto snapshot = store.getSnapshot();
+  store.insert("B", {2});
+  store.erase("A");
+
+  EXPECT_EQ(snapshot->size(), 1);
+  EXPECT_EQ(snapshot->count("A"), 1);
+  EXPECT_EQ(store.getIds(), std::vector<std::string>{"B"});
+}
+
+TEST(PathStoreTest, ConcurrentWritersDoNotLoseUpdates) {
+  PathStore<std::vector<int>> store;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&store, t]() {
+      for (int i = 0; i < 100; ++i) {
+        store.insert(std::to_string(t) + "_" + std::to_string(i), {t, i});
+        store.find(std::to_string(t) + "_" + std::to_string(i / 2));
+      }
+    });
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(store.size(), 400);
+}
@@ -0,0 +1,154 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/filter/poseEKF.hpp"
+#include "okapi/api/units/QAngle.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+namespace {
+double trace(const PoseEKF::Covariance &iP) {
+  return iP(0, 0) + iP(1, 1) + iP(2, 2);
+}
+
+void expectStateNear(const PoseEKF &ifilter,
+                     const QLength &ix,
+                     const QLength &iy,
+                     const QAngle &itheta,
+                     const double itolerance = 1e-6) {
+  const auto state = ifilter.getState();
+  EXPECT_NEAR(state.x.convert(meter), ix.convert(meter), itolerance);
+  EXPECT_NEAR(state.y.convert(meter), iy.convert(meter), itolerance);
+  EXPECT_NEAR(state.theta.convert(degree), itheta.convert(degree), itolerance);
+}
+} // namespace
+
+TEST(MatrixTest, MultiplyAndInvert) {
+  const Matrix<2, 3> a{1, 2, 3, 4, 5, 6};
+  const auto aat = a * a.transpose();
+  EXPECT_DOUBLE_EQ(aat(0, 0), 14);
+  EXPECT_DOUBLE_EQ(aat(0, 1), 32);
+  EXPECT_DOUBLE_EQ(aat(1, 1), 77);
+
+  Matrix<2, 2> inverse;
+  ASSERT_TRUE(aat.invert(inverse));
+  const auto product = aat * inverse;
+  EXPECT_NEAR(product(0, 0), 1, 1e-12);
+  EXPECT_NEAR(product(0, 1), 0, 1e-12);
+  EXPECT_NEAR(product(1, 1), 1, 1e-12);
+
+  EXPECT_FALSE((Matrix<2, 2>{1, 2, 2, 4}).invert(inverse));
+}
+
+TEST(PoseEKFTest, PredictFollowsMotion) {
+  PoseEKF filter;
+  filter.predict(1_m, 0_m, 0_deg);
+  expectStateNear(filter, 1_m, 0_m, 0_deg);
+
+  filter.predict(0_m, 0_m, 90_deg);
+  filter.predict(1_m, 0_m, 0_deg);
+  expectStateNear(filter, 1_m, 1_m, 90_deg);
+
+  // Driving right while facing +y moves towards -x
+  filter.predict(0_m, 1_m, 0_deg);
+  expectStateNear(filter, 0_m, 1_m, 90_deg);
+}
+
+TEST(PoseEKFTest, PredictFromOdometryStatesUsesFilterHeading) {
+  PoseEKF filter(OdomState{0_m, 0_m, 90_deg});
+
+  // The odometry thinks the robot is facing 0 degrees
+  filter.predict(OdomState{1_m, 1_m, 0_deg}, OdomState{1.5_m, 1_m, 0_deg});
+  expectStateNear(filter, 0_m, 0.5_m, 90_deg);
+}
+
+TEST(PoseEKFTest, UncertaintyGrowsOnlyWithMotion) {
+  PoseEKF filter;
+  const double start = trace(filter.getCovariance());
+
+  filter.predict(0_m, 0_m, 0_deg);
+  EXPECT_DOUBLE_EQ(trace(filter.getCovariance()), start);
+
+  filter.predict(1_m, 0_m, 0_deg);
+  const auto P = filter.getCovariance();
+  EXPECT_GT(trace(P), start);
+  EXPECT_DOUBLE_EQ(P(0, 1), P(1, 0));
+}
+
+TEST(PoseEKFTest, HeadingCorrection) {
+  PoseEKF filter(OdomState{}, PoseEKF::Covariance::diagonal({1, 1, 1}));
+  EXPECT_TRUE(filter.correctHeading(10_deg, 0.001_deg));
+  expectStateNear(filter, 0_m, 0_m, 10_deg, 1e-3);
+  EXPECT_LT(filter.getCovariance()(2, 2), 1e-6);
+}
+
+TEST(PoseEKFTest, HeadingCorrectionWrapsAround) {
+  PoseEKF filter(OdomState{0_m, 0_m, 179_deg}, PoseEKF::Covariance::diagonal({1, 1, 1}));
+  filter.correctHeading(-179_deg, 0.001_deg);
+  expectStateNear(filter, 0_m, 0_m, 181_deg, 1e-3);
+}
+
+TEST(PoseEKFTest, EquallyTrustedPositionMeetsHalfway) {
+  PoseEKF filter(OdomState{}, PoseEKF::Covariance::diagonal({0.01, 0.01, 0.01}));
+  EXPECT_TRUE(filter.correctPosition(1_m, -1_m, 0.1_m));
+  expectStateNear(filter, 0.5_m, -0.5_m, 0_deg);
+}
+
+TEST(PoseEKFTest, PoseCorrection) {
+  PoseEKF filter(OdomState{}, PoseEKF::Covariance::diagonal({1, 1, 1}));
+  EXPECT_TRUE(filter.correctPose(OdomState{1_m, 2_m, 30_deg}, 1_mm, 0.001_deg));
+  expectStateNear(filter, 1_m, 2_m, 30_deg, 1e-3);
+}
+
+TEST(PoseEKFTest, DistanceToWallInFront) {
+  PoseEKF filter(OdomState{}, PoseEKF::Covariance::diagonal({1, 1, 0}));
+  const PoseEKF::DistanceSensorMount mount{0.1_m, 0_m, 0_deg};
+  const PoseEKF::Wall wall{PoseEKF::Wall::Axis::x, 2_m};
+
+  // The sensor is 0.1 m in front of the robot and sees the wall 1.8 m away
+  EXPECT_TRUE(filter.correctDistance(1.8_m, mount, wall, 1_mm));
+  expectStateNear(filter, 0.1_m, 0_m, 0_deg, 1e-3);
+}
+
+TEST(PoseEKFTest, DistanceToWallOnTheSide) {
+  PoseEKF filter(OdomState{}, PoseEKF::Covariance::diagonal({1, 1, 0}));
+  const PoseEKF::DistanceSensorMount mount{0_m, 0_m, 90_deg};
+  const PoseEKF::Wall wall{PoseEKF::Wall::Axis::y, 1_m};
+  EXPECT_TRUE(filter.correctDistance(0.5_m, mount, wall, 1_mm));
+  expectStateNear(filter, 0_m, 0.5_m, 0_deg, 1e-3);
+}
+
+TEST(PoseEKFTest, DistanceCorrectsHeading) {
+  // Only the heading is uncertain, and the sensor sees the wall straight on
+  PoseEKF filter(OdomState{0_m, 0_m, 10_deg}, PoseEKF::Covariance::diagonal({0, 0, 0.1}));
+  const PoseEKF::Wall wall{PoseEKF::Wall::Axis::x, 1_m};
+  EXPECT_TRUE(filter.correctDistance(1_m, PoseEKF::DistanceSensorMount{}, wall, 1_mm));
+
+  const auto theta = filter.getState().theta;
+  EXPECT_LT(theta, 10_deg);
+  EXPECT_GT(theta, 0_deg);
+}
+
+TEST(PoseEKFTest, UnusableDistanceReadingsAreIgnored) {
+  PoseEKF filter(OdomState{}, PoseEKF::Covariance::diagonal({1, 1, 1}));
+  const PoseEKF::Wall wall{PoseEKF::Wall::Axis::x, 1_m};
+
+  const PoseEKF::DistanceSensorMount parallel{0_m, 0_m, 90_deg};
+  EXPECT_FALSE(filter.correctDistance(1_m, parallel, wall, 1_mm));
+
+  const PoseEKF::DistanceSensorMount facingAway{0_m, 0_m, 180_deg};
+  EXPECT_FALSE(filter.correctDistance(1_m, facingAway, wall, 1_mm));
+  expectStateNear(filter, 0_m, 0_m, 0_deg);
+}
+
+TEST(PoseEKFTest, OutlierGateRejectsFarMeasurements) {
+  PoseEKF filter(OdomState{}, PoseEKF::Covariance::diagonal({0.01, 0.01, 0.01}));
+  filter.setOutlierGate(9);
+  EXPECT_FALSE(filter.correctPosition(5_m, 0_m, 0.1_m));
+  expectStateNear(filter, 0_m, 0_m, 0_deg);
+
+  EXPECT_TRUE(filter.correctPosition(0.2_m, 0_m, 0.1_m));
+}
@@ -0,0 +1,155 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/chassis/controller/chassisControllerPid.hpp"
+#include "okapi/api/control/async/asyncWrapper.hpp"
+#include "okapi/api/control/util/controlScheduler.hpp"
+#include "okapi/api/control/util/sensorCache.hpp"
+#include "okapi/api/odometry/twoEncoderOdometry.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+namespace {
+class CountingInput : public ControllerInput<double> {
+  public:
+  double controllerGet() override {
+    return ++reads;
+  }
+
+  int reads{0};
+};
+
+class CountingModel : public ReadOnlyChassisModel {
+  public:
+  std::valarray<std::int32_t> getSensorVals() const override {
+    reads++;
+    return {reads, 2 * reads};
+  }
+
+  mutable std::int32_t reads{0};
+};
+
+class NullOutput : public ControllerOutput<double> {
+  public:
+  void controllerSet(double) override {
+  }
+};
+} // namespace
+
+class SensorCacheTest : public ::testing::Test {
+  protected:
+  std::shared_ptr<QTime> now = std::make_shared<QTime>(0_ms);
+  std::shared_ptr<SensorCache> cache =
+    std::make_shared<SensorCache>(std::make_unique<ManualTimer>(now));
+};
+
+TEST_F(SensorCacheTest, ReadsInputOncePerFrame) {
+  auto input = std::make_shared<CountingInput>();
+  auto cached = cache->cache(input);
+
+  EXPECT_DOUBLE_EQ(cached->controllerGet(), 1);
+  EXPECT_DOUBLE_EQ(cached->controllerGet(), 1);
+  EXPECT_EQ(input->reads, 1);
+
+  cache->refresh();
+  EXPECT_DOUBLE_EQ(cached->controllerGet(), 2);
+  EXPECT_DOUBLE_EQ(cached->controllerGet(), 2);
+  EXPECT_EQ(input->reads, 2);
+  EXPECT_EQ(cached->getEntry().getReadCount(), 2);
+}
+
+TEST_F(SensorCacheTest, ReadsModelOncePerFrame) {
+  auto model = std::make_shared<CountingModel>();
+  auto cached = cache->cache(model);
+
+  EXPECT_EQ(cached->getSensorVals()[1], 2);
+  EXPECT_EQ(cached->getSensorVals()[1], 2);
+  EXPECT_EQ(model->reads, 1);
+
+  cache->refresh();
+  EXPECT_EQ(cached->getSensorVals()[0], 2);
+  EXPECT_EQ(model->reads, 2);
+}
+
+TEST_F(SensorCacheTest, SameSensorGetsSameWrapper) {
+  auto input = std::make_shared<CountingInput>();
+  auto model = std::make_shared<CountingModel>();
+
+  auto cached = cache->cache(input);
+  EXPECT_EQ(cache->cache(input), cached);
+  EXPECT_NE(cache->cache(std::make_shared<CountingInput>()), cached);
+  EXPECT_EQ(cache->cache(model), cache->cache(model));
+
+  cached->controllerGet();
+  cache->cache(input)->controllerGet();
+  EXPECT_EQ(input->reads, 1);
+}
+
+TEST_F(SensorCacheTest, TracksStalenessAndAge) {
+  auto cached = cache->cache(std::make_shared<CountingInput>());
+  EXPECT_TRUE(cached->getEntry().isStale());
+  EXPECT_EQ(cached->getEntry().getAge(), 0_ms);
+
+  *now = 5_ms;
+  cached->controllerGet();
+  EXPECT_FALSE(cached->getEntry().isStale());
+
+  *now = 12_ms;
+  EXPECT_EQ(cached->getEntry().getAge(), 7_ms);
+
+  cache->refresh();
+  EXPECT_EQ(cache->getFrameTime(), 12_ms);
+  EXPECT_TRUE(cached->getEntry().isStale());
+  EXPECT_EQ(cached->getEntry().getAge(), 7_ms);
+}
+
+TEST_F(SensorCacheTest, ChassisAndOdometryShareReadingsOnScheduler) {
+  auto scheduler = std::make_shared<ControlScheduler>(createTimeUtil());
+  auto model = std::make_shared<MockSkidSteerModel>();
+  const ChassisScales scales({4_in, 8_in}, imev5GreenTPR);
+  auto chassis = std::make_shared<ChassisControllerPID>(createTimeUtil(),
+                                                        model,
+                                                        std::make_unique<MockIterativeController>(),
+                                                        std::make_unique<MockIterativeController>(),
+                                                        std::make_unique<MockIterativeController>(),
+                                                        AbstractMotor::gearset::green,
+                                                        scales);
+  chassis->startThread(scheduler);
+
+  auto sensors = scheduler->getSensorCache()->cache(model);
+  TwoEncoderOdometry odometry(createTimeUtil(), sensors, scales);
+  scheduler->add([&]() { odometry.step(); }, ControlScheduler::Stage::estimate);
+
+  chassis->moveDistanceAsync(1_m);
+  scheduler->tick();
+  EXPECT_EQ(sensors->getEntry().getReadCount(), 1);
+  scheduler->tick();
+  EXPECT_EQ(sensors->getEntry().getReadCount(), 2);
+}
+
+TEST_F(SensorCacheTest, AsyncWrappersShareInputOnScheduler) {
+  auto scheduler = std::make_shared<ControlScheduler>(createTimeUtil());
+  auto input = std::make_shared<CountingInput>();
+  const Supplier<std::unique_ptr<AbstractRate>> rateSupplier(
+    []() { return std::make_unique<MockRate>(); });
+  AsyncWrapper<double, double> first(input,
+                                     std::make_shared<NullOutput>(),
+                                     std::make_shared<MockIterativeController>(),
+                                     rateSupplier);
+  AsyncWrapper<double, double> second(input,
+                                      std::make_shared<NullOutput>(),
+                                      std::make_shared<MockIterativeController>(),
+                                      rateSupplier);
+  first.startThread(scheduler);
+  second.startThread(scheduler);
+
+  first.setTarget(100);
+  second.setTarget(100);
+  scheduler->tick();
+  scheduler->tick();
+  EXPECT_EQ(input->reads, 2);
+}
@@ -0,0 +1,223 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/chassis/controller/chassisControllerPid.hpp"
+#include "okapi/api/chassis/model/sensorValues.hpp"
+#include "okapi/api/odometry/threeEncoderOdometry.hpp"
+#include "okapi/api/odometry/twoEncoderOdometry.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <cstdlib>
+#include <new>
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+namespace {
+// Only allocations made by the test's own thread while counting is on are counted
+thread_local bool countAllocations = false;
+thread_local std::size_t allocations = 0;
+
+class AllocationCounter {
+  public:
+  AllocationCounter() {
+    allocations = 0;
+    countAllocations = true;
+  }
+
+  ~AllocationCounter() {
+    countAllocations = false;
+  }
+
+  std::size_t get() const {
+    return allocations;
+  }
+};
+
+class ThreeEncoderMockModel : public MockSkidSteerModel {
+  public:
+  SensorValues getSensorValues() const override {
+    return SensorValues{static_cast<std::int32_t>(leftEnc->get()),
+                        static_cast<std::int32_t>(rightEnc->get()),
+                        middle};
+  }
+
+  std::int32_t middle{0};
+};
+
+class TickableChassisControllerPID : public ChassisControllerPID {
+  public:
+  using ChassisControllerPID::ChassisControllerPID;
+  using ChassisControllerPID::tick;
+};
+} // namespace
+
+void *operator new(const std::size_t isize) {
+  if (countAllocations) {
+    allocations++;
+  }
+
+  if (void *ptr = std::malloc(isize == 0 ? 1 : isize)) {
+    return ptr;
+  }
+
+  throw std::bad_alloc();
+}
+
+// Not inlined, or GCC sees operator new's pointer reach free() and warns that they mismatch
+[[gnu::noinline]] void operator delete(void *iptr) noexcept {
+  std::free(iptr);
+}
+
+[[gnu::noinline]] void operator delete(void *iptr, std::size_t) noexcept {
+  std::free(iptr);
+}
+
+TEST(SensorValuesTest, HoldsValues) {
+  const SensorValues values{1, 2, 3};
+  EXPECT_EQ(values.size(), 3);
+  EXPECT_EQ(values[0], 1);
+  EXPECT_EQ(values[2], 3);
+  EXPECT_EQ(SensorValues().size(), 0);
+}
+
+TEST(SensorValuesTest, Arithmetic) {
+  const SensorValues a{5, 7, 9};
+  const SensorValues b{1, 2};
+  EXPECT_EQ(a - b, SensorValues({4, 5, 9}));
+  EXPECT_EQ(a + b, SensorValues({6, 9, 9}));
+  EXPECT_EQ(b - a, SensorValues({-4, -5}));
+  EXPECT_NE(a, b);
+}
+
+TEST(SensorValuesTest, ValarrayRoundTrip) {
+  const std::valarray<std::int32_t> valarray{3, -4};
+  const SensorValues values(valarray);
+  EXPECT_EQ(values, SensorValues({3, -4}));
+
+  const auto back = values.toValarray();
+  ASSERT_EQ(back.size(), 2);
+  EXPECT_EQ(back[0], 3);
+  EXPECT_EQ(back[1], -4);
+}
+
+TEST(SensorValuesTest, Timestamps) {
+  SensorValues values{1, 2};
+  EXPECT_EQ(values.getTimestamp(), 0);
+  values.setTimestamp(40);
+  EXPECT_EQ((values - SensorValues{1, 1}).getTimestamp(), 40);
+  EXPECT_EQ(values, SensorValues({1, 2}));
+
+  EXPECT_EQ(SensorValues::oldestTimestamp({30, 10, 20}), 10);
+  EXPECT_EQ(SensorValues::oldestTimestamp({30, 0, 20}), 0);
+  EXPECT_EQ(SensorValues::oldestTimestamp({5, 0xFFFFFFF0}), 0xFFFFFFF0);
+}
+
+TEST(SensorValuesTest, TooManyValuesThrows) {
+  EXPECT_NO_THROW(SensorValues({1, 2, 3, 4, 5, 6, 7, 8}));
+  EXPECT_THROW(SensorValues({1, 2, 3, 4, 5, 6, 7, 8, 9}), std::out_of_range);
+}
+
+TEST(SensorValuesTest, ValarrayModelsStillWork) {
+  // A model which only implements the old valarray method
+  class ValarrayModel : public ReadOnlyChassisModel {
+    public:
+    std::valarray<std::int32_t> getSensorVals() const override {
+      return {10, 20};
+    }
+  };
+
+  ValarrayModel model;
+  EXPECT_EQ(model.getSensorValues(), SensorValues({10, 20}));
+
+  MockSkidSteerModel newModel;
+  newModel.setSensorVals(1, 2);
+  const auto vals = newModel.getSensorVals();
+  ASSERT_EQ(vals.size(), 2);
+  EXPECT_EQ(vals[1], 2);
+
+  // Subclasses of the built-in models can still override the old method
+  class OldSubclass : public MockSkidSteerModel {
+    public:
+    std::valarray<std::int32_t> getSensorVals() const override {
+      return {3, 4};
+    }
+  };
+
+  OldSubclass oldSubclass;
+  EXPECT_EQ(oldSubclass.getSensorVals()[1], 4);
+
+  // The odometry and the chassis controllers read the old method of such subclasses
+  class OldSkidSteerSubclass : public SkidSteerModel {
+    public:
+    OldSkidSteerSubclass()
+      : SkidSteerModel(std::make_shared<MockMotor>(),
+                       std::make_shared<MockMotor>(),
+                       std::make_shared<MockMotor>()->getEncoder(),
+                       std::make_shared<MockMotor>()->getEncoder(),
+                       toUnderlyingType(AbstractMotor::gearset::green),
+                       v5MotorMaxVoltage) {
+    }
+
+    std::valarray<std::int32_t> getSensorVals() const override {
+      return {5, 6};
+    }
+  };
+
+  OldSkidSteerSubclass oldSkidSteerSubclass;
+  EXPECT_EQ(oldSkidSteerSubclass.getSensorValues(), SensorValues({5, 6}));
+}
+
+TEST(SensorValuesTest, OdometryStepDoesNotAllocate) {
+  auto model = std::make_shared<MockSkidSteerModel>();
+  TwoEncoderOdometry odom(createConstantTimeUtil(10_ms), model, ChassisScales({4_in, 10_in}, 360));
+  odom.step();
+
+  AllocationCounter counter;
+  for (int i = 1; i <= 100; ++i) {
+    model->setSensorVals(i, 2 * i);
+    odom.step();
+  }
+
+  EXPECT_EQ(counter.get(), 0);
+  EXPECT_NE(odom.getState().theta, 0_deg);
+}
+
+TEST(SensorValuesTest, ThreeEncoderOdometryStepDoesNotAllocate) {
+  auto model = std::make_shared<ThreeEncoderMockModel>();
+  ThreeEncoderOdometry odom(
+    createConstantTimeUtil(10_ms), model, ChassisScales({4_in, 10_in, 5_in, 4_in}, 360));
+  odom.step();
+
+  AllocationCounter counter;
+  for (int i = 1; i <= 100; ++i) {
+    model->setSensorVals(i, i);
+    model->middle = i;
+    odom.step();
+  }
+
+  EXPECT_EQ(counter.get(), 0);
+  EXPECT_NE(odom.getState().x, 0_m);
+}
+
+TEST(SensorValuesTest, ChassisControllerTickDoesNotAllocate) {
+  auto model = std::make_shared<MockSkidSteerModel>();
+  TickableChassisControllerPID controller(createConstantTimeUtil(10_ms),
+                                          model,
+                                          std::make_unique<MockIterativeController>(0.1),
+                                          std::make_unique<MockIterativeController>(0.1),
+                                          std::make_unique<MockIterativeController>(0.1),
+                                          AbstractMotor::gearset::green,
+                                          ChassisScales({4_in, 10_in}, imev5GreenTPR));
+  controller.moveDistanceAsync(1_m);
+  controller.tick();
+
+  AllocationCounter counter;
+  for (int i = 1; i <= 100; ++i) {
+    model->setSensorVals(i, i);
+    controller.tick();
+  }
+
+  EXPECT_EQ(counter.get(), 0);
+}
@@ -0,0 +1,163 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/trajectoryCache.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class TrajectoryCacheTest : public ::testing::Test {
+  protected:
+  static std::vector<squiggles::ProfilePoint> makeTrajectory(const std::size_t isize,
+                                                             const double ivel) {
+    std::vector<squiggles::ProfilePoint> trajectory;
+    trajectory.reserve(isize);
+    for (std::size_t i = 0; i < isize; ++i) {
+      trajectory.emplace_back(
+        squiggles::ControlVector(squiggles::Pose(i * 0.01, 0, 0), ivel, 0, 0),
+        std::vector<double>{ivel, ivel},
+        0,
+        i * 0.01);
+    }
+
+    return trajectory;
+  }
+
+  static std::uint64_t makeKey(const QLength &ix) {
+    return TrajectoryCache::makeKey(
+      {PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{ix, 0_m, 0_deg}}, limits, 10.5_in, 0.01);
+  }
+
+  static constexpr PathfinderLimits limits{1.0, 2.0, 10.0};
+  BinaryPathHeader header = BinaryPath::makeHeader(
+    0, 0.01, limits, ChassisScales({4_in, 10.5_in}, quadEncoderTPR));
+};
+
+TEST_F(TrajectoryCacheTest, IdenticalInputsHaveIdenticalKeys) {
+  EXPECT_EQ(makeKey(1_m), makeKey(1_m));
+  EXPECT_NE(makeKey(1_m), makeKey(2_m));
+}
+
+TEST_F(TrajectoryCacheTest, KeyDependsOnLimitsAndChassis) {
+  const std::vector<PathfinderPoint> points{PathfinderPoint{0_m, 0_m, 0_deg},
+                                            PathfinderPoint{1_m, 0_m, 0_deg}};
+  const auto key = TrajectoryCache::makeKey(points, limits, 10.5_in, 0.01);
+
+  EXPECT_NE(key, TrajectoryCache::makeKey(points, {1.5, 2.0, 10.0}, 10.5_in, 0.01));
+  EXPECT_NE(key, TrajectoryCache::makeKey(points, limits, 12_in, 0.01));
+  EXPECT_NE(key, TrajectoryCache::makeKey(points, limits, 10.5_in, 0.005));
+  EXPECT_NE(key, TrajectoryCache::makeKey(points, limits, 10.5_in, 0.01, 0, 0.5));
+  EXPECT_EQ(key, TrajectoryCache::makeKey(points, limits, 10.5_in, 0.01, 0, 0));
+}
+
+TEST_F(TrajectoryCacheTest, NegativeZeroHasTheSameKeyAsZero) {
+  const auto key = TrajectoryCache::makeKey(
+    {PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{1_m, 0_m, 0_deg}}, limits, 10.5_in, 0.01);
+  const auto negativeKey = TrajectoryCache::makeKey(
+    {PathfinderPoint{-0_m, 0_m, -0_deg}, PathfinderPoint{1_m, -0_m, 0_deg}},
+    limits,
+    10.5_in,
+    0.01);
+
+  EXPECT_EQ(key, negativeKey);
+}
+
+TEST_F(TrajectoryCacheTest, CountsHitsAndMisses) {
+  TrajectoryCache cache;
+
+  EXPECT_EQ(cache.get(makeKey(1_m)), nullptr);
+  cache.put(makeKey(1_m), makeTrajectory(10, 1), header);
+
+  const auto trajectory = cache.get(makeKey(1_m));
+  ASSERT_NE(trajectory, nullptr);
+  EXPECT_EQ(trajectory->size(), 10);
+
+  const auto stats = cache.getStats();
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.diskHits, 0);
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.evictions, 0);
+  EXPECT_EQ(stats.entries, 1);
+  EXPECT_GT(stats.memoryUsage, 0);
+
+  cache.resetStats();
+  EXPECT_EQ(cache.getStats().hits, 0);
+  EXPECT_EQ(cache.getStats().entries, 1);
+}
+
+TEST_F(TrajectoryCacheTest, EvictsLeastRecentlyUsedTrajectory) {
+  const auto size = TrajectoryCache::estimateMemoryUsage(makeTrajectory(100, 1));
+  TrajectoryCache cache(size * 2);
+
+  cache.put(makeKey(1_m), makeTrajectory(100, 1), header);
+  cache.put(makeKey(2_m), makeTrajectory(100, 2), header);
+
+  // Use the first trajectory so the second one is evicted next
+  ASSERT_NE(cache.get(makeKey(1_m)), nullptr);
+  cache.put(makeKey(3_m), makeTrajectory(100, 3), header);
+
+  EXPECT_NE(cache.get(makeKey(1_m)), nullptr);
+  EXPECT_EQ(cache.get(makeKey(2_m)), nullptr);
+  EXPECT_NE(cache.get(makeKey(3_m)), nullptr);
+
+  const auto stats = cache.getStats();
+  EXPECT_EQ(stats.evictions, 1);
+  EXPECT_EQ(stats.entries, 2);
+  EXPECT_LE(stats.memoryUsage, size * 2);
+}
+
+TEST_F(TrajectoryCacheTest, TrajectoryLargerThanBudgetIsNotCached) {
+  TrajectoryCache cache(64);
+
+  cache.put(makeKey(1_m), makeTrajectory(100, 1), header);
+
+  EXPECT_EQ(cache.get(makeKey(1_m)), nullptr);
+  EXPECT_EQ(cache.getStats().entries, 0);
+  EXPECT_EQ(cache.getStats().memoryUsage, 0);
+}
+
+TEST_F(TrajectoryCacheTest, EvictedReferencesStayValid) {
+  const auto size = TrajectoryCache::estimateMemoryUsage(makeTrajectory(100, 1));
+  TrajectoryCache cache(size);
+
+  cache.put(makeKey(1_m), makeTrajectory(100, 1), header);
+  const auto trajectory = cache.get(makeKey(1_m));
+  cache.put(makeKey(2_m), makeTrajectory(100, 2), header);
+
+  EXPECT_EQ(cache.get(makeKey(1_m)), nullptr);
+  ASSERT_NE(trajectory, nullptr);
+  EXPECT_EQ(trajectory->size(), 100);
+  EXPECT_DOUBLE_EQ(trajectory->front().vector.vel, 1);
+}
+
+TEST_F(TrajectoryCacheTest, PersistedTrajectoriesAreLoadedByANewCache) {
+  char directory[] = "/tmp/okapiTrajectoryCacheXXXXXX";
+  ASSERT_NE(mkdtemp(directory), nullptr);
+
+  {
+    TrajectoryCache cache(256 * 1024, directory);
+    cache.put(makeKey(1_m), makeTrajectory(10, 1.5), header);
+  }
+
+  TrajectoryCache cache(256 * 1024, directory);
+  const auto trajectory = cache.get(makeKey(1_m));
+  ASSERT_NE(trajectory, nullptr);
+  ASSERT_EQ(trajectory->size(), 10);
+  EXPECT_FLOAT_EQ(trajectory->back().vector.vel, 1.5);
+  EXPECT_FLOAT_EQ(trajectory->back().time, 0.09);
+  EXPECT_EQ(cache.getStats().diskHits, 1);
+
+  // The trajectory loaded from disk is now held in memory
+  EXPECT_NE(cache.get(makeKey(1_m)), nullptr);
+  EXPECT_EQ(cache.getStats().hits, 1);
+
+  char name[24];
+  snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(makeKey(1_m)));
+  std::remove((std::string(directory) + "/" + name).c_str());
+  std::remove(directory);
+}
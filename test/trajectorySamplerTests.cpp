@@ -0,0 +1,99 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/trajectorySampler.hpp"
+#include <vector>
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class TrajectorySamplerTest : public ::testing::Test {
+  protected:
+  std::optional<TrajectorySample> sample(const double ielapsed) {
+    return sampler.sample(ielapsed, times.size(), [this](std::size_t i) { return times.at(i); });
+  }
+
+  std::vector<double> times{0, 0.01, 0.02, 0.03, 0.04};
+  TrajectorySampler sampler;
+};
+
+TEST_F(TrajectorySamplerTest, EmptyTrajectoryHasNoSamples) {
+  EXPECT_FALSE(sampler.sample(0, 0, [](std::size_t) { return 0.0; }).has_value());
+}
+
+TEST_F(TrajectorySamplerTest, SamplesOnPoints) {
+  auto result = sample(0);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->index, 0);
+  EXPECT_EQ(result->next, 1);
+  EXPECT_DOUBLE_EQ(result->fraction, 0);
+
+  result = sample(0.01);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->index, 1);
+  EXPECT_NEAR(result->fraction, 0, 1e-9);
+}
+
+TEST_F(TrajectorySamplerTest, InterpolatesBetweenPoints) {
+  const auto result = sample(0.025);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->index, 2);
+  EXPECT_EQ(result->next, 3);
+  EXPECT_NEAR(result->fraction, 0.5, 1e-9);
+}
+
+TEST_F(TrajectorySamplerTest, LateSampleSkipsPoints) {
+  sample(0);
+  const auto result = sample(0.035);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->index, 3);
+  EXPECT_EQ(sampler.getSkippedPoints(), 2);
+}
+
+TEST_F(TrajectorySamplerTest, LastPointHasNoNextPoint) {
+  const auto result = sample(0.04);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->index, 4);
+  EXPECT_EQ(result->next, 4);
+  EXPECT_DOUBLE_EQ(result->fraction, 0);
+}
+
+TEST_F(TrajectorySamplerTest, FirstSampleAfterTheEndIsOnTheLastPoint) {
+  sample(0);
+  sample(0.01);
+
+  const auto result = sample(0.05);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->index, 4);
+  EXPECT_EQ(result->next, 4);
+  EXPECT_DOUBLE_EQ(result->fraction, 0);
+  EXPECT_EQ(sampler.getSkippedPoints(), 2);
+
+  EXPECT_FALSE(sample(0.06).has_value());
+  EXPECT_EQ(sampler.getSkippedPoints(), 2);
+}
+
+TEST_F(TrajectorySamplerTest, NoSampleAfterTheLastPoint) {
+  sample(0);
+  sample(0.04);
+  EXPECT_FALSE(sample(0.05).has_value());
+  EXPECT_EQ(sampler.getSkippedPoints(), 3);
+}
+
+TEST_F(TrajectorySamplerTest, FirstSampleAfterTheEndSkipsAllButTheLastPoint) {
+  const auto result = sample(1);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->index, 4);
+  EXPECT_EQ(sampler.getSkippedPoints(), 4);
+  EXPECT_FALSE(sample(2).has_value());
+}
+
+TEST_F(TrajectorySamplerTest, SamplesRelativeToFirstPointTime) {
+  times = {1, 1.01, 1.02};
+  const auto result = sample(0.015);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->index, 1);
+  EXPECT_NEAR(result->fraction, 0.5, 1e-9);
+}
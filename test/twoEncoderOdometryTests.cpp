@@ -122,3 +122,176 @@ TEST_F(OdometryTest, TickDiffLessThanMax) {
   odom->step();
   assertOdomStateEquals(odom, 1_in, 2_in, 45_deg);
 }
+
+TEST_F(OdometryTest, UntimedSamplesUseTimerForVelocity) {
+  model->setSensorVals(36, 36);
+  odom->step();
+  EXPECT_NEAR(odom->getLinearVelocity().convert(mps),
+              (calculateDistanceTraveled(36) / 10_ms).convert(mps),
+              1e-9);
+  EXPECT_EQ(odom->getStaleSamples(), 0);
+}
+
+TEST_F(OdometryTest, TimestampedSamplesUseDeviceTime) {
+  model->setSensorTimestamps(100, 100);
+  model->setSensorVals(36, 36);
+  odom->step();
+
+  // The timer says 10 ms passed, but the sensors were sampled 30 ms apart
+  model->setSensorTimestamps(130, 130);
+  model->setSensorVals(72, 72);
+  odom->step();
+
+  assertOdomStateEquals(odom, calculateDistanceTraveled(72), 0_m, 0_deg);
+  EXPECT_NEAR(odom->getLinearVelocity().convert(mps),
+              (calculateDistanceTraveled(36) / 30_ms).convert(mps),
+              1e-9);
+}
+
+TEST_F(OdometryTest, StaleSamplesAreSkipped) {
+  model->setSensorTimestamps(100, 100);
+  model->setSensorVals(36, 36);
+  odom->step();
+  const auto velocity = odom->getLinearVelocity();
+
+  for (int i = 0; i < 3; ++i) {
+    odom->step();
+  }
+
+  EXPECT_EQ(odom->getStaleSamples(), 3);
+  EXPECT_EQ(odom->getLinearVelocity(), velocity);
+  assertOdomStateEquals(odom, calculateDistanceTraveled(36), 0_m, 0_deg);
+}
+
+TEST_F(OdometryTest, PartlyUpdatedSampleWaitsForOldestSensor) {
+  model->setSensorTimestamps(100, 100);
+  odom->step();
+
+  // Only the left sensor has a new sample, so driving straight must not look like a turn
+  model->setSensorTimestamps(110, 100);
+  model->setSensorVals(36, 0);
+  odom->step();
+  EXPECT_EQ(odom->getStaleSamples(), 1);
+  assertOdomStateEquals(odom, 0_m, 0_m, 0_deg);
+
+  model->setSensorTimestamps(110, 110);
+  model->setSensorVals(36, 36);
+  odom->step();
+  assertOdomStateEquals(odom, calculateDistanceTraveled(36), 0_m, 0_deg);
+}
+
+TEST_F(OdometryTest, FastTaskDoesNotBiasVelocity) {
+  // The task runs every 10 ms but the sensors only update every 20 ms
+  const QSpeed expected = calculateDistanceTraveled(20) / 20_ms;
+  for (int step = 0; step < 20; ++step) {
+    const int sample = step / 2;
+    model->setSensorTimestamps(100 + 20 * sample, 100 + 20 * sample);
+    model->setSensorVals(20 * sample, 20 * sample);
+    odom->step();
+
+    if (step >= 2) {
+      EXPECT_NEAR(odom->getLinearVelocity().convert(mps), expected.convert(mps), 1e-9);
+    }
+  }
+
+  EXPECT_EQ(odom->getStaleSamples(), 10);
+  assertOdomStateEquals(odom, calculateDistanceTraveled(180), 0_m, 0_deg);
+}
+
+TEST_F(OdometryTest, TimestampedTurnVelocity) {
+  model->setSensorTimestamps(100, 100);
+  odom->step();
+
+  model->setSensorTimestamps(120, 120);
+  model->setSensorVals(10, -10);
+  odom->step();
+  EXPECT_NEAR(odom->getAngularVelocity().convert(radps),
+              (odom->getState().theta / 20_ms).convert(radps),
+              1e-9);
+  EXPECT_GT(odom->getAngularVelocity().convert(radps), 0);
+}
+
+TEST_F(OdometryTest, GetStateAtInterpolates) {
+  for (int i = 0; i < 3; ++i) {
+    model->setSensorTimestamps(100 + 20 * i, 100 + 20 * i);
+    model->setSensorVals(36 * i, 36 * i);
+    odom->step();
+  }
+
+  EXPECT_NEAR(odom->getStateAt(130_ms).x.convert(meter),
+              calculateDistanceTraveled(54).convert(meter),
+              1e-9);
+  const auto cartesian = odom->getStateAt(120_ms, StateMode::CARTESIAN);
+  EXPECT_EQ(odom->getStateAt(120_ms), (OdomState{cartesian.y, cartesian.x, cartesian.theta}));
+  EXPECT_EQ(odom->getStateAt(50_ms), OdomState{});
+  EXPECT_EQ(odom->getStateAt(1_s), odom->getState());
+}
+
+TEST_F(OdometryTest, HistoryKeepsNewestSteps) {
+  const int steps = TwoEncoderOdometry::historySize + 10;
+  for (int i = 1; i <= steps; ++i) {
+    model->setSensorTimestamps(10 * i, 10 * i);
+    model->setSensorVals(i, i);
+    odom->step();
+  }
+
+  // The first 10 steps were forgotten, so the oldest state is from step 11
+  EXPECT_NEAR(
+    odom->getStateAt(0_ms).x.convert(meter), calculateDistanceTraveled(11).convert(meter), 1e-9);
+  EXPECT_FALSE(odom->correctStateAt(100_ms, OdomState{}));
+  EXPECT_TRUE(odom->correctStateAt(110_ms, OdomState{}));
+  EXPECT_NEAR(odom->getState().x.convert(meter),
+              calculateDistanceTraveled(steps - 11).convert(meter),
+              1e-9);
+}
+
+TEST_F(OdometryTest, CorrectStateAtMovesLaterStates) {
+  for (int i = 0; i < 3; ++i) {
+    model->setSensorTimestamps(100 + 20 * i, 100 + 20 * i);
+    model->setSensorVals(36 * i, 36 * i);
+    odom->step();
+  }
+
+  // The robot was actually facing 90 degrees at 120 ms, so it has since driven along y
+  EXPECT_TRUE(odom->correctStateAt(120_ms, OdomState{1_m, 0_m, 90_deg}));
+  assertOdomStateEquals(odom, 1_m, calculateDistanceTraveled(36), 90_deg);
+  EXPECT_EQ(odom->getStateAt(120_ms), (OdomState{1_m, 0_m, 90_deg}));
+  EXPECT_EQ(odom->getStateAt(100_ms), OdomState{});
+}
+
+TEST_F(OdometryTest, CorrectStateAtMatchesIntegratingAgain) {
+  auto otherModel = std::make_shared<MockSkidSteerModel>();
+  TwoEncoderOdometry other(createConstantTimeUtil(10_ms),
+                           otherModel,
+                           ChassisScales({{wheelDiam, wheelbaseWidth}, 360}));
+  const OdomState corrected{2_in, -3_in, 30_deg};
+
+  for (int i = 0; i < 10; ++i) {
+    model->setSensorTimestamps(100 + 10 * i, 100 + 10 * i);
+    model->setSensorVals(30 * i, 20 * i);
+    odom->step();
+
+    otherModel->setSensorTimestamps(100 + 10 * i, 100 + 10 * i);
+    otherModel->setSensorVals(30 * i, 20 * i);
+    other.step();
+    if (i == 4) {
+      other.setState(corrected);
+    }
+  }
+
+  EXPECT_TRUE(odom->correctStateAt(140_ms, corrected));
+  EXPECT_NEAR(odom->getState().x.convert(meter), other.getState().x.convert(meter), 1e-9);
+  EXPECT_NEAR(odom->getState().y.convert(meter), other.getState().y.convert(meter), 1e-9);
+  EXPECT_NEAR(
+    odom->getState().theta.convert(radian), other.getState().theta.convert(radian), 1e-9);
+}
+
+TEST_F(OdometryTest, SetStateForgetsHistory) {
+  model->setSensorTimestamps(100, 100);
+  model->setSensorVals(36, 36);
+  odom->step();
+
+  odom->setState(OdomState{1_m, 1_m, 0_deg});
+  EXPECT_EQ(odom->getStateAt(100_ms), (OdomState{1_m, 1_m, 0_deg}));
+  EXPECT_FALSE(odom->correctStateAt(100_ms, OdomState{}));
+}
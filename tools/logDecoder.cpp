@@ -0,0 +1,44 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/logRecord.hpp"
+#include <fstream>
+#include <iostream>
+
+/**
+ * Converts a binary log written by a Logger using Logger::Format::binary to text:
+ *
+ *   OkapiLibLogDecoder <binary log> [text log]
+ *
+ * The text is printed if no output file is given.
+ */
+int main(int argc, char **argv) {
+  if (argc < 2 || argc > 3) {
+    std::cerr << "Usage: " << argv[0] << " <binary log> [text log]" << std::endl;
+    return 1;
+  }
+
+  std::ifstream in(argv[1], std::ios::binary);
+  if (!in) {
+    std::cerr << "Could not open " << argv[1] << std::endl;
+    return 1;
+  }
+
+  std::ofstream file;
+  if (argc == 3) {
+    file.open(argv[2]);
+    if (!file) {
+      std::cerr << "Could not open " << argv[2] << std::endl;
+      return 1;
+    }
+  }
+
+  if (!okapi::decodeBinaryLog(in, argc == 3 ? file : std::cout)) {
+    std::cerr << argv[1] << " is not a complete OkapiLib binary log" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}